@@ -100,10 +100,30 @@ static tb_void_t tb_demo_coroutine_channel_perf_recv(tb_cpointer_t priv)
     tb_size_t count = COUNT;
     while (count--) tb_co_channel_recv(channel);
 }
-static tb_void_t tb_demo_coroutine_channel_perf(tb_size_t size)
+static tb_void_t tb_demo_coroutine_channel_perf_send_n(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+
+    // loop
+    tb_size_t       count = COUNT;
+    tb_cpointer_t   data[64] = {0};
+    while (count) count -= tb_co_channel_send_n(channel, data, tb_min(count, tb_arrayn(data)));
+}
+static tb_void_t tb_demo_coroutine_channel_perf_recv_n(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+
+    // loop
+    tb_size_t       count = COUNT;
+    tb_pointer_t    data[64];
+    while (count) count -= tb_co_channel_recv_n(channel, data, tb_min(count, tb_arrayn(data)));
+}
+static tb_void_t tb_demo_coroutine_channel_perf(tb_size_t size, tb_bool_t batch)
 {
     // trace
-    tb_trace_i("perf: %lu", size);
+    tb_trace_i("perf: %lu, batch: %s", size, batch? "yes" : "no");
 
     // init scheduler
     tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
@@ -114,8 +134,8 @@ static tb_void_t tb_demo_coroutine_channel_perf(tb_size_t size)
         tb_assert(channel);
 
         // start coroutine
-        tb_coroutine_start(scheduler, tb_demo_coroutine_channel_perf_send, channel, 0);
-        tb_coroutine_start(scheduler, tb_demo_coroutine_channel_perf_recv, channel, 0);
+        tb_coroutine_start(scheduler, batch? tb_demo_coroutine_channel_perf_send_n : tb_demo_coroutine_channel_perf_send, channel, 0);
+        tb_coroutine_start(scheduler, batch? tb_demo_coroutine_channel_perf_recv_n : tb_demo_coroutine_channel_perf_recv, channel, 0);
 
         // init the start time
         tb_hong_t startime = tb_mclock();
@@ -146,9 +166,10 @@ tb_int_t tb_demo_coroutine_channel_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_coroutine_channel_test(1);
     tb_demo_coroutine_channel_test(5);
 
-    tb_demo_coroutine_channel_perf(0);
-    tb_demo_coroutine_channel_perf(1);
-    tb_demo_coroutine_channel_perf(10);
+    tb_demo_coroutine_channel_perf(0, tb_false);
+    tb_demo_coroutine_channel_perf(1, tb_false);
+    tb_demo_coroutine_channel_perf(10, tb_false);
+    tb_demo_coroutine_channel_perf(256, tb_true);
 
     return 0;
 }
@@ -445,7 +445,7 @@ static tb_void_t tb_demo_coroutine_client(tb_cpointer_t priv)
 }
 static tb_void_t tb_demo_coroutine_listen(tb_cpointer_t priv)
 {
-    // TODO: fix thundering herd issues
+    // each worker has its own listening socket of the listener group if SO_REUSEPORT is supported
     tb_socket_ref_t sock = (tb_socket_ref_t)priv;
     while (tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, -1) > 0)
     {
@@ -487,20 +487,30 @@ static tb_int_t tb_demo_coroutine_worker(tb_cpointer_t priv)
 tb_int_t tb_demo_coroutine_http_server_main(tb_int_t argc, tb_char_t** argv)
 {
     // done
-    tb_socket_ref_t sock = tb_null;
+    tb_size_t       i = 0;
+    tb_socket_ref_t socks[TB_DEMO_CPU] = {0};
     do
     {
-        // init socket
-        sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
-        tb_assert_and_check_break(sock);
-
-        // bind socket
+        // init address
         tb_ipaddr_t addr;
         tb_ipaddr_set(&addr, tb_null, TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
-        if (!tb_socket_bind(sock, &addr)) break;
 
-        // listen socket
-        if (!tb_socket_listen(sock, 1000)) break;
+        // listen one socket for each worker, the kernel will balance the connections to them
+        if (TB_DEMO_CPU == 1 || !tb_socket_listen_group(socks, TB_DEMO_CPU, TB_SOCKET_TYPE_TCP, &addr, 1000, tb_false))
+        {
+            // init socket
+            socks[0] = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+            tb_assert_and_check_break(socks[0]);
+
+            // bind socket
+            if (!tb_socket_bind(socks[0], &addr)) break;
+
+            // listen socket
+            if (!tb_socket_listen(socks[0], 1000)) break;
+
+            // all workers accept on the same socket if the listener group is not supported
+            for (i = 1; i < TB_DEMO_CPU; i++) socks[i] = socks[0];
+        }
 
         // init the root directory
         if (argv[1]) tb_strlcpy(g_rootdir, argv[1], sizeof(g_rootdir));
@@ -514,18 +524,20 @@ tb_int_t tb_demo_coroutine_http_server_main(tb_int_t argc, tb_char_t** argv)
 
 #if TB_DEMO_CPU > 1
         // start workers for multi-threads
-        tb_size_t count = TB_DEMO_CPU - 1;
-        while (count--) tb_thread_init(tb_null, tb_demo_coroutine_worker, sock, 0);
+        for (i = 1; i < TB_DEMO_CPU; i++) tb_thread_init(tb_null, tb_demo_coroutine_worker, socks[i], 0);
 #endif
 
         // start worker
-        tb_demo_coroutine_worker(sock);
+        tb_demo_coroutine_worker(socks[0]);
 
     } while (0);
 
-    // exit socket
-    if (sock) tb_socket_exit(sock);
-    sock = tb_null;
+    // exit sockets, the shared socket will be only exited once
+    for (i = 1; i < TB_DEMO_CPU; i++)
+    {
+        if (socks[i] && socks[i] != socks[0]) tb_socket_exit(socks[i]);
+    }
+    if (socks[0]) tb_socket_exit(socks[0]);
 
     // ok
     return 0;
@@ -0,0 +1,165 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// port
+#define TB_DEMO_PORT        (9091)
+
+// the ping-pong count
+#define TB_DEMO_COUNT       (100000)
+
+// timeout
+#define TB_DEMO_TIMEOUT     (5000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_bool_t tb_demo_coroutine_recv(tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size)
+{
+    // recv all data
+    tb_size_t read = 0;
+    while (read < size)
+    {
+        tb_long_t real = tb_coroutine_recv(sock, data + read, size - read, TB_DEMO_TIMEOUT);
+        tb_check_return_val(real > 0, tb_false);
+        read += real;
+    }
+    return tb_true;
+}
+static tb_bool_t tb_demo_coroutine_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size)
+{
+    // send all data
+    tb_size_t writ = 0;
+    while (writ < size)
+    {
+        tb_long_t real = tb_coroutine_send(sock, data + writ, size - writ, TB_DEMO_TIMEOUT);
+        tb_check_return_val(real > 0, tb_false);
+        writ += real;
+    }
+    return tb_true;
+}
+static tb_void_t tb_demo_coroutine_server(tb_cpointer_t priv)
+{
+    // check
+    tb_socket_ref_t sock = (tb_socket_ref_t)priv;
+    tb_assert_and_check_return(sock);
+
+    // accept the client
+    tb_socket_ref_t client = tb_coroutine_accept(sock, tb_null, TB_DEMO_TIMEOUT);
+    if (client)
+    {
+        // echo data
+        tb_byte_t data[8];
+        while (tb_demo_coroutine_recv(client, data, sizeof(data)))
+        {
+            if (!tb_demo_coroutine_send(client, data, sizeof(data))) break;
+        }
+
+        // exit client
+        tb_socket_exit(client);
+    }
+
+    // exit socket
+    tb_socket_exit(sock);
+}
+static tb_void_t tb_demo_coroutine_client(tb_cpointer_t priv)
+{
+    // done
+    tb_socket_ref_t sock = tb_null;
+    do
+    {
+        // init socket
+        sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+        tb_assert_and_check_break(sock);
+
+        // connect server
+        tb_ipaddr_t addr;
+        tb_ipaddr_set(&addr, "127.0.0.1", TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+        if (tb_coroutine_connect(sock, &addr, TB_DEMO_TIMEOUT) <= 0)
+        {
+            tb_trace_e("connect %{ipaddr} failed!", &addr);
+            break;
+        }
+
+        // ping-pong
+        tb_size_t   count = 0;
+        tb_hong_t   time = tb_mclock();
+        tb_byte_t   data[8] = {0};
+        for (count = 0; count < TB_DEMO_COUNT; count++)
+        {
+            if (!tb_demo_coroutine_send(sock, data, sizeof(data))) break;
+            if (!tb_demo_coroutine_recv(sock, data, sizeof(data))) break;
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("ping-pong: %lu, %lld ms, %lld/s", count, time, time > 0? (1000 * (tb_hong_t)count) / time : 0);
+
+    } while (0);
+
+    // exit socket
+    if (sock) tb_socket_exit(sock);
+    sock = tb_null;
+}
+static tb_void_t tb_demo_coroutine_file(tb_cpointer_t priv)
+{
+    // init file
+    tb_char_t const* path = (tb_char_t const*)priv;
+    tb_file_ref_t file = tb_file_init(path, TB_FILE_MODE_RW | TB_FILE_MODE_CREAT | TB_FILE_MODE_TRUNC);
+    if (file)
+    {
+        // writ and read it
+        tb_char_t const*    data = "hello coroutine io!";
+        tb_char_t           read[64] = {0};
+        tb_long_t           writ = tb_coroutine_pwrit(file, (tb_byte_t const*)data, tb_strlen(data), 0);
+        tb_long_t           real = tb_coroutine_pread(file, (tb_byte_t*)read, sizeof(read) - 1, 0);
+
+        // trace
+        tb_trace_i("file: writ: %ld, read: %ld, %s", writ, real, read);
+
+        // exit file
+        tb_file_exit(file);
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_io_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket
+    tb_socket_ref_t sock = tb_socket_init(TB_SOCKET_TYPE_TCP, TB_IPADDR_FAMILY_IPV4);
+    if (sock)
+    {
+        // bind and listen socket
+        tb_ipaddr_t addr;
+        tb_ipaddr_set(&addr, tb_null, TB_DEMO_PORT, TB_IPADDR_FAMILY_IPV4);
+        if (tb_socket_bind(sock, &addr) && tb_socket_listen(sock, 10))
+        {
+            // init scheduler
+            tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+            if (scheduler)
+            {
+                // start coroutines, the server coroutine will exit the listening socket
+                if (tb_coroutine_start(scheduler, tb_demo_coroutine_server, sock, 0)) sock = tb_null;
+                tb_coroutine_start(scheduler, tb_demo_coroutine_client, tb_null, 0);
+                tb_coroutine_start(scheduler, tb_demo_coroutine_file, argv[1]? argv[1] : "/tmp/coroutine_io.txt", 0);
+
+                // run scheduler
+                tb_co_scheduler_loop(scheduler, tb_true);
+
+                // exit scheduler
+                tb_co_scheduler_exit(scheduler);
+            }
+        }
+
+        // exit socket
+        if (sock) tb_socket_exit(sock);
+    }
+    return 0;
+}
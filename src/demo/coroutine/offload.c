@@ -0,0 +1,121 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the coroutines count
+#define TB_DEMO_COUNT       (100)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the offload task type
+typedef struct __tb_demo_task_t
+{
+    // the waiting coroutine
+    tb_coroutine_ref_t      coroutine;
+
+    // the input value
+    tb_size_t               value;
+
+}tb_demo_task_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the finished tasks count
+static tb_size_t g_finished = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_task_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_demo_task_t* task = (tb_demo_task_t*)priv;
+    tb_assert_and_check_return(task);
+
+    // do the blocking work in the worker thread
+    tb_msleep(10);
+    tb_size_t result = task->value * task->value;
+
+    // resume the waiting coroutine with the result
+    tb_coroutine_resume_safe(task->coroutine, (tb_cpointer_t)result);
+}
+static tb_void_t tb_demo_coroutine_finish(tb_cpointer_t priv)
+{
+    // it is called in the scheduler thread, so we need not lock it
+    g_finished++;
+}
+static tb_void_t tb_demo_coroutine_offload(tb_cpointer_t priv)
+{
+    // init task
+    tb_demo_task_t task;
+    task.coroutine  = tb_coroutine_self();
+    task.value      = (tb_size_t)priv;
+
+    // post it to the thread pool
+    if (tb_thread_pool_task_post(tb_thread_pool(), "offload", tb_demo_task_done, tb_null, &task, tb_false))
+    {
+        // wait the result without blocking the other coroutines
+        tb_size_t result = (tb_size_t)tb_coroutine_sleep(-1);
+
+        // check result
+        tb_assert(result == task.value * task.value);
+
+        // notify the scheduler
+        tb_co_scheduler_post(tb_co_scheduler_self(), tb_demo_coroutine_finish, tb_null);
+    }
+}
+static tb_void_t tb_demo_coroutine_ticker(tb_cpointer_t priv)
+{
+    // the scheduler is still responsive while the tasks are running
+    tb_size_t ticks = 0;
+    while (g_finished < TB_DEMO_COUNT)
+    {
+        tb_coroutine_sleep(10);
+        ticks++;
+    }
+
+    // trace
+    tb_trace_i("ticker: %lu ticks", ticks);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_offload_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start coroutines
+        tb_size_t i = 0;
+        for (i = 0; i < TB_DEMO_COUNT; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_offload, (tb_cpointer_t)i, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_ticker, tb_null, 0);
+
+        /* run scheduler
+         *
+         * we cannot use the exclusive mode, because the global scheduler will be visible to the worker threads,
+         * and tb_msleep() will be switched to tb_coroutine_sleep() in the worker threads
+         */
+        tb_hong_t time = tb_mclock();
+        tb_co_scheduler_loop(scheduler, tb_false);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("offload: %lu finished, %lld ms", g_finished, time);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the worker count
+#define WORKER_COUNT        (4)
+
+// the switch count of each worker
+#define SWITCH_COUNT        (10000)
+
+// the busy slice time (us) of the hog coroutine
+#define HOG_SLICE           (20000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+static tb_void_t tb_demo_coroutine_profiler_worker(tb_cpointer_t priv)
+{
+    // loop
+    tb_size_t count = (tb_size_t)priv;
+    while (count--)
+    {
+        // yield
+        tb_coroutine_yield();
+    }
+}
+static tb_void_t tb_demo_coroutine_profiler_hog(tb_cpointer_t priv)
+{
+    // loop
+    tb_size_t count = (tb_size_t)priv;
+    while (count--)
+    {
+        // busy loop without yielding, it will block all other coroutines
+        tb_hong_t time = tb_uclock();
+        while (tb_uclock() - time < HOG_SLICE) ;
+
+        // yield
+        tb_coroutine_yield();
+    }
+}
+static tb_bool_t tb_demo_coroutine_profiler_trace(tb_co_profiler_sample_t const* sample, tb_cpointer_t priv)
+{
+    // only trace the long slices
+    tb_size_t* count = (tb_size_t*)priv;
+    if (sample->run_time >= HOG_SLICE)
+    {
+        // trace
+        tb_trace_i("[sample]: coroutine: %p, time: %lld, run: %lld us, ready: %lld us", sample->coroutine, sample->time, sample->run_time, sample->ready_time);
+
+        // update count
+        (*count)++;
+    }
+
+    // continue
+    return tb_true;
+}
+static tb_void_t tb_demo_coroutine_profiler_monitor(tb_cpointer_t priv)
+{
+    // wait some time
+    tb_coroutine_sleep(100);
+
+    // dump all coroutines
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_self();
+    tb_co_scheduler_stats_dump(scheduler);
+
+    // export the samples
+    tb_size_t count = 0;
+    tb_size_t total = tb_co_scheduler_trace(scheduler, tb_demo_coroutine_profiler_trace, &count);
+
+    // the longest slice must be the hog coroutine
+    tb_co_profiler_stats_t stats;
+    if (tb_co_scheduler_stats(scheduler, &stats))
+    {
+        // trace
+        tb_trace_i("samples: %lu, long slices: %lu, slice_max: %lld us, is hog: %s"
+                   , total, count, stats.slice_max, stats.slice_max_func == (tb_cpointer_t)tb_demo_coroutine_profiler_hog? "ok" : "no");
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_coroutine_profiler_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // enable the profiler and sample all slices
+        tb_co_scheduler_profile(scheduler, tb_true, 1);
+
+        // start the workers
+        tb_size_t i = 0;
+        for (i = 0; i < WORKER_COUNT; i++)
+            tb_coroutine_start(scheduler, tb_demo_coroutine_profiler_worker, (tb_cpointer_t)SWITCH_COUNT, 0);
+
+        // start the hog coroutine
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profiler_hog, (tb_cpointer_t)8, 0);
+
+        // start the monitor coroutine
+        tb_coroutine_start(scheduler, tb_demo_coroutine_profiler_monitor, tb_null, 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_true);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
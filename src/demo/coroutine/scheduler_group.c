@@ -0,0 +1,72 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */ 
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the coroutine count
+#define COUNT       (1000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */ 
+static tb_void_t tb_demo_coroutine_group_func(tb_cpointer_t priv)
+{
+    // loop
+    tb_size_t count = 10;
+    while (count--)
+    {
+        // do some works
+        tb_size_t i = 0;
+        tb_size_t sum = 0;
+        for (i = 0; i < 100000; i++) sum += i;
+
+        // yield or sleep it
+        if (count & 1) tb_coroutine_yield();
+        else tb_msleep(1);
+    }
+
+    // trace
+    tb_trace_d("[coroutine: %p]: thread: %lu", tb_coroutine_self(), tb_thread_self());
+}
+static tb_void_t tb_demo_coroutine_group_spawn(tb_cpointer_t priv)
+{
+    // start all coroutines to the current worker, the other idle workers will steal them
+    tb_size_t count = (tb_size_t)priv;
+    while (count--)
+    {
+        if (!tb_co_scheduler_group_start(tb_null, tb_demo_coroutine_group_func, tb_null, 0)) break;
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_coroutine_scheduler_group_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init scheduler group, pin one worker per physical core if be "pinned"
+    tb_co_scheduler_group_ref_t group = tb_null;
+    if (argv[1] && !tb_strcmp(argv[1], "pinned")) group = tb_co_scheduler_group_init_pinned();
+    else group = tb_co_scheduler_group_init(argv[1]? tb_atoi(argv[1]) : 0);
+    if (group)
+    {
+        // start the spawner coroutine
+        tb_co_scheduler_group_start(group, tb_demo_coroutine_group_spawn, (tb_cpointer_t)COUNT, 0);
+
+        // init the start time
+        tb_hong_t startime = tb_mclock();
+
+        // run all workers
+        tb_co_scheduler_group_loop(group);
+
+        // trace
+        tb_trace_i("%d coroutines on %lu workers in %lld ms", COUNT, tb_co_scheduler_group_size(group), tb_mclock() - startime);
+
+        // exit scheduler group
+        tb_co_scheduler_group_exit(group);
+    }
+    return 0;
+}
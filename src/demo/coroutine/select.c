@@ -0,0 +1,194 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the producers count
+#define TB_DEMO_PRODUCERS       (2)
+
+// the data count of each producer
+#define TB_DEMO_COUNT           (1000000)
+
+// the batch size
+#define TB_DEMO_BATCH           (64)
+
+// the ticks count
+#define TB_DEMO_TICKS           (3)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the channels
+static tb_co_channel_ref_t  g_channels[TB_DEMO_PRODUCERS];
+
+// the socket pair for ticks
+static tb_socket_ref_t      g_pair[2];
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_void_t tb_demo_coroutine_producer(tb_cpointer_t priv)
+{
+    // check
+    tb_co_channel_ref_t channel = (tb_co_channel_ref_t)priv;
+    tb_assert_and_check_return(channel);
+
+    // send data with batch
+    tb_size_t       i = 0;
+    tb_size_t       sent = 0;
+    tb_cpointer_t   data[TB_DEMO_BATCH];
+    while (sent < TB_DEMO_COUNT)
+    {
+        tb_size_t size = tb_min(TB_DEMO_BATCH, TB_DEMO_COUNT - sent);
+        for (i = 0; i < size; i++) data[i] = (tb_cpointer_t)(sent + i + 1);
+        sent += tb_co_channel_send_n(channel, data, size);
+    }
+}
+static tb_int_t tb_demo_coroutine_producer_thread(tb_cpointer_t priv)
+{
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start producer
+        tb_coroutine_start(scheduler, tb_demo_coroutine_producer, priv, 0);
+
+        // run scheduler, we cannot use the exclusive mode for the multiple threads
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_coroutine_ticker(tb_cpointer_t priv)
+{
+    // send ticks to the consumer
+    tb_size_t count = TB_DEMO_TICKS;
+    while (count--)
+    {
+        tb_coroutine_sleep(10);
+        tb_coroutine_send(g_pair[0], (tb_byte_t const*)"t", 1, -1);
+    }
+}
+static tb_void_t tb_demo_coroutine_consumer(tb_cpointer_t priv)
+{
+    // init cases
+    tb_size_t           i = 0;
+    tb_co_select_case_t cases[TB_DEMO_PRODUCERS + 1];
+    tb_memset(cases, 0, sizeof(cases));
+    for (i = 0; i < TB_DEMO_PRODUCERS; i++)
+    {
+        cases[i].type       = TB_CO_SELECT_CASE_TYPE_RECV;
+        cases[i].channel    = g_channels[i];
+    }
+    cases[i].type   = TB_CO_SELECT_CASE_TYPE_SOCK;
+    cases[i].sock   = g_pair[1];
+    cases[i].events = TB_SOCKET_EVENT_RECV;
+
+    // recv all data from the producers and ticks from the socket
+    tb_size_t       total = 0;
+    tb_size_t       ticks = 0;
+    tb_size_t       timeouts = 0;
+    tb_size_t       sums[TB_DEMO_PRODUCERS] = {0};
+    tb_hong_t       time = tb_mclock();
+    while (total < TB_DEMO_PRODUCERS * TB_DEMO_COUNT || ticks < TB_DEMO_TICKS)
+    {
+        tb_long_t index = tb_co_select(cases, tb_arrayn(cases), 1000);
+        if (index >= 0 && index < TB_DEMO_PRODUCERS)
+        {
+            // save the first data
+            sums[index] += (tb_size_t)cases[index].data;
+            total++;
+
+            // recv the remaining ready data without waiting
+            tb_pointer_t more = tb_null;
+            tb_size_t    count = TB_DEMO_BATCH;
+            while (count-- && tb_co_channel_recv_try(g_channels[index], &more))
+            {
+                sums[index] += (tb_size_t)more;
+                total++;
+            }
+        }
+        else if (index == TB_DEMO_PRODUCERS)
+        {
+            // recv tick
+            tb_byte_t tick = 0;
+            if (tb_socket_recv(g_pair[1], &tick, 1) == 1)
+            {
+                ticks++;
+                tb_trace_i("tick: %lu, received: %lu", ticks, total);
+            }
+        }
+        else if (index == TB_CO_SELECT_TIMEOUT) timeouts++;
+        else break;
+    }
+    time = tb_mclock() - time;
+
+    // check data
+    for (i = 0; i < TB_DEMO_PRODUCERS; i++)
+        tb_assert(sums[i] == ((tb_size_t)TB_DEMO_COUNT * (TB_DEMO_COUNT + 1)) >> 1);
+
+    // trace
+    tb_trace_i("select: %lu data, %lu ticks, %lu timeouts, %lld ms, %lld/s", total, ticks, timeouts, time, time > 0? (1000 * (tb_hong_t)total) / time : 0);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */
+tb_int_t tb_demo_coroutine_select_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init socket pair
+    if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, g_pair)) return -1;
+
+    // init channels
+    tb_size_t i = 0;
+    for (i = 0; i < TB_DEMO_PRODUCERS; i++)
+    {
+        g_channels[i] = tb_co_channel_init(256, tb_null, tb_null);
+        tb_assert_and_check_return_val(g_channels[i], -1);
+    }
+
+    // init scheduler
+    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    if (scheduler)
+    {
+        // start consumer and ticker
+        tb_coroutine_start(scheduler, tb_demo_coroutine_consumer, tb_null, 0);
+        tb_coroutine_start(scheduler, tb_demo_coroutine_ticker, tb_null, 0);
+
+        // start producers in the other threads
+        tb_thread_ref_t threads[TB_DEMO_PRODUCERS];
+        for (i = 0; i < TB_DEMO_PRODUCERS; i++)
+            threads[i] = tb_thread_init(tb_null, tb_demo_coroutine_producer_thread, g_channels[i], 0);
+
+        // run scheduler
+        tb_co_scheduler_loop(scheduler, tb_false);
+
+        // wait producers
+        for (i = 0; i < TB_DEMO_PRODUCERS; i++)
+        {
+            if (threads[i])
+            {
+                tb_thread_wait(threads[i], -1, tb_null);
+                tb_thread_exit(threads[i]);
+            }
+        }
+
+        // exit scheduler
+        tb_co_scheduler_exit(scheduler);
+    }
+
+    // exit channels
+    for (i = 0; i < TB_DEMO_PRODUCERS; i++) tb_co_channel_exit(g_channels[i]);
+
+    // exit socket pair
+    tb_socket_exit(g_pair[0]);
+    tb_socket_exit(g_pair[1]);
+    return 0;
+}
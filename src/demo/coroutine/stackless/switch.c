@@ -70,7 +70,7 @@ static tb_void_t tb_demo_lo_coroutine_switch_perf_func(tb_lo_coroutine_ref_t cor
         }
     }
 }
-static tb_void_t tb_demo_lo_coroutine_switch_perf()
+static tb_void_t tb_demo_lo_coroutine_switch_perf(tb_bool_t profile)
 {
     // init scheduler
     tb_lo_scheduler_ref_t scheduler = tb_lo_scheduler_init();
@@ -81,6 +81,9 @@ static tb_void_t tb_demo_lo_coroutine_switch_perf()
         tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_switch_perf_func, &counts[0], tb_null);
         tb_lo_coroutine_start(scheduler, tb_demo_lo_coroutine_switch_perf_func, &counts[1], tb_null);
 
+        // enable the profiler without samples
+        if (profile) tb_lo_scheduler_profile(scheduler, tb_true, 0);
+
         // init the start time
         tb_hong_t startime = tb_mclock();
 
@@ -91,7 +94,12 @@ static tb_void_t tb_demo_lo_coroutine_switch_perf()
         tb_hong_t duration = tb_mclock() - startime;
 
         // trace
-        tb_trace_i("%d switches in %lld ms, %lld switches per second", COUNT, duration, (((tb_hong_t)1000 * COUNT) / duration));
+        tb_trace_i("%s: %d switches in %lld ms, %lld switches per second", profile? "profile" : "normal", COUNT, duration, (((tb_hong_t)1000 * COUNT) / duration));
+
+        // trace the profiler statistics
+        tb_co_profiler_stats_t stats;
+        if (tb_lo_scheduler_stats(scheduler, &stats))
+            tb_trace_i("profile: switch: %llu, run: %lld us, ready: %lld us, slice_max: %lld us", stats.switch_count, stats.run_time, stats.ready_time, stats.slice_max);
 
         // exit scheduler
         tb_lo_scheduler_exit(scheduler);
@@ -104,6 +112,7 @@ static tb_void_t tb_demo_lo_coroutine_switch_perf()
 tb_int_t tb_demo_lo_coroutine_switch_main(tb_int_t argc, tb_char_t** argv)
 {
     tb_demo_lo_coroutine_switch_test();
-    tb_demo_lo_coroutine_switch_perf();
+    tb_demo_lo_coroutine_switch_perf(tb_false);
+    tb_demo_lo_coroutine_switch_perf(tb_true);
     return 0;
 }
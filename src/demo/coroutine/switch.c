@@ -26,10 +26,10 @@ static tb_void_t tb_demo_coroutine_switch_test_func(tb_cpointer_t priv)
         tb_coroutine_yield();
     }
 }
-static tb_void_t tb_demo_coroutine_switch_test()
+static tb_void_t tb_demo_coroutine_switch_test(tb_bool_t shared)
 {
-    // init scheduler
-    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    // init scheduler, all coroutines will run on one shared stack for the shared-stack mode
+    tb_co_scheduler_ref_t scheduler = shared? tb_co_scheduler_init_shared(1, 0) : tb_co_scheduler_init();
     if (scheduler)
     {
         // start coroutines
@@ -55,10 +55,10 @@ static tb_void_t tb_demo_coroutine_switch_perf_func(tb_cpointer_t priv)
         tb_coroutine_yield();
     }
 }
-static tb_void_t tb_demo_coroutine_switch_perf()
+static tb_void_t tb_demo_coroutine_switch_perf(tb_bool_t shared)
 {
-    // init scheduler
-    tb_co_scheduler_ref_t scheduler = tb_co_scheduler_init();
+    // init scheduler, all coroutines will run on one shared stack for the shared-stack mode
+    tb_co_scheduler_ref_t scheduler = shared? tb_co_scheduler_init_shared(1, 0) : tb_co_scheduler_init();
     if (scheduler)
     {
         // start coroutine
@@ -75,7 +75,7 @@ static tb_void_t tb_demo_coroutine_switch_perf()
         tb_hong_t duration = tb_mclock() - startime;
 
         // trace
-        tb_trace_i("%d switches in %lld ms, %lld switches per second", COUNT, duration, (((tb_hong_t)1000 * COUNT) / duration));
+        tb_trace_i("%s: %d switches in %lld ms, %lld switches per second", shared? "shared" : "private", COUNT, duration, (((tb_hong_t)1000 * COUNT) / duration));
 
         // exit scheduler
         tb_co_scheduler_exit(scheduler);
@@ -87,7 +87,9 @@ static tb_void_t tb_demo_coroutine_switch_perf()
  */ 
 tb_int_t tb_demo_coroutine_switch_main(tb_int_t argc, tb_char_t** argv)
 {
-    tb_demo_coroutine_switch_test();
-    tb_demo_coroutine_switch_perf();
+    tb_demo_coroutine_switch_test(tb_false);
+    tb_demo_coroutine_switch_test(tb_true);
+    tb_demo_coroutine_switch_perf(tb_false);
+    tb_demo_coroutine_switch_perf(tb_true);
     return 0;
 }
@@ -151,6 +151,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(memory_large_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_small_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_default_allocator)
+,   TB_DEMO_MAIN_ITEM(memory_arena_allocator)
 ,   TB_DEMO_MAIN_ITEM(memory_memops)
 ,   TB_DEMO_MAIN_ITEM(memory_buffer)
 ,   TB_DEMO_MAIN_ITEM(memory_queue_buffer)
@@ -182,6 +183,7 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_addrinfo)
 ,   TB_DEMO_MAIN_ITEM(platform_hostname)
 ,   TB_DEMO_MAIN_ITEM(platform_processor)
+,   TB_DEMO_MAIN_ITEM(platform_parallel)
 ,   TB_DEMO_MAIN_ITEM(platform_backtrace)
 ,   TB_DEMO_MAIN_ITEM(platform_directory)
 ,   TB_DEMO_MAIN_ITEM(platform_cache_time)
@@ -194,6 +196,9 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(platform_thread)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_pool)
 ,   TB_DEMO_MAIN_ITEM(platform_thread_local)
+,   TB_DEMO_MAIN_ITEM(platform_mpmc_queue)
+,   TB_DEMO_MAIN_ITEM(platform_mpsc_queue)
+,   TB_DEMO_MAIN_ITEM(platform_lockfree_stack)
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
 ,   TB_DEMO_MAIN_ITEM(platform_context)
 #endif
@@ -232,6 +237,11 @@ static tb_demo_t g_demo[] =
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_server)
 ,   TB_DEMO_MAIN_ITEM(coroutine_file_client)
 ,   TB_DEMO_MAIN_ITEM(coroutine_http_server)
+,   TB_DEMO_MAIN_ITEM(coroutine_scheduler_group)
+,   TB_DEMO_MAIN_ITEM(coroutine_io)
+,   TB_DEMO_MAIN_ITEM(coroutine_offload)
+,   TB_DEMO_MAIN_ITEM(coroutine_select)
+,   TB_DEMO_MAIN_ITEM(coroutine_profiler)
 #   ifdef TB_CONFIG_MODULE_HAVE_XML
 ,   TB_DEMO_MAIN_ITEM(coroutine_spider)
 #   endif
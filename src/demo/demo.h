@@ -140,6 +140,7 @@ TB_DEMO_MAIN_DECL(memory_string_pool);
 TB_DEMO_MAIN_DECL(memory_large_allocator);
 TB_DEMO_MAIN_DECL(memory_small_allocator);
 TB_DEMO_MAIN_DECL(memory_default_allocator);
+TB_DEMO_MAIN_DECL(memory_arena_allocator);
 TB_DEMO_MAIN_DECL(memory_memops);
 TB_DEMO_MAIN_DECL(memory_buffer);
 TB_DEMO_MAIN_DECL(memory_queue_buffer);
@@ -175,6 +176,7 @@ TB_DEMO_MAIN_DECL(platform_ifaddrs);
 TB_DEMO_MAIN_DECL(platform_addrinfo);
 TB_DEMO_MAIN_DECL(platform_hostname);
 TB_DEMO_MAIN_DECL(platform_processor);
+TB_DEMO_MAIN_DECL(platform_parallel);
 TB_DEMO_MAIN_DECL(platform_backtrace);
 TB_DEMO_MAIN_DECL(platform_directory);
 TB_DEMO_MAIN_DECL(platform_exception);
@@ -184,6 +186,9 @@ TB_DEMO_MAIN_DECL(platform_environment);
 TB_DEMO_MAIN_DECL(platform_thread);
 TB_DEMO_MAIN_DECL(platform_thread_pool);
 TB_DEMO_MAIN_DECL(platform_thread_local);
+TB_DEMO_MAIN_DECL(platform_mpmc_queue);
+TB_DEMO_MAIN_DECL(platform_mpsc_queue);
+TB_DEMO_MAIN_DECL(platform_lockfree_stack);
 TB_DEMO_MAIN_DECL(platform_context);
 
 // container
@@ -217,6 +222,11 @@ TB_DEMO_MAIN_DECL(coroutine_echo_server);
 TB_DEMO_MAIN_DECL(coroutine_file_client);
 TB_DEMO_MAIN_DECL(coroutine_file_server);
 TB_DEMO_MAIN_DECL(coroutine_http_server);
+TB_DEMO_MAIN_DECL(coroutine_scheduler_group);
+TB_DEMO_MAIN_DECL(coroutine_io);
+TB_DEMO_MAIN_DECL(coroutine_offload);
+TB_DEMO_MAIN_DECL(coroutine_select);
+TB_DEMO_MAIN_DECL(coroutine_profiler);
 
 // stackless coroutine
 TB_DEMO_MAIN_DECL(lo_coroutine_nest);
@@ -0,0 +1,157 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * demo
+ */ 
+tb_void_t tb_demo_arena_allocator_string(tb_noarg_t);
+tb_void_t tb_demo_arena_allocator_string()
+{
+    // done
+    tb_allocator_ref_t arena_allocator = tb_null;
+    do
+    {
+        // init arena allocator
+        arena_allocator = tb_arena_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(arena_allocator);
+
+        // init string
+        tb_string_t string;
+        tb_string_init_with_allocator(&string, arena_allocator);
+
+        // make string
+        tb_size_t i = 0;
+        for (i = 0; i < 1000; i++) tb_string_cstrfcat(&string, "%lu,", i);
+
+        // trace
+        tb_trace_i("string: %lu bytes: %.32s ...", tb_string_size(&string), tb_string_cstr(&string));
+
+        // exit string
+        tb_string_exit(&string);
+
+#ifdef __tb_debug__
+        // dump arena allocator
+        tb_allocator_dump(arena_allocator);
+#endif
+
+    } while (0);
+
+    // exit arena allocator
+    if (arena_allocator) tb_allocator_exit(arena_allocator);
+    arena_allocator = tb_null;
+}
+#ifdef TB_CONFIG_MODULE_HAVE_OBJECT
+tb_void_t tb_demo_arena_allocator_object(tb_noarg_t);
+tb_void_t tb_demo_arena_allocator_object()
+{
+    // the json data
+    tb_char_t const* json = "{\"name\": \"tbox\", \"list\": [1, 2, 3, \"four\", true, null], \"info\": {\"size\": 1.5}}";
+
+    // done
+    tb_allocator_ref_t arena_allocator = tb_null;
+    do
+    {
+        // init arena allocator
+        arena_allocator = tb_arena_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(arena_allocator);
+
+        // read object from the arena allocator
+        tb_object_ref_t object = tb_object_read_from_data_with_allocator((tb_byte_t const*)json, tb_strlen(json), arena_allocator);
+        tb_assert_and_check_break(object);
+
+        // dump object
+        tb_object_dump(object, TB_OBJECT_FORMAT_JSON);
+
+#ifdef __tb_debug__
+        // dump arena allocator
+        tb_allocator_dump(arena_allocator);
+#endif
+
+        // exit object, all objects will be freed to the arena allocator
+        tb_object_exit(object);
+
+        // clear arena allocator for the next request
+        tb_allocator_clear(arena_allocator);
+
+    } while (0);
+
+    // exit arena allocator
+    if (arena_allocator) tb_allocator_exit(arena_allocator);
+    arena_allocator = tb_null;
+}
+#endif
+tb_void_t tb_demo_arena_allocator_perf(tb_allocator_ref_t allocator, tb_bool_t arena);
+tb_void_t tb_demo_arena_allocator_perf(tb_allocator_ref_t allocator, tb_bool_t arena)
+{
+    // the data list
+    tb_size_t       maxn = 1000;
+    tb_pointer_t    list[1000];
+
+    // done 
+    tb_size_t       round = 0;
+    tb_size_t       indx = 0;
+    tb_size_t       rand = 0xbeaf;
+    tb_hong_t       time = tb_mclock();
+    for (round = 0; round < 1000; round++)
+    {
+        // make data for this request
+        for (indx = 0; indx < maxn; indx++)
+        {
+            // make rand
+            rand = (rand * 10807 + 1) & 0xffffffff;
+
+            // make data
+            list[indx] = tb_allocator_malloc(allocator, (rand & 255) + 1);
+            tb_assert_and_check_break(list[indx]);
+        }
+
+        // release all data at the end of this request
+        if (arena) tb_allocator_clear(allocator);
+        else
+        {
+            for (indx = 0; indx < maxn; indx++) 
+                tb_allocator_free(allocator, list[indx]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("%s: time: %lld ms", arena? "arena" : "default", time);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_memory_arena_allocator_main(tb_int_t argc, tb_char_t** argv)
+{
+#if 1
+    tb_demo_arena_allocator_string();
+#endif
+
+#if defined(TB_CONFIG_MODULE_HAVE_OBJECT) && 1
+    tb_demo_arena_allocator_object();
+#endif
+
+#if 1
+    // init arena allocator
+    tb_allocator_ref_t arena_allocator = tb_arena_allocator_init(tb_null, 0);
+    if (arena_allocator)
+    {
+        // done
+        tb_demo_arena_allocator_perf(arena_allocator, tb_true);
+        tb_demo_arena_allocator_perf(tb_allocator(), tb_false);
+
+#ifdef __tb_debug__
+        // dump arena allocator
+        tb_allocator_dump(arena_allocator);
+#endif
+
+        // exit arena allocator
+        tb_allocator_exit(arena_allocator);
+    }
+#endif
+
+    return 0;
+}
@@ -187,6 +187,58 @@ tb_void_t tb_demo_fixed_pool_perf(tb_size_t item_size)
     // exit pool
     if (pool) tb_fixed_pool_exit(pool);
 }
+tb_void_t tb_demo_fixed_pool_free_perf(tb_size_t item_size, tb_size_t maxn);
+tb_void_t tb_demo_fixed_pool_free_perf(tb_size_t item_size, tb_size_t maxn)
+{
+    // done
+    tb_fixed_pool_ref_t pool = tb_null;
+    tb_pointer_t*       list = tb_null;
+    do
+    {
+        // init pool
+        pool = tb_fixed_pool_init(tb_null, 0, item_size, tb_null, tb_null, tb_null);
+        tb_assert_and_check_break(pool);
+
+        // make data list
+        list = (tb_pointer_t*)calloc(maxn, sizeof(tb_pointer_t));
+        tb_assert_and_check_break(list);
+
+        // make data, there will be many slots
+        tb_size_t indx = 0;
+        for (indx = 0; indx < maxn; indx++)
+        {
+            list[indx] = tb_fixed_pool_malloc(pool);
+            tb_assert_and_check_break(list[indx]);
+        }
+        tb_check_break(indx == maxn);
+
+        // shuffle the data list
+        tb_size_t rand = 0xbeaf;
+        for (indx = maxn - 1; indx > 0; indx--)
+        {
+            rand = (rand * 10807 + 1) & 0xffffffff;
+            tb_size_t       swap_indx = rand % (indx + 1);
+            tb_pointer_t    swap_data = list[indx];
+            list[indx] = list[swap_indx];
+            list[swap_indx] = swap_data;
+        }
+
+        // free all data in the random order
+        tb_hong_t time = tb_mclock();
+        for (indx = 0; indx < maxn; indx++) tb_fixed_pool_free(pool, list[indx]);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("free: item: %lu, count: %lu, time: %lld ms", item_size, maxn, time);
+
+    } while (0);
+
+    // exit list
+    if (list) free(list);
+
+    // exit pool
+    if (pool) tb_fixed_pool_exit(pool);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -208,6 +260,12 @@ tb_int_t tb_demo_memory_fixed_pool_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_fixed_pool_perf(3072);
 #endif
 
+#if 1
+    tb_demo_fixed_pool_free_perf(16, 1000000);
+    tb_demo_fixed_pool_free_perf(256, 200000);
+    tb_demo_fixed_pool_free_perf(3072, 20000);
+#endif
+
 #if 0
     tb_demo_fixed_pool_leak();
 #endif
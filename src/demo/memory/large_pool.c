@@ -226,6 +226,97 @@ tb_void_t tb_demo_large_allocator_perf()
     // exit pool
     if (pool) tb_allocator_exit(pool);
 }
+tb_void_t tb_demo_large_allocator_trim(tb_noarg_t);
+tb_void_t tb_demo_large_allocator_trim()
+{
+    // done
+    tb_allocator_ref_t pool = tb_null;
+    do
+    {
+        // init pool
+        pool = tb_demo_init_pool();
+        tb_assert_and_check_break(pool);
+
+        // make the spike data list
+        tb_size_t       maxn = 1024;
+        tb_pointer_t*   list = (tb_pointer_t*)tb_allocator_large_nalloc0(pool, maxn, sizeof(tb_pointer_t), tb_null);
+        tb_assert_and_check_break(list);
+
+        // make 64MB data and touch all pages
+        tb_size_t indx = 0;
+        for (indx = 0; indx < maxn; indx++)
+        {
+            list[indx] = tb_allocator_large_malloc(pool, 64 * 1024, tb_null);
+            tb_assert_and_check_break(list[indx]);
+            tb_memset(list[indx], indx & 0xff, 64 * 1024);
+        }
+
+        // free all data, but the pages are still used by this process
+        for (indx = 0; indx < maxn; indx++)
+        {
+            if (list[indx]) tb_allocator_large_free(pool, list[indx]);
+            list[indx] = tb_null;
+        }
+
+        // trim it and keep 1MB free memory
+        tb_hong_t   time = tb_mclock();
+        tb_bool_t   ok = tb_allocator_trim(pool, 1024 * 1024);
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("trim: %s, time: %lld ms", ok? "ok" : "no", time);
+
+        // the trimmed memory can be used again
+        tb_pointer_t data = tb_allocator_large_malloc0(pool, 1024 * 1024, tb_null);
+        tb_assert_and_check_break(data);
+        tb_allocator_large_free(pool, data);
+
+        // exit list
+        tb_allocator_large_free(pool, list);
+
+    } while (0);
+
+    // exit pool
+    if (pool) tb_allocator_exit(pool);
+}
+tb_void_t tb_demo_large_allocator_huge(tb_bool_t huge);
+tb_void_t tb_demo_large_allocator_huge(tb_bool_t huge)
+{
+    // done
+    tb_allocator_ref_t pool = tb_null;
+    do
+    {
+        // init pool
+        pool = huge? tb_large_allocator_init_with_huge_pages(256 * 1024 * 1024) : tb_large_allocator_init(tb_null, 0);
+        tb_assert_and_check_break(pool);
+
+        // make the large data
+        tb_size_t   size = 128 * 1024 * 1024;
+        tb_byte_t*  data = (tb_byte_t*)tb_allocator_large_malloc0(pool, size, tb_null);
+        tb_assert_and_check_break(data);
+
+        // access it randomly
+        tb_size_t               indx = 0;
+        tb_size_t               rand = 0;
+        __tb_volatile__ tb_hong_t time = tb_mclock();
+        for (indx = 0; indx < 20000000; indx++)
+        {
+            rand = rand * 1103515245 + 12345;
+            data[rand & (size - 1)]++;
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("%s: huge_page: %lu, time: %lld ms", huge? "huge" : "native", tb_page_huge_size(), time);
+
+        // exit data
+        tb_allocator_large_free(pool, data);
+
+    } while (0);
+
+    // exit pool
+    if (pool) tb_allocator_exit(pool);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -236,6 +327,15 @@ tb_int_t tb_demo_memory_large_allocator_main(tb_int_t argc, tb_char_t** argv)
     tb_demo_large_allocator_perf();
 #endif
 
+#if 1
+    tb_demo_large_allocator_trim();
+#endif
+
+#if 1
+    tb_demo_large_allocator_huge(tb_false);
+    tb_demo_large_allocator_huge(tb_true);
+#endif
+
 #if 0
     tb_demo_large_allocator_leak();
 #endif
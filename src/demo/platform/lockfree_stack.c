@@ -0,0 +1,176 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the thread maxn
+#define TB_TEST_THREAD_MAXN     (16)
+
+// the item count, it is shared by all threads like a free list
+#define TB_TEST_ITEM_COUNT      (64)
+
+// the loop count of each thread
+#define TB_TEST_LOOP_COUNT      (200000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the test item type
+typedef struct __tb_demo_item_t
+{
+    // the stack entry
+    tb_single_list_entry_t  entry;
+
+    // the owner thread, it must be 0 if the item is in the stack
+    tb_atomic_t             owner;
+
+}tb_demo_item_t;
+
+// the test type
+typedef struct __tb_demo_test_t
+{
+    // the lock-free stack
+    tb_lockfree_stack_t     stack;
+
+    // use the mutex and stack for the baseline?
+    tb_bool_t               use_baseline;
+
+    // the mutex and stack for the baseline
+    tb_mutex_ref_t          mutex;
+    tb_stack_ref_t          baseline;
+
+    // the conflicts count, the item has been owned by the other thread after popping it
+    tb_atomic_t             conflicts;
+
+}tb_demo_test_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_demo_item_t* tb_demo_test_pop(tb_demo_test_t* test)
+{
+    // pop it from the lock-free stack
+    tb_demo_item_t* item = tb_null;
+    if (!test->use_baseline)
+    {
+        tb_single_list_entry_ref_t entry = tb_lockfree_stack_pop(&test->stack);
+        if (entry) item = tb_container_of(tb_demo_item_t, entry, entry);
+        return item;
+    }
+
+    // pop it from the baseline stack
+    tb_mutex_enter(test->mutex);
+    if (tb_stack_size(test->baseline))
+    {
+        item = (tb_demo_item_t*)tb_stack_top(test->baseline);
+        tb_stack_pop(test->baseline);
+    }
+    tb_mutex_leave(test->mutex);
+    return item;
+}
+static tb_void_t tb_demo_test_push(tb_demo_test_t* test, tb_demo_item_t* item)
+{
+    // push it to the lock-free stack
+    if (!test->use_baseline)
+    {
+        tb_lockfree_stack_push(&test->stack, &item->entry);
+        return ;
+    }
+
+    // push it to the baseline stack
+    tb_mutex_enter(test->mutex);
+    tb_stack_put(test->baseline, item);
+    tb_mutex_leave(test->mutex);
+}
+static tb_int_t tb_demo_test_loop(tb_cpointer_t priv)
+{
+    // pop and push items, the aba problem will give the same item to two threads
+    tb_demo_test_t* test = (tb_demo_test_t*)priv;
+    tb_long_t       self = (tb_long_t)tb_thread_self();
+    tb_size_t       i = 0;
+    for (i = 0; i < TB_TEST_LOOP_COUNT; i++)
+    {
+        // pop an item
+        tb_demo_item_t* item = tb_demo_test_pop(test);
+        if (!item) 
+        {
+            tb_sched_yield();
+            continue;
+        }
+
+        // own it
+        if (tb_atomic_fetch_and_pset(&item->owner, 0, self)) tb_atomic_fetch_and_inc(&test->conflicts);
+
+        // release it
+        tb_atomic_set0(&item->owner);
+        tb_demo_test_push(test, item);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_test_done(tb_char_t const* name, tb_demo_test_t* test, tb_demo_item_t* items, tb_size_t count)
+{
+    // push items
+    tb_size_t i = 0;
+    for (i = 0; i < TB_TEST_ITEM_COUNT; i++) tb_demo_test_push(test, &items[i]);
+
+    // start threads
+    tb_hong_t       time = tb_mclock();
+    tb_thread_ref_t threads[TB_TEST_THREAD_MAXN] = {0};
+    for (i = 0; i < count; i++)
+        threads[i] = tb_thread_init(tb_null, tb_demo_test_loop, test, 0);
+
+    // wait threads
+    for (i = 0; i < count; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // pop all items
+    tb_size_t left = 0;
+    while (tb_demo_test_pop(test)) left++;
+    tb_assert(left == TB_TEST_ITEM_COUNT && !test->conflicts);
+
+    // trace
+    tb_trace_i("%s: %lu threads, %lu loops, %lld ms, items: %lu, conflicts: %ld", name, count, count * TB_TEST_LOOP_COUNT, time, left, test->conflicts);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_platform_lockfree_stack_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the threads count
+    tb_size_t count = argv[1]? tb_atoi(argv[1]) : 4;
+    tb_assert_and_check_return_val(count && count <= TB_TEST_THREAD_MAXN, 0);
+
+    // the items
+    tb_demo_item_t items[TB_TEST_ITEM_COUNT];
+    tb_memset(items, 0, sizeof(items));
+
+    // test the mutex and stack
+    tb_demo_test_t test = {0};
+    test.use_baseline   = tb_true;
+    test.mutex          = tb_mutex_init();
+    test.baseline       = tb_stack_init(TB_TEST_ITEM_COUNT, tb_element_ptr(tb_null, tb_null));
+    if (test.mutex && test.baseline) tb_demo_test_done("mutex + stack", &test, items, count);
+    if (test.baseline) tb_stack_exit(test.baseline);
+    if (test.mutex) tb_mutex_exit(test.mutex);
+
+    // test the lock-free stack
+    test.use_baseline   = tb_false;
+    test.conflicts      = 0;
+    tb_lockfree_stack_init(&test.stack);
+    tb_demo_test_done("lockfree_stack", &test, items, count);
+    tb_lockfree_stack_exit(&test.stack);
+    return 0;
+}
@@ -0,0 +1,178 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the thread maxn
+#define TB_TEST_THREAD_MAXN     (16)
+
+// the item count of each producer
+#define TB_TEST_ITEM_COUNT      (100000)
+
+// the queue maxn
+#define TB_TEST_QUEUE_MAXN      (1024)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the test type
+typedef struct __tb_demo_test_t
+{
+    // the lock-free queue
+    tb_mpmc_queue_ref_t     queue;
+
+    // the mutex and queue for the baseline
+    tb_mutex_ref_t          mutex;
+    tb_queue_ref_t          baseline;
+
+    // the total item count
+    tb_size_t               total;
+
+    // the popped item count
+    tb_atomic_t             popped;
+
+    // the sum of the popped items
+    tb_atomic_t             sum;
+
+}tb_demo_test_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_bool_t tb_demo_test_put(tb_demo_test_t* test, tb_size_t data)
+{
+    // put it to the lock-free queue
+    if (test->queue) return tb_mpmc_queue_put(test->queue, (tb_cpointer_t)data);
+
+    // put it to the baseline queue
+    tb_bool_t ok = tb_false;
+    tb_mutex_enter(test->mutex);
+    if (tb_queue_size(test->baseline) < TB_TEST_QUEUE_MAXN)
+    {
+        tb_queue_put(test->baseline, (tb_cpointer_t)data);
+        ok = tb_true;
+    }
+    tb_mutex_leave(test->mutex);
+    return ok;
+}
+static tb_bool_t tb_demo_test_pop(tb_demo_test_t* test, tb_size_t* pdata)
+{
+    // pop it from the lock-free queue
+    if (test->queue) return tb_mpmc_queue_pop(test->queue, (tb_pointer_t*)pdata);
+
+    // pop it from the baseline queue
+    tb_bool_t ok = tb_false;
+    tb_mutex_enter(test->mutex);
+    if (tb_queue_size(test->baseline))
+    {
+        *pdata = (tb_size_t)tb_queue_get(test->baseline);
+        tb_queue_pop(test->baseline);
+        ok = tb_true;
+    }
+    tb_mutex_leave(test->mutex);
+    return ok;
+}
+static tb_int_t tb_demo_test_producer(tb_cpointer_t priv)
+{
+    // put items
+    tb_demo_test_t* test = (tb_demo_test_t*)priv;
+    tb_size_t       i = 0;
+    for (i = 1; i <= TB_TEST_ITEM_COUNT; i++)
+    {
+        // full? wait the consumers
+        while (!tb_demo_test_put(test, i)) tb_sched_yield();
+    }
+    return 0;
+}
+static tb_int_t tb_demo_test_consumer(tb_cpointer_t priv)
+{
+    // pop items
+    tb_demo_test_t* test = (tb_demo_test_t*)priv;
+    tb_size_t       data = 0;
+    while ((tb_size_t)tb_atomic_get(&test->popped) < test->total)
+    {
+        // pop it
+        if (tb_demo_test_pop(test, &data))
+        {
+            tb_atomic_fetch_and_add(&test->sum, (tb_long_t)data);
+            tb_atomic_fetch_and_inc(&test->popped);
+        }
+        // empty? wait the producers
+        else tb_sched_yield();
+    }
+    return 0;
+}
+static tb_void_t tb_demo_test_done(tb_char_t const* name, tb_demo_test_t* test, tb_size_t count)
+{
+    // init test
+    test->total     = count * TB_TEST_ITEM_COUNT;
+    test->popped    = 0;
+    test->sum       = 0;
+
+    // start producers and consumers
+    tb_size_t       i = 0;
+    tb_hong_t       time = tb_mclock();
+    tb_thread_ref_t producers[TB_TEST_THREAD_MAXN] = {0};
+    tb_thread_ref_t consumers[TB_TEST_THREAD_MAXN] = {0};
+    for (i = 0; i < count; i++)
+    {
+        producers[i] = tb_thread_init(tb_null, tb_demo_test_producer, test, 0);
+        consumers[i] = tb_thread_init(tb_null, tb_demo_test_consumer, test, 0);
+    }
+
+    // wait them
+    for (i = 0; i < count; i++)
+    {
+        if (producers[i])
+        {
+            tb_thread_wait(producers[i], -1, tb_null);
+            tb_thread_exit(producers[i]);
+        }
+        if (consumers[i])
+        {
+            tb_thread_wait(consumers[i], -1, tb_null);
+            tb_thread_exit(consumers[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // check the sum
+    tb_size_t sum = count * (((tb_size_t)TB_TEST_ITEM_COUNT * (TB_TEST_ITEM_COUNT + 1)) >> 1);
+    tb_assert((tb_size_t)test->sum == sum);
+
+    // trace
+    tb_trace_i("%s: %lu producers and consumers, %lu items, %lld ms, sum: %s", name, count, test->total, time, (tb_size_t)test->sum == sum? "ok" : "failed");
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_platform_mpmc_queue_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the producers and consumers count
+    tb_size_t count = argv[1]? tb_atoi(argv[1]) : 4;
+    tb_assert_and_check_return_val(count && count <= TB_TEST_THREAD_MAXN, 0);
+
+    // test the mutex and queue
+    tb_demo_test_t test = {0};
+    test.mutex      = tb_mutex_init();
+    test.baseline   = tb_queue_init(TB_TEST_QUEUE_MAXN, tb_element_size());
+    if (test.mutex && test.baseline) tb_demo_test_done("mutex + queue", &test, count);
+    if (test.baseline) tb_queue_exit(test.baseline);
+    if (test.mutex) tb_mutex_exit(test.mutex);
+
+    // test the lock-free queue
+    tb_memset(&test, 0, sizeof(tb_demo_test_t));
+    test.queue = tb_mpmc_queue_init(TB_TEST_QUEUE_MAXN);
+    if (test.queue) 
+    {
+        tb_demo_test_done("mpmc_queue", &test, count);
+        tb_mpmc_queue_exit(test.queue);
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the producer maxn
+#define TB_TEST_PRODUCER_MAXN   (16)
+
+// the item count of each producer
+#define TB_TEST_ITEM_COUNT      (100000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the test item type
+typedef struct __tb_demo_item_t
+{
+    // the queue entry
+    tb_single_list_entry_t  entry;
+
+    // the data
+    tb_size_t               data;
+
+}tb_demo_item_t;
+
+// the test type
+typedef struct __tb_demo_test_t
+{
+    // the lock-free queue
+    tb_mpsc_queue_t         queue;
+
+    // use the mutex and queue for the baseline?
+    tb_bool_t               use_baseline;
+
+    // the mutex and queue for the baseline
+    tb_mutex_ref_t          mutex;
+    tb_queue_ref_t          baseline;
+
+    // the items
+    tb_demo_item_t*         items;
+
+}tb_demo_test_t;
+
+// the producer type
+typedef struct __tb_demo_producer_t
+{
+    // the test
+    tb_demo_test_t*         test;
+
+    // the items of this producer
+    tb_demo_item_t*         items;
+
+}tb_demo_producer_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+static tb_int_t tb_demo_test_producer(tb_cpointer_t priv)
+{
+    // put items
+    tb_demo_producer_t* producer = (tb_demo_producer_t*)priv;
+    tb_demo_test_t*     test = producer->test;
+    tb_size_t           i = 0;
+    for (i = 0; i < TB_TEST_ITEM_COUNT; i++)
+    {
+        // init item
+        tb_demo_item_t* item = &producer->items[i];
+        item->data = i + 1;
+
+        // put it
+        if (test->use_baseline)
+        {
+            tb_mutex_enter(test->mutex);
+            tb_queue_put(test->baseline, item);
+            tb_mutex_leave(test->mutex);
+        }
+        else tb_mpsc_queue_put(&test->queue, &item->entry);
+    }
+    return 0;
+}
+static tb_void_t tb_demo_test_done(tb_char_t const* name, tb_demo_test_t* test, tb_size_t count)
+{
+    // start producers
+    tb_size_t           i = 0;
+    tb_hong_t           time = tb_mclock();
+    tb_thread_ref_t     threads[TB_TEST_PRODUCER_MAXN] = {0};
+    tb_demo_producer_t  producers[TB_TEST_PRODUCER_MAXN];
+    for (i = 0; i < count; i++)
+    {
+        producers[i].test   = test;
+        producers[i].items  = test->items + i * TB_TEST_ITEM_COUNT;
+        threads[i] = tb_thread_init(tb_null, tb_demo_test_producer, &producers[i], 0);
+    }
+
+    // pop items on the current thread
+    tb_size_t total = count * TB_TEST_ITEM_COUNT;
+    tb_size_t popped = 0;
+    tb_size_t sum = 0;
+    while (popped < total)
+    {
+        // pop it
+        tb_demo_item_t* item = tb_null;
+        if (test->use_baseline)
+        {
+            tb_mutex_enter(test->mutex);
+            if (tb_queue_size(test->baseline))
+            {
+                item = (tb_demo_item_t*)tb_queue_get(test->baseline);
+                tb_queue_pop(test->baseline);
+            }
+            tb_mutex_leave(test->mutex);
+        }
+        else
+        {
+            tb_single_list_entry_ref_t entry = tb_mpsc_queue_pop(&test->queue);
+            if (entry) item = tb_container_of(tb_demo_item_t, entry, entry);
+        }
+
+        // empty? wait the producers
+        if (!item) 
+        {
+            tb_sched_yield();
+            continue;
+        }
+
+        // done it
+        sum += item->data;
+        popped++;
+    }
+
+    // wait producers
+    for (i = 0; i < count; i++)
+    {
+        if (threads[i])
+        {
+            tb_thread_wait(threads[i], -1, tb_null);
+            tb_thread_exit(threads[i]);
+        }
+    }
+    time = tb_mclock() - time;
+
+    // check the sum
+    tb_bool_t ok = sum == count * (((tb_size_t)TB_TEST_ITEM_COUNT * (TB_TEST_ITEM_COUNT + 1)) >> 1);
+    tb_assert(ok);
+
+    // trace
+    tb_trace_i("%s: %lu producers, %lu items, %lld ms, sum: %s", name, count, total, time, ok? "ok" : "failed");
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_platform_mpsc_queue_main(tb_int_t argc, tb_char_t** argv)
+{
+    // the producers count
+    tb_size_t count = argv[1]? tb_atoi(argv[1]) : 4;
+    tb_assert_and_check_return_val(count && count <= TB_TEST_PRODUCER_MAXN, 0);
+
+    // init items
+    tb_demo_test_t test = {0};
+    test.items = tb_nalloc_type(count * TB_TEST_ITEM_COUNT, tb_demo_item_t);
+    tb_assert_and_check_return_val(test.items, 0);
+
+    // test the mutex and queue
+    test.use_baseline   = tb_true;
+    test.mutex          = tb_mutex_init();
+    test.baseline       = tb_queue_init(0, tb_element_ptr(tb_null, tb_null));
+    if (test.mutex && test.baseline) tb_demo_test_done("mutex + queue", &test, count);
+    if (test.baseline) tb_queue_exit(test.baseline);
+    if (test.mutex) tb_mutex_exit(test.mutex);
+
+    // test the lock-free queue
+    test.use_baseline   = tb_false;
+    tb_mpsc_queue_init(&test.queue);
+    tb_demo_test_done("mpsc_queue", &test, count);
+    tb_mpsc_queue_exit(&test.queue);
+
+    // exit items
+    tb_free(test.items);
+    return 0;
+}
@@ -0,0 +1,85 @@
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "../demo.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */ 
+
+// the data count
+#define TB_DEMO_DATA_COUNT      (1 << 20)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * test
+ */ 
+static tb_void_t tb_demo_parallel_for(tb_size_t begin, tb_size_t end, tb_cpointer_t priv)
+{
+    // double them
+    tb_size_t* data = (tb_size_t*)priv;
+    for (; begin < end; begin++) data[begin] = begin << 1;
+}
+static tb_void_t tb_demo_parallel_sum(tb_size_t begin, tb_size_t end, tb_pointer_t value, tb_cpointer_t priv)
+{
+    // sum this chunk
+    tb_size_t const* data = (tb_size_t const*)priv;
+    for (; begin < end; begin++) *((tb_hize_t*)value) += data[begin];
+}
+static tb_void_t tb_demo_parallel_join(tb_pointer_t value, tb_cpointer_t other, tb_cpointer_t priv)
+{
+    // join the partial sum
+    *((tb_hize_t*)value) += *((tb_hize_t const*)other);
+}
+static tb_void_t tb_demo_parallel_nested(tb_size_t begin, tb_size_t end, tb_cpointer_t priv)
+{
+    // sum the sub-range in the worker
+    tb_hize_t sum = 0;
+    tb_parallel_reduce(tb_null, begin * 1024, end * 1024, 256, &sum, sizeof(sum), tb_demo_parallel_sum, tb_demo_parallel_join, priv);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * main
+ */ 
+tb_int_t tb_demo_platform_parallel_main(tb_int_t argc, tb_char_t** argv)
+{
+    // init data
+    tb_size_t* data = tb_nalloc0_type(TB_DEMO_DATA_COUNT, tb_size_t);
+    tb_assert_and_check_return_val(data, -1);
+
+    // the grain
+    tb_size_t grain = argv[1]? tb_atoi(argv[1]) : 1024;
+
+    // parallel for
+    tb_hong_t time = tb_mclock();
+    tb_parallel_for(tb_null, 0, TB_DEMO_DATA_COUNT, grain, tb_demo_parallel_for, data);
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("for: %lu items, grain: %lu, time: %lld ms", (tb_size_t)TB_DEMO_DATA_COUNT, grain, time);
+
+    // parallel reduce
+    tb_hize_t sum = 0;
+    time = tb_mclock();
+    tb_parallel_reduce(tb_null, 0, TB_DEMO_DATA_COUNT, grain, &sum, sizeof(sum), tb_demo_parallel_sum, tb_demo_parallel_join, data);
+    time = tb_mclock() - time;
+
+    // check it
+    tb_hize_t count = TB_DEMO_DATA_COUNT;
+    tb_hize_t expected = count * (count - 1);
+    tb_assert(sum == expected);
+
+    // trace
+    tb_trace_i("reduce: sum: %llu, expected: %llu, time: %lld ms", sum, expected, time);
+
+    // nested parallel reduce in the workers
+    time = tb_mclock();
+    tb_parallel_for(tb_null, 0, TB_DEMO_DATA_COUNT / 1024, 1, tb_demo_parallel_nested, data);
+    time = tb_mclock() - time;
+
+    // trace
+    tb_trace_i("nested: time: %lld ms", time);
+
+    // exit data
+    tb_free(data);
+    return 0;
+}
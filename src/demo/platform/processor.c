@@ -10,5 +10,25 @@ tb_int_t tb_demo_platform_processor_main(tb_int_t argc, tb_char_t** argv)
 {
     // trace
     tb_trace_i("cpu: %lu", tb_processor_count());
+
+    // the topology
+    tb_processor_topology_t const* topology = tb_processor_topology();
+    if (topology)
+    {
+        // trace
+        tb_trace_i("cpus: %lu, cores: %lu, packages: %lu, nodes: %lu", topology->cpus_count, topology->cores_count, topology->packages_count, topology->nodes_count);
+        tb_trace_i("cache: line: %lu, l1d: %lu, l2: %lu, l3: %lu", topology->cache_line, topology->cache_l1d, topology->cache_l2, topology->cache_l3);
+
+        // trace the physical cores
+        tb_size_t i = 0;
+        for (i = 0; i < topology->cores_count; i++)
+        {
+            tb_processor_core_t const* core = &topology->cores[i];
+            tb_trace_i("core[%lu]: node: %u, package: %u, threads: %u", i, core->node, core->package, core->threads);
+        }
+
+        // pin the current thread to the first core
+        if (topology->cores_count) tb_trace_i("pin to core[0]: %s", tb_thread_affinity_set(tb_null, (tb_cpuset_ref_t)&topology->cores[0].cpus)? "ok" : "failed");
+    }
     return 0;
 }
@@ -19,6 +19,14 @@ static tb_void_t tb_demo_task_time_exit(tb_thread_pool_worker_ref_t worker, tb_c
     // trace
     tb_trace_i("exit: %u ms", tb_p2u32(priv));
 }
+static tb_void_t tb_demo_task_stage_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // trace
+    tb_trace_i("stage: %s", (tb_char_t const*)priv);
+    
+    // wait some time
+    tb_msleep(10);
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * main
@@ -69,6 +77,30 @@ tb_int_t tb_demo_platform_thread_pool_main(tb_int_t argc, tb_char_t** argv)
     // wait all
     tb_thread_pool_task_wait_all(tb_thread_pool(), -1);
 
+    // init group
+    tb_thread_pool_group_ref_t group = tb_thread_pool_group_init(tb_thread_pool());
+    if (group)
+    {
+        // post pipeline: decode -> (transform, compress) -> write
+        tb_thread_pool_task_ref_t deps[2];
+        tb_thread_pool_task_ref_t decode = tb_thread_pool_group_task_init(group, "decode", tb_demo_task_stage_done, tb_null, "decode", tb_false, tb_null, 0);
+        deps[0] = tb_thread_pool_group_task_init(group, "transform", tb_demo_task_stage_done, tb_null, "transform", tb_false, &decode, 1);
+        deps[1] = tb_thread_pool_group_task_init(group, "compress", tb_demo_task_stage_done, tb_null, "compress", tb_false, &decode, 1);
+        if (decode && deps[0] && deps[1])
+            tb_thread_pool_group_post(group, "write", tb_demo_task_stage_done, tb_null, "write", tb_false, deps, 2);
+
+        // detach the tasks
+        if (decode) tb_thread_pool_task_detach(tb_thread_pool(), decode);
+        if (deps[0]) tb_thread_pool_task_detach(tb_thread_pool(), deps[0]);
+        if (deps[1]) tb_thread_pool_task_detach(tb_thread_pool(), deps[1]);
+
+        // wait the pipeline only
+        tb_thread_pool_group_wait(group, -1);
+
+        // exit group
+        tb_thread_pool_group_exit(group);
+    }
+
 #endif
 
     // trace
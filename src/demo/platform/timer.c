@@ -3,9 +3,120 @@
  */
 #include "../demo.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the tasks count for the wheel test
+#define TB_DEMO_TIMER_WHEEL_COUNT       (10000)
+
+// the re-arming count for the perf test
+#define TB_DEMO_TIMER_REARM_COUNT       (1000000)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the wheel test type
+typedef struct __tb_demo_timer_wheel_t
+{
+    // the expected time of each task
+    tb_hong_t           when[TB_DEMO_TIMER_WHEEL_COUNT];
+
+    // the fired count
+    tb_size_t           fired;
+
+    // the late count, the task is done more than 10ms later, it is only a hint for the loaded system
+    tb_size_t           late;
+
+    // the early count
+    tb_size_t           early;
+
+}tb_demo_timer_wheel_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * func
  */
+static tb_hong_t tb_demo_timer_now()
+{
+    tb_timeval_t tv = {0};
+    return tb_gettimeofday(&tv, tb_null)? ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000) : 0;
+}
+static tb_demo_timer_wheel_t* g_wheel = tb_null;
+static tb_void_t tb_demo_timer_wheel_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // check the time
+    tb_hong_t now = tb_demo_timer_now();
+    tb_hong_t when = g_wheel->when[(tb_size_t)priv];
+    if (now < when) g_wheel->early++;
+    else if (now > when + 10) g_wheel->late++;
+    g_wheel->fired++;
+}
+static tb_void_t tb_demo_timer_wheel_rearm_func(tb_bool_t killed, tb_cpointer_t priv)
+{
+}
+static tb_void_t tb_demo_timer_wheel_test()
+{
+    // init timer with the real time
+    tb_timer_ref_t timer = tb_timer_init(0, tb_false);
+    g_wheel = tb_malloc0_type(tb_demo_timer_wheel_t);
+    if (timer && g_wheel)
+    {
+        // add tasks in [0, 2s), some of them will be cascaded from the higher wheel
+        tb_size_t i = 0;
+        tb_size_t count = 0;
+        tb_timer_task_ref_t tasks[TB_DEMO_TIMER_WHEEL_COUNT];
+        for (i = 0; i < TB_DEMO_TIMER_WHEEL_COUNT; i++)
+        {
+            tb_size_t delay = (i * 7919) % 2000;
+            g_wheel->when[i] = tb_demo_timer_now() + delay;
+            tasks[i] = tb_timer_task_init(timer, delay, tb_false, tb_demo_timer_wheel_func, (tb_cpointer_t)i);
+        }
+
+        // cancel the odd tasks
+        for (i = 1; i < TB_DEMO_TIMER_WHEEL_COUNT; i += 2)
+        {
+            if (tasks[i]) tb_timer_task_exit(timer, tasks[i]);
+            tasks[i] = tb_null;
+        }
+
+        // add a far task on the highest wheel and cancel it
+        tb_timer_task_exit(timer, tb_timer_task_init(timer, 7 * 24 * 3600 * 1000, tb_false, tb_demo_timer_wheel_func, tb_null));
+
+        // spak the timer until all tasks have been done
+        tb_hong_t time = tb_mclock();
+        while (g_wheel->fired < (TB_DEMO_TIMER_WHEEL_COUNT >> 1) && tb_mclock() - time < 5000)
+        {
+            tb_size_t delay = tb_timer_delay(timer);
+            if (delay) tb_msleep(tb_min(delay, 100));
+            tb_timer_spak(timer);
+        }
+
+        // exit the fired tasks
+        for (i = 0; i < TB_DEMO_TIMER_WHEEL_COUNT; i += 2)
+            if (tasks[i]) tb_timer_task_exit(timer, tasks[i]);
+
+        // trace
+        tb_trace_i("wheel: fired: %lu, early: %lu, late: %lu, %s", g_wheel->fired, g_wheel->early, g_wheel->late, g_wheel->fired == (TB_DEMO_TIMER_WHEEL_COUNT >> 1) && !g_wheel->early? "ok" : "failed");
+
+        // re-arm the idle timeout of the connections
+        time = tb_mclock();
+        for (i = 0; i < TB_DEMO_TIMER_REARM_COUNT; i++, count++)
+        {
+            tb_timer_task_ref_t task = tb_timer_task_init(timer, 30000 + (i & 1023), tb_false, tb_demo_timer_wheel_rearm_func, tb_null);
+            if (task) tb_timer_task_exit(timer, task);
+        }
+        time = tb_mclock() - time;
+
+        // trace
+        tb_trace_i("wheel: re-arm %lu tasks in %lld ms", count, time);
+    }
+
+    // exit timer
+    if (timer) tb_timer_exit(timer);
+    if (g_wheel) tb_free(g_wheel);
+    g_wheel = tb_null;
+}
 static tb_void_t tb_demo_timer_task_func(tb_bool_t killed, tb_cpointer_t priv)
 {
     // get the time
@@ -25,6 +136,9 @@ static tb_void_t tb_demo_timer_task_func(tb_bool_t killed, tb_cpointer_t priv)
  */ 
 tb_int_t tb_demo_platform_timer_main(tb_int_t argc, tb_char_t** argv)
 {
+    // test the timing wheel
+    tb_demo_timer_wheel_test();
+
     // add task: every
     tb_timer_task_post(tb_timer(), 1000, tb_true, tb_demo_timer_task_func, "every");
 
@@ -70,6 +70,9 @@
 // the self bucket item maximum size
 #define TB_HASH_MAP_BUCKET_ITEM_MAXN                    (1 << 16)
 
+// the hash map allocator
+#define tb_hash_map_allocator(hash_map)                 ((hash_map)->allocator? (hash_map)->allocator : tb_allocator())
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -115,6 +118,9 @@ typedef struct __tb_hash_map_t
     // the element for data
     tb_element_t                    element_data;
 
+    // the allocator, uses the global allocator if be null
+    tb_allocator_ref_t              allocator;
+
 }tb_hash_map_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -383,7 +389,7 @@ static tb_void_t tb_hash_map_itor_remove(tb_iterator_ref_t iterator, tb_size_t i
     else 
     {
         // free it
-        tb_free(list);
+        tb_allocator_free(tb_hash_map_allocator(hash_map), list);
 
         // reset
         hash_map->hash_list[buck] = tb_null;
@@ -481,6 +487,10 @@ static tb_void_t tb_hash_map_itor_remove_range(tb_iterator_ref_t iterator, tb_si
  * implementation
  */
 tb_hash_map_ref_t tb_hash_map_init(tb_size_t bucket_size, tb_element_t element_name, tb_element_t element_data)
+{
+    return tb_hash_map_init_with_allocator(bucket_size, element_name, element_data, tb_null);
+}
+tb_hash_map_ref_t tb_hash_map_init_with_allocator(tb_size_t bucket_size, tb_element_t element_name, tb_element_t element_data, tb_allocator_ref_t allocator)
 {
     // check
     tb_assert_and_check_return_val(element_name.size && element_name.hash && element_name.comp && element_name.data && element_name.dupl, tb_null);
@@ -496,9 +506,12 @@ tb_hash_map_ref_t tb_hash_map_init(tb_size_t bucket_size, tb_element_t element_n
     do
     {
         // make self
-        hash_map = tb_malloc0_type(tb_hash_map_t);
+        hash_map = (tb_hash_map_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_hash_map_t));
         tb_assert_and_check_break(hash_map);
 
+        // init self allocator
+        hash_map->allocator = allocator;
+
         // init self func
         hash_map->element_name = element_name;
         hash_map->element_data = element_data;
@@ -523,7 +536,7 @@ tb_hash_map_ref_t tb_hash_map_init(tb_size_t bucket_size, tb_element_t element_n
         tb_assert_and_check_break(hash_map->hash_size <= TB_HASH_MAP_BUCKET_MAXN);
 
         // init self list
-        hash_map->hash_list = (tb_hash_map_item_list_t**)tb_nalloc0(hash_map->hash_size, sizeof(tb_size_t));
+        hash_map->hash_list = (tb_hash_map_item_list_t**)tb_allocator_nalloc0(tb_hash_map_allocator(hash_map), hash_map->hash_size, sizeof(tb_size_t));
         tb_assert_and_check_break(hash_map->hash_list);
 
         // init item grow
@@ -557,10 +570,10 @@ tb_void_t tb_hash_map_exit(tb_hash_map_ref_t self)
     tb_hash_map_clear(self);
 
     // free hash_map list
-    if (hash_map->hash_list) tb_free(hash_map->hash_list);
+    if (hash_map->hash_list) tb_allocator_free(tb_hash_map_allocator(hash_map), hash_map->hash_list);
 
     // free it
-    tb_free(hash_map);
+    tb_allocator_free(tb_hash_map_allocator(hash_map), hash_map);
 }
 tb_void_t tb_hash_map_clear(tb_hash_map_ref_t self)
 {
@@ -594,7 +607,7 @@ tb_void_t tb_hash_map_clear(tb_hash_map_ref_t self)
             }
 
             // free list
-            tb_free(list);
+            tb_allocator_free(tb_hash_map_allocator(hash_map), list);
         }
         hash_map->hash_list[i] = tb_null;
     }
@@ -677,7 +690,7 @@ tb_size_t tb_hash_map_insert(tb_hash_map_ref_t self, tb_cpointer_t name, tb_cpoi
                 tb_assert_and_check_return_val(maxn > list->maxn, 0);
 
                 // realloc it
-                list = (tb_hash_map_item_list_t*)tb_ralloc(list, sizeof(tb_hash_map_item_list_t) + maxn * step);  
+                list = (tb_hash_map_item_list_t*)tb_allocator_ralloc(tb_hash_map_allocator(hash_map), list, sizeof(tb_hash_map_item_list_t) + maxn * step);  
                 tb_assert_and_check_return_val(list, 0);
 
                 // update the hash_map item maxn
@@ -707,7 +720,7 @@ tb_size_t tb_hash_map_insert(tb_hash_map_ref_t self, tb_cpointer_t name, tb_cpoi
             tb_assert_and_check_return_val(hash_map->item_grow, 0);
 
             // make list
-            list = (tb_hash_map_item_list_t*)tb_malloc0(sizeof(tb_hash_map_item_list_t) + hash_map->item_grow * step);
+            list = (tb_hash_map_item_list_t*)tb_allocator_malloc0(tb_hash_map_allocator(hash_map), sizeof(tb_hash_map_item_list_t) + hash_map->item_grow * step);
             tb_assert_and_check_return_val(list, 0);
 
             // init list
@@ -32,6 +32,7 @@
 #include "prefix.h"
 #include "element.h"
 #include "iterator.h"
+#include "../memory/allocator.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -110,6 +111,19 @@ typedef tb_iterator_ref_t tb_hash_map_ref_t;
  */
 tb_hash_map_ref_t       tb_hash_map_init(tb_size_t bucket_size, tb_element_t element_name, tb_element_t element_data);
 
+/*! init hash map with the given allocator
+ *
+ * @note the elements still duplicate their own data, e.g. tb_element_str(tb_true)
+ *
+ * @param bucket_size   the hash bucket size, using the default size if be zero
+ * @param element_name  the item for name
+ * @param element_data  the item for data
+ * @param allocator     the allocator, uses the global allocator if be null
+ *
+ * @return              the hash map
+ */
+tb_hash_map_ref_t       tb_hash_map_init_with_allocator(tb_size_t bucket_size, tb_element_t element_name, tb_element_t element_data, tb_allocator_ref_t allocator);
+
 /*! exit hash map
  *
  * @param hash_map      the hash map
@@ -59,6 +59,9 @@
 #   define TB_VECTOR_MAXN             (1 << 30)
 #endif
 
+// the vector allocator
+#define tb_vector_allocator(vector)         ((vector)->allocator? (vector)->allocator : tb_allocator())
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -84,6 +87,9 @@ typedef struct __tb_vector_t
     // the element
     tb_element_t            element;
 
+    // the allocator, uses the global allocator if be null
+    tb_allocator_ref_t      allocator;
+
 }tb_vector_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -187,6 +193,10 @@ static tb_void_t tb_vector_itor_remove_range(tb_iterator_ref_t iterator, tb_size
  * implementation
  */
 tb_vector_ref_t tb_vector_init(tb_size_t grow, tb_element_t element)
+{
+    return tb_vector_init_with_allocator(grow, element, tb_null);
+}
+tb_vector_ref_t tb_vector_init_with_allocator(tb_size_t grow, tb_element_t element, tb_allocator_ref_t allocator)
 {
     // check
     tb_assert_and_check_return_val(element.size && element.data && element.dupl && element.repl && element.ndupl && element.nrepl, tb_null);
@@ -200,10 +210,11 @@ tb_vector_ref_t tb_vector_init(tb_size_t grow, tb_element_t element)
         if (!grow) grow = TB_VECTOR_GROW;
 
         // make vector
-        vector = tb_malloc0_type(tb_vector_t);
+        vector = (tb_vector_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_vector_t));
         tb_assert_and_check_break(vector);
 
         // init vector
+        vector->allocator = allocator;
         vector->size      = 0;
         vector->grow      = grow;
         vector->maxn      = grow;
@@ -227,7 +238,7 @@ tb_vector_ref_t tb_vector_init(tb_size_t grow, tb_element_t element)
         vector->itor.remove_range = tb_vector_itor_remove_range;
 
         // make data
-        vector->data = (tb_byte_t*)tb_nalloc0(vector->maxn, element.size);
+        vector->data = (tb_byte_t*)tb_allocator_nalloc0(tb_vector_allocator(vector), vector->maxn, element.size);
         tb_assert_and_check_break(vector->data);
 
         // ok
@@ -256,11 +267,11 @@ tb_void_t tb_vector_exit(tb_vector_ref_t self)
     tb_vector_clear(self);
 
     // free data
-    if (vector->data) tb_free(vector->data);
+    if (vector->data) tb_allocator_free(tb_vector_allocator(vector), vector->data);
     vector->data = tb_null;
 
     // free it
-    tb_free(vector);
+    tb_allocator_free(tb_vector_allocator(vector), vector);
 }
 tb_void_t tb_vector_clear(tb_vector_ref_t self)
 {
@@ -372,7 +383,7 @@ tb_bool_t tb_vector_resize(tb_vector_ref_t self, tb_size_t size)
         tb_assert_and_check_return_val(maxn < TB_VECTOR_MAXN, tb_false);
 
         // realloc data
-        vector->data = (tb_byte_t*)tb_ralloc(vector->data, maxn * vector->element.size);
+        vector->data = (tb_byte_t*)tb_allocator_ralloc(tb_vector_allocator(vector), vector->data, maxn * vector->element.size);
         tb_assert_and_check_return_val(vector->data, tb_false);
 
         // must be align by 4-bytes
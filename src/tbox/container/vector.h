@@ -32,6 +32,7 @@
 #include "prefix.h"
 #include "element.h"
 #include "iterator.h"
+#include "../memory/allocator.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -119,6 +120,18 @@ typedef tb_iterator_ref_t tb_vector_ref_t;
  */
 tb_vector_ref_t     tb_vector_init(tb_size_t grow, tb_element_t element);
 
+/*! init vector with the given allocator
+ *
+ * @note the element still duplicates its own data, e.g. tb_element_str(tb_true)
+ *
+ * @param grow      the item grow
+ * @param element   the element
+ * @param allocator the allocator, uses the global allocator if be null
+ *
+ * @return          the vector
+ */
+tb_vector_ref_t     tb_vector_init_with_allocator(tb_size_t grow, tb_element_t element, tb_allocator_ref_t allocator);
+
 /*! exist vector
  *
  * @param vector    the vector
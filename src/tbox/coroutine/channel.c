@@ -38,38 +38,56 @@
 #include "scheduler.h"
 #include "impl/impl.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the notified waiters at once
+#define TB_CO_CHANNEL_NOTIFY_MAXN       (16)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
-/* the channel queue type
+// the channel ring cell type
+typedef struct __tb_co_channel_cell_t
+{
+    // the sequence
+    tb_atomic_t                     seq;
+
+    // the data
+    tb_cpointer_t                   data;
+
+}tb_co_channel_cell_t;
+
+/* the channel ring type
+ *
+ * it is a bounded lock-free ring for the multi-producers and multi-consumers,
+ * and the sequence of each cell tells whether it can be written or read now
  *
- * we do not use tb_circle_queue_t because it is too heavy
+ * we do not use tb_circle_queue_t because it is too heavy and not thread-safe
  */
-typedef struct __tb_co_channel_queue_t
+typedef struct __tb_co_channel_ring_t
 {
-    // the data
-    tb_cpointer_t*                  data;
-    
-    // the head
-    tb_size_t                       head;
+    // the cells
+    tb_co_channel_cell_t*           cells;
 
-    // the tail
-    tb_size_t                       tail;
+    // the cells mask, the cells count is the power of 2
+    tb_size_t                       mask;
 
-    // the maxn
-    tb_size_t                       maxn;
+    // the read position
+    tb_atomic_t                     head;
 
-    // the size
-    tb_size_t                       size;
+    // the write position
+    tb_atomic_t                     tail;
 
-}tb_co_channel_queue_t;
+}tb_co_channel_ring_t;
 
 // the coroutine channel type
 typedef struct __tb_co_channel_t
 {
-    // the queue
-    tb_co_channel_queue_t           queue;
+    // the ring, no buffer if the cells is null
+    tb_co_channel_ring_t            ring;
 
     // the free function
     tb_co_channel_free_func_t       free;
@@ -77,284 +95,394 @@ typedef struct __tb_co_channel_t
     // the user private data
     tb_cpointer_t                   priv;
 
+    // the lock of the waiting lists
+    tb_spinlock_t                   lock;
+
     // the waiting send coroutines 
-    tb_single_list_entry_head_t     waiting_send;
+    tb_list_entry_head_t            waiting_send;
 
     // the waiting recv coroutines 
-    tb_single_list_entry_head_t     waiting_recv;
+    tb_list_entry_head_t            waiting_recv;
+
+    // the waiting send coroutines count, we can check it without the lock
+    tb_atomic_t                     waiting_send_count;
+
+    // the waiting recv coroutines count, we can check it without the lock
+    tb_atomic_t                     waiting_recv_count;
 
 }tb_co_channel_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-static tb_bool_t tb_co_channel_send_resume(tb_co_channel_t* channel, tb_pointer_t* pdata)
+static tb_bool_t tb_co_channel_ring_push(tb_co_channel_ring_t* ring, tb_cpointer_t data)
 {
     // check
-    tb_assert(channel);
+    tb_assert(ring && ring->cells);
 
-    // resume the first waiting send coroutine and recv data
-    tb_bool_t ok = tb_false;
-    if (tb_single_list_entry_size(&channel->waiting_send))
+    // reserve a cell
+    tb_size_t               pos = (tb_size_t)tb_atomic_get(&ring->tail);
+    tb_co_channel_cell_t*   cell = tb_null;
+    while (1)
     {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_send);
-        tb_assert(entry);
-
-        // remove it from the waiting send coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_send);
-
-        // get the waiting send coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_send, entry);
-
-        // resume this coroutine and recv data
-        tb_pointer_t data = tb_coroutine_resume(waiting, tb_null);
-
-        // save data
-        if (pdata) *pdata = data;
-
-        // ok
-        ok = tb_true;
+        // the cell can be written if its sequence is equal to the position
+        cell = &ring->cells[pos & ring->mask];
+        tb_long_t diff = (tb_long_t)((tb_size_t)tb_atomic_get(&cell->seq) - pos);
+        if (!diff)
+        {
+            // reserve it
+            tb_size_t prev = (tb_size_t)tb_atomic_fetch_and_pset(&ring->tail, pos, pos + 1);
+            if (prev == pos) break;
+            pos = prev;
+        }
+        // full?
+        else if (diff < 0) return tb_false;
+        // the other producers have reserved it, try the next position
+        else pos = (tb_size_t)tb_atomic_get(&ring->tail);
     }
 
-    // ok?
-    return ok;
+    // put data and publish it
+    cell->data = data;
+    tb_atomic_set(&cell->seq, pos + 1);
+    return tb_true;
 }
-static tb_void_t tb_co_channel_recv_resume(tb_co_channel_t* channel)
+static tb_bool_t tb_co_channel_ring_pop(tb_co_channel_ring_t* ring, tb_pointer_t* pdata)
 {
     // check
-    tb_assert(channel);
+    tb_assert(ring && ring->cells && pdata);
 
-    // resume the first waiting recv coroutine 
-    if (tb_single_list_entry_size(&channel->waiting_recv))
+    // reserve a cell
+    tb_size_t               pos = (tb_size_t)tb_atomic_get(&ring->head);
+    tb_co_channel_cell_t*   cell = tb_null;
+    while (1)
     {
-        // get the next entry from head
-        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&channel->waiting_recv);
-        tb_assert(entry);
+        // the cell can be read if its data has been published
+        cell = &ring->cells[pos & ring->mask];
+        tb_long_t diff = (tb_long_t)((tb_size_t)tb_atomic_get(&cell->seq) - (pos + 1));
+        if (!diff)
+        {
+            // reserve it
+            tb_size_t prev = (tb_size_t)tb_atomic_fetch_and_pset(&ring->head, pos, pos + 1);
+            if (prev == pos) break;
+            pos = prev;
+        }
+        // empty?
+        else if (diff < 0) return tb_false;
+        // the other consumers have reserved it, try the next position
+        else pos = (tb_size_t)tb_atomic_get(&ring->head);
+    }
 
-        // remove it from the waiting recv coroutines
-        tb_single_list_entry_remove_head(&channel->waiting_recv);
+    // get data and release this cell for the next round
+    *pdata = (tb_pointer_t)cell->data;
+    tb_atomic_set(&cell->seq, pos + ring->mask + 1);
+    return tb_true;
+}
+static __tb_inline__ tb_bool_t tb_co_channel_ring_empty(tb_co_channel_ring_t* ring)
+{
+    return tb_atomic_get(&ring->head) == tb_atomic_get(&ring->tail);
+}
+static __tb_inline__ tb_void_t tb_co_channel_link(tb_list_entry_head_ref_t waiting, tb_co_waiter_t* waiter)
+{
+    // link it to the waiting list
+    tb_list_entry_insert_tail(waiting, &waiter->entry);
+    waiter->linked = tb_true;
+}
+static __tb_inline__ tb_void_t tb_co_channel_unlink(tb_list_entry_head_ref_t waiting, tb_atomic_t* count, tb_co_waiter_t* waiter)
+{
+    // unlink it from the waiting list if it has been not claimed
+    if (waiter->linked)
+    {
+        tb_list_entry_remove(waiting, &waiter->entry);
+        tb_atomic_fetch_and_dec(count);
+        waiter->linked = tb_false;
+    }
+}
+static tb_co_waiter_t* tb_co_channel_claim(tb_list_entry_head_ref_t waiting, tb_atomic_t* count)
+{
+    // claim the first waiter, we need skip the waiters of select() which have been fired by the other cases
+    while (tb_list_entry_size(waiting))
+    {
+        // get the first waiter
+        tb_co_waiter_t* waiter = (tb_co_waiter_t*)tb_list_entry(waiting, tb_list_entry_head(waiting));
+        tb_assert(waiter && waiter->fired);
 
-        // get the waiting recv coroutine
-        tb_coroutine_ref_t waiting = (tb_coroutine_ref_t)tb_single_list_entry(&channel->waiting_recv, entry);
+        // remove it from the waiting list
+        tb_list_entry_remove_head(waiting);
+        tb_atomic_fetch_and_dec(count);
+        waiter->linked = tb_false;
 
-        // resume this coroutine 
-        tb_coroutine_resume(waiting, tb_null);
+        // claim it
+        if (!tb_atomic_fetch_and_pset(waiter->fired, 0, waiter->index + 1)) return waiter;
     }
+    return tb_null;
 }
-static tb_void_t tb_co_channel_send_suspend(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_void_t tb_co_channel_wake(tb_co_waiter_t* waiter)
 {
     // check
-    tb_assert(channel);
+    tb_assert(waiter && waiter->coroutine);
 
-    // get the running coroutine 
-    tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-    tb_assert(running);
+    // get the scheduler of the waiting coroutine
+    tb_coroutine_t*     coroutine = waiter->coroutine;
+    tb_co_scheduler_t*  scheduler = (tb_co_scheduler_t*)tb_coroutine_scheduler(coroutine);
+    tb_assert(scheduler);
 
-    // save this coroutine to the waiting send coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_send, &running->rs.single_entry);
+    // trace
+    tb_trace_d("wake coroutine(%p)", coroutine);
 
-    // send data and wait it
-    tb_coroutine_suspend(data);
+    // resume it directly on the same scheduler, otherwise post it to the scheduler thread
+    if ((tb_co_scheduler_t*)tb_co_scheduler_self() == scheduler) tb_co_scheduler_resume(scheduler, coroutine, tb_null);
+    else tb_co_scheduler_inbox_post(scheduler, coroutine, tb_null, tb_null);
 }
-static tb_void_t tb_co_channel_recv_suspend(tb_co_channel_t* channel)
+static tb_void_t tb_co_channel_notify(tb_co_channel_t* channel, tb_list_entry_head_ref_t waiting, tb_atomic_t* count, tb_size_t maxn)
 {
     // check
-    tb_assert(channel);
+    tb_assert(channel && waiting && count);
 
+    // no waiters? we need not enter the lock
+    while (maxn && tb_atomic_get(count))
+    {
+        // claim the waiters
+        tb_size_t       i = 0;
+        tb_size_t       n = 0;
+        tb_co_waiter_t* waiters[TB_CO_CHANNEL_NOTIFY_MAXN];
+        tb_spinlock_enter(&channel->lock);
+        while (n < maxn && n < TB_CO_CHANNEL_NOTIFY_MAXN && (waiters[n] = tb_co_channel_claim(waiting, count))) n++;
+        tb_spinlock_leave(&channel->lock);
+
+        // wake them
+        for (i = 0; i < n; i++) tb_co_channel_wake(waiters[i]);
+
+        // no more waiters?
+        if (n < TB_CO_CHANNEL_NOTIFY_MAXN) break;
+        maxn -= n;
+    }
+}
+static tb_coroutine_t* tb_co_channel_wait_init(tb_cpointer_t data)
+{
     // get the running coroutine 
     tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
-    tb_assert(running);
+    tb_assert_and_check_return_val(running, tb_null);
+
+    /* we need the inbox event to handle the coroutines resumed from the other threads,
+     * it is cheaper than starting the io loop which is only needed by the io and timeout waits
+     */
+    if (!tb_co_scheduler_inbox_need((tb_co_scheduler_t*)tb_coroutine_scheduler(running))) return tb_null;
+
+    // init waiter
+    tb_co_waiter_t* waiter = &running->waiter;
+    waiter->coroutine   = running;
+    waiter->fired       = &running->fired;
+    waiter->index       = 0;
+    waiter->data        = data;
+    waiter->linked      = tb_false;
+    tb_atomic_set0(&running->fired);
+
+    // ok
+    return running;
+}
+static tb_bool_t tb_co_channel_wait(tb_co_channel_t* channel, tb_coroutine_t* running, tb_list_entry_head_ref_t waiting, tb_atomic_t* count)
+{
+    // check
+    tb_assert(channel && running);
 
-    // save this coroutine to the waiting recv coroutines
-    tb_single_list_entry_insert_tail(&channel->waiting_recv, &running->rs.single_entry);
+    // trace
+    tb_trace_d("[%p]: wait ..", running);
+
+    // wait it, the main loop will wait the inbox for it if there are no other ready coroutines
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_coroutine_scheduler(running);
+    scheduler->inbox_waiting++;
+    tb_co_scheduler_suspend(scheduler, tb_null);
+    scheduler->inbox_waiting--;
+
+    // the scheduler has been stopped? remove it from the waiting list
+    if (running->waiter.linked)
+    {
+        tb_spinlock_enter(&channel->lock);
+        tb_co_channel_unlink(waiting, count, &running->waiter);
+        tb_spinlock_leave(&channel->lock);
+    }
+
+    // trace
+    tb_trace_d("[%p]: wait %s", running, tb_atomic_get(&running->fired)? "ok" : "failed");
 
-    // wait data
-    tb_coroutine_suspend(tb_null);
+    // ok?
+    return tb_atomic_get(&running->fired) != 0;
 }
-static tb_void_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_bool_t tb_co_channel_send_buffer(tb_co_channel_t* channel, tb_cpointer_t data)
 {
     // check
-    tb_assert_and_check_return(channel && channel->queue.data);
+    tb_assert(channel && channel->ring.cells);
 
     // done
-    do
+    while (1)
     {
-        // put data into queue if be not full
-        if (channel->queue.size + 1 < channel->queue.maxn)
+        // put data into ring if be not full
+        if (tb_co_channel_ring_push(&channel->ring, data))
         {
             // trace
             tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
 
-            // put data
-            channel->queue.data[channel->queue.tail] = data;
-            channel->queue.tail = (channel->queue.tail + 1) % channel->queue.maxn;
-            channel->queue.size++;
-
             // notify to recv data
-            tb_co_channel_recv_resume(channel);
-
-            // send ok
-            break;
+            tb_co_channel_notify(channel, &channel->waiting_recv, &channel->waiting_recv_count, 1);
+            return tb_true;
         }
-        // wait it if be full
-        else
+
+        // init waiter
+        tb_coroutine_t* running = tb_co_channel_wait_init(tb_null);
+        tb_check_return_val(running, tb_false);
+
+        /* put data again after the waiting count has been increased, 
+         * so the consumer will see this waiter if it has been full before
+         */
+        tb_bool_t full = tb_true;
+        tb_spinlock_enter(&channel->lock);
+        tb_atomic_fetch_and_inc(&channel->waiting_send_count);
+        if (tb_co_channel_ring_push(&channel->ring, data))
         {
-            // trace
-            tb_trace_d("send[%p]: wait ..", tb_coroutine_self());
+            tb_atomic_fetch_and_dec(&channel->waiting_send_count);
+            full = tb_false;
+        }
+        else tb_co_channel_link(&channel->waiting_send, &running->waiter);
+        tb_spinlock_leave(&channel->lock);
 
-            // wait send
-            tb_co_channel_send_suspend(channel, tb_null);
- 
-            // trace
-            tb_trace_d("send[%p]: wait ok", tb_coroutine_self());
+        // be not full now?
+        if (!full)
+        {
+            tb_co_channel_notify(channel, &channel->waiting_recv, &channel->waiting_recv_count, 1);
+            return tb_true;
         }
 
-    } while (1);
- 
-    // trace
-    tb_trace_d("send[%p]: ok", tb_coroutine_self());
+        // wait it if be full
+        if (!tb_co_channel_wait(channel, running, &channel->waiting_send, &channel->waiting_send_count)) return tb_false;
+    }
+
+    // failed
+    return tb_false;
 }
-static tb_pointer_t tb_co_channel_recv_buffer(tb_co_channel_t* channel)
+static tb_bool_t tb_co_channel_recv_buffer(tb_co_channel_t* channel, tb_pointer_t* pdata)
 {
     // check
-    tb_assert_and_check_return_val(channel && channel->queue.data, tb_null);
+    tb_assert(channel && channel->ring.cells && pdata);
 
     // done
-    tb_pointer_t data = tb_null;
-    do
+    while (1)
     {
-        // recv data from channel if be not null
-        if (channel->queue.size)
+        // get data from ring if be not null
+        if (tb_co_channel_ring_pop(&channel->ring, pdata))
         {
-            // get data
-            data = (tb_pointer_t)channel->queue.data[channel->queue.head];
-
-            // pop data
-            channel->queue.head = (channel->queue.head + 1) % channel->queue.maxn;
-            channel->queue.size--;
-
             // trace
-            tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), data);
+            tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), *pdata);
 
             // notify to send data
-            tb_co_channel_send_resume(channel, tb_null);
-
-            // recv ok
-            break;
+            tb_co_channel_notify(channel, &channel->waiting_send, &channel->waiting_send_count, 1);
+            return tb_true;
         }
-        // wait it if be null
-        else
-        {
-            // trace
-            tb_trace_d("recv[%p]: wait ..", tb_coroutine_self());
 
-            // wait recv
-            tb_co_channel_recv_suspend(channel);
+        // init waiter
+        tb_coroutine_t* running = tb_co_channel_wait_init(tb_null);
+        tb_check_return_val(running, tb_false);
 
-            // trace
-            tb_trace_d("recv[%p]: wait ok", tb_coroutine_self());
+        // get data again after the waiting count has been increased
+        tb_bool_t empty = tb_true;
+        tb_spinlock_enter(&channel->lock);
+        tb_atomic_fetch_and_inc(&channel->waiting_recv_count);
+        if (tb_co_channel_ring_pop(&channel->ring, pdata))
+        {
+            tb_atomic_fetch_and_dec(&channel->waiting_recv_count);
+            empty = tb_false;
         }
+        else tb_co_channel_link(&channel->waiting_recv, &running->waiter);
+        tb_spinlock_leave(&channel->lock);
 
-    } while (1);
- 
-    // trace
-    tb_trace_d("recv[%p]: ok", tb_coroutine_self());
-
-    // get data
-    return data;
-}
-static tb_bool_t tb_co_channel_send_buffer_try(tb_co_channel_t* channel, tb_cpointer_t data)
-{
-    // check
-    tb_assert_and_check_return_val(channel && channel->queue.data, tb_false);
-
-    // put data into queue if be not full
-    if (channel->queue.size + 1 < channel->queue.maxn)
-    {
-        // trace
-        tb_trace_d("send[%p]: put data(%p)", tb_coroutine_self(), data);
-
-        // put data
-        channel->queue.data[channel->queue.tail] = data;
-        channel->queue.tail = (channel->queue.tail + 1) % channel->queue.maxn;
-        channel->queue.size++;
-
-        // notify to recv data
-        tb_co_channel_recv_resume(channel);
+        // be not null now?
+        if (!empty)
+        {
+            tb_co_channel_notify(channel, &channel->waiting_send, &channel->waiting_send_count, 1);
+            return tb_true;
+        }
 
-        // send ok
-        return tb_true;
+        // wait it if be null
+        if (!tb_co_channel_wait(channel, running, &channel->waiting_recv, &channel->waiting_recv_count)) return tb_false;
     }
 
     // failed
     return tb_false;
 }
-static tb_bool_t tb_co_channel_recv_buffer_try(tb_co_channel_t* channel, tb_pointer_t* pdata)
+static tb_bool_t tb_co_channel_send_buffer0(tb_co_channel_t* channel, tb_cpointer_t data, tb_bool_t wait)
 {
     // check
-    tb_assert_and_check_return_val(channel && channel->queue.data && pdata, tb_false);
+    tb_assert(channel);
 
-    // recv data from channel if be not null
-    if (channel->queue.size)
+    // init waiter
+    tb_coroutine_t* running = tb_null;
+    if (wait)
     {
-        // get data
-        *pdata = (tb_pointer_t)channel->queue.data[channel->queue.head];
-
-        // pop data
-        channel->queue.head = (channel->queue.head + 1) % channel->queue.maxn;
-        channel->queue.size--;
-
-        // trace
-        tb_trace_d("recv[%p]: get data(%p)", tb_coroutine_self(), *pdata);
+        running = tb_co_channel_wait_init(data);
+        tb_check_return_val(running, tb_false);
+    }
 
-        // notify to send data
-        tb_co_channel_send_resume(channel, tb_null);
+    // pass data to the waiting recv coroutine directly
+    tb_spinlock_enter(&channel->lock);
+    tb_co_waiter_t* waiter = tb_co_channel_claim(&channel->waiting_recv, &channel->waiting_recv_count);
+    if (waiter) waiter->data = data;
+    else if (wait)
+    {
+        tb_atomic_fetch_and_inc(&channel->waiting_send_count);
+        tb_co_channel_link(&channel->waiting_send, &running->waiter);
+    }
+    tb_spinlock_leave(&channel->lock);
 
-        // recv ok
+    // resume the waiting recv coroutine
+    if (waiter)
+    {
+        tb_co_channel_wake(waiter);
         return tb_true;
     }
 
-    // failed
-    return tb_false;
+    // wait the recv coroutine
+    return wait? tb_co_channel_wait(channel, running, &channel->waiting_send, &channel->waiting_send_count) : tb_false;
 }
-static tb_void_t tb_co_channel_send_buffer0(tb_co_channel_t* channel, tb_cpointer_t data)
+static tb_bool_t tb_co_channel_recv_buffer0(tb_co_channel_t* channel, tb_pointer_t* pdata, tb_bool_t wait)
 {
     // check
-    tb_assert(channel);
+    tb_assert(channel && pdata);
 
-    // resume one waiting recv coroutine 
-    tb_co_channel_recv_resume(channel);
+    // init waiter
+    tb_coroutine_t* running = tb_null;
+    if (wait)
+    {
+        running = tb_co_channel_wait_init(tb_null);
+        tb_check_return_val(running, tb_false);
+    }
 
-    // send data and wait it
-    tb_co_channel_send_suspend(channel, data);
-}
-static tb_pointer_t tb_co_channel_recv_buffer0(tb_co_channel_t* channel)
-{
-    // check
-    tb_assert(channel);
+    // get data from the waiting send coroutine directly
+    tb_spinlock_enter(&channel->lock);
+    tb_co_waiter_t* waiter = tb_co_channel_claim(&channel->waiting_send, &channel->waiting_send_count);
+    if (waiter) *pdata = (tb_pointer_t)waiter->data;
+    else if (wait)
+    {
+        tb_atomic_fetch_and_inc(&channel->waiting_recv_count);
+        tb_co_channel_link(&channel->waiting_recv, &running->waiter);
+    }
+    tb_spinlock_leave(&channel->lock);
 
-    // done
-    tb_pointer_t data = tb_null;
-    do
+    // resume the waiting send coroutine
+    if (waiter)
     {
-        // resume the first waiting send coroutine and recv data
-        if (tb_co_channel_send_resume(channel, &data))
-        {
-            // recv ok
-            break;
-        }
-        // no data?
-        else
-        {
-            // wait data
-            tb_co_channel_recv_suspend(channel);
-        }
+        tb_co_channel_wake(waiter);
+        return tb_true;
+    }
 
-    } while (1);
+    // wait the send coroutine
+    if (wait && tb_co_channel_wait(channel, running, &channel->waiting_recv, &channel->waiting_recv_count))
+    {
+        // get the passed data
+        *pdata = (tb_pointer_t)running->waiter.data;
+        return tb_true;
+    }
 
-    // ok?
-    return data;
+    // failed
+    return tb_false;
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -371,11 +499,14 @@ tb_co_channel_ref_t tb_co_channel_init(tb_size_t size, tb_co_channel_free_func_t
         channel = tb_malloc0_type(tb_co_channel_t);
         tb_assert_and_check_break(channel);
 
+        // init lock
+        if (!tb_spinlock_init(&channel->lock)) break;
+
         // init waiting send coroutines
-        tb_single_list_entry_init(&channel->waiting_send, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_send, tb_co_waiter_t, entry, tb_null);
 
         // init waiting recv coroutines
-        tb_single_list_entry_init(&channel->waiting_recv, tb_coroutine_t, rs.single_entry, tb_null);
+        tb_list_entry_init(&channel->waiting_recv, tb_co_waiter_t, entry, tb_null);
 
         // init free function and data
         channel->free = free;
@@ -384,12 +515,24 @@ tb_co_channel_ref_t tb_co_channel_init(tb_size_t size, tb_co_channel_free_func_t
         // with buffer?
         if (size)
         {
-            // init maxn, + tail
-            channel->queue.maxn = size + 1;
-
-            // make data
-            channel->queue.data = tb_nalloc_type(channel->queue.maxn, tb_cpointer_t);
-            tb_assert_and_check_break(channel->queue.data);
+            /* init cells count, it will be aligned to the power of 2
+             *
+             * we need two cells at least, otherwise the sequence of the written cell will be equal to the next position
+             */
+            tb_size_t maxn = tb_align_pow2(tb_max(size, 2));
+            channel->ring.mask = maxn - 1;
+
+            // make cells
+            channel->ring.cells = tb_nalloc_type(maxn, tb_co_channel_cell_t);
+            tb_assert_and_check_break(channel->ring.cells);
+
+            // init the sequence of cells
+            tb_size_t i = 0;
+            for (i = 0; i < maxn; i++) 
+            {
+                channel->ring.cells[i].seq  = (tb_long_t)i;
+                channel->ring.cells[i].data = tb_null;
+            }
         }
 
         // ok
@@ -414,35 +557,31 @@ tb_void_t tb_co_channel_exit(tb_co_channel_ref_t self)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return(channel);
 
-    // exit queue
-    if (channel->queue.data)
+    // exit ring
+    if (channel->ring.cells)
     {
         // free data
-        if (channel->free)
+        tb_pointer_t data = tb_null;
+        while (tb_co_channel_ring_pop(&channel->ring, &data))
         {
-            tb_size_t head = channel->queue.head;
-            tb_size_t maxn = channel->queue.maxn;
-            tb_size_t size = channel->queue.size;
-            while (size--)
-            {
-                channel->free((tb_pointer_t)channel->queue.data[head], channel->priv);
-                head = (head + 1) % maxn;
-            }
+            if (channel->free) channel->free(data, channel->priv);
         }
 
         // free it
-        tb_free(channel->queue.data);
+        tb_free(channel->ring.cells);
     }
-    channel->queue.data = tb_null;
-    channel->queue.size = 0;
+    channel->ring.cells = tb_null;
 
     // check waiting coroutines
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_send));
-    tb_assert(!tb_single_list_entry_size(&channel->waiting_recv));
+    tb_assert(!tb_list_entry_size(&channel->waiting_send));
+    tb_assert(!tb_list_entry_size(&channel->waiting_recv));
 
     // exit waiting coroutines
-    tb_single_list_entry_exit(&channel->waiting_send);
-    tb_single_list_entry_exit(&channel->waiting_recv);
+    tb_list_entry_exit(&channel->waiting_send);
+    tb_list_entry_exit(&channel->waiting_recv);
+
+    // exit lock
+    tb_spinlock_exit(&channel->lock);
 
     // exit the channel
     tb_free(channel);
@@ -454,8 +593,8 @@ tb_void_t tb_co_channel_send(tb_co_channel_ref_t self, tb_cpointer_t data)
     tb_assert_and_check_return(channel);
 
     // send it
-    if (channel->queue.data) tb_co_channel_send_buffer(channel, data);
-    else tb_co_channel_send_buffer0(channel, data);
+    if (channel->ring.cells) tb_co_channel_send_buffer(channel, data);
+    else tb_co_channel_send_buffer0(channel, data, tb_true);
 }
 tb_pointer_t tb_co_channel_recv(tb_co_channel_ref_t self)
 {
@@ -464,7 +603,77 @@ tb_pointer_t tb_co_channel_recv(tb_co_channel_ref_t self)
     tb_assert_and_check_return_val(channel, tb_null);
 
     // recv it
-    return channel->queue.data? tb_co_channel_recv_buffer(channel) : tb_co_channel_recv_buffer0(channel);
+    tb_pointer_t data = tb_null;
+    if (channel->ring.cells) tb_co_channel_recv_buffer(channel, &data);
+    else tb_co_channel_recv_buffer0(channel, &data, tb_true);
+    return data;
+}
+tb_size_t tb_co_channel_send_n(tb_co_channel_ref_t self, tb_cpointer_t const* data, tb_size_t size)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return_val(channel && data, 0);
+
+    // no buffer? send them one by one
+    tb_size_t sent = 0;
+    if (!channel->ring.cells)
+    {
+        while (sent < size && tb_co_channel_send_buffer0(channel, data[sent], tb_true)) sent++;
+        return sent;
+    }
+
+    // send them
+    while (sent < size)
+    {
+        // put data into ring as many as possible
+        tb_size_t count = 0;
+        while (sent + count < size && tb_co_channel_ring_push(&channel->ring, data[sent + count])) count++;
+
+        // notify to recv all data at once
+        if (count)
+        {
+            tb_co_channel_notify(channel, &channel->waiting_recv, &channel->waiting_recv_count, count);
+            sent += count;
+        }
+        // be full? wait it 
+        else if (tb_co_channel_send_buffer(channel, data[sent])) sent++;
+        else break;
+    }
+
+    // ok
+    return sent;
+}
+tb_size_t tb_co_channel_recv_n(tb_co_channel_ref_t self, tb_pointer_t* data, tb_size_t size)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return_val(channel && data && size, 0);
+
+    // no buffer? recv the first data and the data of the other waiting send coroutines
+    tb_size_t count = 0;
+    if (!channel->ring.cells)
+    {
+        if (tb_co_channel_recv_buffer0(channel, &data[0], tb_true))
+        {
+            count++;
+            while (count < size && tb_co_channel_recv_buffer0(channel, &data[count], tb_false)) count++;
+        }
+        return count;
+    }
+
+    // recv the first data, it will wait if no data
+    if (tb_co_channel_recv_buffer(channel, &data[0]))
+    {
+        // get the remaining data from ring as many as possible
+        count++;
+        while (count < size && tb_co_channel_ring_pop(&channel->ring, &data[count])) count++;
+
+        // notify to send data at once
+        if (count > 1) tb_co_channel_notify(channel, &channel->waiting_send, &channel->waiting_send_count, count - 1);
+    }
+
+    // ok
+    return count;
 }
 tb_bool_t tb_co_channel_send_try(tb_co_channel_ref_t self, tb_cpointer_t data)
 {
@@ -472,8 +681,19 @@ tb_bool_t tb_co_channel_send_try(tb_co_channel_ref_t self, tb_cpointer_t data)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return_val(channel, tb_false);
 
-    // try sending it
-    return channel->queue.data? tb_co_channel_send_buffer_try(channel, data) : tb_false;
+    // no buffer? pass it to the waiting recv coroutine
+    if (!channel->ring.cells) return tb_co_channel_send_buffer0(channel, data, tb_false);
+
+    // put data into ring if be not full
+    if (tb_co_channel_ring_push(&channel->ring, data))
+    {
+        // notify to recv data
+        tb_co_channel_notify(channel, &channel->waiting_recv, &channel->waiting_recv_count, 1);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
 }
 tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
 {
@@ -481,7 +701,62 @@ tb_bool_t tb_co_channel_recv_try(tb_co_channel_ref_t self, tb_pointer_t* pdata)
     tb_co_channel_t* channel = (tb_co_channel_t*)self;
     tb_assert_and_check_return_val(channel && pdata, tb_false);
 
-    // try recving it
-    return channel->queue.data? tb_co_channel_recv_buffer_try(channel, pdata) : tb_false;
+    // no buffer? get it from the waiting send coroutine
+    if (!channel->ring.cells) return tb_co_channel_recv_buffer0(channel, pdata, tb_false);
+
+    // get data from ring if be not null
+    if (tb_co_channel_ring_pop(&channel->ring, pdata))
+    {
+        // notify to send data
+        tb_co_channel_notify(channel, &channel->waiting_send, &channel->waiting_send_count, 1);
+        return tb_true;
+    }
+
+    // failed
+    return tb_false;
+}
+tb_bool_t tb_co_channel_wait_recv(tb_co_channel_ref_t self, tb_co_waiter_t* waiter)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return_val(channel && waiter && waiter->fired, tb_false);
+
+    // link this waiter if there is no data now 
+    tb_bool_t ready = tb_false;
+    tb_spinlock_enter(&channel->lock);
+    tb_atomic_fetch_and_inc(&channel->waiting_recv_count);
+    ready = channel->ring.cells? !tb_co_channel_ring_empty(&channel->ring) : tb_list_entry_size(&channel->waiting_send) != 0;
+    if (ready) tb_atomic_fetch_and_dec(&channel->waiting_recv_count);
+    else tb_co_channel_link(&channel->waiting_recv, waiter);
+    tb_spinlock_leave(&channel->lock);
+
+    // ok?
+    return !ready;
+}
+tb_void_t tb_co_channel_wait_cancel(tb_co_channel_ref_t self, tb_co_waiter_t* waiter)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return(channel && waiter);
+
+    // unlink it if it has been not claimed
+    tb_spinlock_enter(&channel->lock);
+    tb_co_channel_unlink(&channel->waiting_recv, &channel->waiting_recv_count, waiter);
+    tb_spinlock_leave(&channel->lock);
 }
+tb_bool_t tb_co_channel_wait_fetch(tb_co_channel_ref_t self, tb_co_waiter_t* waiter, tb_pointer_t* pdata)
+{
+    // check
+    tb_co_channel_t* channel = (tb_co_channel_t*)self;
+    tb_assert_and_check_return_val(channel && waiter && pdata, tb_false);
+
+    // no buffer? the data has been passed to the waiter
+    if (!channel->ring.cells)
+    {
+        *pdata = (tb_pointer_t)waiter->data;
+        return tb_true;
+    }
 
+    // get it from ring, it may have been received by the other coroutines
+    return tb_co_channel_recv_try(self, pdata);
+}
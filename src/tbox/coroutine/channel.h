@@ -57,7 +57,12 @@ typedef tb_void_t       (*tb_co_channel_free_func_t)(tb_pointer_t data, tb_cpoin
 
 /*! init channel 
  *
- * @param size          the buffer size, 0: no buffer
+ * the channel can be used by the coroutines of the different schedulers (threads),
+ * and the buffered data is stored in a lock-free ring.
+ *
+ * @note the schedulers must not run with the exclusive mode if the channel is shared between threads
+ *
+ * @param size          the buffer size, 0: no buffer, it will be aligned to the power of 2 (2 at least)
  * @param free          the free function
  * @param priv          the user private data
  *
@@ -90,9 +95,36 @@ tb_void_t               tb_co_channel_send(tb_co_channel_ref_t channel, tb_cpoin
  */
 tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
 
-/*! try sending data into channel only with buffer
+/*! send multiple data into channel
  *
- * the current coroutine will be suspend if this channel is full 
+ * the current coroutine will be suspend if this channel is full, 
+ * and the waiting recv coroutines will be notified at once for all data in the ring
+ *
+ * @param channel       the channel
+ * @param data          the data list
+ * @param size          the data count
+ *
+ * @return              the sent data count, it is less than size only if the scheduler has been stopped
+ */
+tb_size_t               tb_co_channel_send_n(tb_co_channel_ref_t channel, tb_cpointer_t const* data, tb_size_t size);
+
+/*! recv multiple data from channel
+ *
+ * the current coroutine will be suspend if no data, 
+ * and it will return all ready data (at most size) after it has been waked up
+ *
+ * @param channel       the channel
+ * @param data          the data list
+ * @param size          the maximum data count
+ *
+ * @return              the received data count
+ */
+tb_size_t               tb_co_channel_recv_n(tb_co_channel_ref_t channel, tb_pointer_t* data, tb_size_t size);
+
+/*! try sending data into channel without waiting
+ *
+ * it can be called in the other threads without coroutine,
+ * and the data will be passed to the waiting recv coroutine directly if this channel has no buffer
  *
  * @param channel       the channel
  * @param data          the channel data
@@ -101,9 +133,10 @@ tb_pointer_t            tb_co_channel_recv(tb_co_channel_ref_t channel);
  */
 tb_bool_t               tb_co_channel_send_try(tb_co_channel_ref_t channel, tb_cpointer_t data);
 
-/*! try recving data from channel only with buffer
+/*! try recving data from channel without waiting
  *
- * the current coroutine will be suspend if no data
+ * it can be called in the other threads without coroutine,
+ * and the data will be got from the waiting send coroutine directly if this channel has no buffer
  *
  * @param channel       the channel
  * @param pdata         the channel data pointer
@@ -64,6 +64,15 @@ tb_pointer_t tb_coroutine_resume(tb_coroutine_ref_t coroutine, tb_cpointer_t pri
     // resume the given coroutine
     return scheduler? tb_co_scheduler_resume(scheduler, (tb_coroutine_t*)coroutine, priv) : tb_null;
 }
+tb_bool_t tb_coroutine_resume_safe(tb_coroutine_ref_t self, tb_cpointer_t priv)
+{
+    // check
+    tb_coroutine_t* coroutine = (tb_coroutine_t*)self;
+    tb_assert_and_check_return_val(coroutine, tb_false);
+
+    // post it to the inbox of its scheduler
+    return tb_co_scheduler_inbox_post((tb_co_scheduler_t*)tb_coroutine_scheduler(coroutine), coroutine, tb_null, priv);
+}
 tb_pointer_t tb_coroutine_suspend(tb_cpointer_t priv)
 {
     // get current scheduler
@@ -88,6 +97,78 @@ tb_long_t tb_coroutine_waitio(tb_socket_ref_t sock, tb_size_t events, tb_long_t
     // wait events
     return scheduler? tb_co_scheduler_wait(scheduler, sock, events, timeout) : -1;
 }
+tb_long_t tb_coroutine_recv(tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(sock && data, -1);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // recv it
+    return scheduler_io? tb_co_scheduler_io_recv(scheduler_io, sock, data, size, timeout) : -1;
+}
+tb_long_t tb_coroutine_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(sock && data, -1);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // send it
+    return scheduler_io? tb_co_scheduler_io_send(scheduler_io, sock, data, size, timeout) : -1;
+}
+tb_socket_ref_t tb_coroutine_accept(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(sock, tb_null);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // accept it
+    return scheduler_io? tb_co_scheduler_io_accept(scheduler_io, sock, addr, timeout) : tb_null;
+}
+tb_long_t tb_coroutine_connect(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(sock && addr, -1);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // connect it
+    return scheduler_io? tb_co_scheduler_io_connect(scheduler_io, sock, addr, timeout) : -1;
+}
+tb_long_t tb_coroutine_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // read it
+    return scheduler_io? tb_co_scheduler_io_pread(scheduler_io, file, data, size, offset) : tb_file_pread(file, data, size, offset);
+}
+tb_long_t tb_coroutine_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert_and_check_return_val(file && data, -1);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_co_scheduler_io_ref_t    scheduler_io = scheduler? tb_co_scheduler_io_need(scheduler) : tb_null;
+
+    // writ it
+    return scheduler_io? tb_co_scheduler_io_pwrit(scheduler_io, file, data, size, offset) : tb_file_pwrit(file, data, size, offset);
+}
 tb_coroutine_ref_t tb_coroutine_self()
 {
     // get coroutine
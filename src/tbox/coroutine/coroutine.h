@@ -31,9 +31,11 @@
  */
 #include "lock.h"
 #include "channel.h"
+#include "select.h"
 #include "semaphore.h"
 #include "scheduler.h"
 #include "stackless/stackless.h"
+#include "../network/ipaddr.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -80,6 +82,20 @@ tb_bool_t               tb_coroutine_yield(tb_noarg_t);
  */
 tb_pointer_t            tb_coroutine_resume(tb_coroutine_ref_t coroutine, tb_cpointer_t priv);
 
+/*! resume the given coroutine (suspended) from any thread (thread-safe)
+ *
+ * it will post the coroutine to the inbox of its scheduler and wake up the io loop, 
+ * .e.g resume the waiting coroutine after the blocking task has been finished in the thread pool
+ *
+ * @note the coroutine must be suspended by sleep(-1) and be resumed only once
+ *
+ * @param coroutine     the suspended coroutine
+ * @param priv          the user private data as the return value of sleep()
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_coroutine_resume_safe(tb_coroutine_ref_t coroutine, tb_cpointer_t priv);
+
 /*! suspend the current coroutine
  *
  * @param priv          the user private data as the return value of resume() 
@@ -106,6 +122,75 @@ tb_pointer_t            tb_coroutine_sleep(tb_long_t interval);
  */
 tb_long_t               tb_coroutine_waitio(tb_socket_ref_t sock, tb_size_t events, tb_long_t timeout);
 
+/*! recv data from the socket
+ *
+ * it will suspend the current coroutine until some data are received,
+ * and it uses io_uring to finish it with only one kernel crossing if be supported.
+ *
+ * @param sock          the socket
+ * @param data          the data
+ * @param size          the size
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t               tb_coroutine_recv(tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout);
+
+/*! send data to the socket
+ *
+ * @param sock          the socket
+ * @param data          the data
+ * @param size          the size
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t               tb_coroutine_send(tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout);
+
+/*! accept the client socket
+ *
+ * @param sock          the listening socket
+ * @param addr          the client address, optional
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              the client socket, null: timeout or failed
+ */
+tb_socket_ref_t         tb_coroutine_accept(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/*! connect the given address
+ *
+ * @param sock          the socket
+ * @param addr          the address
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              1: ok, 0: timeout, -1: failed
+ */
+tb_long_t               tb_coroutine_connect(tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/*! read the file data at the given offset
+ *
+ * it will not block the other coroutines if io_uring is supported
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ * @param offset        the offset
+ *
+ * @return              >= 0: the real size, -1: failed
+ */
+tb_long_t               tb_coroutine_pread(tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset);
+
+/*! writ the file data at the given offset
+ *
+ * @param file          the file
+ * @param data          the data
+ * @param size          the size
+ * @param offset        the offset
+ *
+ * @return              >= 0: the real size, -1: failed
+ */
+tb_long_t               tb_coroutine_pwrit(tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset);
+
 /*! get the current coroutine
  *
  * @return              the current coroutine
@@ -117,4 +202,11 @@ tb_coroutine_ref_t      tb_coroutine_self(tb_noarg_t);
  */
 __tb_extern_c_leave__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+
+// the scheduler group need the coroutine types
+#include "scheduler_group.h"
+
 #endif
@@ -0,0 +1,78 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        channel.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_CHANNEL_H
+#define TB_COROUTINE_IMPL_CHANNEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* link the waiter to the waiting recv list of the channel if there is no data now
+ *
+ * the waiter will be claimed and resumed by the send coroutine, 
+ * and the sent data will be passed to the waiter directly if the channel has no buffer
+ *
+ * @param channel           the channel
+ * @param waiter            the waiter
+ *
+ * @return                  tb_true if the waiter has been linked, tb_false if the data is ready now
+ */
+tb_bool_t                   tb_co_channel_wait_recv(tb_co_channel_ref_t channel, tb_co_waiter_t* waiter);
+
+/* unlink the waiter from the waiting recv list if it has been not claimed
+ *
+ * @param channel           the channel
+ * @param waiter            the waiter
+ */
+tb_void_t                   tb_co_channel_wait_cancel(tb_co_channel_ref_t channel, tb_co_waiter_t* waiter);
+
+/* fetch the data for the claimed waiter
+ *
+ * @param channel           the channel
+ * @param waiter            the claimed waiter
+ * @param pdata             the data pointer
+ *
+ * @return                  tb_true or tb_false (the data has been received by the other coroutines)
+ */
+tb_bool_t                   tb_co_channel_wait_fetch(tb_co_channel_ref_t channel, tb_co_waiter_t* waiter, tb_pointer_t* pdata);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
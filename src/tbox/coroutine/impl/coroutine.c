@@ -35,6 +35,7 @@
  */
 #include "coroutine.h"
 #include "scheduler.h"
+#include "stack.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -46,9 +47,85 @@
 // the default stack size
 #define TB_COROUTINE_STACK_DEFSIZE          (8192 << 1)
 
+// the stack guard size at the stack top, keep the stack base aligned
+#define TB_COROUTINE_STACK_GUARDSIZE        (16)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
+ * private implementation
  */
+static tb_bool_t tb_coroutine_stack_init(tb_coroutine_t* coroutine, tb_size_t stacksize)
+{
+    // check
+    tb_assert(coroutine && coroutine->scheduler && stacksize);
+
+    // the scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)coroutine->scheduler;
+
+    // uses the shared stack if be shared-stack mode and it is large enough
+    if (scheduler->shared_count && stacksize <= scheduler->shared_stacks[0].size)
+    {
+        // get the next shared stack
+        tb_co_shared_stack_t* shared = &scheduler->shared_stacks[scheduler->shared_index++ % scheduler->shared_count];
+
+        // init stack
+        coroutine->shared       = shared;
+        coroutine->saved_size   = 0;
+        coroutine->stacksize    = shared->size - TB_COROUTINE_STACK_GUARDSIZE;
+        coroutine->stackbase    = shared->data + coroutine->stacksize;
+    }
+    else
+    {
+        // get the stack pool of the scheduler
+        tb_co_stack_pool_ref_t pool = tb_co_scheduler_stack_pool(scheduler);
+        tb_assert_and_check_return_val(pool, tb_false);
+
+        /* alloc stack from the pool
+         *
+         *  ---------------------------------------------
+         * | guard page | ...... stacksize ...... | guard |
+         *  ---------------------------------------------
+         *                                        ^
+         *                                        stackbase
+         */
+        tb_byte_t* stack = tb_co_stack_pool_alloc(pool, &stacksize);
+        tb_assert_and_check_return_val(stack && stacksize > TB_COROUTINE_STACK_GUARDSIZE, tb_false);
+
+        // init stack
+        coroutine->stacksize = stacksize - TB_COROUTINE_STACK_GUARDSIZE;
+        coroutine->stackbase = stack + coroutine->stacksize;
+    }
+
+    // fill guard
+    coroutine->guard = TB_COROUTINE_STACK_GUARD;
+    tb_bits_set_u16_ne(coroutine->stackbase, TB_COROUTINE_STACK_GUARD);
+    return tb_true;
+}
+static tb_void_t tb_coroutine_stack_exit(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert(coroutine && coroutine->scheduler);
+
+    // uses the shared stack?
+    if (coroutine->shared)
+    {
+        // release the shared stack if it is occupied by this coroutine
+        if (coroutine->shared->occupy == coroutine) coroutine->shared->occupy = tb_null;
+        coroutine->shared = tb_null;
+
+        // exit the saved stack data
+        if (coroutine->saved_data) tb_free(coroutine->saved_data);
+        coroutine->saved_data = tb_null;
+        coroutine->saved_size = 0;
+        coroutine->saved_maxn = 0;
+    }
+    // free stack to the pool
+    else if (coroutine->stackbase)
+    {
+        tb_co_stack_pool_free(tb_co_scheduler_stack_pool((tb_co_scheduler_t*)coroutine->scheduler), coroutine->stackbase - coroutine->stacksize, coroutine->stacksize + TB_COROUTINE_STACK_GUARDSIZE);
+    }
+    coroutine->stackbase = tb_null;
+    coroutine->stacksize = 0;
+}
 static tb_void_t tb_coroutine_entry(tb_context_from_t from)
 {
     // get the from-coroutine 
@@ -107,37 +184,28 @@ tb_coroutine_t* tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_coroutine_
         stacksize <<= 1;
 #endif
 
-        /* make coroutine
-         *
-         * TODO: 
-         *
-         * - segment stack 
-         *
-         *  -----------------------------------------------
-         * | coroutine | guard | ... stacksize ... | guard |
-         *  -----------------------------------------------
-         */
-        coroutine = (tb_coroutine_t*)tb_malloc_bytes(sizeof(tb_coroutine_t) + stacksize + sizeof(tb_uint16_t));
+        // make coroutine
+        coroutine = tb_malloc0_type(tb_coroutine_t);
         tb_assert_and_check_break(coroutine);
 
         // save scheduler
         coroutine->scheduler = scheduler;
 
         // init stack
-        coroutine->stackbase = (tb_byte_t*)&(coroutine[1]) + stacksize;
-        coroutine->stacksize = stacksize;
-
-        // fill guard
-        coroutine->guard = TB_COROUTINE_STACK_GUARD;
-        tb_bits_set_u16_ne(coroutine->stackbase, TB_COROUTINE_STACK_GUARD);
+        if (!tb_coroutine_stack_init(coroutine, stacksize)) break;
 
         // init function and user private data
         coroutine->rs.func.func = func;
         coroutine->rs.func.priv = priv;
 
-        // make context
-        coroutine->context = tb_context_make(coroutine->stackbase - stacksize, stacksize, tb_coroutine_entry);
-        tb_assert_and_check_break(coroutine->context);
+        /* make context
+         *
+         * the context will be made by the switcher later if the coroutine uses the shared stack,
+         * because the shared stack may be occupied by the other coroutine now
+         */
+        coroutine->context      = !coroutine->shared? tb_coroutine_context_make(coroutine) : tb_null;
+        coroutine->saved_size   = 0;
+        tb_assert_and_check_break(coroutine->context || coroutine->shared);
 
         // ok
         ok = tb_true;
@@ -178,34 +246,41 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
         tb_coroutine_check(coroutine);
 #endif
 
-        // remake coroutine
-        if (stacksize > coroutine->stacksize)
-            coroutine = (tb_coroutine_t*)tb_ralloc_bytes(coroutine, sizeof(tb_coroutine_t) + stacksize + sizeof(tb_uint16_t));
-        else stacksize = coroutine->stacksize;
-        tb_assert_and_check_break(coroutine && coroutine->scheduler);
-
-        // init stack
-        coroutine->stackbase = (tb_byte_t*)&(coroutine[1]) + stacksize;
-        coroutine->stacksize = stacksize;
-
-        // fill guard
-        coroutine->guard = TB_COROUTINE_STACK_GUARD;
-        tb_bits_set_u16_ne(coroutine->stackbase, TB_COROUTINE_STACK_GUARD);
+        // check scheduler
+        tb_assert_and_check_break(coroutine->scheduler);
+
+        // the stack is too small? remake it
+        if (stacksize > coroutine->stacksize + TB_COROUTINE_STACK_GUARDSIZE)
+        {
+            tb_coroutine_stack_exit(coroutine);
+            if (!tb_coroutine_stack_init(coroutine, stacksize)) break;
+        }
+        else
+        {
+            // fill guard
+            coroutine->guard = TB_COROUTINE_STACK_GUARD;
+            tb_bits_set_u16_ne(coroutine->stackbase, TB_COROUTINE_STACK_GUARD);
+        }
 
         // init function and user private data
         coroutine->rs.func.func = func;
         coroutine->rs.func.priv = priv;
 
-        // make context
-        coroutine->context = tb_context_make(coroutine->stackbase - stacksize, stacksize, tb_coroutine_entry);
-        tb_assert_and_check_break(coroutine->context);
+        /* make context
+         *
+         * the context will be made by the switcher later if the coroutine uses the shared stack,
+         * because the shared stack may be occupied by the other coroutine now
+         */
+        coroutine->context      = !coroutine->shared? tb_coroutine_context_make(coroutine) : tb_null;
+        coroutine->saved_size   = 0;
+        tb_assert_and_check_break(coroutine->context || coroutine->shared);
 
         // ok
         ok = tb_true;
 
     } while (0);
 
-    // failed? reset it
+    // failed? reset it and the caller will exit it
     if (!ok) coroutine = tb_null;
 
     // trace
@@ -214,6 +289,14 @@ tb_coroutine_t* tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func
     // ok?
     return coroutine;
 }
+tb_context_ref_t tb_coroutine_context_make(tb_coroutine_t* coroutine)
+{
+    // check
+    tb_assert_and_check_return_val(coroutine && coroutine->stackbase, tb_null);
+
+    // make context on the stack
+    return tb_context_make(coroutine->stackbase - coroutine->stacksize, coroutine->stacksize, tb_coroutine_entry);
+}
 tb_void_t tb_coroutine_exit(tb_coroutine_t* coroutine)
 {
     // check
@@ -227,14 +310,17 @@ tb_void_t tb_coroutine_exit(tb_coroutine_t* coroutine)
     tb_coroutine_check(coroutine);
 #endif
 
+    // exit stack
+    tb_coroutine_stack_exit(coroutine);
+
     // exit it
     tb_free(coroutine);
 }
 #ifdef __tb_debug__
 tb_void_t tb_coroutine_check(tb_coroutine_t* coroutine)
 {
-    // check
-    tb_assert(coroutine && coroutine->context);
+    // check, the context of the shared-stack coroutine will be made lazily
+    tb_assert(coroutine && (coroutine->context || coroutine->shared));
 
     // this coroutine is original for scheduler?
     tb_check_return(!tb_coroutine_is_original(coroutine));
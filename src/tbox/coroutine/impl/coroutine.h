@@ -30,6 +30,7 @@
  * includes
  */
 #include "prefix.h"
+#include "profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -50,6 +51,39 @@ __tb_extern_c_enter__
  * types
  */
 
+// the shared stack type
+struct __tb_co_shared_stack_t;
+
+// the select type
+struct __tb_co_select_t;
+
+/* the waiter type for the channel
+ *
+ * it will be linked to the waiting list of the channel, and be claimed only once by the waker,
+ * so the waiter of select() can be linked to multiple channels at the same time
+ */
+typedef struct __tb_co_waiter_t
+{
+    // the list entry
+    tb_list_entry_t                 entry;
+
+    // the waiting coroutine
+    struct __tb_coroutine_t*        coroutine;
+
+    // the fired flag, the waker claims it by setting it from zero to (index + 1)
+    tb_atomic_t*                    fired;
+
+    // the case index
+    tb_size_t                       index;
+
+    // the passed data for the unbuffered channel
+    tb_cpointer_t                   data;
+
+    // is linked to the waiting list?
+    tb_bool_t                       linked;
+
+}tb_co_waiter_t;
+
 // the coroutine function type
 typedef struct __tb_coroutine_rs_func_t
 {
@@ -64,11 +98,7 @@ typedef struct __tb_coroutine_rs_func_t
 // the coroutine wait type
 typedef struct __tb_coroutine_rs_wait_t
 {
-    /* the timer task pointer for ltimer or timer
-     *
-     * for ltimer:  task
-     * for timer:   task & 0x1
-     */
+    // the timer task
     tb_cpointer_t                   task;
 
     // the socket
@@ -106,9 +136,33 @@ typedef struct __tb_coroutine_t
     // the stack size
     tb_size_t                       stacksize;
 
+    // the shared stack, null if the coroutine uses the private stack
+    struct __tb_co_shared_stack_t*  shared;
+
+    // the saved stack data for the shared stack
+    tb_byte_t*                      saved_data;
+
+    // the saved stack size
+    tb_size_t                       saved_size;
+
+    // the saved stack buffer maxn
+    tb_size_t                       saved_maxn;
+
     // the passed user private data between priv = resume(priv) and priv = suspend(priv)
     tb_cpointer_t                   rs_priv;
 
+    // the waiter for the channel
+    tb_co_waiter_t                  waiter;
+
+    // the fired flag of the waiter
+    tb_atomic_t                     fired;
+
+    // the select state if the coroutine is waiting in select()
+    struct __tb_co_select_t*        select;
+
+    // the profiler record, only be updated if the profiler of the scheduler is enabled
+    tb_co_profiler_record_t         profiler;
+
     // the passed private data between resume() and suspend()
     union 
     {
@@ -157,6 +211,14 @@ tb_coroutine_t*         tb_coroutine_init(tb_co_scheduler_ref_t scheduler, tb_co
  */
 tb_coroutine_t*         tb_coroutine_reinit(tb_coroutine_t* coroutine, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
 
+/* make the context of the given coroutine on its stack
+ *
+ * @param coroutine     the coroutine
+ *
+ * @return              the context
+ */
+tb_context_ref_t        tb_coroutine_context_make(tb_coroutine_t* coroutine);
+
 /* exit coroutine
  *
  * @param coroutine     the coroutine
@@ -32,6 +32,11 @@
 #include "coroutine.h"
 #include "scheduler.h"
 #include "scheduler_io.h"
+#include "stack.h"
+#include "channel.h"
+#include "select.h"
+#include "profiler.h"
+#include "scheduler_group.h"
 #include "stackless/stackless.h"
 
 #endif
@@ -0,0 +1,299 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        profiler.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "profiler"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "profiler.h"
+#include "../../algorithm/algorithm.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the samples maximum count, must be power of 2
+#ifdef __tb_small__
+#   define TB_CO_PROFILER_SAMPLES_MAXN      (1024)
+#else
+#   define TB_CO_PROFILER_SAMPLES_MAXN      (8192)
+#endif
+
+// the maximum count of the dumped coroutines
+#define TB_CO_PROFILER_DUMP_MAXN            (16)
+
+// the monotonic time, us, it is timestamped for each switch, so we use the cheap clock
+#define tb_co_profiler_now()                (tb_clock_ns() / 1000)
+
+// get the record of the coroutine
+#define tb_co_profiler_record(coroutine, offset)    ((tb_co_profiler_record_t*)((tb_byte_t*)(coroutine) + (offset)))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_co_profiler_sample(tb_co_profiler_t* profiler, tb_cpointer_t coroutine, tb_co_profiler_record_t* record, tb_hong_t run_time)
+{
+    // check
+    tb_assert(profiler && profiler->samples && record);
+
+    // get the next sample, it will overwrite the oldest sample if be full
+    tb_size_t                   mask = profiler->samples_maxn - 1;
+    tb_co_profiler_sample_t*    sample = &profiler->samples[(profiler->samples_head + profiler->samples_size) & mask];
+    if (profiler->samples_size < profiler->samples_maxn) profiler->samples_size++;
+    else profiler->samples_head = (profiler->samples_head + 1) & mask;
+
+    // save it
+    sample->coroutine   = coroutine;
+    sample->func        = record->func;
+    sample->time        = record->run_at;
+    sample->run_time    = run_time;
+    sample->ready_time  = record->run_at - record->ready_at;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_profiler_t* tb_co_profiler_init(tb_size_t rate)
+{
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_co_profiler_t*   profiler = tb_null;
+    do
+    {
+        // make profiler
+        profiler = tb_malloc0_type(tb_co_profiler_t);
+        tb_assert_and_check_break(profiler);
+
+        // init samples
+        if (rate)
+        {
+            profiler->samples = tb_nalloc0_type(TB_CO_PROFILER_SAMPLES_MAXN, tb_co_profiler_sample_t);
+            tb_assert_and_check_break(profiler->samples);
+
+            profiler->rate          = rate;
+            profiler->samples_maxn  = TB_CO_PROFILER_SAMPLES_MAXN;
+        }
+
+        // the records before this time will be ignored
+        profiler->since = tb_co_profiler_now();
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (profiler) tb_co_profiler_exit(profiler);
+        profiler = tb_null;
+    }
+
+    // ok?
+    return profiler;
+}
+tb_void_t tb_co_profiler_exit(tb_co_profiler_t* profiler)
+{
+    // check
+    tb_assert_and_check_return(profiler);
+
+    // exit samples
+    if (profiler->samples) tb_free(profiler->samples);
+    profiler->samples = tb_null;
+
+    // exit it
+    tb_free(profiler);
+}
+tb_void_t tb_co_profiler_record_init(tb_co_profiler_record_t* record, tb_cpointer_t func)
+{
+    // check
+    tb_assert(record);
+
+    // reset it
+    tb_memset(record, 0, sizeof(tb_co_profiler_record_t));
+    record->func = func;
+}
+tb_void_t tb_co_profiler_record_reset(tb_list_entry_head_ref_t* lists, tb_size_t count, tb_size_t offset)
+{
+    // check
+    tb_assert(lists);
+
+    // reset the records of all coroutines, but keep their functions
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_for_all_if (tb_pointer_t, coroutine, tb_list_entry_itor(lists[i]), coroutine)
+        {
+            tb_co_profiler_record_t* record = tb_co_profiler_record(coroutine, offset);
+            tb_co_profiler_record_init(record, record->func);
+        }
+    }
+}
+tb_void_t tb_co_profiler_ready(tb_co_profiler_t* profiler, tb_co_profiler_record_t* record)
+{
+    // check
+    tb_assert(profiler && record);
+
+    // mark the ready time
+    record->ready_at = tb_co_profiler_now();
+}
+tb_void_t tb_co_profiler_switch(tb_co_profiler_t* profiler, tb_cpointer_t from, tb_co_profiler_record_t* record_from, tb_co_profiler_record_t* record_to)
+{
+    // check
+    tb_assert(profiler);
+
+    // get the current time only once for leaving and entering
+    tb_hong_t now = tb_co_profiler_now();
+
+    // leave the from-coroutine
+    if (record_from)
+    {
+        // it has been running after the profiler was enabled?
+        if (record_from->run_at >= profiler->since)
+        {
+            // update the running time
+            tb_hong_t slice = now - record_from->run_at;
+            record_from->run_time += slice;
+            profiler->stats.run_time += slice;
+
+            // update the longest slice
+            if (slice > record_from->slice_max) record_from->slice_max = slice;
+            if (slice > profiler->stats.slice_max)
+            {
+                profiler->stats.slice_max           = slice;
+                profiler->stats.slice_max_coroutine = from;
+                profiler->stats.slice_max_func      = record_from->func;
+            }
+
+            // sample this slice
+            if (profiler->rate && ++profiler->tick >= profiler->rate)
+            {
+                tb_co_profiler_sample(profiler, from, record_from, slice);
+                profiler->tick = 0;
+            }
+        }
+
+        // it is still ready if be yielded, and the ready time will be updated again if be resumed later
+        record_from->ready_at = now;
+    }
+
+    // enter the to-coroutine
+    if (record_to)
+    {
+        // update the ready time
+        if (record_to->ready_at >= profiler->since)
+        {
+            tb_hong_t ready = now - record_to->ready_at;
+            record_to->ready_time += ready;
+            profiler->stats.ready_time += ready;
+        }
+        else record_to->ready_at = now;
+
+        // start running
+        record_to->run_at = now;
+        record_to->switch_count++;
+
+        // update the switch count
+        profiler->stats.switch_count++;
+    }
+}
+tb_void_t tb_co_profiler_dump(tb_co_profiler_t* profiler, tb_list_entry_head_ref_t* lists, tb_size_t count, tb_size_t offset)
+{
+    // check
+    tb_assert_and_check_return(profiler && lists);
+
+    // find the busiest coroutines by the running time
+    tb_size_t                   i = 0;
+    tb_size_t                   n = 0;
+    tb_cpointer_t               coroutines[TB_CO_PROFILER_DUMP_MAXN];
+    tb_co_profiler_record_t*    records[TB_CO_PROFILER_DUMP_MAXN];
+    for (i = 0; i < count; i++)
+    {
+        tb_for_all_if (tb_pointer_t, coroutine, tb_list_entry_itor(lists[i]), coroutine)
+        {
+            // get the record
+            tb_co_profiler_record_t* record = tb_co_profiler_record(coroutine, offset);
+            tb_check_continue(record->switch_count);
+
+            // find the insert position
+            tb_size_t j = n;
+            while (j && records[j - 1]->run_time < record->run_time) j--;
+            tb_check_continue(j < TB_CO_PROFILER_DUMP_MAXN);
+
+            // insert it
+            if (n < TB_CO_PROFILER_DUMP_MAXN) n++;
+            tb_size_t k = n - 1;
+            for (; k > j; k--)
+            {
+                records[k]      = records[k - 1];
+                coroutines[k]   = coroutines[k - 1];
+            }
+            records[j]      = record;
+            coroutines[j]   = coroutine;
+        }
+    }
+
+    // trace
+    tb_co_profiler_stats_t const* stats = &profiler->stats;
+    tb_trace_i("");
+    tb_trace_i("switch: %llu, run: %lld us, ready: %lld us", stats->switch_count, stats->run_time, stats->ready_time);
+    tb_trace_i("slice_max: %lld us, coroutine: %p, func: %p", stats->slice_max, stats->slice_max_coroutine, stats->slice_max_func);
+    tb_trace_i("samples: %lu, rate: %lu", profiler->samples_size, profiler->rate);
+
+    // trace the busiest coroutines
+    for (i = 0; i < n; i++)
+    {
+        tb_co_profiler_record_t* record = records[i];
+        tb_trace_i("coroutine: %p, func: %p, switch: %lu, run: %lld us, ready: %lld us, slice_max: %lld us"
+                , coroutines[i], record->func, record->switch_count, record->run_time, record->ready_time, record->slice_max);
+    }
+}
+tb_size_t tb_co_profiler_trace(tb_co_profiler_t* profiler, tb_co_profiler_trace_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(profiler && func, 0);
+
+    // walk all samples from the oldest one
+    tb_size_t i = 0;
+    tb_size_t mask = profiler->samples_maxn - 1;
+    for (i = 0; i < profiler->samples_size; i++)
+    {
+        if (!func(&profiler->samples[(profiler->samples_head + i) & mask], priv))
+        {
+            i++;
+            break;
+        }
+    }
+
+    // ok
+    return i;
+}
@@ -0,0 +1,184 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        profiler.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_PROFILER_H
+#define TB_COROUTINE_IMPL_PROFILER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../profiler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// enable the coroutine profiler, the micro mode only compiles the stackless scheduler without it
+#ifndef TB_CONFIG_MICRO_ENABLE
+#   define TB_CO_PROFILER_ENABLE
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the profiler record of the coroutine
+typedef struct __tb_co_profiler_record_t
+{
+    // the coroutine function
+    tb_cpointer_t               func;
+
+    // the time when it becomes ready
+    tb_hong_t                   ready_at;
+
+    // the time when it starts running
+    tb_hong_t                   run_at;
+
+    // the running time
+    tb_hong_t                   run_time;
+
+    // the time spent ready but not running
+    tb_hong_t                   ready_time;
+
+    // the longest slice
+    tb_hong_t                   slice_max;
+
+    // the switch count to this coroutine
+    tb_size_t                   switch_count;
+
+}tb_co_profiler_record_t;
+
+/* the coroutine profiler type
+ *
+ * it is only accessed in the scheduler thread, so we need not any locks
+ */
+typedef struct __tb_co_profiler_t
+{
+    // the statistics of the whole scheduler
+    tb_co_profiler_stats_t      stats;
+
+    // the time when the profiler was enabled, the older records will be ignored
+    tb_hong_t                   since;
+
+    // sample one slice every rate slices, no samples if be zero
+    tb_size_t                   rate;
+
+    // the sample tick
+    tb_size_t                   tick;
+
+    // the samples ring
+    tb_co_profiler_sample_t*    samples;
+
+    // the samples maxn
+    tb_size_t                   samples_maxn;
+
+    // the samples head
+    tb_size_t                   samples_head;
+
+    // the samples size
+    tb_size_t                   samples_size;
+
+}tb_co_profiler_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init profiler
+ *
+ * @param rate              sample one slice every rate slices, no samples if be zero
+ *
+ * @return                  the profiler
+ */
+tb_co_profiler_t*           tb_co_profiler_init(tb_size_t rate);
+
+/* exit profiler
+ *
+ * @param profiler          the profiler
+ */
+tb_void_t                   tb_co_profiler_exit(tb_co_profiler_t* profiler);
+
+/* reset the record of the started coroutine
+ *
+ * @param record            the record
+ * @param func              the coroutine function
+ */
+tb_void_t                   tb_co_profiler_record_init(tb_co_profiler_record_t* record, tb_cpointer_t func);
+
+/* reset the records of all coroutines in the given lists
+ *
+ * @param lists             the coroutine lists
+ * @param count             the lists count
+ * @param offset            the record offset in the coroutine
+ */
+tb_void_t                   tb_co_profiler_record_reset(tb_list_entry_head_ref_t* lists, tb_size_t count, tb_size_t offset);
+
+/* mark the coroutine as ready
+ *
+ * @param profiler          the profiler
+ * @param record            the record of the coroutine
+ */
+tb_void_t                   tb_co_profiler_ready(tb_co_profiler_t* profiler, tb_co_profiler_record_t* record);
+
+/* switch from the given coroutine to the other coroutine
+ *
+ * @param profiler          the profiler
+ * @param from              the from-coroutine, null if it is the original (loop) coroutine
+ * @param record_from       the record of the from-coroutine
+ * @param record_to         the record of the to-coroutine, null if it is the original (loop) coroutine
+ */
+tb_void_t                   tb_co_profiler_switch(tb_co_profiler_t* profiler, tb_cpointer_t from, tb_co_profiler_record_t* record_from, tb_co_profiler_record_t* record_to);
+
+/* dump the statistics and the busiest coroutines in the given lists
+ *
+ * @param profiler          the profiler
+ * @param lists             the coroutine lists
+ * @param count             the lists count
+ * @param offset            the record offset in the coroutine
+ */
+tb_void_t                   tb_co_profiler_dump(tb_co_profiler_t* profiler, tb_list_entry_head_ref_t* lists, tb_size_t count, tb_size_t offset);
+
+/* export the sampled slices in the time order
+ *
+ * @param profiler          the profiler
+ * @param func              the trace function
+ * @param priv              the user private data
+ *
+ * @return                  the exported samples count
+ */
+tb_size_t                   tb_co_profiler_trace(tb_co_profiler_t* profiler, tb_co_profiler_trace_func_t func, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -48,6 +48,9 @@
 #   define TB_SCHEDULER_DEAD_CACHE_MAXN     (256)
 #endif
 
+// the switcher stack size for the shared-stack mode
+#define TB_SCHEDULER_SWITCHER_STACKSIZE     (8192)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -93,6 +96,11 @@ static tb_void_t tb_co_scheduler_make_ready(tb_co_scheduler_t* scheduler, tb_cor
         // .. -> coroutine(inserted) -> running -> ..
         tb_list_entry_insert_prev(&scheduler->coroutines_ready, (tb_list_entry_ref_t)scheduler->running, (tb_list_entry_ref_t)coroutine);
     }
+
+#ifdef TB_CO_PROFILER_ENABLE
+    // mark the ready time for the profiler
+    if (__tb_unlikely__(scheduler->profiler != tb_null)) tb_co_profiler_ready(scheduler->profiler, &coroutine->profiler);
+#endif
 }
 static tb_void_t tb_co_scheduler_make_suspend(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine)
 {
@@ -125,6 +133,81 @@ static __tb_inline__ tb_coroutine_t* tb_co_scheduler_next_ready(tb_co_scheduler_
     return (tb_coroutine_t*)tb_list_entry0(entry_next);
 }
 
+static tb_void_t tb_co_scheduler_switcher_save(tb_co_shared_stack_t* shared)
+{
+    // check
+    tb_assert(shared);
+
+    // no occupied coroutine or it has been finished?
+    tb_coroutine_t* occupy = shared->occupy;
+    tb_check_return(occupy && occupy->context);
+
+    // get the used stack data, [context, stackbase)
+    tb_byte_t const*    data = (tb_byte_t const*)occupy->context;
+    tb_size_t           size = occupy->stackbase - data;
+    tb_assert(data >= shared->data && size <= occupy->stacksize);
+
+    // grow or shrink the saved buffer to the right size
+    if (size > occupy->saved_maxn || occupy->saved_maxn > (size << 2))
+    {
+        tb_size_t maxn = tb_align8(size);
+        tb_byte_t* saved_data = (tb_byte_t*)tb_ralloc_bytes(occupy->saved_data, maxn);
+        tb_assert_and_check_return(saved_data);
+        occupy->saved_data = saved_data;
+        occupy->saved_maxn = maxn;
+    }
+
+    // save it
+    tb_memcpy(occupy->saved_data, data, size);
+    occupy->saved_size = size;
+
+    // trace
+    tb_trace_d("switcher: save coroutine(%p) stack: %lu bytes", occupy, size);
+}
+static tb_void_t tb_co_scheduler_switcher_func(tb_cpointer_t priv)
+{
+    // the switcher never runs the coroutine function
+    tb_assert(0);
+}
+static tb_void_t tb_co_scheduler_switcher_entry(tb_context_from_t from)
+{
+    // get the scheduler from the first from-coroutine
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)((tb_coroutine_t*)from.priv)->scheduler;
+    tb_assert(scheduler && scheduler->switcher);
+
+    // loop
+    while (1)
+    {
+        // update the context of the from-coroutine 
+        tb_coroutine_t* coroutine_from = (tb_coroutine_t*)from.priv;
+        tb_assert(coroutine_from && from.context);
+        coroutine_from->context = from.context;
+
+        // get the coroutine to be switched, it has been marked as running
+        tb_coroutine_t*         coroutine = scheduler->running;
+        tb_co_shared_stack_t*   shared = coroutine->shared;
+        tb_assert(shared && shared->occupy != coroutine);
+
+        // save the stack data of the occupied coroutine
+        tb_co_scheduler_switcher_save(shared);
+
+        // restore the stack data of this coroutine, it will run on the same stack address
+        if (coroutine->context)
+        {
+            tb_assert(coroutine->saved_data && coroutine->saved_size);
+            tb_memcpy(coroutine->stackbase - coroutine->saved_size, coroutine->saved_data, coroutine->saved_size);
+        }
+        // make context for the new coroutine
+        else coroutine->context = tb_coroutine_context_make(coroutine);
+
+        // occupy this stack
+        shared->occupy = coroutine;
+
+        // jump to this coroutine, it will update the context of the switcher
+        from = tb_context_jump(coroutine->context, scheduler->switcher);
+    }
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -172,6 +255,11 @@ tb_bool_t tb_co_scheduler_start(tb_co_scheduler_t* scheduler, tb_coroutine_func_
         if (!coroutine) coroutine = tb_coroutine_init((tb_co_scheduler_ref_t)scheduler, func, priv, stacksize);
         tb_assert_and_check_break(coroutine);
 
+#ifdef TB_CO_PROFILER_ENABLE
+        // reset the profiler record
+        tb_co_profiler_record_init(&coroutine->profiler, (tb_cpointer_t)func);
+#endif
+
         // ready coroutine
         tb_co_scheduler_make_ready(scheduler, coroutine);
 
@@ -309,6 +397,10 @@ tb_void_t tb_co_scheduler_finish(tb_co_scheduler_t* scheduler)
     // make the running coroutine as dead
     tb_co_scheduler_make_dead(scheduler, scheduler->running);
 
+    // the stack data of the dead coroutine need not be saved
+    if (scheduler->running->shared && scheduler->running->shared->occupy == scheduler->running)
+        scheduler->running->shared->occupy = tb_null;
+
     // switch to next coroutine 
     if (coroutine_next != scheduler->running) tb_co_scheduler_switch(scheduler, coroutine_next);
     // no more coroutine?
@@ -340,7 +432,7 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
 {
     // check
     tb_assert(scheduler && scheduler->running);
-    tb_assert(coroutine && coroutine->context);
+    tb_assert(coroutine && (coroutine->context || coroutine->shared));
 
     // the current running coroutine
     tb_coroutine_t* running = scheduler->running;
@@ -351,8 +443,23 @@ tb_void_t tb_co_scheduler_switch(tb_co_scheduler_t* scheduler, tb_coroutine_t* c
     // trace
     tb_trace_d("switch to coroutine(%p) from coroutine(%p)", coroutine, running);
 
+#ifdef TB_CO_PROFILER_ENABLE
+    // profile this switch, the original coroutine is not profiled
+    if (__tb_unlikely__(scheduler->profiler != tb_null))
+    {
+        tb_co_profiler_switch(scheduler->profiler, running
+            , tb_coroutine_is_original(running)? tb_null : &running->profiler
+            , tb_coroutine_is_original(coroutine)? tb_null : &coroutine->profiler);
+    }
+#endif
+
+    // the shared stack is occupied by the other coroutine? switch to it by the switcher
+    tb_context_ref_t context = coroutine->context;
+    if (coroutine->shared && coroutine->shared->occupy != coroutine)
+        context = scheduler->switcher->context;
+
     // jump to the given coroutine
-    tb_context_from_t from = tb_context_jump(coroutine->context, running);
+    tb_context_from_t from = tb_context_jump(context, running);
 
     // the from-coroutine 
     tb_coroutine_t* coroutine_from = (tb_coroutine_t*)from.priv;
@@ -381,3 +488,226 @@ tb_long_t tb_co_scheduler_wait(tb_co_scheduler_t* scheduler, tb_socket_ref_t soc
     // sleep it
     return tb_co_scheduler_io_wait(scheduler->scheduler_io, sock, events, timeout);
 }
+struct __tb_co_scheduler_io_t* tb_co_scheduler_io_need(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler && scheduler->running);
+    tb_assert(scheduler->running == (tb_coroutine_t*)tb_coroutine_self());
+
+    // have been stopped? return it directly
+    tb_check_return_val(!scheduler->stopped, tb_null);
+
+    // need io scheduler
+    return tb_co_scheduler_need_io(scheduler)? scheduler->scheduler_io : tb_null;
+}
+tb_bool_t tb_co_scheduler_shared_init(tb_co_scheduler_t* scheduler, tb_size_t stackcount, tb_size_t stacksize)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler && stackcount && stacksize && !scheduler->shared_count, tb_false);
+
+    // done
+    tb_bool_t ok = tb_false;
+    do
+    {
+        // init the switcher with the private stack before enabling the shared stacks
+        scheduler->switcher = tb_coroutine_init((tb_co_scheduler_ref_t)scheduler, tb_co_scheduler_switcher_func, tb_null, TB_SCHEDULER_SWITCHER_STACKSIZE);
+        tb_assert_and_check_break(scheduler->switcher);
+
+        // the switcher runs its own entry on the private stack instead of the coroutine function
+        scheduler->switcher->context = tb_context_make(scheduler->switcher->stackbase - scheduler->switcher->stacksize, scheduler->switcher->stacksize, tb_co_scheduler_switcher_entry);
+        tb_assert_and_check_break(scheduler->switcher->context);
+
+        // init the shared stacks
+        scheduler->shared_stacks = tb_nalloc0_type(stackcount, tb_co_shared_stack_t);
+        tb_assert_and_check_break(scheduler->shared_stacks);
+
+        // alloc the shared stacks from the stack pool
+        tb_size_t i = 0;
+        for (i = 0; i < stackcount; i++)
+        {
+            tb_co_shared_stack_t* shared = &scheduler->shared_stacks[i];
+            shared->size = stacksize;
+            shared->data = tb_co_stack_pool_alloc(scheduler->stack_pool, &shared->size);
+            tb_assert_and_check_break(shared->data);
+        }
+        tb_check_break(i == stackcount);
+
+        // enable the shared-stack mode
+        scheduler->shared_count = stackcount;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        scheduler->shared_count = stackcount;
+        tb_co_scheduler_shared_exit(scheduler);
+    }
+
+    // ok?
+    return ok;
+}
+tb_void_t tb_co_scheduler_shared_exit(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert_and_check_return(scheduler);
+
+    // exit the switcher
+    if (scheduler->switcher) tb_coroutine_exit(scheduler->switcher);
+    scheduler->switcher = tb_null;
+
+    // exit the shared stacks
+    if (scheduler->shared_stacks)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < scheduler->shared_count; i++)
+        {
+            tb_co_shared_stack_t* shared = &scheduler->shared_stacks[i];
+            if (shared->data) tb_co_stack_pool_free(scheduler->stack_pool, shared->data, shared->size);
+        }
+        tb_free(scheduler->shared_stacks);
+    }
+    scheduler->shared_stacks = tb_null;
+    scheduler->shared_count = 0;
+}
+tb_bool_t tb_co_scheduler_inbox_post(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine, tb_co_scheduler_post_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler && (coroutine || func), tb_false);
+
+    // make message
+    tb_co_scheduler_message_t* message = tb_malloc0_type(tb_co_scheduler_message_t);
+    tb_assert_and_check_return_val(message, tb_false);
+
+    // init message
+    message->coroutine  = coroutine;
+    message->func       = func;
+    message->priv       = priv;
+
+    // push it to the inbox
+    tb_size_t head = 0;
+    do
+    {
+        head = (tb_size_t)tb_atomic_get(&scheduler->inbox);
+        message->next = (tb_co_scheduler_message_t*)head;
+
+    } while ((tb_size_t)tb_atomic_fetch_and_pset(&scheduler->inbox, head, (tb_size_t)message) != head);
+
+    /* the inbox was empty? spak the io loop
+     *
+     * the other messages have been posted before and it has been spaked, 
+     * and the io loop will take all messages at once
+     */
+    if (!head)
+    {
+        // spak the io loop
+        struct __tb_co_scheduler_io_t* scheduler_io = scheduler->scheduler_io;
+        if (scheduler_io) tb_co_scheduler_io_spak(scheduler_io);
+
+        /* wake up the main loop if it is waiting the inbox without the io loop
+         *
+         * we post it even if the io loop exists, because it may be started after we read it,
+         * and the main loop only wakes up once more if it is not necessary
+         */
+        tb_semaphore_ref_t inbox_event = scheduler->inbox_event;
+        if (inbox_event) tb_semaphore_post(inbox_event, 1);
+    }
+
+    // ok
+    return tb_true;
+}
+tb_bool_t tb_co_scheduler_inbox_need(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // have been stopped?
+    tb_check_return_val(!scheduler->stopped, tb_false);
+
+    // init the inbox event, the posted thread will see it after it claims the waiting coroutine
+    if (!scheduler->inbox_event) scheduler->inbox_event = tb_semaphore_init(0);
+    return scheduler->inbox_event != tb_null;
+}
+tb_bool_t tb_co_scheduler_inbox_wait(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // no coroutines are waiting the inbox? or the io loop will handle it
+    tb_check_return_val(!scheduler->stopped && scheduler->inbox_waiting && scheduler->inbox_event && !scheduler->scheduler_io, tb_false);
+
+    // trace
+    tb_trace_d("inbox: wait %lu coroutines ..", scheduler->inbox_waiting);
+
+    // wait the posted messages
+    if (tb_semaphore_wait(scheduler->inbox_event, -1) < 0) return tb_false;
+
+    // resume the coroutines and call the functions
+    tb_co_scheduler_inbox_spak(scheduler);
+    return tb_true;
+}
+tb_size_t tb_co_scheduler_inbox_spak(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert(scheduler);
+
+    // no messages?
+    tb_check_return_val(scheduler->inbox, 0);
+
+    // take all messages
+    tb_co_scheduler_message_t* message = (tb_co_scheduler_message_t*)tb_atomic_fetch_and_set(&scheduler->inbox, 0);
+
+    // reverse them to the posted order
+    tb_co_scheduler_message_t* list = tb_null;
+    while (message)
+    {
+        tb_co_scheduler_message_t* next = message->next;
+        message->next = list;
+        list = message;
+        message = next;
+    }
+
+    // handle messages
+    tb_size_t count = 0;
+    while (list)
+    {
+        // get message
+        message = list;
+        list = list->next;
+
+        // resume the suspended coroutine or call the function
+        if (message->coroutine) tb_co_scheduler_resume(scheduler, message->coroutine, message->priv);
+        else message->func(message->priv);
+
+        // exit message
+        tb_free(message);
+        count++;
+    }
+
+    // trace
+    tb_trace_d("inbox: %lu messages", count);
+
+    // ok
+    return count;
+}
+tb_void_t tb_co_scheduler_inbox_exit(tb_co_scheduler_t* scheduler)
+{
+    // check
+    tb_assert_and_check_return(scheduler);
+
+    // free all unhandled messages
+    tb_co_scheduler_message_t* message = (tb_co_scheduler_message_t*)tb_atomic_fetch_and_set(&scheduler->inbox, 0);
+    while (message)
+    {
+        tb_co_scheduler_message_t* next = message->next;
+        tb_free(message);
+        message = next;
+    }
+
+    // exit the inbox event
+    if (scheduler->inbox_event) tb_semaphore_exit(scheduler->inbox_event);
+    scheduler->inbox_event = tb_null;
+}
@@ -31,6 +31,8 @@
  */
 #include "prefix.h"
 #include "coroutine.h"
+#include "stack.h"
+#include "profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -53,6 +55,9 @@ __tb_extern_c_enter__
 // get the io scheduler
 #define tb_co_scheduler_io(scheduler)                  ((scheduler)->scheduler_io)
 
+// get the stack pool
+#define tb_co_scheduler_stack_pool(scheduler)          ((scheduler)->stack_pool)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -60,6 +65,47 @@ __tb_extern_c_enter__
 // the io scheduler type
 struct __tb_co_scheduler_io_t;
 
+// the scheduler worker type
+struct __tb_co_scheduler_worker_t;
+
+/* the inbox message type
+ *
+ * it is posted from the other threads to resume the suspended coroutine or run the function
+ */
+typedef struct __tb_co_scheduler_message_t
+{
+    // the next message
+    struct __tb_co_scheduler_message_t* next;
+
+    // the suspended coroutine to be resumed, null if it is a function
+    tb_coroutine_t*                     coroutine;
+
+    // the function
+    tb_co_scheduler_post_func_t         func;
+
+    // the user private data as the argument of function or the return value of suspend()
+    tb_cpointer_t                       priv;
+
+}tb_co_scheduler_message_t;
+
+/* the shared stack type
+ *
+ * only the coroutine which occupies this stack keeps its stack data here,
+ * and the other coroutines have been saved to their buffers
+ */
+typedef struct __tb_co_shared_stack_t
+{
+    // the stack data (bottom)
+    tb_byte_t*                      data;
+
+    // the stack size
+    tb_size_t                       size;
+
+    // the coroutine which occupies this stack now
+    tb_coroutine_t*                 occupy;
+
+}tb_co_shared_stack_t;
+
 // the scheduler type
 typedef struct __tb_co_scheduler_t
 {   
@@ -78,6 +124,27 @@ typedef struct __tb_co_scheduler_t
     // the io scheduler
     struct __tb_co_scheduler_io_t*  scheduler_io;
 
+    // the worker of the scheduler group, only for the multi-threaded mode
+    struct __tb_co_scheduler_worker_t* worker;
+
+    // the stack pool
+    tb_co_stack_pool_ref_t          stack_pool;
+
+    // the shared stacks, only for the shared-stack mode
+    tb_co_shared_stack_t*           shared_stacks;
+
+    // the shared stacks count
+    tb_size_t                       shared_count;
+
+    // the next shared stack index for the new coroutine
+    tb_size_t                       shared_index;
+
+    /* the switcher coroutine with the private stack, only for the shared-stack mode
+     *
+     * it will save and restore the shared stack data, because we cannot copy them on the same stack
+     */
+    tb_coroutine_t*                 switcher;
+
     // the dead coroutines
     tb_list_entry_head_t            coroutines_dead;
 
@@ -92,6 +159,26 @@ typedef struct __tb_co_scheduler_t
     // the suspend coroutines
     tb_list_entry_head_t            coroutines_suspend;
 
+    /* the inbox of the posted messages from the other threads
+     *
+     * it is a lock-free stack (multi-producers and single-consumer),
+     * and the io loop takes all messages at once and handles them in order
+     */
+    tb_atomic_t                     inbox;
+
+    /* the inbox event to wake up the main loop if there is no io loop
+     *
+     * it is inited lazily when the coroutine waits the channel at first,
+     * so the plain channel waits need not start the io scheduler
+     */
+    tb_semaphore_ref_t              inbox_event;
+
+    // the count of the suspended coroutines which are waiting to be resumed from the inbox
+    tb_size_t                       inbox_waiting;
+
+    // the profiler, null if it is disabled
+    tb_co_profiler_t*               profiler;
+
 }tb_co_scheduler_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -169,6 +256,71 @@ tb_void_t                   tb_co_scheduler_switch(tb_co_scheduler_t* scheduler,
  */
 tb_long_t                   tb_co_scheduler_wait(tb_co_scheduler_t* scheduler, tb_socket_ref_t sock, tb_size_t events, tb_long_t timeout);
 
+/*! get the io scheduler of the current coroutine, it will be inited if not exists
+ *
+ * @param scheduler         the scheduler
+ *
+ * @return                  the io scheduler, null if the scheduler have been stopped
+ */
+struct __tb_co_scheduler_io_t* tb_co_scheduler_io_need(tb_co_scheduler_t* scheduler);
+
+/* post a message to the inbox of the scheduler from any thread (thread-safe)
+ *
+ * @param scheduler         the scheduler
+ * @param coroutine         the suspended coroutine to be resumed, null if it is a function
+ * @param func              the function
+ * @param priv              the user private data
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_inbox_post(tb_co_scheduler_t* scheduler, tb_coroutine_t* coroutine, tb_co_scheduler_post_func_t func, tb_cpointer_t priv);
+
+/* init the inbox event to resume the suspended coroutines from the other threads without the io loop
+ *
+ * @param scheduler         the scheduler
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_inbox_need(tb_co_scheduler_t* scheduler);
+
+/* wait and handle the posted messages in the main loop if there are no ready coroutines and no io loop
+ *
+ * @param scheduler         the scheduler
+ *
+ * @return                  tb_true if it has been waked up, tb_false if there are no coroutines waiting the inbox
+ */
+tb_bool_t                   tb_co_scheduler_inbox_wait(tb_co_scheduler_t* scheduler);
+
+/* handle all posted messages in the inbox, only be called in the scheduler thread
+ *
+ * @param scheduler         the scheduler
+ *
+ * @return                  the handled messages count
+ */
+tb_size_t                   tb_co_scheduler_inbox_spak(tb_co_scheduler_t* scheduler);
+
+/* exit the inbox and drop all unhandled messages
+ *
+ * @param scheduler         the scheduler
+ */
+tb_void_t                   tb_co_scheduler_inbox_exit(tb_co_scheduler_t* scheduler);
+
+/* init the shared stacks and enable the shared-stack mode
+ *
+ * @param scheduler         the scheduler
+ * @param stackcount        the shared stacks count
+ * @param stacksize         the shared stack size
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_shared_init(tb_co_scheduler_t* scheduler, tb_size_t stackcount, tb_size_t stacksize);
+
+/* exit the shared stacks
+ *
+ * @param scheduler         the scheduler
+ */
+tb_void_t                   tb_co_scheduler_shared_exit(tb_co_scheduler_t* scheduler);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
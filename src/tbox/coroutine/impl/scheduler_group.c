@@ -0,0 +1,227 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_group.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "scheduler_group"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "scheduler_group.h"
+#include "scheduler_io.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum count of the pulled or stolen tasks at once
+#ifdef __tb_small__
+#   define TB_SCHEDULER_WORKER_PULL_MAXN    (16)
+#else
+#   define TB_SCHEDULER_WORKER_PULL_MAXN    (64)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_co_scheduler_worker_entry(tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_task_t* task = (tb_co_scheduler_task_t*)priv;
+    tb_assert_and_check_return(task && task->group && task->func);
+
+    // save the task arguments
+    tb_co_scheduler_group_t*    group = task->group;
+    tb_coroutine_func_t         func = task->func;
+    tb_cpointer_t               func_priv = task->priv;
+
+    // exit task
+    tb_free(task);
+
+    // call the coroutine function
+    func(func_priv);
+
+    // all group coroutines have been finished? spak all workers to exit loop
+    if (!tb_atomic_dec_and_fetch(&group->alive))
+    {
+        // trace
+        tb_trace_d("all coroutines have been finished!");
+
+        // spak all workers
+        tb_size_t i = 0;
+        for (i = 0; i < group->count; i++)
+        {
+            tb_co_scheduler_t* scheduler = group->workers[i].scheduler;
+            if (scheduler && scheduler->scheduler_io && scheduler->scheduler_io->poller)
+                tb_poller_spak(scheduler->scheduler_io->poller);
+        }
+    }
+}
+static tb_size_t tb_co_scheduler_worker_take(tb_co_scheduler_worker_t* worker, tb_co_scheduler_task_t** tasks, tb_size_t maxn, tb_bool_t steal)
+{
+    // check
+    tb_assert(worker && tasks && maxn);
+
+    // try to enter lock, we need not wait it if steal tasks from the other workers
+    if (steal)
+    {
+        if (!tb_spinlock_enter_try(&worker->lock)) return 0;
+    }
+    else tb_spinlock_enter(&worker->lock);
+
+    // the pending count
+    tb_size_t size = tb_single_list_entry_size(&worker->pending);
+
+    // only steal the half of tasks
+    if (steal) size = (size + 1) >> 1;
+    if (size > maxn) size = maxn;
+
+    // take tasks from the head
+    tb_size_t count = 0;
+    while (count < size)
+    {
+        // get the next entry from head
+        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&worker->pending);
+        tb_assert_and_check_break(entry);
+
+        // remove it from the pending tasks
+        tb_single_list_entry_remove_head(&worker->pending);
+
+        // save this task
+        tasks[count++] = (tb_co_scheduler_task_t*)tb_single_list_entry0(entry);
+    }
+
+    // leave lock
+    tb_spinlock_leave(&worker->lock);
+
+    // ok?
+    return count;
+}
+static tb_size_t tb_co_scheduler_worker_take_all(tb_co_scheduler_worker_t* worker, tb_co_scheduler_task_t** tasks, tb_size_t maxn)
+{
+    // check
+    tb_assert(worker && worker->group && tasks && maxn);
+
+    // take the pending tasks from this worker first
+    tb_size_t count = tb_co_scheduler_worker_take(worker, tasks, maxn, tb_false);
+    tb_check_return_val(!count, count);
+
+    /* steal tasks from the other workers
+     *
+     * the pinned worker steals from the workers on the same numa node at the first pass,
+     * and the other nodes will be stolen only if the local node has no tasks.
+     */
+    tb_co_scheduler_group_t* group = worker->group;
+    tb_size_t i = 1;
+    tb_size_t pass = group->pinned? 0 : 1;
+    for (; pass < 2 && !count; pass++)
+    {
+        for (i = 1; i < group->count && !count; i++)
+        {
+            tb_co_scheduler_worker_t* other = &group->workers[(worker->index + i) % group->count];
+            if (!group->pinned || (other->node == worker->node) == !pass)
+                count = tb_co_scheduler_worker_take(other, tasks, maxn, tb_true);
+        }
+    }
+
+    // trace
+    tb_trace_d("worker(%lu): steal %lu tasks", worker->index, count);
+
+    // ok?
+    return count;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_size_t tb_co_scheduler_worker_pull(tb_co_scheduler_worker_t* worker)
+{
+    // check
+    tb_assert(worker && worker->group && worker->scheduler);
+
+    // have been stopped?
+    tb_co_scheduler_group_t* group = worker->group;
+    tb_check_return_val(!tb_atomic_get(&group->stopped), 0);
+
+    // take tasks
+    tb_co_scheduler_task_t* tasks[TB_SCHEDULER_WORKER_PULL_MAXN];
+    tb_size_t count = tb_co_scheduler_worker_take_all(worker, tasks, tb_arrayn(tasks));
+    if (!count)
+    {
+        /* mark this worker as idle first and try to take tasks again
+         *
+         * we need ensure that the new posted tasks will spak this worker if it is waiting now
+         */
+        tb_atomic_set(&worker->idle, 1);
+        count = tb_co_scheduler_worker_take_all(worker, tasks, tb_arrayn(tasks));
+        tb_check_return_val(count, 0);
+
+        // be busy now
+        tb_atomic_set0(&worker->idle);
+    }
+
+    // start all tasks
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        // start it
+        tb_co_scheduler_task_t* task = tasks[i];
+        if (!tb_co_scheduler_start(worker->scheduler, tb_co_scheduler_worker_entry, task, task->stacksize))
+        {
+            // trace
+            tb_trace_e("worker(%lu): start coroutine failed!", worker->index);
+
+            // exit this task
+            tb_free(task);
+            tb_atomic_fetch_and_dec(&group->alive);
+        }
+    }
+
+    // trace
+    tb_trace_d("worker(%lu): pull %lu tasks", worker->index, count);
+
+    // ok
+    return count;
+}
+tb_void_t tb_co_scheduler_worker_busy(tb_co_scheduler_worker_t* worker)
+{
+    // check
+    tb_assert(worker);
+
+    // mark this worker as busy
+    tb_atomic_set0(&worker->idle);
+}
+tb_bool_t tb_co_scheduler_worker_alive(tb_co_scheduler_worker_t* worker)
+{
+    // check
+    tb_assert(worker && worker->group);
+
+    // exists the alive coroutines?
+    return !tb_atomic_get(&worker->group->stopped) && tb_atomic_get(&worker->group->alive) > 0;
+}
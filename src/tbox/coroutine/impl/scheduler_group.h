@@ -0,0 +1,152 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_group.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_SCHEDULER_GROUP_H
+#define TB_COROUTINE_IMPL_SCHEDULER_GROUP_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "scheduler.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the scheduler group type
+struct __tb_co_scheduler_group_t;
+
+// the pending coroutine task type
+typedef struct __tb_co_scheduler_task_t
+{
+    // the list entry
+    tb_single_list_entry_t              entry;
+
+    // the group
+    struct __tb_co_scheduler_group_t*   group;
+
+    // the coroutine function
+    tb_coroutine_func_t                 func;
+
+    // the user private data as the argument of function
+    tb_cpointer_t                       priv;
+
+    // the stack size
+    tb_size_t                           stacksize;
+
+}tb_co_scheduler_task_t;
+
+// the scheduler worker type
+typedef struct __tb_co_scheduler_worker_t
+{
+    // the group
+    struct __tb_co_scheduler_group_t*   group;
+
+    // the scheduler of this worker
+    tb_co_scheduler_t*                  scheduler;
+
+    // the worker thread, the first worker is run in the thread of tb_co_scheduler_group_loop()
+    tb_thread_ref_t                     thread;
+
+    // the worker index
+    tb_size_t                           index;
+
+    // the numa node of the pinned worker
+    tb_size_t                           node;
+
+    // is idle? waiting io events in poller now
+    tb_atomic_t                         idle;
+
+    // the lock of the pending tasks
+    tb_spinlock_t                       lock;
+
+    // the pending tasks, the other idle workers may steal them
+    tb_single_list_entry_head_t         pending;
+
+}tb_co_scheduler_worker_t;
+
+// the scheduler group type
+typedef struct __tb_co_scheduler_group_t
+{
+    // is stopped?
+    tb_atomic_t                         stopped;
+
+    // the alive count of the pending and running coroutines
+    tb_atomic_t                         alive;
+
+    // the next worker index for posting tasks from the other threads
+    tb_atomic_t                         next;
+
+    // the worker count
+    tb_size_t                           count;
+
+    // pin one worker per physical core?
+    tb_bool_t                           pinned;
+
+    // the workers
+    tb_co_scheduler_worker_t*           workers;
+
+}tb_co_scheduler_group_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* pull the pending tasks from the given worker or steal them from the other workers and start them
+ *
+ * the worker will be marked as idle if no pending tasks
+ *
+ * @param worker            the worker
+ *
+ * @return                  the started coroutines count
+ */
+tb_size_t                   tb_co_scheduler_worker_pull(tb_co_scheduler_worker_t* worker);
+
+/* mark the given worker as busy after waiting io events
+ *
+ * @param worker            the worker
+ */
+tb_void_t                   tb_co_scheduler_worker_busy(tb_co_scheduler_worker_t* worker);
+
+/* exists the alive coroutines in the group of the given worker?
+ *
+ * @param worker            the worker
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_worker_alive(tb_co_scheduler_worker_t* worker);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
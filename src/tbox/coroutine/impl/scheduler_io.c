@@ -34,22 +34,22 @@
  * includes
  */
 #include "scheduler_io.h"
+#include "scheduler_io_uring.h"
+#include "scheduler_group.h"
 #include "coroutine.h"
+#include "select.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
-
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -63,15 +63,8 @@ static tb_void_t tb_co_scheduler_io_resume(tb_co_scheduler_t* scheduler, tb_coro
         tb_co_scheduler_io_ref_t scheduler_io = tb_co_scheduler_io(scheduler);
         tb_assert(scheduler_io && scheduler_io->poller);
 
-        // is high-precision timer?
-        tb_size_t is_timer = (tb_size_t)(task) & 0x1;
-
-        // check
-        tb_assert((tb_size_t)task & (tb_size_t)~0x1);
-
         // remove the timer task
-        if (__tb_unlikely__(is_timer)) tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)((tb_size_t)task & (tb_size_t)~0x1));
-        else tb_ltimer_task_exit(scheduler_io->ltimer, (tb_ltimer_task_ref_t)task);
+        tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
         coroutine->rs.wait.task = tb_null;
     }
 
@@ -99,10 +92,25 @@ static tb_void_t tb_co_scheduler_io_timeout(tb_bool_t killed, tb_cpointer_t priv
 }
 static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_socket_ref_t sock, tb_size_t events, tb_cpointer_t priv)
 {
+    // the io_uring completions? reap them and resume the waiting coroutines
+    if (!priv)
+    {
+        tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)tb_poller_priv(poller);
+        if (scheduler_io && scheduler_io->uring) tb_co_scheduler_io_uring_spak(scheduler_io->uring);
+        return ;
+    }
+
     // check
     tb_coroutine_t* coroutine = (tb_coroutine_t*)priv;
     tb_assert(coroutine && poller && sock && priv);
 
+    // the coroutine is waiting in select()? notify it
+    if (coroutine->select)
+    {
+        tb_co_select_spak(coroutine->select, sock, events);
+        return ;
+    }
+
     // get scheduler
     tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_coroutine_scheduler(coroutine);
     tb_assert(scheduler);
@@ -114,41 +122,43 @@ static tb_void_t tb_co_scheduler_io_events(tb_poller_ref_t poller, tb_socket_ref
     if (coroutine->rs.wait.waiting)
     {
         // eof for edge trigger?
+        tb_size_t events_wait = coroutine->rs.wait.events;
         if (events & TB_POLLER_EVENT_EOF)
         {
             // cache this eof as next recv/send event
             events &= ~TB_POLLER_EVENT_EOF;
-            coroutine->rs.wait.events_cache |= coroutine->rs.wait.events;
+            events |= events_wait;
+            coroutine->rs.wait.events_cache |= events_wait;
         }
 
-        // resume the coroutine and pass the events to suspend()
-        tb_co_scheduler_io_resume(scheduler, coroutine, (tb_cpointer_t)events);
+        /* cache the other events which are not waited now, e.g. the send event when waiting recv,
+         * because the socket is registered with all events and we will not get this edge again
+         */
+        coroutine->rs.wait.events_cache |= events & ~events_wait;
+
+        // resume the coroutine and pass the waited events to suspend()
+        events &= events_wait;
+        if (events) tb_co_scheduler_io_resume(scheduler, coroutine, (tb_cpointer_t)events);
     }
-    // cache this events
-    else coroutine->rs.wait.events_cache = events;
+    // cache this events, the eof will be the next recv/send event
+    else coroutine->rs.wait.events_cache |= (events & TB_POLLER_EVENT_EOF)? TB_POLLER_EVENT_EALL : (events & TB_POLLER_EVENT_EALL);
 }
 static tb_bool_t tb_co_scheduler_io_timer_spak(tb_co_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
-
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
-
-    // pk
-    return tb_true;
+    return tb_timer_spak(scheduler_io->timer);
 }
 static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
 {
     // check
     tb_co_scheduler_io_ref_t scheduler_io = (tb_co_scheduler_io_ref_t)priv;
-    tb_assert_and_check_return(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert_and_check_return(scheduler_io && scheduler_io->timer);
 
     // the scheduler
     tb_co_scheduler_t* scheduler = scheduler_io->scheduler;
@@ -158,6 +168,9 @@ static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
     tb_poller_ref_t poller = scheduler_io->poller;
     tb_assert_and_check_return(poller);
 
+    // the worker of the scheduler group
+    tb_co_scheduler_worker_t* worker = scheduler->worker;
+
     // loop
     while (!scheduler->stopped)
     {
@@ -168,20 +181,37 @@ static tb_void_t tb_co_scheduler_io_loop(tb_cpointer_t priv)
             if (!tb_co_scheduler_io_timer_spak(scheduler_io)) break;
         }
 
+        // resume the coroutines and call the functions posted from the other threads
+        if (tb_co_scheduler_inbox_spak(scheduler)) continue;
+
+        // submit all queued io_uring requests at once and reap the finished completions
+        if (scheduler_io->uring)
+        {
+            if (tb_co_scheduler_io_uring_submit(scheduler_io->uring) < 0) break;
+            if (tb_co_scheduler_io_uring_spak(scheduler_io->uring)) continue;
+        }
+
+        // be idle now? start the pending coroutines of the group or steal them from the other workers
+        if (worker && tb_co_scheduler_worker_pull(worker)) continue;
+
         // no more suspended coroutines? loop end
-        tb_check_break(tb_co_scheduler_suspend_count(scheduler));
+        if (!tb_co_scheduler_suspend_count(scheduler))
+        {
+            // we need wait the new coroutines if the group is alive
+            if (!worker || !tb_co_scheduler_worker_alive(worker)) break;
+        }
 
         // the delay
         tb_size_t delay = tb_timer_delay(scheduler_io->timer);
 
-        // the ldelay
-        tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
-
         // trace
-        tb_trace_d("loop: wait %lu ms ..", tb_min(delay, ldelay));
+        tb_trace_d("loop: wait %lu ms ..", delay);
 
         // no more ready coroutines? wait io events and timers
-        if (tb_poller_wait(poller, tb_co_scheduler_io_events, tb_min(delay, ldelay)) < 0) break;
+        if (tb_poller_wait(poller, tb_co_scheduler_io_events, delay) < 0) break;
+
+        // mark this worker as busy
+        if (worker) tb_co_scheduler_worker_busy(worker);
 
         // spak timer
         if (!tb_co_scheduler_io_timer_spak(scheduler_io)) break;
@@ -209,14 +239,22 @@ tb_co_scheduler_io_ref_t tb_co_scheduler_io_init(tb_co_scheduler_t* scheduler)
         scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
 
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
-
         // init poller
-        scheduler_io->poller = tb_poller_init(tb_null);
+        scheduler_io->poller = tb_poller_init(scheduler_io);
         tb_assert_and_check_break(scheduler_io->poller);
 
+        /* init io_uring and wait its completions in the poller, uses the poller only if it is not supported
+         *
+         * the shared-stack mode cannot use it, because the kernel may access the buffers on the stack
+         * after the stack data has been swapped out by the other coroutines
+         */
+        if (!scheduler_io->scheduler->shared_count) scheduler_io->uring = tb_co_scheduler_io_uring_init(scheduler_io);
+        if (scheduler_io->uring && !tb_poller_insert(scheduler_io->poller, tb_co_scheduler_io_uring_sock(scheduler_io->uring), TB_POLLER_EVENT_RECV, tb_null))
+        {
+            tb_co_scheduler_io_uring_exit(scheduler_io->uring);
+            scheduler_io->uring = tb_null;
+        }
+
         // start the io loop coroutine
         if (!tb_co_scheduler_start(scheduler_io->scheduler, tb_co_scheduler_io_loop, scheduler_io, 0)) break;
 
@@ -245,14 +283,14 @@ tb_void_t tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t scheduler_io)
     if (scheduler_io->poller) tb_poller_exit(scheduler_io->poller);
     scheduler_io->poller = tb_null;
 
+    // exit io_uring
+    if (scheduler_io->uring) tb_co_scheduler_io_uring_exit(scheduler_io->uring);
+    scheduler_io->uring = tb_null;
+
     // exit timer
     if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
 
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
-
     // clear scheduler
     scheduler_io->scheduler = tb_null;
 
@@ -270,12 +308,17 @@ tb_void_t tb_co_scheduler_io_kill(tb_co_scheduler_io_ref_t scheduler_io)
     // kill timer
     if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
 
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
-
     // kill poller
     if (scheduler_io->poller) tb_poller_kill(scheduler_io->poller);
 }
+tb_void_t tb_co_scheduler_io_spak(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // check
+    tb_assert_and_check_return(scheduler_io);
+
+    // spak poller
+    if (scheduler_io->poller) tb_poller_spak(scheduler_io->poller);
+}
 tb_pointer_t tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t scheduler_io, tb_long_t interval)
 {
     // check
@@ -294,18 +337,8 @@ tb_pointer_t tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t scheduler_io, tb_
     // infinity?
     if (interval > 0)
     {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
-        }
+        // post task to timer
+        tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_co_scheduler_io_timeout, coroutine);
     }
 
     // suspend it
@@ -323,28 +356,36 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_sock
     // trace
     tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for socket(%p) ..", coroutine, events, timeout, sock);
 
-    // enable edge-trigger mode if be supported
-    if (tb_poller_support(scheduler_io->poller, TB_POLLER_EVENT_CLEAR))
-        events |= TB_POLLER_EVENT_CLEAR;
+    /* register the socket only once with all events in the edge-trigger mode if be supported,
+     * and we only track the waited events here, so we need not modify it when the waited events are changed
+     */
+    tb_poller_ref_t poller      = scheduler_io->poller;
+    tb_size_t       events_wait = events & TB_POLLER_EVENT_EALL;
+    tb_size_t       events_poll = events_wait;
+    if (tb_poller_support(poller, TB_POLLER_EVENT_CLEAR))
+        events_poll = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR;
+
+    // wake only one of the schedulers if this listening socket is shared by multiple threads
+    if ((events & TB_POLLER_EVENT_EXCLUSIVE) && tb_poller_support(poller, TB_POLLER_EVENT_EXCLUSIVE))
+        events_poll |= TB_POLLER_EVENT_EXCLUSIVE;
 
-    // exists this socket? only modify events 
+    // exists this socket? 
     tb_socket_ref_t sock_prev = coroutine->rs.wait.sock;
     if (sock_prev == sock)
     {
         // return the cached events directly if the waiting events exists cache
-        tb_size_t events_prev   = coroutine->rs.wait.events;
-        tb_size_t events_cache  = coroutine->rs.wait.events_cache;
-        if (events_cache && (events_prev & events))
+        tb_size_t events_cache = coroutine->rs.wait.events_cache;
+        if (events_cache & events_wait)
         {
             // clear cache events
-            coroutine->rs.wait.events_cache &= ~events;
+            coroutine->rs.wait.events_cache &= ~events_wait;
 
             // return the cached events
-            return events_cache & events;
+            return events_cache & events_wait;
         }
 
-        // modify socket from poller for waiting events if the waiting events has been changed 
-        if (events_prev != events && !tb_poller_modify(scheduler_io->poller, sock, events, coroutine))
+        // modify socket from poller for waiting events if it is not registered with all events
+        if (!(events_poll & TB_POLLER_EVENT_CLEAR) && coroutine->rs.wait.events != events_wait && !tb_poller_modify(poller, sock, events_poll, coroutine))
         {
             // trace
             tb_trace_e("failed to modify sock(%p) to poller on coroutine(%p)!", sock, coroutine);
@@ -356,7 +397,7 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_sock
     else
     {
         // remove the previous socket first if exists
-        if (sock_prev && !tb_poller_remove(scheduler_io->poller, sock_prev))
+        if (sock_prev && !tb_poller_remove(poller, sock_prev))
         {
             // trace
             tb_trace_e("failed to remove sock(%p) to poller on coroutine(%p)!", sock_prev, coroutine);
@@ -366,7 +407,7 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_sock
         }
 
         // insert socket to poller for waiting events
-        if (!tb_poller_insert(scheduler_io->poller, sock, events, coroutine))
+        if (!tb_poller_insert(poller, sock, events_poll, coroutine))
         {
             // trace
             tb_trace_e("failed to insert sock(%p) to poller on coroutine(%p)!", sock, coroutine);
@@ -374,44 +415,28 @@ tb_long_t tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t scheduler_io, tb_sock
             // failed
             return -1;
         }
+
+        // clear the cached events of the previous socket
+        coroutine->rs.wait.events_cache = 0;
     }
 
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
-    // check
-    tb_assert(!((tb_size_t)(task) & 0x1));
-
     // save the timer task to coroutine
-    coroutine->rs.wait.task = (is_ltimer || !task)? task : (tb_cpointer_t)((tb_size_t)(task) | 0x1);
+    coroutine->rs.wait.task = task;
 
     // save the socket to coroutine for the timer function
     coroutine->rs.wait.sock = sock;
 
     // save waiting events to coroutine
-    coroutine->rs.wait.events        = (tb_uint16_t)events;
-    coroutine->rs.wait.events_cache  = 0;
+    coroutine->rs.wait.events        = (tb_uint16_t)events_wait;
 
     // mark as waiting state
     coroutine->rs.wait.waiting       = 1;
@@ -444,6 +469,11 @@ tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_so
             return tb_false;
         }
 
+        // clear the waited socket, it will be inserted again if the next socket has the same fd
+        coroutine->rs.wait.sock         = tb_null;
+        coroutine->rs.wait.events       = 0;
+        coroutine->rs.wait.events_cache = 0;
+
         // remove ok
         return tb_true;
     }
@@ -451,6 +481,92 @@ tb_bool_t tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_so
     // no this socket
     return tb_false;
 }
+tb_long_t tb_co_scheduler_io_recv(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && sock && data);
+
+    // recv it with only one kernel crossing if io_uring is supported
+    if (scheduler_io->uring) return tb_co_scheduler_io_uring_recv(scheduler_io->uring, sock, data, size, timeout);
+
+    // recv it and wait the readiness events
+    tb_long_t real = 0;
+    while (!(real = tb_socket_recv(sock, data, size)))
+    {
+        tb_long_t wait = tb_co_scheduler_io_wait(scheduler_io, sock, TB_SOCKET_EVENT_RECV, timeout);
+        tb_check_return_val(wait > 0, wait);
+    }
+    return real;
+}
+tb_long_t tb_co_scheduler_io_send(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && sock && data);
+
+    // send it with only one kernel crossing if io_uring is supported
+    if (scheduler_io->uring) return tb_co_scheduler_io_uring_send(scheduler_io->uring, sock, data, size, timeout);
+
+    // send it and wait the readiness events
+    tb_long_t real = 0;
+    while (!(real = tb_socket_send(sock, data, size)))
+    {
+        tb_long_t wait = tb_co_scheduler_io_wait(scheduler_io, sock, TB_SOCKET_EVENT_SEND, timeout);
+        tb_check_return_val(wait > 0, wait);
+    }
+    return real;
+}
+tb_socket_ref_t tb_co_scheduler_io_accept(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && sock);
+
+    // accept it with only one kernel crossing if io_uring is supported
+    if (scheduler_io->uring) return tb_co_scheduler_io_uring_accept(scheduler_io->uring, sock, addr, timeout);
+
+    // accept it and wait the readiness events
+    tb_socket_ref_t client = tb_null;
+    while (!(client = tb_socket_accept(sock, addr)))
+    {
+        /* we will accept all pending clients after being woken up once, 
+         * and only one scheduler will be woken up if this listener is shared by multiple threads
+         */
+        tb_check_break(tb_co_scheduler_io_wait(scheduler_io, sock, TB_SOCKET_EVENT_ACPT | TB_POLLER_EVENT_EXCLUSIVE, timeout) > 0);
+    }
+    return client;
+}
+tb_long_t tb_co_scheduler_io_connect(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_assert(scheduler_io && sock && addr);
+
+    // connect it with only one kernel crossing if io_uring is supported
+    if (scheduler_io->uring) return tb_co_scheduler_io_uring_connect(scheduler_io->uring, sock, addr, timeout);
+
+    // connect it and wait the readiness events
+    tb_long_t ok = 0;
+    while (!(ok = tb_socket_connect(sock, addr)))
+    {
+        tb_long_t wait = tb_co_scheduler_io_wait(scheduler_io, sock, TB_SOCKET_EVENT_CONN, timeout);
+        tb_check_return_val(wait > 0, wait);
+    }
+    return ok;
+}
+tb_long_t tb_co_scheduler_io_pread(tb_co_scheduler_io_ref_t scheduler_io, tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert(scheduler_io && file && data);
+
+    // read it without blocking the other coroutines if io_uring is supported
+    return scheduler_io->uring? tb_co_scheduler_io_uring_pread(scheduler_io->uring, file, data, size, offset) : tb_file_pread(file, data, size, offset);
+}
+tb_long_t tb_co_scheduler_io_pwrit(tb_co_scheduler_io_ref_t scheduler_io, tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_assert(scheduler_io && file && data);
+
+    // writ it without blocking the other coroutines if io_uring is supported
+    return scheduler_io->uring? tb_co_scheduler_io_uring_pwrit(scheduler_io->uring, file, data, size, offset) : tb_file_pwrit(file, data, size, offset);
+}
 tb_co_scheduler_io_ref_t tb_co_scheduler_io_self()
 {
     // get the current scheduler
@@ -40,6 +40,9 @@ __tb_extern_c_enter__
  * types
  */
 
+// the io_uring type
+struct __tb_co_scheduler_io_uring_t;
+
 // the io scheduler type
 typedef struct __tb_co_scheduler_io_t
 {
@@ -52,11 +55,11 @@ typedef struct __tb_co_scheduler_io_t
     // the poller
     tb_poller_ref_t     poller;
 
-    // the timer
+    // the timer, it uses the hierarchical timing wheels for both the sleep and the io timeout
     tb_timer_ref_t      timer;
 
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
+    // the io_uring for the completion-based io, it will be null if not be supported
+    struct __tb_co_scheduler_io_uring_t* uring;
 
 }tb_co_scheduler_io_t, *tb_co_scheduler_io_ref_t;
 
@@ -82,6 +85,12 @@ tb_void_t                   tb_co_scheduler_io_exit(tb_co_scheduler_io_ref_t sch
  */
 tb_void_t                   tb_co_scheduler_io_kill(tb_co_scheduler_io_ref_t scheduler_io);
 
+/* spak the io scheduler from any thread (thread-safe), it will wake up the waiting io loop
+ *
+ * @param scheduler_io      the io scheduler
+ */
+tb_void_t                   tb_co_scheduler_io_spak(tb_co_scheduler_io_ref_t scheduler_io);
+
 /* sleep the current coroutine
  *
  * @param scheduler_io      the io scheduler
@@ -95,7 +104,7 @@ tb_pointer_t                tb_co_scheduler_io_sleep(tb_co_scheduler_io_ref_t sc
  *
  * @param scheduler_io      the io scheduler
  * @param sock              the socket
- * @param events            the waited events
+ * @param events            the waited events, the shared listening socket can also pass TB_POLLER_EVENT_EXCLUSIVE
  * @param timeout           the timeout, infinity: -1
  *
  * @return                  > 0: the events, 0: timeout, -1: failed
@@ -111,6 +120,76 @@ tb_long_t                   tb_co_scheduler_io_wait(tb_co_scheduler_io_ref_t sch
  */
 tb_bool_t                   tb_co_scheduler_io_cancel(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock);
 
+/*! recv data from the socket
+ *
+ * @param scheduler_io      the io scheduler
+ * @param sock              the socket
+ * @param data              the data
+ * @param size              the size
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t                   tb_co_scheduler_io_recv(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout);
+
+/*! send data to the socket
+ *
+ * @param scheduler_io      the io scheduler
+ * @param sock              the socket
+ * @param data              the data
+ * @param size              the size
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t                   tb_co_scheduler_io_send(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout);
+
+/*! accept the client socket
+ *
+ * @param scheduler_io      the io scheduler
+ * @param sock              the listening socket
+ * @param addr              the client address, optional
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  the client socket, null: timeout or failed
+ */
+tb_socket_ref_t             tb_co_scheduler_io_accept(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/*! connect the given address
+ *
+ * @param scheduler_io      the io scheduler
+ * @param sock              the socket
+ * @param addr              the address
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  1: ok, 0: timeout, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_connect(tb_co_scheduler_io_ref_t scheduler_io, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/*! read the file data at the given offset
+ *
+ * @param scheduler_io      the io scheduler
+ * @param file              the file
+ * @param data              the data
+ * @param size              the size
+ * @param offset            the offset
+ *
+ * @return                  >= 0: the real size, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_pread(tb_co_scheduler_io_ref_t scheduler_io, tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset);
+
+/*! writ the file data at the given offset
+ *
+ * @param scheduler_io      the io scheduler
+ * @param file              the file
+ * @param data              the data
+ * @param size              the size
+ * @param offset            the offset
+ *
+ * @return                  >= 0: the real size, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_pwrit(tb_co_scheduler_io_ref_t scheduler_io, tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset);
+
 /* get the current io scheduler
  *
  * @return                  the io scheduler
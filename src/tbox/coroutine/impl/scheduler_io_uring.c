@@ -0,0 +1,739 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_io_uring.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "scheduler_io_uring"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "scheduler_io_uring.h"
+#include "coroutine.h"
+#include "../../algorithm/algorithm.h"
+#ifdef TB_CONFIG_POSIX_HAVE_IO_URING_SETUP
+#   include "../../platform/posix/sockaddr.h"
+#   include <errno.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/socket.h>
+#   include <sys/syscall.h>
+#   include <linux/io_uring.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the entries count of the submission queue
+#ifdef __tb_small__
+#   define TB_SCHEDULER_IO_URING_MAXN       (64)
+#else
+#   define TB_SCHEDULER_IO_URING_MAXN       (1024)
+#endif
+
+#ifdef TB_CONFIG_POSIX_HAVE_IO_URING_SETUP
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the io_uring type
+typedef struct __tb_co_scheduler_io_uring_t
+{
+    // the io scheduler
+    tb_co_scheduler_io_ref_t        scheduler_io;
+
+    // the io_uring fd
+    tb_int_t                        fd;
+
+    // the single mmap for the submission and completion queues?
+    tb_bool_t                       single;
+
+    // the submission queue ring
+    tb_pointer_t                    sq_ring;
+    tb_size_t                       sq_ring_size;
+
+    // the completion queue ring
+    tb_pointer_t                    cq_ring;
+    tb_size_t                       cq_ring_size;
+
+    // the submission queue entries
+    struct io_uring_sqe*            sqes;
+    tb_size_t                       sqes_size;
+
+    // the head and tail of the submission queue (shared with kernel)
+    tb_uint32_t volatile*           sq_khead;
+    tb_uint32_t volatile*           sq_ktail;
+
+    // the flags of the submission queue (shared with kernel)
+    tb_uint32_t volatile*           sq_kflags;
+
+    // the mask and entries of the submission queue
+    tb_uint32_t                     sq_mask;
+    tb_uint32_t                     sq_entries;
+
+    // the local tail of the queued and submitted entries
+    tb_uint32_t                     sq_tail;
+    tb_uint32_t                     sq_submitted;
+
+    // the head and tail of the completion queue (shared with kernel)
+    tb_uint32_t volatile*           cq_khead;
+    tb_uint32_t volatile*           cq_ktail;
+
+    // the mask of the completion queue
+    tb_uint32_t                     cq_mask;
+
+    // the completion queue entries
+    struct io_uring_cqe*            cqes;
+
+    // the count of the in-flight requests which will resume the waiting coroutines
+    tb_size_t                       inflight;
+
+    /* the timeouts of the linked timeout entries
+     *
+     * the kernel will copy it when submitting entries, so we use the slot of the entry index
+     */
+    struct __kernel_timespec*       timeouts;
+
+}tb_co_scheduler_io_uring_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_long_t tb_co_scheduler_io_uring_enter(tb_int_t fd, tb_uint32_t to_submit, tb_uint32_t min_complete, tb_uint32_t flags)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, tb_null, 0);
+}
+static tb_size_t tb_co_scheduler_io_uring_reap(tb_co_scheduler_io_uring_t* uring, tb_bool_t resume)
+{
+    // check
+    tb_assert(uring && uring->scheduler_io && uring->scheduler_io->scheduler);
+
+    // reap all completions
+    tb_size_t count = 0;
+    while (1)
+    {
+        // the head and tail
+        tb_uint32_t head = *uring->cq_khead;
+        tb_uint32_t tail = *uring->cq_ktail;
+        tb_barrier();
+
+        // reap the completions in the completion queue
+        while (head != tail)
+        {
+            // get the next completion
+            struct io_uring_cqe* cqe = &uring->cqes[head++ & uring->cq_mask];
+
+            // we need ignore the linked timeout and cancel entries
+            tb_coroutine_t* coroutine = (tb_coroutine_t*)(tb_size_t)cqe->user_data;
+            tb_check_continue(coroutine);
+
+            // this request is finished
+            tb_assert(uring->inflight);
+            uring->inflight--;
+            count++;
+
+            // trace
+            tb_trace_d("coroutine(%p): completed: %d%s", coroutine, cqe->res, resume? "" : ", dropped");
+
+            // resume the waiting coroutine and pass the result to suspend()
+            if (resume) tb_co_scheduler_resume(uring->scheduler_io->scheduler, coroutine, (tb_cpointer_t)(tb_long_t)cqe->res);
+        }
+
+        // release the reaped completions to kernel
+        tb_barrier();
+        *uring->cq_khead = head;
+
+        /* the completion queue has been overflowed? flush the overflowed completions and reap them again
+         *
+         * the kernel will not notify the io_uring fd for them and rejects the new submissions until they are flushed
+         */
+        tb_barrier();
+        tb_check_break(*uring->sq_kflags & IORING_SQ_CQ_OVERFLOW);
+        if (tb_co_scheduler_io_uring_enter(uring->fd, 0, 0, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) break;
+    }
+
+    // ok?
+    return count;
+}
+static tb_void_t tb_co_scheduler_io_uring_cancel(tb_co_scheduler_io_uring_t* uring)
+{
+    // check
+    tb_assert(uring && uring->scheduler_io && uring->scheduler_io->scheduler);
+
+    // no in-flight requests?
+    tb_check_return(uring->inflight);
+
+    // trace
+    tb_trace_d("cancel: %lu in-flight requests ..", uring->inflight);
+
+    /* cancel the requests of all suspended coroutines, it will fail if the coroutine is not waiting io_uring,
+     * we match them by user_data, so it works for the older kernels without IORING_ASYNC_CANCEL_ANY
+     */
+    tb_co_scheduler_t* scheduler = uring->scheduler_io->scheduler;
+    tb_for_all_if (tb_coroutine_t*, coroutine, tb_list_entry_itor(&scheduler->coroutines_suspend), coroutine)
+    {
+        // no enough entries? submit the queued entries and drop the finished completions first
+        if (uring->sq_tail + 1 - *uring->sq_khead > uring->sq_entries)
+        {
+            if (tb_co_scheduler_io_uring_submit((tb_co_scheduler_io_uring_ref_t)uring) < 0) break;
+            tb_co_scheduler_io_uring_reap(uring, tb_false);
+            tb_barrier();
+            tb_check_break(uring->sq_tail + 1 - *uring->sq_khead <= uring->sq_entries);
+        }
+
+        // make the cancel entry, we need not resume coroutine for it
+        struct io_uring_sqe* sqe = &uring->sqes[uring->sq_tail++ & uring->sq_mask];
+        tb_memset_(sqe, 0, sizeof(struct io_uring_sqe));
+        sqe->opcode     = IORING_OP_ASYNC_CANCEL;
+        sqe->fd         = -1;
+        sqe->addr       = (tb_uint64_t)(tb_size_t)coroutine;
+        sqe->user_data  = 0;
+    }
+
+    /* wait and drop all completions of the in-flight requests,
+     * the coroutines will be freed after exiting, so the kernel must not write to their buffers or resume them later
+     */
+    while (uring->inflight)
+    {
+        // submit the queued entries
+        if (tb_co_scheduler_io_uring_submit((tb_co_scheduler_io_uring_ref_t)uring) < 0) break;
+
+        // drop the finished completions
+        if (tb_co_scheduler_io_uring_reap(uring, tb_false)) continue;
+
+        // wait one completion at least
+        if (tb_co_scheduler_io_uring_enter(uring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) break;
+    }
+
+    // trace
+    tb_trace_d("cancel: %lu in-flight requests left", uring->inflight);
+}
+static struct io_uring_sqe* tb_co_scheduler_io_uring_prep(tb_co_scheduler_io_uring_t* uring, tb_uint8_t opcode, tb_int_t fd, tb_long_t timeout)
+{
+    // check
+    tb_assert(uring && uring->scheduler_io && uring->scheduler_io->scheduler);
+
+    // have been stopped? we cannot wait the completion
+    tb_check_return_val(!uring->scheduler_io->scheduler->stopped, tb_null);
+
+    // the entries count, we need link a timeout entry if exists timeout
+    tb_uint32_t count = timeout >= 0? 2 : 1;
+
+    // no enough entries? submit the queued entries first
+    while (uring->sq_tail + count - *uring->sq_khead > uring->sq_entries)
+    {
+        // submit it
+        if (tb_co_scheduler_io_uring_submit((tb_co_scheduler_io_uring_ref_t)uring) < 0) return tb_null;
+
+        // the submission queue is not full now?
+        tb_barrier();
+        tb_check_break(uring->sq_tail + count - *uring->sq_khead > uring->sq_entries);
+
+        /* the kernel is busy now, e.g. the completion queue has been overflowed,
+         * we reap the completions to resume the other coroutines or wait one completion at least
+         */
+        if (!tb_co_scheduler_io_uring_reap(uring, tb_true))
+        {
+            tb_check_return_val(uring->inflight, tb_null);
+            if (tb_co_scheduler_io_uring_enter(uring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) return tb_null;
+        }
+    }
+
+    // get the current coroutine
+    tb_coroutine_t* coroutine = tb_co_scheduler_running(uring->scheduler_io->scheduler);
+    tb_assert(coroutine);
+
+    // make entry, we cannot use the checked tb_memset() for the mapped kernel memory
+    struct io_uring_sqe* sqe = &uring->sqes[uring->sq_tail++ & uring->sq_mask];
+    tb_memset_(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode     = opcode;
+    sqe->fd         = fd;
+    sqe->user_data  = (tb_uint64_t)(tb_size_t)coroutine;
+    uring->inflight++;
+
+    // exists timeout? link a timeout entry
+    if (timeout >= 0)
+    {
+        // link the next entry
+        sqe->flags |= IOSQE_IO_LINK;
+
+        // init the timeout of this slot
+        tb_uint32_t                 index = uring->sq_tail++ & uring->sq_mask;
+        struct __kernel_timespec*   ts = &uring->timeouts[index];
+        ts->tv_sec  = timeout / 1000;
+        ts->tv_nsec = (timeout % 1000) * 1000000;
+
+        // make the timeout entry, we need not resume coroutine for it
+        struct io_uring_sqe* sqe_timeout = &uring->sqes[index];
+        tb_memset_(sqe_timeout, 0, sizeof(struct io_uring_sqe));
+        sqe_timeout->opcode     = IORING_OP_LINK_TIMEOUT;
+        sqe_timeout->fd         = -1;
+        sqe_timeout->addr       = (tb_uint64_t)(tb_size_t)ts;
+        sqe_timeout->len        = 1;
+        sqe_timeout->user_data  = 0;
+    }
+
+    // trace
+    tb_trace_d("coroutine(%p): prep opcode(%u) for fd(%d) with %ld ms ..", coroutine, opcode, fd, timeout);
+
+    // ok
+    return sqe;
+}
+static __tb_inline__ tb_long_t tb_co_scheduler_io_uring_wait(tb_co_scheduler_io_uring_t* uring)
+{
+    // check
+    tb_assert(uring && uring->scheduler_io && uring->scheduler_io->scheduler);
+
+    /* suspend the current coroutine and return the completion result
+     *
+     * the queued entries will be submitted in the next loop of the io scheduler
+     */
+    return (tb_long_t)tb_co_scheduler_suspend(uring->scheduler_io->scheduler, tb_null);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_scheduler_io_uring_ref_t tb_co_scheduler_io_uring_init(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // check
+    tb_assert_and_check_return_val(scheduler_io, tb_null);
+
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_co_scheduler_io_uring_t* uring = tb_null;
+    do
+    {
+        // make io_uring
+        uring = tb_malloc0_type(tb_co_scheduler_io_uring_t);
+        tb_assert_and_check_break(uring);
+
+        // init it
+        uring->fd           = -1;
+        uring->scheduler_io = scheduler_io;
+        uring->sq_ring      = MAP_FAILED;
+        uring->cq_ring      = MAP_FAILED;
+        uring->sqes         = MAP_FAILED;
+
+        // init io_uring fd, it may be not supported or be disabled in the current system
+        struct io_uring_params params;
+        tb_memset(&params, 0, sizeof(params));
+        uring->fd = (tb_int_t)syscall(__NR_io_uring_setup, TB_SCHEDULER_IO_URING_MAXN, &params);
+        tb_check_break(uring->fd >= 0);
+
+        /* we need the fast poll feature for the socket operations,
+         * otherwise they will be blocked in the kernel worker threads
+         */
+        tb_check_break(params.features & IORING_FEAT_FAST_POLL);
+
+        // init the ring sizes
+        uring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(tb_uint32_t);
+        uring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        uring->sqes_size    = params.sq_entries * sizeof(struct io_uring_sqe);
+        uring->single       = (params.features & IORING_FEAT_SINGLE_MMAP)? tb_true : tb_false;
+        if (uring->single) uring->sq_ring_size = uring->cq_ring_size = tb_max(uring->sq_ring_size, uring->cq_ring_size);
+
+        // map the submission queue ring
+        uring->sq_ring = mmap(tb_null, uring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+        tb_assert_and_check_break(uring->sq_ring != MAP_FAILED);
+
+        // map the completion queue ring
+        uring->cq_ring = uring->single? uring->sq_ring : mmap(tb_null, uring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+        tb_assert_and_check_break(uring->cq_ring != MAP_FAILED);
+
+        // map the submission queue entries
+        uring->sqes = (struct io_uring_sqe*)mmap(tb_null, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+        tb_assert_and_check_break(uring->sqes != MAP_FAILED);
+
+        // init the submission queue
+        tb_byte_t* sq_ring  = (tb_byte_t*)uring->sq_ring;
+        uring->sq_khead     = (tb_uint32_t volatile*)(sq_ring + params.sq_off.head);
+        uring->sq_ktail     = (tb_uint32_t volatile*)(sq_ring + params.sq_off.tail);
+        uring->sq_kflags    = (tb_uint32_t volatile*)(sq_ring + params.sq_off.flags);
+        uring->sq_mask      = *(tb_uint32_t*)(sq_ring + params.sq_off.ring_mask);
+        uring->sq_entries   = *(tb_uint32_t*)(sq_ring + params.sq_off.ring_entries);
+        uring->sq_tail      = *uring->sq_ktail;
+        uring->sq_submitted = uring->sq_tail;
+
+        // the entry index is always same as the slot index
+        tb_uint32_t  i = 0;
+        tb_uint32_t* sq_array = (tb_uint32_t*)(sq_ring + params.sq_off.array);
+        for (i = 0; i < uring->sq_entries; i++) sq_array[i] = i;
+
+        // init the completion queue
+        tb_byte_t* cq_ring  = (tb_byte_t*)uring->cq_ring;
+        uring->cq_khead     = (tb_uint32_t volatile*)(cq_ring + params.cq_off.head);
+        uring->cq_ktail     = (tb_uint32_t volatile*)(cq_ring + params.cq_off.tail);
+        uring->cq_mask      = *(tb_uint32_t*)(cq_ring + params.cq_off.ring_mask);
+        uring->cqes         = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+        // init timeouts
+        uring->timeouts = tb_nalloc0_type(uring->sq_entries, struct __kernel_timespec);
+        tb_assert_and_check_break(uring->timeouts);
+
+        // trace
+        tb_trace_d("init: sq: %u, cq: %u, features: %x", params.sq_entries, params.cq_entries, params.features);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (uring) tb_co_scheduler_io_uring_exit((tb_co_scheduler_io_uring_ref_t)uring);
+        uring = tb_null;
+    }
+
+    // ok?
+    return (tb_co_scheduler_io_uring_ref_t)uring;
+}
+tb_void_t tb_co_scheduler_io_uring_exit(tb_co_scheduler_io_uring_ref_t self)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return(uring);
+
+    // cancel all in-flight requests before the waiting coroutines are freed
+    if (uring->fd >= 0 && uring->sqes != MAP_FAILED && uring->cq_ring != MAP_FAILED)
+        tb_co_scheduler_io_uring_cancel(uring);
+
+    // exit timeouts
+    if (uring->timeouts) tb_free(uring->timeouts);
+    uring->timeouts = tb_null;
+
+    // unmap the submission queue entries
+    if (uring->sqes != MAP_FAILED) munmap(uring->sqes, uring->sqes_size);
+    uring->sqes = MAP_FAILED;
+
+    // unmap the completion queue ring
+    if (uring->cq_ring != MAP_FAILED && !uring->single) munmap(uring->cq_ring, uring->cq_ring_size);
+    uring->cq_ring = MAP_FAILED;
+
+    // unmap the submission queue ring
+    if (uring->sq_ring != MAP_FAILED) munmap(uring->sq_ring, uring->sq_ring_size);
+    uring->sq_ring = MAP_FAILED;
+
+    // close fd
+    if (uring->fd >= 0) close(uring->fd);
+    uring->fd = -1;
+
+    // exit it
+    tb_free(uring);
+}
+tb_socket_ref_t tb_co_scheduler_io_uring_sock(tb_co_scheduler_io_uring_ref_t self)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring, tb_null);
+
+    // the socket of the io_uring fd
+    return tb_fd2sock(uring->fd);
+}
+tb_long_t tb_co_scheduler_io_uring_submit(tb_co_scheduler_io_uring_ref_t self)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring, -1);
+
+    // no queued entries?
+    tb_uint32_t count = uring->sq_tail - uring->sq_submitted;
+    tb_check_return_val(count, 0);
+
+    // publish the queued entries to kernel
+    tb_barrier();
+    *uring->sq_ktail = uring->sq_tail;
+    tb_barrier();
+
+    // submit them with only one system call
+    tb_long_t real = tb_co_scheduler_io_uring_enter(uring->fd, count, 0, 0);
+    if (real < 0)
+    {
+        // busy now? submit them in the next loop
+        if (errno == EAGAIN || errno == EBUSY || errno == EINTR) return 0;
+
+        // trace
+        tb_trace_e("submit %u entries failed, errno: %d", count, errno);
+
+        // failed
+        return -1;
+    }
+
+    // update the submitted tail
+    uring->sq_submitted += (tb_uint32_t)real;
+
+    // trace
+    tb_trace_d("submit: %ld entries", real);
+
+    // ok
+    return real;
+}
+tb_size_t tb_co_scheduler_io_uring_spak(tb_co_scheduler_io_uring_ref_t self)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && uring->scheduler_io && uring->scheduler_io->scheduler, 0);
+
+    // reap all completions and resume the waiting coroutines
+    return tb_co_scheduler_io_uring_reap(uring, tb_true);
+}
+tb_long_t tb_co_scheduler_io_uring_recv(tb_co_scheduler_io_uring_ref_t self, tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && sock && data, -1);
+
+    // no data?
+    tb_check_return_val(size, 0);
+
+    // recv it
+    tb_long_t real = -1;
+    do
+    {
+        // post recv
+        struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_RECV, tb_sock2fd(sock), timeout);
+        tb_check_return_val(sqe, -1);
+
+        // init data
+        sqe->addr = (tb_uint64_t)(tb_size_t)data;
+        sqe->len  = (tb_uint32_t)size;
+
+        // wait it
+        real = tb_co_scheduler_io_uring_wait(uring);
+
+    } while (real == -EINTR || real == -EAGAIN);
+
+    // ok? closed? timeout or failed?
+    return real > 0? real : (real == -ECANCELED? 0 : -1);
+}
+tb_long_t tb_co_scheduler_io_uring_send(tb_co_scheduler_io_uring_ref_t self, tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && sock && data, -1);
+
+    // no data?
+    tb_check_return_val(size, 0);
+
+    // send it
+    tb_long_t real = -1;
+    do
+    {
+        // post send
+        struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_SEND, tb_sock2fd(sock), timeout);
+        tb_check_return_val(sqe, -1);
+
+        // init data, do not raise SIGPIPE if the peer has been closed
+        sqe->addr       = (tb_uint64_t)(tb_size_t)data;
+        sqe->len        = (tb_uint32_t)size;
+        sqe->msg_flags  = MSG_NOSIGNAL;
+
+        // wait it
+        real = tb_co_scheduler_io_uring_wait(uring);
+
+    } while (real == -EINTR || real == -EAGAIN);
+
+    // ok? closed? timeout or failed?
+    return real > 0? real : (real == -ECANCELED? 0 : -1);
+}
+tb_socket_ref_t tb_co_scheduler_io_uring_accept(tb_co_scheduler_io_uring_ref_t self, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && sock, tb_null);
+
+    // accept it, the address will be written by kernel when it is completed
+    tb_long_t               fd = -1;
+    struct sockaddr_storage d;
+    socklen_t               n = sizeof(d);
+    do
+    {
+        // post accept
+        struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_ACCEPT, tb_sock2fd(sock), timeout);
+        tb_check_return_val(sqe, tb_null);
+
+        // init address and non-block client socket
+        tb_memset(&d, 0, sizeof(d));
+        n = sizeof(d);
+        sqe->addr           = (tb_uint64_t)(tb_size_t)&d;
+        sqe->addr2          = (tb_uint64_t)(tb_size_t)&n;
+        sqe->accept_flags   = SOCK_NONBLOCK;
+
+        // wait it
+        fd = tb_co_scheduler_io_uring_wait(uring);
+
+    } while (fd == -EINTR || fd == -EAGAIN);
+
+    // no client?
+    tb_check_return_val(fd >= 0, tb_null);
+
+    // the client socket
+    tb_socket_ref_t client = tb_fd2sock(fd);
+
+    // disable the nagle's algorithm like tb_socket_accept()
+    tb_socket_ctrl(client, TB_SOCKET_CTRL_SET_TCP_NODELAY, tb_true);
+
+    // save address
+    if (addr) tb_sockaddr_save(addr, &d);
+
+    // ok
+    return client;
+}
+tb_long_t tb_co_scheduler_io_uring_connect(tb_co_scheduler_io_uring_ref_t self, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && sock && addr, -1);
+    tb_assert_and_check_return_val(!tb_ipaddr_is_empty(addr), -1);
+
+    // load address, it need be valid until the connection is completed
+    struct sockaddr_storage d = {0};
+    tb_size_t               n = tb_sockaddr_load(&d, addr);
+    tb_assert_and_check_return_val(n, -1);
+
+    // post connect
+    struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_CONNECT, tb_sock2fd(sock), timeout);
+    tb_check_return_val(sqe, -1);
+
+    // init address
+    sqe->addr   = (tb_uint64_t)(tb_size_t)&d;
+    sqe->off    = (tb_uint64_t)n;
+
+    // wait it
+    tb_long_t ok = tb_co_scheduler_io_uring_wait(uring);
+
+    // ok? timeout or failed?
+    return (!ok || ok == -EISCONN)? 1 : (ok == -ECANCELED? 0 : -1);
+}
+tb_long_t tb_co_scheduler_io_uring_pread(tb_co_scheduler_io_uring_ref_t self, tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && file && data, -1);
+
+    // no data?
+    tb_check_return_val(size, 0);
+
+    // post read
+    struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_READ, tb_file2fd(file), -1);
+    tb_check_return_val(sqe, -1);
+
+    // init data
+    sqe->addr   = (tb_uint64_t)(tb_size_t)data;
+    sqe->len    = (tb_uint32_t)size;
+    sqe->off    = (tb_uint64_t)offset;
+
+    // wait it
+    tb_long_t real = tb_co_scheduler_io_uring_wait(uring);
+
+    // ok?
+    return real >= 0? real : -1;
+}
+tb_long_t tb_co_scheduler_io_uring_pwrit(tb_co_scheduler_io_uring_ref_t self, tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    // check
+    tb_co_scheduler_io_uring_t* uring = (tb_co_scheduler_io_uring_t*)self;
+    tb_assert_and_check_return_val(uring && file && data, -1);
+
+    // no data?
+    tb_check_return_val(size, 0);
+
+    // post write
+    struct io_uring_sqe* sqe = tb_co_scheduler_io_uring_prep(uring, IORING_OP_WRITE, tb_file2fd(file), -1);
+    tb_check_return_val(sqe, -1);
+
+    // init data
+    sqe->addr   = (tb_uint64_t)(tb_size_t)data;
+    sqe->len    = (tb_uint32_t)size;
+    sqe->off    = (tb_uint64_t)offset;
+
+    // wait it
+    tb_long_t real = tb_co_scheduler_io_uring_wait(uring);
+
+    // ok?
+    return real >= 0? real : -1;
+}
+#else
+tb_co_scheduler_io_uring_ref_t tb_co_scheduler_io_uring_init(tb_co_scheduler_io_ref_t scheduler_io)
+{
+    // not supported, uses the poller only
+    return tb_null;
+}
+tb_void_t tb_co_scheduler_io_uring_exit(tb_co_scheduler_io_uring_ref_t uring)
+{
+    tb_trace_noimpl();
+}
+tb_socket_ref_t tb_co_scheduler_io_uring_sock(tb_co_scheduler_io_uring_ref_t uring)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_long_t tb_co_scheduler_io_uring_submit(tb_co_scheduler_io_uring_ref_t uring)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_size_t tb_co_scheduler_io_uring_spak(tb_co_scheduler_io_uring_ref_t uring)
+{
+    tb_trace_noimpl();
+    return 0;
+}
+tb_long_t tb_co_scheduler_io_uring_recv(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_co_scheduler_io_uring_send(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_socket_ref_t tb_co_scheduler_io_uring_accept(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    tb_trace_noimpl();
+    return tb_null;
+}
+tb_long_t tb_co_scheduler_io_uring_connect(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_co_scheduler_io_uring_pread(tb_co_scheduler_io_uring_ref_t uring, tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+tb_long_t tb_co_scheduler_io_uring_pwrit(tb_co_scheduler_io_uring_ref_t uring, tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset)
+{
+    tb_trace_noimpl();
+    return -1;
+}
+#endif
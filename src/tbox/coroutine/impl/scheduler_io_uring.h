@@ -0,0 +1,163 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_io_uring.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_SCHEDULER_IO_URING_H
+#define TB_COROUTINE_IMPL_SCHEDULER_IO_URING_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "scheduler_io.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the io_uring of the io scheduler ref type
+typedef struct __tb_co_scheduler_io_uring_t*    tb_co_scheduler_io_uring_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the completion-based io_uring for the given io scheduler
+ *
+ * @param scheduler_io      the io scheduler
+ *
+ * @return                  the io_uring, return null if not be supported and uses the poller only
+ */
+tb_co_scheduler_io_uring_ref_t  tb_co_scheduler_io_uring_init(tb_co_scheduler_io_ref_t scheduler_io);
+
+/* exit the io_uring
+ *
+ * @param uring             the io_uring
+ */
+tb_void_t                   tb_co_scheduler_io_uring_exit(tb_co_scheduler_io_uring_ref_t uring);
+
+/* get the io_uring socket for waiting completions in the poller
+ *
+ * @param uring             the io_uring
+ *
+ * @return                  the socket of the io_uring fd
+ */
+tb_socket_ref_t             tb_co_scheduler_io_uring_sock(tb_co_scheduler_io_uring_ref_t uring);
+
+/* submit all queued requests with only one system call
+ *
+ * @param uring             the io_uring
+ *
+ * @return                  the submitted requests count, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_submit(tb_co_scheduler_io_uring_ref_t uring);
+
+/* reap all completions and resume the waiting coroutines
+ *
+ * @param uring             the io_uring
+ *
+ * @return                  the resumed coroutines count
+ */
+tb_size_t                   tb_co_scheduler_io_uring_spak(tb_co_scheduler_io_uring_ref_t uring);
+
+/* recv data from the socket in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param sock              the socket
+ * @param data              the data
+ * @param size              the size
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_recv(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_byte_t* data, tb_size_t size, tb_long_t timeout);
+
+/* send data to the socket in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param sock              the socket
+ * @param data              the data
+ * @param size              the size
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  > 0: the real size, 0: timeout, -1: failed or closed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_send(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_byte_t const* data, tb_size_t size, tb_long_t timeout);
+
+/* accept the client socket in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param sock              the listening socket
+ * @param addr              the client address, optional
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  the client socket, null: timeout or failed
+ */
+tb_socket_ref_t             tb_co_scheduler_io_uring_accept(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/* connect the given address in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param sock              the socket
+ * @param addr              the address
+ * @param timeout           the timeout, infinity: -1
+ *
+ * @return                  1: ok, 0: timeout, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_connect(tb_co_scheduler_io_uring_ref_t uring, tb_socket_ref_t sock, tb_ipaddr_ref_t addr, tb_long_t timeout);
+
+/* read the file data at the given offset in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param file              the file
+ * @param data              the data
+ * @param size              the size
+ * @param offset            the offset
+ *
+ * @return                  >= 0: the real size, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_pread(tb_co_scheduler_io_uring_ref_t uring, tb_file_ref_t file, tb_byte_t* data, tb_size_t size, tb_hize_t offset);
+
+/* writ the file data at the given offset in the current coroutine
+ *
+ * @param uring             the io_uring
+ * @param file              the file
+ * @param data              the data
+ * @param size              the size
+ * @param offset            the offset
+ *
+ * @return                  >= 0: the real size, -1: failed
+ */
+tb_long_t                   tb_co_scheduler_io_uring_pwrit(tb_co_scheduler_io_uring_ref_t uring, tb_file_ref_t file, tb_byte_t const* data, tb_size_t size, tb_hize_t offset);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
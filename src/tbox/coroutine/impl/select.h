@@ -0,0 +1,94 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_SELECT_H
+#define TB_COROUTINE_IMPL_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the select type
+ *
+ * it is allocated only if the select coroutine need be suspended, 
+ * because the stack of the suspended coroutine may be saved if it uses the shared stack
+ */
+typedef struct __tb_co_select_t
+{
+    // the select coroutine
+    tb_coroutine_t*             coroutine;
+
+    /* the fired flag
+     *
+     * 0:               waiting
+     * index + 1:       the fired case
+     * count + 1:       timeout
+     * count + 2:       canceled
+     */
+    tb_atomic_t                 fired;
+
+    // the copied cases
+    tb_co_select_case_t*        cases;
+
+    // the waiters of cases
+    tb_co_waiter_t*             waiters;
+
+    // the cases count
+    tb_size_t                   count;
+
+    // the timer task
+    tb_cpointer_t               task;
+
+}tb_co_select_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* notify the socket events to the select coroutine, only be called in the io loop
+ *
+ * @param select            the select
+ * @param sock              the socket
+ * @param events            the socket events
+ */
+tb_void_t                   tb_co_select_spak(tb_co_select_t* select, tb_socket_ref_t sock, tb_size_t events);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
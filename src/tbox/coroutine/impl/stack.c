@@ -0,0 +1,282 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        stack.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "stack"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "stack.h"
+#if defined(TB_CONFIG_POSIX_HAVE_MMAP) && defined(TB_CONFIG_POSIX_HAVE_MPROTECT)
+#   include <sys/mman.h>
+#   define TB_CO_STACK_HAVE_MMAP
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the size classes count, the maximum pooled stack size is (pagesize << (count - 1)), .e.g 8MB
+#define TB_CO_STACK_POOL_CLASS_MAXN     (12)
+
+// the cached stacks maximum count of each size class
+#ifdef __tb_small__
+#   define TB_CO_STACK_POOL_CACHE_MAXN  (32)
+#else
+#   define TB_CO_STACK_POOL_CACHE_MAXN  (128)
+#endif
+
+/* the maximum count of the guard-paged stacks for all pools
+ *
+ * each guard-paged stack costs two memory maps, and the maps are limited (.e.g vm.max_map_count: 65530),
+ * so we need keep enough maps for the other allocations
+ */
+#ifdef __tb_small__
+#   define TB_CO_STACK_MAPPED_MAXN      (4096)
+#else
+#   define TB_CO_STACK_MAPPED_MAXN      (16384)
+#endif
+
+// the mmap flags
+#ifdef TB_CO_STACK_HAVE_MMAP
+#   ifndef MAP_ANONYMOUS
+#       define MAP_ANONYMOUS            MAP_ANON
+#   endif
+#   ifndef MAP_NORESERVE
+#       define MAP_NORESERVE            (0)
+#   endif
+#   ifndef MAP_STACK
+#       define MAP_STACK                (0)
+#   endif
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the stack size class type
+typedef struct __tb_co_stack_class_t
+{
+    // the cached stacks count
+    tb_size_t               count;
+
+    // the cached stacks
+    tb_byte_t*              stacks[TB_CO_STACK_POOL_CACHE_MAXN];
+
+}tb_co_stack_class_t;
+
+// the stack pool type
+typedef struct __tb_co_stack_pool_t
+{
+    // the page size
+    tb_size_t               pagesize;
+
+    // the size classes
+    tb_co_stack_class_t     classes[TB_CO_STACK_POOL_CLASS_MAXN];
+
+#ifdef TB_CO_STACK_HAVE_MMAP
+    // the unguarded stacks from the allocator if there are too many guard-paged stacks
+    tb_hash_set_ref_t       unguarded;
+#endif
+
+}tb_co_stack_pool_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+#ifdef TB_CO_STACK_HAVE_MMAP
+// the guard-paged stacks count of all pools
+static tb_atomic_t  g_mapped_count = 0;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static __tb_inline__ tb_size_t tb_co_stack_pool_class(tb_co_stack_pool_t* pool, tb_size_t size)
+{
+    // get the class index of the power of two pages
+    tb_size_t index = 0;
+    tb_size_t pages = (size + pool->pagesize - 1) / pool->pagesize;
+    while (((tb_size_t)1 << index) < pages) index++;
+    return index;
+}
+static tb_byte_t* tb_co_stack_pool_map(tb_co_stack_pool_t* pool, tb_size_t size)
+{
+#ifdef TB_CO_STACK_HAVE_MMAP
+    /* reserve the stack and the guard page
+     *
+     * the stack pages will be committed by the system only when it is touched
+     */
+    if (tb_atomic_fetch_and_inc(&g_mapped_count) < TB_CO_STACK_MAPPED_MAXN)
+    {
+        tb_byte_t* mapped = (tb_byte_t*)mmap(tb_null, size + pool->pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+        if (mapped != (tb_byte_t*)MAP_FAILED)
+        {
+            // protect the guard page, the stack overflow will trap instead of corrupting the heap
+            if (!mprotect(mapped, pool->pagesize, PROT_NONE)) return mapped + pool->pagesize;
+            munmap(mapped, size + pool->pagesize);
+        }
+    }
+    tb_atomic_fetch_and_dec(&g_mapped_count);
+
+    // init the unguarded stacks
+    if (!pool->unguarded) pool->unguarded = tb_hash_set_init(TB_HASH_SET_BUCKET_SIZE_LARGE, tb_element_ptr(tb_null, tb_null));
+    tb_assert_and_check_return_val(pool->unguarded, tb_null);
+
+    // trace
+    tb_trace_d("map: too many stacks, uses the unguarded stack: %lu bytes", size);
+
+    // alloc the unguarded stack from the allocator
+    tb_byte_t* data = (tb_byte_t*)tb_malloc_bytes(size);
+    if (data) tb_hash_set_insert(pool->unguarded, data);
+    return data;
+#else
+    return (tb_byte_t*)tb_malloc_bytes(size);
+#endif
+}
+/* release the stack pages or unmap it
+ *
+ * return tb_true if the stack can be cached, otherwise it has been freed
+ */
+static tb_bool_t tb_co_stack_pool_release(tb_co_stack_pool_t* pool, tb_byte_t* data, tb_size_t size, tb_bool_t cached)
+{
+#ifdef TB_CO_STACK_HAVE_MMAP
+    // is the unguarded stack? free it directly
+    if (pool->unguarded && tb_hash_set_get(pool->unguarded, data))
+    {
+        tb_hash_set_remove(pool->unguarded, data);
+        tb_free(data);
+        return tb_false;
+    }
+
+    // cache it and release the used pages to the system, but keep the reserved address space
+    if (cached)
+    {
+#   ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+        madvise(data, size, MADV_DONTNEED);
+#   endif
+        return tb_true;
+    }
+    munmap(data - pool->pagesize, size + pool->pagesize);
+    tb_atomic_fetch_and_dec(&g_mapped_count);
+#else
+    // cache it
+    if (cached) return tb_true;
+    tb_free(data);
+#endif
+    return tb_false;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_stack_pool_ref_t tb_co_stack_pool_init()
+{
+    // make pool
+    tb_co_stack_pool_t* pool = tb_malloc0_type(tb_co_stack_pool_t);
+    tb_assert_and_check_return_val(pool, tb_null);
+
+    // init page size
+    pool->pagesize = tb_page_size();
+    if (!pool->pagesize) pool->pagesize = 4096;
+
+    // ok
+    return (tb_co_stack_pool_ref_t)pool;
+}
+tb_void_t tb_co_stack_pool_exit(tb_co_stack_pool_ref_t self)
+{
+    // check
+    tb_co_stack_pool_t* pool = (tb_co_stack_pool_t*)self;
+    tb_assert_and_check_return(pool);
+
+    // free all cached stacks
+    tb_size_t index = 0;
+    for (index = 0; index < TB_CO_STACK_POOL_CLASS_MAXN; index++)
+    {
+        tb_co_stack_class_t* sclass = &pool->classes[index];
+        while (sclass->count) tb_co_stack_pool_release(pool, sclass->stacks[--sclass->count], pool->pagesize << index, tb_false);
+    }
+
+#ifdef TB_CO_STACK_HAVE_MMAP
+    // exit the unguarded stacks
+    if (pool->unguarded) tb_hash_set_exit(pool->unguarded);
+    pool->unguarded = tb_null;
+#endif
+
+    // exit it
+    tb_free(pool);
+}
+tb_byte_t* tb_co_stack_pool_alloc(tb_co_stack_pool_ref_t self, tb_size_t* psize)
+{
+    // check
+    tb_co_stack_pool_t* pool = (tb_co_stack_pool_t*)self;
+    tb_assert_and_check_return_val(pool && psize && *psize, tb_null);
+
+    // get the size class
+    tb_size_t index = tb_co_stack_pool_class(pool, *psize);
+
+    // too large? map it directly
+    if (index >= TB_CO_STACK_POOL_CLASS_MAXN)
+    {
+        tb_size_t size = tb_align(*psize, pool->pagesize);
+        tb_byte_t* data = tb_co_stack_pool_map(pool, size);
+        if (data) *psize = size;
+        return data;
+    }
+
+    // save the real size
+    *psize = pool->pagesize << index;
+
+    // reuse the cached stack first, its pages have been released and will be committed on touch
+    tb_co_stack_class_t* sclass = &pool->classes[index];
+    if (sclass->count) return sclass->stacks[--sclass->count];
+
+    // trace
+    tb_trace_d("map: %lu bytes", *psize);
+
+    // map a new stack
+    return tb_co_stack_pool_map(pool, *psize);
+}
+tb_void_t tb_co_stack_pool_free(tb_co_stack_pool_ref_t self, tb_byte_t* data, tb_size_t size)
+{
+    // check
+    tb_co_stack_pool_t* pool = (tb_co_stack_pool_t*)self;
+    tb_assert_and_check_return(pool && data && size);
+
+    // get the size class
+    tb_size_t index = tb_co_stack_pool_class(pool, size);
+    tb_assert((index >= TB_CO_STACK_POOL_CLASS_MAXN) || size == (pool->pagesize << index));
+
+    // cache it if the class is not full, the unguarded stack will be freed directly
+    tb_co_stack_class_t* sclass = index < TB_CO_STACK_POOL_CLASS_MAXN? &pool->classes[index] : tb_null;
+    if (tb_co_stack_pool_release(pool, data, size, sclass && sclass->count < TB_CO_STACK_POOL_CACHE_MAXN))
+        sclass->stacks[sclass->count++] = data;
+}
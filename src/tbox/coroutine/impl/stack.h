@@ -0,0 +1,95 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        stack.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_IMPL_STACK_H
+#define TB_COROUTINE_IMPL_STACK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the coroutine stack pool ref type
+typedef __tb_typeref__(co_stack_pool);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the stack pool
+ *
+ * the stacks will be recycled by the size classes (power of two pages),
+ * and all stacks are reserved from the virtual memory with a guard page if be supported
+ *
+ *  ----------------------------------------------------
+ * | guard page (no access) | ...... stack (lazy) ..... |
+ *  ----------------------------------------------------
+ * ^                        ^                           ^
+ * mapped                   data                        data + size (stack base)
+ *
+ * @return                  the stack pool
+ */
+tb_co_stack_pool_ref_t      tb_co_stack_pool_init(tb_noarg_t);
+
+/* exit the stack pool and free all cached stacks
+ *
+ * @param pool              the stack pool
+ */
+tb_void_t                   tb_co_stack_pool_exit(tb_co_stack_pool_ref_t pool);
+
+/* alloc a stack from the pool
+ *
+ * @param pool              the stack pool
+ * @param psize             the needed stack size, and return the real stack size
+ *
+ * @return                  the stack data (bottom)
+ */
+tb_byte_t*                  tb_co_stack_pool_alloc(tb_co_stack_pool_ref_t pool, tb_size_t* psize);
+
+/* free the stack to the pool
+ *
+ * the unused stack pages will be released to the system if it is cached
+ *
+ * @param pool              the stack pool
+ * @param data              the stack data (bottom)
+ * @param size              the real stack size
+ */
+tb_void_t                   tb_co_stack_pool_free(tb_co_stack_pool_ref_t pool, tb_byte_t* data, tb_size_t size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
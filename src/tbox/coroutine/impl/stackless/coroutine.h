@@ -29,6 +29,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -43,11 +44,7 @@ __tb_extern_c_enter__
 typedef struct __tb_lo_coroutine_rs_wait_t
 {
 #ifndef TB_CONFIG_MICRO_ENABLE
-    /* the timer task pointer for ltimer or timer
-     *
-     * for ltimer:  task
-     * for timer:   task & 0x1
-     */
+    // the timer task
     tb_cpointer_t               task;
 #endif
 
@@ -89,6 +86,11 @@ typedef struct __tb_lo_coroutine_t
     // the scheduler
     tb_lo_scheduler_ref_t       scheduler;
 
+#ifdef TB_CO_PROFILER_ENABLE
+    // the profiler record, only be updated if the profiler of the scheduler is enabled
+    tb_co_profiler_record_t     profiler;
+#endif
+
     // the passed private data between resume() and suspend()
     union 
     {
@@ -84,6 +84,11 @@ typedef struct __tb_lo_scheduler_t
     // the suspend coroutines
     tb_list_entry_head_t            coroutines_suspend;
 
+#ifdef TB_CO_PROFILER_ENABLE
+    // the profiler, null if it is disabled
+    tb_co_profiler_t*               profiler;
+#endif
+
 }tb_lo_scheduler_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
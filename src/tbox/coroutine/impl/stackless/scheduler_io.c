@@ -41,21 +41,33 @@
  * macros
  */
 
-// the ltimer grow
+// the timer grow
 #ifdef __tb_small__
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (64)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (64)
 #else
-#   define TB_SCHEDULER_IO_LTIMER_GROW      (4096)
+#   define TB_SCHEDULER_IO_TIMER_GROW       (4096)
 #endif
 
-// the timer grow
-#define TB_SCHEDULER_IO_TIMER_GROW          (TB_SCHEDULER_IO_LTIMER_GROW >> 4)
-
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
 static tb_void_t tb_lo_scheduler_io_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine, tb_size_t events)
 {
+#ifndef TB_CONFIG_MICRO_ENABLE
+    // exists the timer task? remove it
+    tb_cpointer_t task = coroutine->rs.wait.task;
+    if (task) 
+    {
+        // get io scheduler
+        tb_lo_scheduler_io_ref_t scheduler_io = tb_lo_scheduler_io(scheduler);
+        tb_assert(scheduler_io && scheduler_io->timer);
+
+        // remove the timer task
+        tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)task);
+        coroutine->rs.wait.task = tb_null;
+    }
+#endif
+
     // clear waiting state
     coroutine->rs.wait.waiting = 0;
 
@@ -100,50 +112,44 @@ static tb_void_t tb_lo_scheduler_io_events(tb_poller_ref_t poller, tb_socket_ref
     if (coroutine->rs.wait.waiting)
     {
         // eof for edge trigger?
+        tb_size_t events_wait = coroutine->rs.wait.events;
         if (events & TB_POLLER_EVENT_EOF)
         {
             // cache this eof as next recv/send event
             events &= ~TB_POLLER_EVENT_EOF;
-            coroutine->rs.wait.events_cache |= coroutine->rs.wait.events;
+            events |= events_wait;
+            coroutine->rs.wait.events_cache |= events_wait;
         }
 
-        // resume the coroutine and pass the events to suspend()
-        tb_lo_scheduler_io_resume(scheduler, coroutine, events);
+        // cache the other events which are not waited now, we will not get this edge again
+        coroutine->rs.wait.events_cache |= events & ~events_wait;
+
+        // resume the coroutine and pass the waited events to suspend()
+        events &= events_wait;
+        if (events) tb_lo_scheduler_io_resume(scheduler, coroutine, events);
     }
-    // cache this events
-    else coroutine->rs.wait.events_cache = events;
+    // cache this events, the eof will be the next recv/send event
+    else coroutine->rs.wait.events_cache |= (events & TB_POLLER_EVENT_EOF)? TB_POLLER_EVENT_EALL : (events & TB_POLLER_EVENT_EALL);
 }
 #ifndef TB_CONFIG_MICRO_ENABLE
 static tb_bool_t tb_lo_scheduler_io_timer_spak(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // spak ctime
     tb_cache_time_spak();
 
     // spak timer
-    if (!tb_timer_spak(scheduler_io->timer)) return tb_false;
-
-    // spak ltimer
-    if (!tb_ltimer_spak(scheduler_io->ltimer)) return tb_false;
-
-    // pk
-    return tb_true;
+    return tb_timer_spak(scheduler_io->timer);
 }
 static tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
 {
     // check
-    tb_assert(scheduler_io && scheduler_io->timer && scheduler_io->ltimer);
-
-    // the delay
-    tb_size_t delay = tb_timer_delay(scheduler_io->timer);
-
-    // the ldelay
-    tb_size_t ldelay = tb_ltimer_delay(scheduler_io->ltimer);
+    tb_assert(scheduler_io && scheduler_io->timer);
 
     // return the timer delay
-    return tb_min(delay, ldelay);
+    return tb_timer_delay(scheduler_io->timer);
 }
 #else
 static __tb_inline__ tb_long_t tb_lo_scheduler_io_timer_delay(tb_lo_scheduler_io_ref_t scheduler_io)
@@ -221,10 +227,6 @@ tb_lo_scheduler_io_ref_t tb_lo_scheduler_io_init(tb_lo_scheduler_t* scheduler)
         // init timer and using cache time
         scheduler_io->timer = tb_timer_init(TB_SCHEDULER_IO_TIMER_GROW, tb_true);
         tb_assert_and_check_break(scheduler_io->timer);
-
-        // init ltimer and using cache time
-        scheduler_io->ltimer = tb_ltimer_init(TB_SCHEDULER_IO_LTIMER_GROW, TB_LTIMER_TICK_S, tb_true);
-        tb_assert_and_check_break(scheduler_io->ltimer);
 #endif
 
         // start the io loop coroutine
@@ -259,10 +261,6 @@ tb_void_t tb_lo_scheduler_io_exit(tb_lo_scheduler_io_ref_t scheduler_io)
     // exit timer
     if (scheduler_io->timer) tb_timer_exit(scheduler_io->timer);
     scheduler_io->timer = tb_null;
-
-    // exit ltimer
-    if (scheduler_io->ltimer) tb_ltimer_exit(scheduler_io->ltimer);
-    scheduler_io->ltimer = tb_null;
 #endif
 
     // clear scheduler
@@ -282,9 +280,6 @@ tb_void_t tb_lo_scheduler_io_kill(tb_lo_scheduler_io_ref_t scheduler_io)
 #ifndef TB_CONFIG_MICRO_ENABLE
     // kill timer
     if (scheduler_io->timer) tb_timer_kill(scheduler_io->timer);
-
-    // kill ltimer
-    if (scheduler_io->ltimer) tb_ltimer_kill(scheduler_io->ltimer);
 #endif
 
     // kill poller
@@ -306,18 +301,8 @@ tb_void_t tb_lo_scheduler_io_sleep(tb_lo_scheduler_io_ref_t scheduler_io, tb_lon
     // infinity?
     if (interval > 0)
     {
-        // high-precision interval?
-        if (interval % 1000)
-        {
-            // post task to timer
-            tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
-        // low-precision interval?
-        else
-        {
-            // post task to ltimer (faster)
-            tb_ltimer_task_post(scheduler_io->ltimer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-        }
+        // post task to timer
+        tb_timer_task_post(scheduler_io->timer, interval, tb_false, tb_lo_scheduler_io_timeout, coroutine);
     }
 #else
     // not impl
@@ -336,29 +321,37 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_sock
     // trace
     tb_trace_d("coroutine(%p): wait events(%lu) with %ld ms for socket(%p) ..", coroutine, events, timeout, sock);
 
-    // enable edge-trigger mode if be supported
-    if (tb_poller_support(scheduler_io->poller, TB_POLLER_EVENT_CLEAR))
-        events |= TB_POLLER_EVENT_CLEAR;
+    /* register the socket only once with all events in the edge-trigger mode if be supported,
+     * and we only track the waited events here, so we need not modify it when the waited events are changed
+     */
+    tb_poller_ref_t poller      = scheduler_io->poller;
+    tb_size_t       events_wait = events & TB_POLLER_EVENT_EALL;
+    tb_size_t       events_poll = events_wait;
+    if (tb_poller_support(poller, TB_POLLER_EVENT_CLEAR))
+        events_poll = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR;
 
-    // exists this socket? only modify events 
+    // wake only one of the schedulers if this listening socket is shared by multiple threads
+    if ((events & TB_POLLER_EVENT_EXCLUSIVE) && tb_poller_support(poller, TB_POLLER_EVENT_EXCLUSIVE))
+        events_poll |= TB_POLLER_EVENT_EXCLUSIVE;
+
+    // exists this socket? 
     tb_socket_ref_t sock_prev = coroutine->rs.wait.sock;
     if (sock_prev == sock)
     {
         // return the cached events directly if the waiting events exists cache
-        tb_size_t events_prev   = coroutine->rs.wait.events;
-        tb_size_t events_cache  = coroutine->rs.wait.events_cache;
-        if (events_cache && (events_prev & events))
+        tb_size_t events_cache = coroutine->rs.wait.events_cache;
+        if (events_cache & events_wait)
         {
             // clear cache events
-            coroutine->rs.wait.events_cache &= ~events;
+            coroutine->rs.wait.events_cache &= ~events_wait;
 
             // return the cached events
-            coroutine->rs.wait.events_result = events_cache & events;
+            coroutine->rs.wait.events_result = events_cache & events_wait;
             return tb_false;
         }
 
-        // modify socket from poller for waiting events if the waiting events has been changed 
-        if (events_prev != events && !tb_poller_modify(scheduler_io->poller, sock, events, coroutine))
+        // modify socket from poller for waiting events if it is not registered with all events
+        if (!(events_poll & TB_POLLER_EVENT_CLEAR) && coroutine->rs.wait.events != events_wait && !tb_poller_modify(poller, sock, events_poll, coroutine))
         {
             // trace
             tb_trace_e("failed to modify sock(%p) to poller on coroutine(%p)!", sock, coroutine);
@@ -371,7 +364,7 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_sock
     else
     {
         // remove the previous socket first if exists
-        if (sock_prev && !tb_poller_remove(scheduler_io->poller, sock_prev))
+        if (sock_prev && !tb_poller_remove(poller, sock_prev))
         {
             // trace
             tb_trace_e("failed to remove sock(%p) to poller on coroutine(%p)!", sock_prev, coroutine);
@@ -382,7 +375,7 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_sock
         }
 
         // insert socket to poller for waiting events
-        if (!tb_poller_insert(scheduler_io->poller, sock, events, coroutine))
+        if (!tb_poller_insert(poller, sock, events_poll, coroutine))
         {
             // trace
             tb_trace_e("failed to insert sock(%p) to poller on coroutine(%p)!", sock, coroutine);
@@ -391,46 +384,30 @@ tb_bool_t tb_lo_scheduler_io_wait(tb_lo_scheduler_io_ref_t scheduler_io, tb_sock
             coroutine->rs.wait.events_result = -1;
             return tb_false;
         }
+
+        // clear the cached events of the previous socket
+        coroutine->rs.wait.events_cache = 0;
     }
 
 #ifndef TB_CONFIG_MICRO_ENABLE
     // exists timeout?
-    tb_cpointer_t   task = tb_null;
-    tb_bool_t       is_ltimer = tb_false;
+    tb_cpointer_t task = tb_null;
     if (timeout >= 0)
     {
-        // high-precision interval?
-        if (timeout % 1000)
-        {
-            // init task for timer
-            task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-        }
-        // low-precision interval?
-        else
-        {
-            // init task for ltimer (faster)
-            task = tb_ltimer_task_init(scheduler_io->ltimer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
-            tb_assert_and_check_return_val(task, tb_false);
-
-            // mark as low-precision timer
-            is_ltimer = tb_true;
-        }
+        // init task for timer
+        task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_lo_scheduler_io_timeout, coroutine);
+        tb_assert_and_check_return_val(task, tb_false);
     }
 
-    // check
-    tb_assert(!((tb_size_t)(task) & 0x1));
-
     // save the timer task to coroutine
-    coroutine->rs.wait.task = (is_ltimer || !task)? task : (tb_cpointer_t)((tb_size_t)(task) | 0x1);
+    coroutine->rs.wait.task = task;
 #endif
 
     // save the socket to coroutine for the timer function
     coroutine->rs.wait.sock = sock;
 
     // save waiting events to coroutine
-    coroutine->rs.wait.events        = (tb_sint32_t)events;
-    coroutine->rs.wait.events_cache  = 0;
+    coroutine->rs.wait.events        = (tb_sint32_t)events_wait;
     coroutine->rs.wait.events_result = 0;
 
     // mark as waiting state
@@ -465,6 +442,11 @@ tb_bool_t tb_lo_scheduler_io_cancel(tb_lo_scheduler_io_ref_t scheduler_io, tb_so
             return tb_false;
         }
 
+        // clear the waited socket, it will be inserted again if the next socket has the same fd
+        coroutine->rs.wait.sock          = tb_null;
+        coroutine->rs.wait.events        = 0;
+        coroutine->rs.wait.events_cache  = 0;
+
         // remove ok
         coroutine->rs.wait.events_result = 0;
         return tb_true;
@@ -53,11 +53,8 @@ typedef struct __tb_lo_scheduler_io_t
     tb_poller_ref_t     poller;
 
 #ifndef TB_CONFIG_MICRO_ENABLE
-    // the timer
+    // the timer, it uses the hierarchical timing wheels for both the sleep and the io timeout
     tb_timer_ref_t      timer;
-
-    // the low-precision timer (faster)
-    tb_ltimer_ref_t     ltimer;
 #endif
 
 }tb_lo_scheduler_io_t, *tb_lo_scheduler_io_ref_t;
@@ -95,7 +92,7 @@ tb_void_t                   tb_lo_scheduler_io_sleep(tb_lo_scheduler_io_ref_t sc
  *
  * @param scheduler_io      the io scheduler
  * @param sock              the socket
- * @param events            the waited events
+ * @param events            the waited events, the shared listening socket can also pass TB_POLLER_EVENT_EXCLUSIVE
  * @param timeout           the timeout, infinity: -1
  *
  * @return                  suspend coroutine if be tb_true
@@ -0,0 +1,104 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        profiler.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_PROFILER_H
+#define TB_COROUTINE_PROFILER_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the coroutine profiler statistics type
+ *
+ * all times are in microseconds, and the slice is the time between switching to
+ * the coroutine and switching out from it (yield, suspend, wait or finish)
+ */
+typedef struct __tb_co_profiler_stats_t
+{
+    /// the switch count, only the switches to the coroutines (not the scheduler loop) are counted
+    tb_hize_t                   switch_count;
+
+    /// the running time of all slices
+    tb_hong_t                   run_time;
+
+    /// the time spent ready but not running
+    tb_hong_t                   ready_time;
+
+    /// the longest non-yielding slice
+    tb_hong_t                   slice_max;
+
+    /// the coroutine of the longest slice
+    tb_cpointer_t               slice_max_coroutine;
+
+    /// the coroutine function of the longest slice
+    tb_cpointer_t               slice_max_func;
+
+}tb_co_profiler_stats_t;
+
+/// the coroutine profiler sample type
+typedef struct __tb_co_profiler_sample_t
+{
+    /// the coroutine
+    tb_cpointer_t               coroutine;
+
+    /// the coroutine function
+    tb_cpointer_t               func;
+
+    /// the start time of this slice, from tb_clock_ns() / 1000
+    tb_hong_t                   time;
+
+    /// the running time of this slice
+    tb_hong_t                   run_time;
+
+    /// the time spent ready before this slice
+    tb_hong_t                   ready_time;
+
+}tb_co_profiler_sample_t;
+
+/*! the profiler trace function type
+ *
+ * @param sample        the sample
+ * @param priv          the user private data
+ *
+ * @return              tb_true: continue, tb_false: break
+ */
+typedef tb_bool_t       (*tb_co_profiler_trace_func_t)(tb_co_profiler_sample_t const* sample, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
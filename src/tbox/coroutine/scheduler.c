@@ -37,12 +37,31 @@
 #include "impl/impl.h"
 #include "../algorithm/algorithm.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default shared stacks count
+#define TB_CO_SCHEDULER_SHARED_STACK_DEFCOUNT       (4)
+
+// the default shared stack size
+#ifdef __tb_small__
+#   define TB_CO_SCHEDULER_SHARED_STACK_DEFSIZE     (128 * 1024)
+#else
+#   define TB_CO_SCHEDULER_SHARED_STACK_DEFSIZE     (256 * 1024)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
 
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+// the self scheduler on the current thread
+static __tb_thread_local__ tb_co_scheduler_t*   s_scheduler_self = tb_null;
+#else
 // the self scheduler local 
 static tb_thread_local_t        s_scheduler_self = TB_THREAD_LOCAL_INIT;
+#endif
 
 // the global scheduler for the exclusive mode
 static tb_co_scheduler_t*       s_scheduler_self_ex = tb_null;
@@ -93,6 +112,10 @@ tb_co_scheduler_ref_t tb_co_scheduler_init()
         // init suspend coroutines
         tb_list_entry_init(&scheduler->coroutines_suspend, tb_coroutine_t, entry, tb_null);
 
+        // init stack pool
+        scheduler->stack_pool = tb_co_stack_pool_init();
+        tb_assert_and_check_break(scheduler->stack_pool);
+
         // init original coroutine
         scheduler->original.scheduler = (tb_co_scheduler_ref_t)scheduler;
 
@@ -115,6 +138,24 @@ tb_co_scheduler_ref_t tb_co_scheduler_init()
     // ok?
     return (tb_co_scheduler_ref_t)scheduler;
 }
+tb_co_scheduler_ref_t tb_co_scheduler_init_shared(tb_size_t stackcount, tb_size_t stacksize)
+{
+    // init scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_init();
+    tb_assert_and_check_return_val(scheduler, tb_null);
+
+    // init the shared stacks
+    if (!tb_co_scheduler_shared_init(scheduler, stackcount? stackcount : TB_CO_SCHEDULER_SHARED_STACK_DEFCOUNT, stacksize? stacksize : TB_CO_SCHEDULER_SHARED_STACK_DEFSIZE))
+    {
+        // exit it
+        scheduler->stopped = tb_true;
+        tb_co_scheduler_exit((tb_co_scheduler_ref_t)scheduler);
+        scheduler = tb_null;
+    }
+
+    // ok?
+    return (tb_co_scheduler_ref_t)scheduler;
+}
 tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
 {
     // check
@@ -153,6 +194,20 @@ tb_void_t tb_co_scheduler_exit(tb_co_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+    // drop all unhandled messages of the inbox
+    tb_co_scheduler_inbox_exit(scheduler);
+
+    // exit the shared stacks
+    tb_co_scheduler_shared_exit(scheduler);
+
+    // exit stack pool after all coroutines have been freed
+    if (scheduler->stack_pool) tb_co_stack_pool_exit(scheduler->stack_pool);
+    scheduler->stack_pool = tb_null;
+
+    // exit the profiler
+    if (scheduler->profiler) tb_co_profiler_exit(scheduler->profiler);
+    scheduler->profiler = tb_null;
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -167,6 +222,9 @@ tb_void_t tb_co_scheduler_kill(tb_co_scheduler_ref_t self)
 
     // kill the io scheduler
     if (scheduler->scheduler_io) tb_co_scheduler_io_kill(scheduler->scheduler_io);
+
+    // wake up the main loop if it is waiting the inbox
+    if (scheduler->inbox_event) tb_semaphore_post(scheduler->inbox_event, 1);
 }
 tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
 {
@@ -178,16 +236,31 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     if (exclusive) s_scheduler_self_ex = scheduler;
     else
     {
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        // update and overide the current scheduler
+        s_scheduler_self = scheduler;
+#else
         // init self scheduler local
         if (!tb_thread_local_init(&s_scheduler_self, tb_null)) return ;
      
         // update and overide the current scheduler
         tb_thread_local_set(&s_scheduler_self, self);
+#endif
     }
 
     // schedule all ready coroutines
-    while (tb_list_entry_size(&scheduler->coroutines_ready)) 
+    while (1) 
     {
+        /* no ready coroutines? wait the coroutines which will be resumed from the other threads
+         *
+         * the io loop will handle the inbox if it has been started, otherwise we need wait it here
+         */
+        if (!tb_list_entry_size(&scheduler->coroutines_ready))
+        {
+            if (tb_co_scheduler_inbox_wait(scheduler)) continue;
+            break;
+        }
+
         // check
         tb_assert(tb_coroutine_is_original(scheduler->running));
 
@@ -210,11 +283,86 @@ tb_void_t tb_co_scheduler_loop(tb_co_scheduler_ref_t self, tb_bool_t exclusive)
     else
     {
         // clear the current scheduler
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        s_scheduler_self = tb_null;
+#else
         tb_thread_local_set(&s_scheduler_self, tb_null);
+#endif
     }
 }
+tb_bool_t tb_co_scheduler_post(tb_co_scheduler_ref_t self, tb_co_scheduler_post_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && func, tb_false);
+
+    // post it to the inbox
+    return tb_co_scheduler_inbox_post(scheduler, tb_null, func, priv);
+}
 tb_co_scheduler_ref_t tb_co_scheduler_self()
 { 
     // get self scheduler on the current thread
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    return (tb_co_scheduler_ref_t)(s_scheduler_self_ex? s_scheduler_self_ex : s_scheduler_self);
+#else
     return (tb_co_scheduler_ref_t)(s_scheduler_self_ex? s_scheduler_self_ex : tb_thread_local_get(&s_scheduler_self));
+#endif
+}
+tb_bool_t tb_co_scheduler_profile(tb_co_scheduler_ref_t self, tb_bool_t enable, tb_size_t rate)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler, tb_false);
+
+    // exit the old profiler
+    if (scheduler->profiler) tb_co_profiler_exit(scheduler->profiler);
+    scheduler->profiler = tb_null;
+
+    // disable it?
+    tb_check_return_val(enable, tb_true);
+
+    // clear the old records of all alive coroutines
+    tb_list_entry_head_ref_t lists[] = {&scheduler->coroutines_ready, &scheduler->coroutines_suspend};
+    tb_co_profiler_record_reset(lists, tb_arrayn(lists), tb_offsetof(tb_coroutine_t, profiler));
+
+    // init the profiler
+    scheduler->profiler = tb_co_profiler_init(rate);
+
+    // ok?
+    return scheduler->profiler != tb_null;
+}
+tb_bool_t tb_co_scheduler_stats(tb_co_scheduler_ref_t self, tb_co_profiler_stats_t* stats)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && stats, tb_false);
+
+    // the profiler is disabled?
+    tb_check_return_val(scheduler->profiler, tb_false);
+
+    // save the statistics
+    *stats = scheduler->profiler->stats;
+    return tb_true;
+}
+tb_void_t tb_co_scheduler_stats_dump(tb_co_scheduler_ref_t self)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler && scheduler->profiler);
+
+    // dump the alive coroutines
+    tb_list_entry_head_ref_t lists[] = {&scheduler->coroutines_ready, &scheduler->coroutines_suspend};
+    tb_co_profiler_dump(scheduler->profiler, lists, tb_arrayn(lists), tb_offsetof(tb_coroutine_t, profiler));
+}
+tb_size_t tb_co_scheduler_trace(tb_co_scheduler_ref_t self, tb_co_profiler_trace_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && func, 0);
+
+    // the profiler is disabled?
+    tb_check_return_val(scheduler->profiler, 0);
+
+    // export the samples
+    return tb_co_profiler_trace(scheduler->profiler, func, priv);
 }
@@ -30,6 +30,7 @@
  * includes
  */
 #include "prefix.h"
+#include "profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -43,6 +44,9 @@ __tb_extern_c_enter__
 /// the coroutine scheduler ref type
 typedef __tb_typeref__(co_scheduler);
 
+/// the posted function type of the scheduler
+typedef tb_void_t       (*tb_co_scheduler_post_func_t)(tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -53,6 +57,23 @@ typedef __tb_typeref__(co_scheduler);
  */
 tb_co_scheduler_ref_t   tb_co_scheduler_init(tb_noarg_t);
 
+/*! init scheduler with the shared stacks (copy-on-switch mode)
+ *
+ * all coroutines run on a few shared large stacks, and only the used part of the stack
+ * is copied out to a right-sized buffer when the other coroutine occupies the same stack.
+ *
+ * an idle coroutine only costs about its live stack depth, but the switching will be slower.
+ *
+ * @note the stack data of the coroutine cannot be accessed by the other coroutines,
+ * and the coroutine with the larger stack size will still use the private stack
+ *
+ * @param stackcount    the shared stacks count, uses the default count if be zero
+ * @param stacksize     the shared stack size, uses the default size if be zero
+ *
+ * @return              the scheduler 
+ */
+tb_co_scheduler_ref_t   tb_co_scheduler_init_shared(tb_size_t stackcount, tb_size_t stacksize);
+
 /*! exit scheduler
  *
  * @param scheduler     the scheduler
@@ -73,12 +94,73 @@ tb_void_t               tb_co_scheduler_kill(tb_co_scheduler_ref_t scheduler);
  */
 tb_void_t               tb_co_scheduler_loop(tb_co_scheduler_ref_t schedule, tb_bool_t exclusive);
 
+/*! post a function to the scheduler from any thread (thread-safe)
+ *
+ * the function will be called in the scheduler thread by the io loop,
+ * and the io loop will be waked up immediately if it is waiting for the io events.
+ *
+ * @note the scheduler must be alive and the io loop will be started by the io operations or sleep()
+ *
+ * @param scheduler     the scheduler
+ * @param func          the function
+ * @param priv          the user private data
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_post(tb_co_scheduler_ref_t scheduler, tb_co_scheduler_post_func_t func, tb_cpointer_t priv);
+
 /*! get the scheduler of the current coroutine
  *
  * @return              the scheduler
  */
 tb_co_scheduler_ref_t   tb_co_scheduler_self(tb_noarg_t);
 
+/*! enable or disable the runtime profiler of the scheduler
+ *
+ * it records the running time, ready time, switch count and the longest slice of each coroutine,
+ * and the scheduler only checks one pointer in the switch path if it is disabled.
+ *
+ * @note it is not thread-safe and must be called in the scheduler thread
+ *
+ * @param scheduler     the scheduler
+ * @param enable        enable or disable it, the old statistics will be cleared if be enabled again
+ * @param rate          sample one slice every rate slices for tb_co_scheduler_trace(), no samples if be zero
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_co_scheduler_profile(tb_co_scheduler_ref_t scheduler, tb_bool_t enable, tb_size_t rate);
+
+/*! get the profiler statistics of the scheduler
+ *
+ * @note it must be called in the scheduler thread
+ *
+ * @param scheduler     the scheduler
+ * @param stats         the statistics
+ *
+ * @return              tb_true or tb_false (the profiler is disabled)
+ */
+tb_bool_t               tb_co_scheduler_stats(tb_co_scheduler_ref_t scheduler, tb_co_profiler_stats_t* stats);
+
+/*! dump the profiler statistics and the busiest coroutines
+ *
+ * @note it must be called in the scheduler thread
+ *
+ * @param scheduler     the scheduler
+ */
+tb_void_t               tb_co_scheduler_stats_dump(tb_co_scheduler_ref_t scheduler);
+
+/*! export the sampled slices in the time order
+ *
+ * @note it must be called in the scheduler thread
+ *
+ * @param scheduler     the scheduler
+ * @param func          the trace function
+ * @param priv          the user private data
+ *
+ * @return              the exported samples count
+ */
+tb_size_t               tb_co_scheduler_trace(tb_co_scheduler_ref_t scheduler, tb_co_profiler_trace_func_t func, tb_cpointer_t priv);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -0,0 +1,415 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_group.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "scheduler_group"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "scheduler_group.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the maximum worker count
+#ifdef __tb_small__
+#   define TB_SCHEDULER_GROUP_WORKER_MAXN   (64)
+#else
+#   define TB_SCHEDULER_GROUP_WORKER_MAXN   (256)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_int_t tb_co_scheduler_group_worker_loop(tb_cpointer_t priv)
+{
+    // check
+    tb_co_scheduler_worker_t* worker = (tb_co_scheduler_worker_t*)priv;
+    tb_assert_and_check_return_val(worker && worker->scheduler, -1);
+
+    // trace
+    tb_trace_d("worker(%lu): loop ..", worker->index);
+
+    /* pin this worker to its physical core, the coroutine stacks will be mapped and touched on the local node
+     *
+     * the first worker is run in the thread of tb_co_scheduler_group_loop(), 
+     * so we need restore the original affinity after the loop
+     */
+    tb_bool_t   pinned = tb_false;
+    tb_cpuset_t affinity;
+    if (worker->group->pinned && tb_thread_affinity_get(tb_null, &affinity))
+    {
+        tb_processor_topology_t const* topology = tb_processor_topology();
+        if (topology && worker->index < topology->cores_count)
+            pinned = tb_thread_affinity_set(tb_null, (tb_cpuset_ref_t)&topology->cores[worker->index].cpus);
+    }
+
+    // run the scheduler of this worker
+    tb_co_scheduler_loop((tb_co_scheduler_ref_t)worker->scheduler, tb_false);
+
+    // restore the original affinity
+    if (pinned) tb_thread_affinity_set(tb_null, &affinity);
+
+    // trace
+    tb_trace_d("worker(%lu): exit", worker->index);
+
+    // ok
+    return 0;
+}
+static tb_co_scheduler_worker_t* tb_co_scheduler_group_worker_self(tb_co_scheduler_group_t* group)
+{
+    // get the current scheduler
+    tb_co_scheduler_t* scheduler = (tb_co_scheduler_t*)tb_co_scheduler_self();
+    tb_check_return_val(scheduler && scheduler->worker, tb_null);
+
+    // get the worker if it belongs to the given group
+    return (!group || scheduler->worker->group == group)? scheduler->worker : tb_null;
+}
+static tb_void_t tb_co_scheduler_group_worker_wake(tb_co_scheduler_group_t* group, tb_co_scheduler_worker_t* worker)
+{
+    // check
+    tb_assert(group && worker);
+
+    // get the idle worker, attempt to wake the owner worker first
+    tb_co_scheduler_worker_t* idle = tb_null;
+    if (tb_atomic_get(&worker->idle)) idle = worker;
+    else
+    {
+        // find an idle worker to steal it
+        tb_size_t i = 1;
+        for (i = 1; i < group->count && !idle; i++)
+        {
+            tb_co_scheduler_worker_t* other = &group->workers[(worker->index + i) % group->count];
+            if (tb_atomic_get(&other->idle)) idle = other;
+        }
+    }
+
+    // spak the poller of this idle worker if it is waiting now
+    if (idle && idle->scheduler->scheduler_io && idle->scheduler->scheduler_io->poller)
+    {
+        // trace
+        tb_trace_d("wake worker(%lu)", idle->index);
+
+        // spak it
+        tb_poller_spak(idle->scheduler->scheduler_io->poller);
+    }
+}
+static tb_void_t tb_co_scheduler_group_worker_clear(tb_co_scheduler_worker_t* worker)
+{
+    // check
+    tb_assert(worker && worker->group);
+
+    // enter lock
+    tb_spinlock_enter(&worker->lock);
+
+    // free all pending tasks
+    while (tb_single_list_entry_size(&worker->pending))
+    {
+        // get the next entry from head
+        tb_single_list_entry_ref_t entry = tb_single_list_entry_head(&worker->pending);
+        tb_assert(entry);
+
+        // remove it from the pending tasks
+        tb_single_list_entry_remove_head(&worker->pending);
+
+        // exit this task
+        tb_free(tb_single_list_entry0(entry));
+        tb_atomic_fetch_and_dec(&worker->group->alive);
+    }
+
+    // leave lock
+    tb_spinlock_leave(&worker->lock);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_co_scheduler_group_ref_t tb_co_scheduler_group_init(tb_size_t count)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_co_scheduler_group_t*    group = tb_null;
+    do
+    {
+        // uses the processor count if be zero
+        if (!count) count = tb_processor_count();
+        if (!count) count = 1;
+        tb_assert_and_check_break(count <= TB_SCHEDULER_GROUP_WORKER_MAXN);
+
+        // make group
+        group = tb_malloc0_type(tb_co_scheduler_group_t);
+        tb_assert_and_check_break(group);
+
+        // make workers
+        group->workers = tb_nalloc0_type(count, tb_co_scheduler_worker_t);
+        tb_assert_and_check_break(group->workers);
+
+        // init workers
+        tb_size_t i = 0;
+        for (i = 0; i < count; i++)
+        {
+            // init worker
+            tb_co_scheduler_worker_t* worker = &group->workers[i];
+            worker->group = group;
+            worker->index = i;
+
+            // init lock
+            if (!tb_spinlock_init(&worker->lock)) break;
+
+            // init pending tasks
+            tb_single_list_entry_init(&worker->pending, tb_co_scheduler_task_t, entry, tb_null);
+
+            // init the scheduler of this worker
+            worker->scheduler = (tb_co_scheduler_t*)tb_co_scheduler_init();
+            tb_assert_and_check_break(worker->scheduler);
+
+            // bind this worker to scheduler
+            worker->scheduler->worker = worker;
+
+            // update the worker count for exit() if failed
+            group->count = i + 1;
+        }
+        tb_check_break(i == count);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (group) tb_co_scheduler_group_exit((tb_co_scheduler_group_ref_t)group);
+        group = tb_null;
+    }
+
+    // ok?
+    return (tb_co_scheduler_group_ref_t)group;
+}
+tb_co_scheduler_group_ref_t tb_co_scheduler_group_init_pinned()
+{
+    // get the physical cores count
+    tb_processor_topology_t const* topology = tb_processor_topology();
+    tb_assert_and_check_return_val(topology && topology->cores_count, tb_null);
+
+    // init group with one worker per physical core
+    tb_co_scheduler_group_t* group = (tb_co_scheduler_group_t*)tb_co_scheduler_group_init(tb_min(topology->cores_count, TB_SCHEDULER_GROUP_WORKER_MAXN));
+    tb_assert_and_check_return_val(group, tb_null);
+
+    // pin all workers and bind them to the numa nodes of their cores
+    tb_size_t i = 0;
+    for (i = 0; i < group->count; i++) group->workers[i].node = topology->cores[i].node;
+    group->pinned = tb_true;
+
+    // ok
+    return (tb_co_scheduler_group_ref_t)group;
+}
+tb_void_t tb_co_scheduler_group_exit(tb_co_scheduler_group_ref_t self)
+{
+    // check
+    tb_co_scheduler_group_t* group = (tb_co_scheduler_group_t*)self;
+    tb_assert_and_check_return(group);
+
+    // exit workers
+    if (group->workers)
+    {
+        tb_size_t i = 0;
+        for (i = 0; i < group->count; i++)
+        {
+            // the worker
+            tb_co_scheduler_worker_t* worker = &group->workers[i];
+
+            // exit the worker thread
+            if (worker->thread) tb_thread_exit(worker->thread);
+            worker->thread = tb_null;
+
+            // free all pending tasks
+            tb_co_scheduler_group_worker_clear(worker);
+
+            // exit the scheduler of this worker
+            if (worker->scheduler)
+            {
+                // stop it if the loop have been not run
+                worker->scheduler->stopped = tb_true;
+
+                // exit it
+                tb_co_scheduler_exit((tb_co_scheduler_ref_t)worker->scheduler);
+            }
+            worker->scheduler = tb_null;
+
+            // exit pending tasks
+            tb_single_list_entry_exit(&worker->pending);
+
+            // exit lock
+            tb_spinlock_exit(&worker->lock);
+        }
+
+        // free workers
+        tb_free(group->workers);
+    }
+    group->workers = tb_null;
+
+    // free it
+    tb_free(group);
+}
+tb_void_t tb_co_scheduler_group_kill(tb_co_scheduler_group_ref_t self)
+{
+    // check
+    tb_co_scheduler_group_t* group = (tb_co_scheduler_group_t*)self;
+    tb_assert_and_check_return(group && group->workers);
+
+    // trace
+    tb_trace_d("kill: ..");
+
+    // stop it
+    if (!tb_atomic_fetch_and_set(&group->stopped, 1))
+    {
+        // kill all schedulers
+        tb_size_t i = 0;
+        for (i = 0; i < group->count; i++)
+        {
+            if (group->workers[i].scheduler)
+                tb_co_scheduler_kill((tb_co_scheduler_ref_t)group->workers[i].scheduler);
+        }
+    }
+}
+tb_bool_t tb_co_scheduler_group_start(tb_co_scheduler_group_ref_t self, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_false);
+
+    // get the current worker
+    tb_co_scheduler_group_t*    group = (tb_co_scheduler_group_t*)self;
+    tb_co_scheduler_worker_t*   worker = tb_co_scheduler_group_worker_self(group);
+
+    // uses the group of the current worker if be null
+    if (!group && worker) group = worker->group;
+    tb_assert_and_check_return_val(group && group->workers && group->count, tb_false);
+
+    // have been stopped? do not continue to start new coroutines
+    tb_check_return_val(!tb_atomic_get(&group->stopped), tb_false);
+
+    // the current thread is not a worker of this group? post it to the next worker
+    if (!worker) worker = &group->workers[(tb_size_t)tb_atomic_fetch_and_inc(&group->next) % group->count];
+    tb_assert(worker);
+
+    // make task
+    tb_co_scheduler_task_t* task = tb_malloc0_type(tb_co_scheduler_task_t);
+    tb_assert_and_check_return_val(task, tb_false);
+
+    // init task
+    task->group     = group;
+    task->func      = func;
+    task->priv      = priv;
+    task->stacksize = stacksize;
+
+    // the alive coroutines++
+    tb_atomic_fetch_and_inc(&group->alive);
+
+    // post it to the pending tasks of this worker
+    tb_spinlock_enter(&worker->lock);
+    tb_single_list_entry_insert_tail(&worker->pending, &task->entry);
+    tb_spinlock_leave(&worker->lock);
+
+    // wake an idle worker to start or steal it
+    tb_co_scheduler_group_worker_wake(group, worker);
+
+    // trace
+    tb_trace_d("start: post task(%p) to worker(%lu)", task, worker->index);
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_co_scheduler_group_loop(tb_co_scheduler_group_ref_t self)
+{
+    // check
+    tb_co_scheduler_group_t* group = (tb_co_scheduler_group_t*)self;
+    tb_assert_and_check_return(group && group->workers && group->count);
+
+    // done
+    tb_size_t i = 0;
+    do
+    {
+        // init the io schedulers of all workers before running them, the other workers need spak their pollers
+        for (i = 0; i < group->count; i++)
+        {
+            tb_co_scheduler_t* scheduler = group->workers[i].scheduler;
+            tb_assert_and_check_break(scheduler);
+
+            if (!scheduler->scheduler_io) scheduler->scheduler_io = tb_co_scheduler_io_init(scheduler);
+            tb_assert_and_check_break(scheduler->scheduler_io);
+        }
+        tb_check_break(i == group->count);
+
+        // start the other worker threads
+        for (i = 1; i < group->count; i++)
+        {
+            tb_co_scheduler_worker_t* worker = &group->workers[i];
+            worker->thread = tb_thread_init(tb_null, tb_co_scheduler_group_worker_loop, worker, 0);
+            tb_assert_and_check_break(worker->thread);
+        }
+
+        // kill all workers if failed
+        if (i != group->count) tb_co_scheduler_group_kill(self);
+
+        // run the first worker in the current thread
+        tb_co_scheduler_group_worker_loop(&group->workers[0]);
+
+        // run the remaining workers without threads if failed, they will be exited directly after killing
+        for (i = 1; i < group->count; i++)
+        {
+            tb_co_scheduler_worker_t* worker = &group->workers[i];
+            if (!worker->thread) tb_co_scheduler_group_worker_loop(worker);
+        }
+
+    } while (0);
+
+    // wait all worker threads
+    for (i = 1; i < group->count; i++)
+    {
+        tb_co_scheduler_worker_t* worker = &group->workers[i];
+        if (worker->thread) tb_thread_wait(worker->thread, -1, tb_null);
+    }
+
+    // trace
+    tb_trace_d("loop: end");
+}
+tb_size_t tb_co_scheduler_group_size(tb_co_scheduler_group_ref_t self)
+{
+    // check
+    tb_co_scheduler_group_t* group = (tb_co_scheduler_group_t*)self;
+    tb_assert_and_check_return_val(group, 0);
+
+    // the worker count
+    return group->count;
+}
@@ -0,0 +1,161 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        scheduler_group.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_SCHEDULER_GROUP_H
+#define TB_COROUTINE_SCHEDULER_GROUP_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "coroutine.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the coroutine scheduler group ref type
+ *
+ * the multi-threaded scheduler mode, it runs one scheduler per worker thread
+ * and each worker has its own ready coroutines and poller.
+ *
+ * the coroutines started by tb_co_scheduler_group_start() are pending in the worker queue
+ * until they are started, and the idle workers will steal them from the busy workers.
+ *
+ * @note the started coroutine will be always run on the same worker,
+ * because its sockets have been bound to the poller of this worker.
+ */
+typedef __tb_typeref__(co_scheduler_group);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init scheduler group
+ *
+ * @code
+
+    static tb_void_t tb_demo_coroutine_listen(tb_cpointer_t priv)
+    {
+        // ...
+        while (tb_socket_wait(sock, TB_SOCKET_EVENT_ACPT, -1) > 0)
+        {
+            tb_socket_ref_t client = tb_null;
+            while ((client = tb_socket_accept(sock, tb_null)))
+            {
+                // start the client coroutine to the current group, it may be stolen by the other idle workers
+                if (!tb_co_scheduler_group_start(tb_null, tb_demo_coroutine_client, client, 0)) break;
+            }
+        }
+    }
+
+    tb_co_scheduler_group_ref_t group = tb_co_scheduler_group_init(0);
+    if (group)
+    {
+        // start listening
+        tb_co_scheduler_group_start(group, tb_demo_coroutine_listen, tb_null, 0);
+
+        // run all workers
+        tb_co_scheduler_group_loop(group);
+
+        // exit group
+        tb_co_scheduler_group_exit(group);
+    }
+
+ * @endcode
+ *
+ * @param count         the worker count, uses the processor count if be zero
+ *
+ * @return              the scheduler group
+ */
+tb_co_scheduler_group_ref_t tb_co_scheduler_group_init(tb_size_t count);
+
+/*! init scheduler group with one pinned worker per physical core
+ *
+ * each worker is pinned to the smt siblings of its physical core, so its coroutine stacks
+ * are allocated on the local numa node, and the idle worker steals the pending coroutines
+ * from the workers on the same node before the other nodes.
+ *
+ * @note the thread of tb_co_scheduler_group_loop() runs the first worker on the first core,
+ * and its original affinity will be restored after the loop.
+ *
+ * @return              the scheduler group
+ */
+tb_co_scheduler_group_ref_t tb_co_scheduler_group_init_pinned(tb_noarg_t);
+
+/*! exit scheduler group
+ *
+ * @param group         the scheduler group
+ */
+tb_void_t                   tb_co_scheduler_group_exit(tb_co_scheduler_group_ref_t group);
+
+/*! kill all workers of the scheduler group
+ *
+ * @param group         the scheduler group
+ */
+tb_void_t                   tb_co_scheduler_group_kill(tb_co_scheduler_group_ref_t group);
+
+/*! start coroutine to the scheduler group
+ *
+ * it will be posted to the queue of the current worker (or the next worker if be called from the other threads)
+ * and be started when this worker is idle or be stolen by the other idle workers.
+ *
+ * @param group         the scheduler group, uses the group of the current worker if be null
+ * @param func          the coroutine function
+ * @param priv          the passed user private data as the argument of function
+ * @param stacksize     the stack size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_co_scheduler_group_start(tb_co_scheduler_group_ref_t group, tb_coroutine_func_t func, tb_cpointer_t priv, tb_size_t stacksize);
+
+/*! run all workers of the scheduler group
+ *
+ * the current thread will be used as the first worker,
+ * and it will return after all group coroutines have been finished or the group be killed.
+ *
+ * @param group         the scheduler group
+ */
+tb_void_t                   tb_co_scheduler_group_loop(tb_co_scheduler_group_ref_t group);
+
+/*! get the worker count of the scheduler group
+ *
+ * @param group         the scheduler group
+ *
+ * @return              the worker count
+ */
+tb_size_t                   tb_co_scheduler_group_size(tb_co_scheduler_group_ref_t group);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,297 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.c
+ * @ingroup     coroutine
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "select"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "select.h"
+#include "coroutine.h"
+#include "scheduler.h"
+#include "impl/impl.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_co_select_fire(tb_co_select_t* select, tb_size_t fired)
+{
+    // check
+    tb_assert(select && select->coroutine);
+
+    // claim it, it may have been fired by the other cases
+    tb_check_return_val(!tb_atomic_fetch_and_pset(&select->fired, 0, fired), tb_false);
+
+    // trace
+    tb_trace_d("coroutine(%p): fired: %lu", select->coroutine, fired);
+
+    // resume the select coroutine
+    tb_co_scheduler_resume((tb_co_scheduler_t*)tb_coroutine_scheduler(select->coroutine), select->coroutine, tb_null);
+    return tb_true;
+}
+static tb_void_t tb_co_select_timeout(tb_bool_t killed, tb_cpointer_t priv)
+{
+    // check
+    tb_co_select_t* select = (tb_co_select_t*)priv;
+    tb_assert(select);
+
+    // timeout
+    tb_co_select_fire(select, select->count + 1);
+}
+static tb_long_t tb_co_select_try(tb_co_select_case_t* cases, tb_size_t count)
+{
+    // recv data from the ready channel
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (cases[i].type == TB_CO_SELECT_CASE_TYPE_RECV && tb_co_channel_recv_try(cases[i].channel, &cases[i].data)) 
+            return (tb_long_t)i;
+    }
+
+    // no ready cases
+    return -1;
+}
+static tb_bool_t tb_co_select_wait(tb_co_select_t* select, tb_co_scheduler_io_ref_t scheduler_io, tb_long_t timeout)
+{
+    // check
+    tb_assert(select && scheduler_io && scheduler_io->poller);
+
+    // the coroutine
+    tb_coroutine_t* coroutine = select->coroutine;
+
+    // init waiters
+    tb_size_t i = 0;
+    tb_size_t count = select->count;
+    tb_memset(select->waiters, 0, count * sizeof(tb_co_waiter_t));
+    for (i = 0; i < count; i++)
+    {
+        select->waiters[i].coroutine    = coroutine;
+        select->waiters[i].fired        = &select->fired;
+        select->waiters[i].index        = i;
+    }
+    tb_atomic_set0(&select->fired);
+
+    // link waiters to the channels
+    tb_bool_t ready = tb_false;
+    for (i = 0; i < count && !ready; i++)
+    {
+        tb_co_select_case_t* scase = &select->cases[i];
+        if (scase->type == TB_CO_SELECT_CASE_TYPE_RECV && !tb_co_channel_wait_recv(scase->channel, &select->waiters[i]))
+            ready = tb_true;
+    }
+
+    // insert sockets to poller
+    tb_bool_t ok = tb_true;
+    for (i = 0; i < count && !ready && ok; i++)
+    {
+        tb_co_select_case_t* scase = &select->cases[i];
+        if (scase->type == TB_CO_SELECT_CASE_TYPE_SOCK)
+        {
+            // remove the cached socket of the previous waitio() first
+            if (coroutine->rs.wait.sock == scase->sock)
+            {
+                tb_poller_remove(scheduler_io->poller, scase->sock);
+                coroutine->rs.wait.sock = tb_null;
+            }
+
+            // insert it with the level-trigger mode, because it will be removed after waiting
+            if (!tb_poller_insert(scheduler_io->poller, scase->sock, scase->events, coroutine))
+            {
+                // trace
+                tb_trace_e("failed to insert sock(%p) to poller on coroutine(%p)!", scase->sock, coroutine);
+
+                // failed
+                ok = tb_false;
+            }
+
+            // mark as inserted
+            select->waiters[i].linked = ok;
+        }
+    }
+
+    // init the timer task
+    select->task = tb_null;
+    if (!ready && ok && timeout > 0)
+    {
+        select->task = tb_timer_task_init(scheduler_io->timer, timeout, tb_false, tb_co_select_timeout, select);
+        if (!select->task) ok = tb_false;
+    }
+
+    // wait it if no ready cases
+    if (!ready && ok)
+    {
+        coroutine->select = select;
+        tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
+        coroutine->select = tb_null;
+    }
+    /* cancel it, but it may have been claimed by the send coroutine of the other scheduler,
+     * so we need wait it to be resumed
+     */
+    else if (tb_atomic_fetch_and_pset(&select->fired, 0, count + 2))
+        tb_co_scheduler_suspend(scheduler_io->scheduler, tb_null);
+
+    // remove all waiters
+    for (i = 0; i < count; i++)
+    {
+        tb_co_select_case_t* scase = &select->cases[i];
+        if (scase->type == TB_CO_SELECT_CASE_TYPE_RECV) tb_co_channel_wait_cancel(scase->channel, &select->waiters[i]);
+        else if (scase->type == TB_CO_SELECT_CASE_TYPE_SOCK && select->waiters[i].linked)
+        {
+            tb_poller_remove(scheduler_io->poller, scase->sock);
+            select->waiters[i].linked = tb_false;
+        }
+    }
+
+    // remove the timer task
+    if (select->task)
+    {
+        tb_timer_task_exit(scheduler_io->timer, (tb_timer_task_ref_t)select->task);
+        select->task = tb_null;
+    }
+
+    // ok?
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_co_select_spak(tb_co_select_t* select, tb_socket_ref_t sock, tb_size_t events)
+{
+    // check
+    tb_assert(select && sock);
+
+    // fire the socket case
+    tb_size_t i = 0;
+    for (i = 0; i < select->count; i++)
+    {
+        tb_co_select_case_t* scase = &select->cases[i];
+        if (scase->type == TB_CO_SELECT_CASE_TYPE_SOCK && scase->sock == sock)
+        {
+            if (tb_co_select_fire(select, i + 1)) scase->events = events;
+            break;
+        }
+    }
+}
+tb_long_t tb_co_select(tb_co_select_case_t* cases, tb_size_t count, tb_long_t timeout)
+{
+    // check
+    tb_assert_and_check_return_val(cases && count, TB_CO_SELECT_FAILED);
+
+    // get the running coroutine
+    tb_coroutine_t* running = (tb_coroutine_t*)tb_coroutine_self();
+    tb_assert_and_check_return_val(running, TB_CO_SELECT_FAILED);
+
+    // recv data from the ready channel first
+    tb_long_t index = tb_co_select_try(cases, count);
+    tb_check_return_val(index < 0, index);
+
+    // no waiting?
+    tb_check_return_val(timeout, TB_CO_SELECT_TIMEOUT);
+
+    // get the io scheduler
+    tb_co_scheduler_t*          scheduler = (tb_co_scheduler_t*)tb_coroutine_scheduler(running);
+    tb_co_scheduler_io_ref_t    scheduler_io = tb_co_scheduler_io_need(scheduler);
+    tb_check_return_val(scheduler_io, TB_CO_SELECT_FAILED);
+
+    // make select, we cannot use the stack data because it may be saved if the coroutine uses the shared stack
+    tb_co_select_t* select = (tb_co_select_t*)tb_malloc0(sizeof(tb_co_select_t) + count * (sizeof(tb_co_select_case_t) + sizeof(tb_co_waiter_t)));
+    tb_assert_and_check_return_val(select, TB_CO_SELECT_FAILED);
+
+    // init select
+    select->coroutine   = running;
+    select->count       = count;
+    select->cases       = (tb_co_select_case_t*)(select + 1);
+    select->waiters     = (tb_co_waiter_t*)(select->cases + count);
+    tb_memcpy(select->cases, cases, count * sizeof(tb_co_select_case_t));
+
+    // done
+    tb_hong_t   deadline = timeout > 0? tb_mclock() + timeout : -1;
+    tb_long_t   result = TB_CO_SELECT_FAILED;
+    while (!scheduler->stopped)
+    {
+        // wait cases
+        if (!tb_co_select_wait(select, scheduler_io, timeout)) break;
+
+        // timeout?
+        tb_size_t fired = (tb_size_t)tb_atomic_get(&select->fired);
+        if (fired == count + 1) 
+        {
+            result = TB_CO_SELECT_TIMEOUT;
+            break;
+        }
+
+        // the case has been fired?
+        if (fired && fired <= count)
+        {
+            index = (tb_long_t)fired - 1;
+            if (cases[index].type == TB_CO_SELECT_CASE_TYPE_SOCK)
+            {
+                cases[index].events = select->cases[index].events;
+                result = index;
+                break;
+            }
+            else if (tb_co_channel_wait_fetch(cases[index].channel, &select->waiters[index], &cases[index].data))
+            {
+                result = index;
+                break;
+            }
+        }
+
+        // the data may be ready now or be received by the other coroutines, try it again
+        index = tb_co_select_try(cases, count);
+        if (index >= 0)
+        {
+            result = index;
+            break;
+        }
+
+        // update the timeout
+        if (deadline >= 0)
+        {
+            tb_hong_t left = deadline - tb_mclock();
+            if (left <= 0)
+            {
+                result = TB_CO_SELECT_TIMEOUT;
+                break;
+            }
+            timeout = (tb_long_t)left;
+        }
+    }
+
+    // exit select
+    tb_free(select);
+
+    // trace
+    tb_trace_d("coroutine(%p): select: %ld", running, result);
+
+    // ok?
+    return result;
+}
@@ -0,0 +1,127 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        select.h
+ * @ingroup     coroutine
+ *
+ */
+#ifndef TB_COROUTINE_SELECT_H
+#define TB_COROUTINE_SELECT_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "channel.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/// select() is timeout
+#define TB_CO_SELECT_TIMEOUT            (-1)
+
+/// select() is failed
+#define TB_CO_SELECT_FAILED             (-2)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the select case type enum
+typedef enum __tb_co_select_case_type_e
+{
+    TB_CO_SELECT_CASE_TYPE_NONE         = 0     //!< ignored
+,   TB_CO_SELECT_CASE_TYPE_RECV         = 1     //!< recv data from the channel
+,   TB_CO_SELECT_CASE_TYPE_SOCK         = 2     //!< wait the socket events
+
+}tb_co_select_case_type_e;
+
+/// the select case type
+typedef struct __tb_co_select_case_t
+{
+    /// the case type
+    tb_size_t                   type;
+
+    /// the channel for TB_CO_SELECT_CASE_TYPE_RECV
+    tb_co_channel_ref_t         channel;
+
+    /// the received data for TB_CO_SELECT_CASE_TYPE_RECV
+    tb_pointer_t                data;
+
+    /// the socket for TB_CO_SELECT_CASE_TYPE_SOCK
+    tb_socket_ref_t             sock;
+
+    /// the waited socket events for TB_CO_SELECT_CASE_TYPE_SOCK, and return the ready events
+    tb_size_t                   events;
+
+}tb_co_select_case_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! wait multiple channels and sockets with the timeout at the same time
+ *
+ * the current coroutine will be suspend until one of the cases is ready or timeout,
+ * and the channels can be sent by the coroutines of the other schedulers (threads).
+ *
+ * @code
+    tb_co_select_case_t cases[2] = {{0}};
+    cases[0].type       = TB_CO_SELECT_CASE_TYPE_RECV;
+    cases[0].channel    = channel;
+    cases[1].type       = TB_CO_SELECT_CASE_TYPE_SOCK;
+    cases[1].sock       = sock;
+    cases[1].events     = TB_SOCKET_EVENT_RECV;
+    switch (tb_co_select(cases, 2, 1000))
+    {
+    case 0: // cases[0].data
+        break;
+    case 1: // cases[1].events
+        break;
+    case TB_CO_SELECT_TIMEOUT:
+        break;
+    default:
+        break;
+    }
+ * @endcode
+ *
+ * @note the waited sockets must not be waited by the other coroutines at the same time
+ *
+ * @param cases         the cases
+ * @param count         the cases count
+ * @param timeout       the timeout, infinity: -1
+ *
+ * @return              the index of the ready case, TB_CO_SELECT_TIMEOUT or TB_CO_SELECT_FAILED
+ */
+tb_long_t               tb_co_select(tb_co_select_case_t* cases, tb_size_t count, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
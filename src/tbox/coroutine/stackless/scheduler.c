@@ -53,7 +53,11 @@
  * globals
  */
 
-#ifndef TB_CONFIG_MICRO_ENABLE
+#if defined(TB_CONFIG_MICRO_ENABLE)
+#elif defined(TB_THREAD_LOCAL_STATIC_ENABLE)
+// the self scheduler on the current thread
+static __tb_thread_local__ tb_lo_scheduler_t*   s_scheduler_self = tb_null;
+#else
 // the self scheduler local 
 static tb_thread_local_t        s_scheduler_self = TB_THREAD_LOCAL_INIT;
 #endif
@@ -102,6 +106,11 @@ static tb_void_t tb_lo_scheduler_make_ready(tb_lo_scheduler_t* scheduler, tb_lo_
         // .. last -> coroutine(inserted)
         tb_list_entry_insert_tail(&scheduler->coroutines_ready, &coroutine->entry);
     }
+
+#ifdef TB_CO_PROFILER_ENABLE
+    // mark the ready time for the profiler
+    if (__tb_unlikely__(scheduler->profiler != tb_null)) tb_co_profiler_ready(scheduler->profiler, &coroutine->profiler);
+#endif
 }
 static tb_void_t tb_lo_scheduler_make_dead(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t* coroutine)
 {
@@ -164,6 +173,17 @@ static tb_void_t tb_lo_scheduler_switch(tb_lo_scheduler_t* scheduler, tb_lo_coro
     // mark the given coroutine as running
     scheduler->running = coroutine;
 
+#ifdef TB_CO_PROFILER_ENABLE
+    // profile this slice, the coroutine function will return if it yields, suspends or finishes
+    if (__tb_unlikely__(scheduler->profiler != tb_null))
+    {
+        tb_co_profiler_switch(scheduler->profiler, tb_null, tb_null, &coroutine->profiler);
+        coroutine->func((tb_lo_coroutine_ref_t)coroutine, coroutine->priv);
+        if (scheduler->profiler) tb_co_profiler_switch(scheduler->profiler, coroutine, &coroutine->profiler, tb_null);
+        return ;
+    }
+#endif
+
     // call the coroutine function
     coroutine->func((tb_lo_coroutine_ref_t)coroutine, coroutine->priv);
 }
@@ -208,6 +228,11 @@ tb_bool_t tb_lo_scheduler_start(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_fu
         if (!coroutine) coroutine = tb_lo_coroutine_init((tb_lo_scheduler_ref_t)scheduler, func, priv, free);
         tb_assert_and_check_break(coroutine);
 
+#ifdef TB_CO_PROFILER_ENABLE
+        // reset the profiler record
+        tb_co_profiler_record_init(&coroutine->profiler, (tb_cpointer_t)func);
+#endif
+
         // ready coroutine
         tb_lo_scheduler_make_ready(scheduler, coroutine);
 
@@ -250,11 +275,14 @@ tb_void_t tb_lo_scheduler_resume(tb_lo_scheduler_t* scheduler, tb_lo_coroutine_t
 }
 tb_lo_scheduler_ref_t tb_lo_scheduler_self_()
 { 
-#ifndef TB_CONFIG_MICRO_ENABLE
+#if defined(TB_CONFIG_MICRO_ENABLE)
+    return (tb_lo_scheduler_ref_t)s_scheduler_self_ex;
+#elif defined(TB_THREAD_LOCAL_STATIC_ENABLE)
     // get self scheduler on the current thread
-    return (tb_lo_scheduler_ref_t)(s_scheduler_self_ex? s_scheduler_self_ex : tb_thread_local_get(&s_scheduler_self));
+    return (tb_lo_scheduler_ref_t)(s_scheduler_self_ex? s_scheduler_self_ex : s_scheduler_self);
 #else
-    return (tb_lo_scheduler_ref_t)s_scheduler_self_ex;
+    // get self scheduler on the current thread
+    return (tb_lo_scheduler_ref_t)(s_scheduler_self_ex? s_scheduler_self_ex : tb_thread_local_get(&s_scheduler_self));
 #endif
 }
 
@@ -332,6 +360,12 @@ tb_void_t tb_lo_scheduler_exit(tb_lo_scheduler_ref_t self)
     // exit suspend coroutines
     tb_list_entry_exit(&scheduler->coroutines_suspend);
 
+#ifdef TB_CO_PROFILER_ENABLE
+    // exit the profiler
+    if (scheduler->profiler) tb_co_profiler_exit(scheduler->profiler);
+    scheduler->profiler = tb_null;
+#endif
+
     // exit the scheduler
     tb_free(scheduler);
 }
@@ -352,20 +386,26 @@ tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
 
     // is exclusive mode?
     if (exclusive) s_scheduler_self_ex = scheduler;
-#ifndef TB_CONFIG_MICRO_ENABLE
+#if defined(TB_CONFIG_MICRO_ENABLE)
+    else
+    {
+        // trace
+        tb_trace_e("non-exclusive is not suspported in micro mode!");
+    }
+#elif defined(TB_THREAD_LOCAL_STATIC_ENABLE)
     else
     {
-        // init self scheduler local
-        if (!tb_thread_local_init(&s_scheduler_self, tb_null)) return ;
-     
         // update and overide the current scheduler
-        tb_thread_local_set(&s_scheduler_self, self);
+        s_scheduler_self = scheduler;
     }
 #else
     else
     {
-        // trace
-        tb_trace_e("non-exclusive is not suspported in micro mode!");
+        // init self scheduler local
+        if (!tb_thread_local_init(&s_scheduler_self, tb_null)) return ;
+     
+        // update and overide the current scheduler
+        tb_thread_local_set(&s_scheduler_self, self);
     }
 #endif
 
@@ -407,8 +447,71 @@ tb_void_t tb_lo_scheduler_loop(tb_lo_scheduler_ref_t self, tb_bool_t exclusive)
     else
     {
         // clear the current scheduler
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        s_scheduler_self = tb_null;
+#else
         tb_thread_local_set(&s_scheduler_self, tb_null);
+#endif
     }
 #endif
 }
+#ifndef TB_CONFIG_MICRO_ENABLE
+tb_bool_t tb_lo_scheduler_profile(tb_lo_scheduler_ref_t self, tb_bool_t enable, tb_size_t rate)
+{
+    // check
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler, tb_false);
+
+    // exit the old profiler
+    if (scheduler->profiler) tb_co_profiler_exit(scheduler->profiler);
+    scheduler->profiler = tb_null;
+
+    // disable it?
+    tb_check_return_val(enable, tb_true);
+
+    // clear the old records of all alive coroutines
+    tb_list_entry_head_ref_t lists[] = {&scheduler->coroutines_ready, &scheduler->coroutines_suspend};
+    tb_co_profiler_record_reset(lists, tb_arrayn(lists), tb_offsetof(tb_lo_coroutine_t, profiler));
+
+    // init the profiler
+    scheduler->profiler = tb_co_profiler_init(rate);
+
+    // ok?
+    return scheduler->profiler != tb_null;
+}
+tb_bool_t tb_lo_scheduler_stats(tb_lo_scheduler_ref_t self, tb_co_profiler_stats_t* stats)
+{
+    // check
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && stats, tb_false);
+
+    // the profiler is disabled?
+    tb_check_return_val(scheduler->profiler, tb_false);
+
+    // save the statistics
+    *stats = scheduler->profiler->stats;
+    return tb_true;
+}
+tb_void_t tb_lo_scheduler_stats_dump(tb_lo_scheduler_ref_t self)
+{
+    // check
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    tb_assert_and_check_return(scheduler && scheduler->profiler);
 
+    // dump the alive coroutines
+    tb_list_entry_head_ref_t lists[] = {&scheduler->coroutines_ready, &scheduler->coroutines_suspend};
+    tb_co_profiler_dump(scheduler->profiler, lists, tb_arrayn(lists), tb_offsetof(tb_lo_coroutine_t, profiler));
+}
+tb_size_t tb_lo_scheduler_trace(tb_lo_scheduler_ref_t self, tb_co_profiler_trace_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_lo_scheduler_t* scheduler = (tb_lo_scheduler_t*)self;
+    tb_assert_and_check_return_val(scheduler && func, 0);
+
+    // the profiler is disabled?
+    tb_check_return_val(scheduler->profiler, 0);
+
+    // export the samples
+    return tb_co_profiler_trace(scheduler->profiler, func, priv);
+}
+#endif
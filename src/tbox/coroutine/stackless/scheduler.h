@@ -30,6 +30,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -73,6 +74,45 @@ tb_void_t               tb_lo_scheduler_kill(tb_lo_scheduler_ref_t scheduler);
  */
 tb_void_t               tb_lo_scheduler_loop(tb_lo_scheduler_ref_t scheduler, tb_bool_t exclusive);
 
+#ifndef TB_CONFIG_MICRO_ENABLE
+/*! enable or disable the runtime profiler of the scheduler
+ *
+ * @note it is not thread-safe and must be called in the scheduler thread
+ *
+ * @param scheduler     the scheduler
+ * @param enable        enable or disable it, the old statistics will be cleared if be enabled again
+ * @param rate          sample one slice every rate slices for tb_lo_scheduler_trace(), no samples if be zero
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_lo_scheduler_profile(tb_lo_scheduler_ref_t scheduler, tb_bool_t enable, tb_size_t rate);
+
+/*! get the profiler statistics of the scheduler
+ *
+ * @param scheduler     the scheduler
+ * @param stats         the statistics
+ *
+ * @return              tb_true or tb_false (the profiler is disabled)
+ */
+tb_bool_t               tb_lo_scheduler_stats(tb_lo_scheduler_ref_t scheduler, tb_co_profiler_stats_t* stats);
+
+/*! dump the profiler statistics and the busiest coroutines
+ *
+ * @param scheduler     the scheduler
+ */
+tb_void_t               tb_lo_scheduler_stats_dump(tb_lo_scheduler_ref_t scheduler);
+
+/*! export the sampled slices in the time order
+ *
+ * @param scheduler     the scheduler
+ * @param func          the trace function
+ * @param priv          the user private data
+ *
+ * @return              the exported samples count
+ */
+tb_size_t               tb_lo_scheduler_trace(tb_lo_scheduler_ref_t scheduler, tb_co_profiler_trace_func_t func, tb_cpointer_t priv);
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
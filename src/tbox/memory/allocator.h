@@ -80,15 +80,27 @@ typedef enum __tb_allocator_type_e
 ,   TB_ALLOCATOR_STATIC     = 4
 ,   TB_ALLOCATOR_LARGE      = 5
 ,   TB_ALLOCATOR_SMALL      = 6
+,   TB_ALLOCATOR_ARENA      = 7
 
 }tb_allocator_type_e;
 
+/// the allocator flag enum
+typedef enum __tb_allocator_flag_e
+{
+    TB_ALLOCATOR_FLAG_NONE      = 0
+,   TB_ALLOCATOR_FLAG_NOLOCK    = 1     //!< malloc, ralloc and free lock by themselves and skip the allocator lock, clear and dump still enter it
+
+}tb_allocator_flag_e;
+
 /// the allocator type
 typedef struct __tb_allocator_t
 {
     /// the type
     tb_size_t               type;
 
+    /// the flag
+    tb_size_t               flag;
+
     /// the lock
     tb_spinlock_t           lock;
 
@@ -156,6 +168,18 @@ typedef struct __tb_allocator_t
      */
     tb_void_t               (*clear)(struct __tb_allocator_t* allocator);
 
+    /*! trim allocator and return the free pages to the system
+     *
+     * @note it will be called without the allocator lock,
+     * so it need enter the lock by itself and only hold it for a short while
+     *
+     * @param allocator     the allocator 
+     * @param keep_bytes    the free bytes which will be kept
+     *
+     * @return              tb_true if some memory was released, otherwise tb_false
+     */
+    tb_bool_t               (*trim)(struct __tb_allocator_t* allocator, tb_size_t keep_bytes);
+
     /*! exit allocator
      *
      * @param allocator     the allocator 
@@ -393,6 +417,31 @@ tb_bool_t               tb_allocator_align_free_(tb_allocator_ref_t allocator, t
  */
 tb_void_t               tb_allocator_clear(tb_allocator_ref_t allocator);
 
+/*! trim it and return the free pages to the system
+ *
+ * the allocating threads will not be stalled for a long time, 
+ * because the allocator lock is only held when trimming one free block.
+ *
+ * we can call it periodically to decay the unused memory, e.g. in a timer task:
+ *
+ * @code
+ * static tb_void_t tb_demo_trim_func(tb_bool_t killed, tb_cpointer_t priv)
+ * {
+ *     // keep 4MB free memory as the high-water mark and release the others
+ *     if (!killed) tb_allocator_trim(tb_allocator(), 4 * 1024 * 1024);
+ * }
+ *
+ * // trim it every 10s
+ * tb_timer_task_post(tb_timer(), 10000, tb_true, tb_demo_trim_func, tb_null);
+ * @endcode
+ *
+ * @param allocator     the allocator 
+ * @param keep_bytes    the free bytes which will be kept for the next allocations
+ *
+ * @return              tb_true if some memory was released, otherwise tb_false
+ */
+tb_bool_t               tb_allocator_trim(tb_allocator_ref_t allocator, tb_size_t keep_bytes);
+
 /*! exit it
  *
  * @param allocator     the allocator 
@@ -0,0 +1,612 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        arena_allocator.c
+ * @ingroup     memory
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "arena_allocator"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "arena_allocator.h"
+#include "impl/prefix.h"
+#include "../libc/libc.h"
+#include "../utils/utils.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the default chunk size
+#ifdef __tb_small__
+#   define TB_ARENA_ALLOCATOR_CHUNK_SIZE        (4096)
+#else
+#   define TB_ARENA_ALLOCATOR_CHUNK_SIZE        (16384)
+#endif
+
+// the patch size for checking underflow
+#ifdef __tb_debug__
+#   define TB_ARENA_ALLOCATOR_PATCH_SIZE        (1)
+#else
+#   define TB_ARENA_ALLOCATOR_PATCH_SIZE        (0)
+#endif
+
+// the data head
+#define tb_arena_allocator_data_head(data)      (&(((tb_pool_data_head_t*)(data))[-1]))
+
+// the data space of the given size in the chunk
+#define tb_arena_allocator_data_space(size)     tb_align(sizeof(tb_pool_data_head_t) + (size) + TB_ARENA_ALLOCATOR_PATCH_SIZE, TB_POOL_DATA_ALIGN)
+
+// the data of the large chunk
+#define tb_arena_allocator_large_data(chunk)    ((tb_pointer_t)((tb_byte_t*)&(chunk)[1] + sizeof(tb_pool_data_head_t)))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the arena allocator chunk type
+typedef __tb_pool_data_aligned__ struct __tb_arena_allocator_chunk_t
+{
+    // the next chunk
+    struct __tb_arena_allocator_chunk_t*    next;
+
+    // the chunk data size
+    tb_size_t                               size;
+
+}__tb_pool_data_aligned__ tb_arena_allocator_chunk_t;
+
+// the arena allocator type
+typedef struct __tb_arena_allocator_t
+{
+    // the base
+    tb_allocator_t                  base;
+
+    // the parent allocator
+    tb_allocator_ref_t              parent;
+
+    // the chunk size
+    tb_size_t                       chunk_size;
+
+    // the chunks, they will be reused after clearing
+    tb_arena_allocator_chunk_t*     chunks;
+
+    // the current chunk
+    tb_arena_allocator_chunk_t*     chunk;
+
+    // the bump pointer of the current chunk
+    tb_byte_t*                      pos;
+
+    // the end of the current chunk
+    tb_byte_t*                      end;
+
+    // the last data in the current chunk, it can be resized in place
+    tb_byte_t*                      last;
+
+    // the large chunks, the newest chunk is at the head
+    tb_arena_allocator_chunk_t*     large_chunks;
+
+#ifdef __tb_debug__
+    // the used size
+    tb_size_t                       used_size;
+
+    // the peak size
+    tb_size_t                       peak_size;
+
+    // the chunk count
+    tb_size_t                       chunk_count;
+
+    // the malloc count
+    tb_size_t                       malloc_count;
+
+    // the ralloc count
+    tb_size_t                       ralloc_count;
+
+    // the large count
+    tb_size_t                       large_count;
+#endif
+
+}tb_arena_allocator_t, *tb_arena_allocator_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+static tb_bool_t tb_arena_allocator_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_pointer_t tb_arena_allocator_data_init(tb_arena_allocator_ref_t allocator, tb_byte_t* head, tb_size_t size __tb_debug_decl__)
+{
+    // the data head
+    tb_pool_data_head_t* data_head = (tb_pool_data_head_t*)head;
+    data_head->size = size;
+
+#ifdef __tb_debug__
+    // init the debug info
+    data_head->debug.magic     = TB_POOL_DATA_MAGIC;
+    data_head->debug.file      = file_;
+    data_head->debug.func      = func_;
+    data_head->debug.line      = (tb_uint16_t)line_;
+
+    // save backtrace
+    tb_pool_data_save_backtrace(&data_head->debug, 4);
+
+    // make the dirty data and patch 0xcc for checking underflow
+    tb_memset_((tb_pointer_t)&data_head[1], TB_POOL_DATA_PATCH, size + TB_ARENA_ALLOCATOR_PATCH_SIZE);
+
+    // update the used and peak size
+    allocator->used_size += size;
+    if (allocator->used_size > allocator->peak_size) allocator->peak_size = allocator->used_size;
+
+    // update the malloc count
+    allocator->malloc_count++;
+#endif
+
+    // ok
+    return (tb_pointer_t)&data_head[1];
+}
+static tb_pointer_t tb_arena_allocator_large_make(tb_arena_allocator_ref_t allocator, tb_size_t size __tb_debug_decl__)
+{
+    // make the large chunk
+    tb_arena_allocator_chunk_t* chunk = (tb_arena_allocator_chunk_t*)tb_allocator_large_malloc_(allocator->parent, sizeof(tb_arena_allocator_chunk_t) + tb_arena_allocator_data_space(size), tb_null __tb_debug_args__);
+    tb_assert_and_check_return_val(chunk, tb_null);
+
+    // save it to the head of the large chunks
+    chunk->size = size;
+    chunk->next = allocator->large_chunks;
+    allocator->large_chunks = chunk;
+
+#ifdef __tb_debug__
+    // update the large count
+    allocator->large_count++;
+#endif
+
+    // init data
+    return tb_arena_allocator_data_init(allocator, (tb_byte_t*)&chunk[1], size __tb_debug_args__);
+}
+static tb_bool_t tb_arena_allocator_chunk_next(tb_arena_allocator_ref_t allocator __tb_debug_decl__)
+{
+    // reuse the next chunk first
+    tb_arena_allocator_chunk_t* chunk = allocator->chunk? allocator->chunk->next : allocator->chunks;
+    if (!chunk)
+    {
+        // make a new chunk
+        chunk = (tb_arena_allocator_chunk_t*)tb_allocator_large_malloc_(allocator->parent, sizeof(tb_arena_allocator_chunk_t) + allocator->chunk_size, tb_null __tb_debug_args__);
+        tb_assert_and_check_return_val(chunk, tb_false);
+
+        // init chunk
+        chunk->next = tb_null;
+        chunk->size = allocator->chunk_size;
+
+        // append it
+        if (allocator->chunk) allocator->chunk->next = chunk;
+        else allocator->chunks = chunk;
+
+#ifdef __tb_debug__
+        // update the chunk count
+        allocator->chunk_count++;
+#endif
+    }
+
+    // switch to this chunk
+    allocator->chunk    = chunk;
+    allocator->pos      = (tb_byte_t*)&chunk[1];
+    allocator->end      = allocator->pos + chunk->size;
+    allocator->last     = tb_null;
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_arena_allocator_clear(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->parent);
+
+    /* the allocator lock has been entered by tb_allocator_clear() like malloc and free,
+     * and trim enters the same lock, so they never see the half rewound chunks of each other.
+     */
+
+    // free all large chunks
+    tb_arena_allocator_chunk_t* chunk = allocator->large_chunks;
+    while (chunk)
+    {
+        tb_arena_allocator_chunk_t* next = chunk->next;
+        tb_allocator_large_free(allocator->parent, chunk);
+        chunk = next;
+    }
+    allocator->large_chunks = tb_null;
+
+    // rewind to the first chunk, all chunks will be reused
+    allocator->chunk    = allocator->chunks;
+    allocator->pos      = allocator->chunk? (tb_byte_t*)&allocator->chunk[1] : tb_null;
+    allocator->end      = allocator->chunk? allocator->pos + allocator->chunk->size : tb_null;
+    allocator->last     = tb_null;
+
+#ifdef __tb_debug__
+    // clear the used size
+    allocator->used_size = 0;
+#endif
+}
+static tb_bool_t tb_arena_allocator_trim(tb_allocator_ref_t self, tb_size_t keep_bytes)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->parent, tb_false);
+
+    // enter, the same lock as tb_allocator_clear()
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // skip the used chunks and keep some unused chunks
+    tb_size_t                       kept = 0;
+    tb_arena_allocator_chunk_t*     last = allocator->chunk;
+    tb_arena_allocator_chunk_t*     chunk = last? last->next : allocator->chunks;
+    while (chunk && kept + chunk->size <= keep_bytes)
+    {
+        kept += chunk->size;
+        last = chunk;
+        chunk = chunk->next;
+    }
+
+    // detach the other unused chunks
+    if (last) last->next = tb_null;
+    else allocator->chunks = tb_null;
+
+    // free them to the parent allocator
+    tb_bool_t ok = tb_false;
+    while (chunk)
+    {
+        tb_arena_allocator_chunk_t* next = chunk->next;
+        tb_allocator_large_free(allocator->parent, chunk);
+        chunk = next;
+        ok = tb_true;
+
+#ifdef __tb_debug__
+        // update the chunk count
+        allocator->chunk_count--;
+#endif
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return ok;
+}
+static tb_void_t tb_arena_allocator_exit(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator && allocator->parent);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // clear it first
+    tb_arena_allocator_clear(self);
+
+    // free all chunks
+    tb_arena_allocator_chunk_t* chunk = allocator->chunks;
+    while (chunk)
+    {
+        tb_arena_allocator_chunk_t* next = chunk->next;
+        tb_allocator_large_free(allocator->parent, chunk);
+        chunk = next;
+    }
+    allocator->chunks   = tb_null;
+    allocator->chunk    = tb_null;
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // exit lock
+    tb_spinlock_exit(&allocator->base.lock);
+
+    // exit it
+    tb_allocator_large_free(allocator->parent, allocator);
+}
+static tb_pointer_t tb_arena_allocator_malloc(tb_allocator_ref_t self, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->parent && size, tb_null);
+
+    // the need space
+    tb_size_t need = tb_arena_allocator_data_space(size);
+
+    // too large? make a large chunk for it
+    if (need > (allocator->chunk_size >> 2)) return tb_arena_allocator_large_make(allocator, size __tb_debug_args__);
+
+    // no enough space in the current chunk? switch to the next chunk
+    if (allocator->pos + need > allocator->end && !tb_arena_allocator_chunk_next(allocator __tb_debug_args__)) return tb_null;
+    tb_assert(allocator->pos + need <= allocator->end);
+
+    // bump it
+    tb_byte_t* head = allocator->pos;
+    allocator->pos  += need;
+    allocator->last = head;
+
+    // init data
+    return tb_arena_allocator_data_init(allocator, head, size __tb_debug_args__);
+}
+static tb_pointer_t tb_arena_allocator_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->parent && data && size, tb_null);
+
+    // the data head
+    tb_pool_data_head_t* data_head = tb_arena_allocator_data_head(data);
+    tb_size_t            size_old = data_head->size;
+
+#ifdef __tb_debug__
+    // check
+    tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "ralloc invalid data: %p", data);
+    tb_assertf(((tb_byte_t*)data)[size_old] == TB_POOL_DATA_PATCH, "data underflow");
+
+    // update the ralloc count
+    allocator->ralloc_count++;
+#endif
+
+    // shrink it in place
+    if (size <= size_old)
+    {
+#ifdef __tb_debug__
+        // fill the patch bytes
+        tb_memset_((tb_byte_t*)data + size, TB_POOL_DATA_PATCH, size_old - size + TB_ARENA_ALLOCATOR_PATCH_SIZE);
+
+        // update the used size
+        allocator->used_size -= size_old - size;
+#endif
+        data_head->size = size;
+        return data;
+    }
+
+    // is the last data in the current chunk? grow it in place if there is enough space
+    tb_size_t need = tb_arena_allocator_data_space(size);
+    if ((tb_byte_t*)data_head == allocator->last && need <= (allocator->chunk_size >> 2) && allocator->last + need <= allocator->end)
+    {
+        // bump it
+        allocator->pos = allocator->last + need;
+
+#ifdef __tb_debug__
+        // fill the patch bytes
+        tb_memset_((tb_byte_t*)data + size_old, TB_POOL_DATA_PATCH, size - size_old + TB_ARENA_ALLOCATOR_PATCH_SIZE);
+
+        // update the used and peak size
+        allocator->used_size += size - size_old;
+        if (allocator->used_size > allocator->peak_size) allocator->peak_size = allocator->used_size;
+#endif
+        data_head->size = size;
+        return data;
+    }
+
+    // is the data of the newest large chunk? ralloc this chunk directly
+    tb_arena_allocator_chunk_t* chunk = allocator->large_chunks;
+    if (chunk && data == tb_arena_allocator_large_data(chunk))
+    {
+        // ralloc chunk
+        chunk = (tb_arena_allocator_chunk_t*)tb_allocator_large_ralloc_(allocator->parent, chunk, sizeof(tb_arena_allocator_chunk_t) + need, tb_null __tb_debug_args__);
+        tb_assert_and_check_return_val(chunk, tb_null);
+
+        // update chunk
+        chunk->size = size;
+        allocator->large_chunks = chunk;
+
+        // update data
+        data = tb_arena_allocator_large_data(chunk);
+        data_head = tb_arena_allocator_data_head(data);
+        data_head->size = size;
+
+#ifdef __tb_debug__
+        // fill the patch bytes
+        tb_memset_((tb_byte_t*)data + size_old, TB_POOL_DATA_PATCH, size - size_old + TB_ARENA_ALLOCATOR_PATCH_SIZE);
+
+        // update the used and peak size
+        allocator->used_size += size - size_old;
+        if (allocator->used_size > allocator->peak_size) allocator->peak_size = allocator->used_size;
+#endif
+        return data;
+    }
+
+    // make the new data
+    tb_pointer_t data_new = tb_arena_allocator_malloc(self, size __tb_debug_args__);
+    tb_assert_and_check_return_val(data_new, tb_null);
+
+    // copy the old data
+    tb_memcpy_(data_new, data, size_old);
+
+    // free the old data, it will be released after clearing
+    tb_arena_allocator_free(self, data __tb_debug_args__);
+
+    // ok
+    return data_new;
+}
+static tb_bool_t tb_arena_allocator_free(tb_allocator_ref_t self, tb_pointer_t data __tb_debug_decl__)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->parent && data, tb_false);
+
+    // the data head
+    tb_pool_data_head_t* data_head = tb_arena_allocator_data_head(data);
+
+#ifdef __tb_debug__
+    // check
+    tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "free invalid data: %p", data);
+    tb_assertf(((tb_byte_t*)data)[data_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+    // update the used size
+    allocator->used_size -= data_head->size;
+#endif
+
+    // is the data of the newest large chunk? free this chunk directly
+    tb_arena_allocator_chunk_t* chunk = allocator->large_chunks;
+    if (chunk && data == tb_arena_allocator_large_data(chunk))
+    {
+        allocator->large_chunks = chunk->next;
+        return tb_allocator_large_free_(allocator->parent, chunk __tb_debug_args__);
+    }
+
+    // is the last data in the current chunk? rewind the bump pointer
+    if ((tb_byte_t*)data_head == allocator->last)
+    {
+        allocator->pos  = allocator->last;
+        allocator->last = tb_null;
+    }
+
+#ifdef __tb_debug__
+    // mark it as freed, it will be released after clearing
+    data_head->debug.magic = (tb_uint16_t)~TB_POOL_DATA_MAGIC;
+#endif
+
+    // ok
+    return tb_true;
+}
+static tb_pointer_t tb_arena_allocator_large_malloc(tb_allocator_ref_t self, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    // malloc it
+    tb_pointer_t data = tb_arena_allocator_malloc(self, size __tb_debug_args__);
+
+    // save the real size
+    if (data && real) *real = size;
+
+    // ok?
+    return data;
+}
+static tb_pointer_t tb_arena_allocator_large_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size, tb_size_t* real __tb_debug_decl__)
+{
+    // ralloc it
+    tb_pointer_t data_new = tb_arena_allocator_ralloc(self, data, size __tb_debug_args__);
+
+    // save the real size
+    if (data_new && real) *real = size;
+
+    // ok?
+    return data_new;
+}
+#ifdef __tb_debug__
+static tb_void_t tb_arena_allocator_dump(tb_allocator_ref_t self)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return(allocator);
+
+    // trace
+    tb_trace_i("");
+    tb_trace_i("chunk_size: %lu",           allocator->chunk_size);
+    tb_trace_i("chunk_count: %lu",          allocator->chunk_count);
+    tb_trace_i("large_count: %lu",          allocator->large_count);
+    tb_trace_i("used_size: %lu",            allocator->used_size);
+    tb_trace_i("peak_size: %lu",            allocator->peak_size);
+    tb_trace_i("malloc_count: %lu",         allocator->malloc_count);
+    tb_trace_i("ralloc_count: %lu",         allocator->ralloc_count);
+}
+static tb_bool_t tb_arena_allocator_have(tb_allocator_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_arena_allocator_ref_t allocator = (tb_arena_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+    // find it from the chunks
+    tb_arena_allocator_chunk_t* chunk = allocator->chunks;
+    for (; chunk; chunk = chunk->next)
+    {
+        if ((tb_byte_t const*)data > (tb_byte_t const*)&chunk[1] && (tb_byte_t const*)data < (tb_byte_t const*)&chunk[1] + chunk->size) 
+            return tb_true;
+    }
+
+    // find it from the large chunks
+    for (chunk = allocator->large_chunks; chunk; chunk = chunk->next)
+    {
+        if (data == tb_arena_allocator_large_data(chunk)) return tb_true;
+    }
+
+    // no
+    return tb_false;
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_allocator_ref_t tb_arena_allocator_init(tb_allocator_ref_t parent, tb_size_t chunk_size)
+{
+    // done
+    tb_bool_t                   ok = tb_false;
+    tb_arena_allocator_ref_t    allocator = tb_null;
+    do
+    {
+        // no parent? uses the global allocator
+        if (!parent) parent = tb_allocator();
+        tb_assert_and_check_break(parent);
+
+        // make allocator
+        allocator = (tb_arena_allocator_ref_t)tb_allocator_large_malloc0(parent, sizeof(tb_arena_allocator_t), tb_null);
+        tb_assert_and_check_break(allocator);
+
+        // init parent
+        allocator->parent               = parent;
+
+        // init chunk size
+        allocator->chunk_size           = tb_align(chunk_size? chunk_size : TB_ARENA_ALLOCATOR_CHUNK_SIZE, TB_POOL_DATA_ALIGN);
+
+        // init base
+        allocator->base.type            = TB_ALLOCATOR_ARENA;
+        allocator->base.malloc          = tb_arena_allocator_malloc;
+        allocator->base.ralloc          = tb_arena_allocator_ralloc;
+        allocator->base.free            = tb_arena_allocator_free;
+        allocator->base.large_malloc    = tb_arena_allocator_large_malloc;
+        allocator->base.large_ralloc    = tb_arena_allocator_large_ralloc;
+        allocator->base.large_free      = tb_arena_allocator_free;
+        allocator->base.clear           = tb_arena_allocator_clear;
+        allocator->base.trim            = tb_arena_allocator_trim;
+        allocator->base.exit            = tb_arena_allocator_exit;
+#ifdef __tb_debug__
+        allocator->base.dump            = tb_arena_allocator_dump;
+        allocator->base.have            = tb_arena_allocator_have;
+#endif
+
+        // init lock
+        if (!tb_spinlock_init(&allocator->base.lock)) break;
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        if (allocator) tb_arena_allocator_exit((tb_allocator_ref_t)allocator);
+        allocator = tb_null;
+    }
+
+    // ok?
+    return (tb_allocator_ref_t)allocator;
+}
@@ -0,0 +1,81 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        arena_allocator.h
+ * @ingroup     memory
+ *
+ */
+#ifndef TB_MEMORY_ARENA_ALLOCATOR_H
+#define TB_MEMORY_ARENA_ALLOCATOR_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "allocator.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init the arena allocator
+ *
+ * the data is allocated by bumping the pointer in the current chunk, and freeing data will do nothing,
+ * all data will be released at once by tb_allocator_clear() or tb_allocator_exit(). 
+ *
+ * it is suitable for the request-scoped objects which will be dead together.
+ *
+ * <pre>
+ *
+ *  ---------------------------------------
+ * |    parent allocator (large malloc)    | 
+ *  ---------------------------------------
+ *        |                     |
+ *  ------------------    -----------------------------
+ * | chunk | chunk | ...| large data > chunk size / 4 |
+ *  ------------------    -----------------------------
+ *    |
+ *  ---------------------------------------
+ * | data | data | data | ... | => bump   |
+ *  ---------------------------------------
+ *
+ * </pre>
+ *
+ * @note tb_allocator_clear() only resets the chunks and they will be reused, so it is O(1) 
+ *       if there is no large data, and tb_allocator_trim() will free the unused chunks to the parent allocator
+ *
+ * @param parent        the parent allocator, uses the global allocator if be null
+ * @param chunk_size    the chunk size, uses the default size if be zero
+ *
+ * @return              the allocator 
+ */
+tb_allocator_ref_t      tb_arena_allocator_init(tb_allocator_ref_t parent, tb_size_t chunk_size);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -41,18 +41,26 @@
 #   define TB_BUFFER_GROW_SIZE       (256)
 #endif
 
+// the buffer allocator
+#define tb_buffer_allocator(buffer)     ((buffer)->allocator? (buffer)->allocator : tb_allocator())
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 tb_bool_t tb_buffer_init(tb_buffer_ref_t buffer)
+{
+    return tb_buffer_init_with_allocator(buffer, tb_null);
+}
+tb_bool_t tb_buffer_init_with_allocator(tb_buffer_ref_t buffer, tb_allocator_ref_t allocator)
 {
     // check
     tb_assert_and_check_return_val(buffer, tb_false);
 
     // init
-    buffer->data = buffer->buff;
-    buffer->size = 0;
-    buffer->maxn = sizeof(buffer->buff);
+    buffer->data        = buffer->buff;
+    buffer->size        = 0;
+    buffer->maxn        = sizeof(buffer->buff);
+    buffer->allocator   = allocator;
 
     // ok
     return tb_true;
@@ -66,7 +74,7 @@ tb_void_t tb_buffer_exit(tb_buffer_ref_t buffer)
     tb_buffer_clear(buffer);
 
     // exit data
-    if (buffer->data && buffer->data != buffer->buff) tb_free(buffer->data);
+    if (buffer->data && buffer->data != buffer->buff) tb_allocator_free(tb_buffer_allocator(buffer), buffer->data);
     buffer->data = buffer->buff;
 
     // exit size
@@ -131,7 +139,7 @@ tb_byte_t* tb_buffer_resize(tb_buffer_ref_t buffer, tb_size_t size)
                 tb_assert_and_check_break(size <= buff_maxn);
 
                 // grow data
-                buff_data = tb_malloc_bytes(buff_maxn);
+                buff_data = (tb_byte_t*)tb_allocator_malloc(tb_buffer_allocator(buffer), buff_maxn);
                 tb_assert_and_check_break(buff_data);
 
                 // copy data
@@ -151,7 +159,7 @@ tb_byte_t* tb_buffer_resize(tb_buffer_ref_t buffer, tb_size_t size)
                 tb_assert_and_check_break(size <= buff_maxn);
 
                 // grow data
-                buff_data = (tb_byte_t*)tb_ralloc(buff_data, buff_maxn);
+                buff_data = (tb_byte_t*)tb_allocator_ralloc(tb_buffer_allocator(buffer), buff_data, buff_maxn);
                 tb_assert_and_check_break(buff_data);
             }
 #if 0
@@ -165,7 +173,7 @@ tb_byte_t* tb_buffer_resize(tb_buffer_ref_t buffer, tb_size_t size)
                 tb_memcpy(buffer->buff, buff_data, size);
 
                 // free data
-                tb_free(buff_data);
+                tb_allocator_free(tb_buffer_allocator(buffer), buff_data);
 
                 // using the static buffer
                 buff_data = buffer->buff;
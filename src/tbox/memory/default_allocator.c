@@ -39,10 +39,83 @@
 #include "default_allocator.h"
 #include "impl/prefix.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// enable the thread cache?
+#ifndef TB_CONFIG_MICRO_ENABLE
+#   define TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+#endif
+
+// the maximum cached bytes of each size class in the thread cache
+#ifdef __tb_small__
+#   define TB_DEFAULT_ALLOCATOR_CACHE_SIZE      (8 << 10)
+#else
+#   define TB_DEFAULT_ALLOCATOR_CACHE_SIZE      (32 << 10)
+#endif
+
+// the maximum and minimum cached items count of each size class
+#define TB_DEFAULT_ALLOCATOR_CACHE_MAXN         (64)
+#define TB_DEFAULT_ALLOCATOR_CACHE_MINN         (4)
+
+// the maximum half magazines count of each size class in the depot
+#ifdef __tb_small__
+#   define TB_DEFAULT_ALLOCATOR_DEPOT_MAXN      (4)
+#else
+#   define TB_DEFAULT_ALLOCATOR_DEPOT_MAXN      (16)
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the magazine type of the thread cache
+typedef struct __tb_default_allocator_magazine_t
+{
+    // the cached items, they are linked by the first pointer of the data
+    tb_pointer_t            items;
+
+    // the cached items count
+    tb_size_t               count;
+
+    // the maximum cached items count
+    tb_size_t               maxn;
+
+}tb_default_allocator_magazine_t;
+
+// the thread cache type
+typedef struct __tb_default_allocator_cache_t
+{
+    // the next cache
+    struct __tb_default_allocator_cache_t*  next;
+
+    // the allocator
+    struct __tb_default_allocator_t*        allocator;
+
+    // the owner thread, it is zero if be detached
+    tb_size_t                               owner;
+
+    // the magazines of all size classes
+    tb_default_allocator_magazine_t         magazines[TB_SMALL_ALLOCATOR_CLASS_MAXN];
+
+}tb_default_allocator_cache_t;
+
+/* the depot type of each size class
+ *
+ * the half magazines flushed by the thread caches are kept here and reused by the other thread caches,
+ * so the data freed by a remote thread will go back to the allocating thread without the small allocator.
+ */
+typedef struct __tb_default_allocator_depot_t
+{
+    // the half magazines, they are linked by the second pointer of their first items
+    tb_pointer_t            list;
+
+    // the half magazines count
+    tb_size_t               count;
+
+}tb_default_allocator_depot_t;
+
 // the default allocator type
 typedef struct __tb_default_allocator_t
 {
@@ -55,17 +128,442 @@ typedef struct __tb_default_allocator_t
     // the small allocator
     tb_allocator_ref_t      small_allocator;
 
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // the thread caches, they are protected by the allocator lock
+    tb_default_allocator_cache_t*   caches;
+
+    // the depots of all size classes, they are protected by the allocator lock
+    tb_default_allocator_depot_t    depots[TB_SMALL_ALLOCATOR_CLASS_MAXN];
+
+    // enable the thread caches? only the global default allocator uses them
+    tb_bool_t                       caches_enabled;
+#endif
+
 }tb_default_allocator_t, *tb_default_allocator_ref_t;
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * declaration
+ */
+__tb_extern_c__ tb_size_t   tb_small_allocator_index(tb_size_t size, tb_size_t* pspace);
+__tb_extern_c__ tb_size_t   tb_small_allocator_malloc_list(tb_allocator_ref_t allocator, tb_size_t size, tb_size_t count, tb_pointer_t* plist __tb_debug_decl__);
+__tb_extern_c__ tb_size_t   tb_small_allocator_free_list(tb_allocator_ref_t allocator, tb_pointer_t list __tb_debug_decl__);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+
+// the thread cache of the current thread
+static tb_thread_local_t                                g_cache_local = TB_THREAD_LOCAL_INIT;
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+static __tb_thread_local__ tb_default_allocator_cache_t* g_cache = tb_null;
+
+// the thread cache of the current thread has been exited?
+static __tb_thread_local__ tb_bool_t                    g_cache_exited = tb_false;
+#endif
+
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+static tb_pointer_t tb_default_allocator_depot_get(tb_default_allocator_ref_t allocator, tb_size_t index)
+{
+    // check
+    tb_assert(allocator && index < tb_arrayn(allocator->depots));
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // get a half magazine
+    tb_default_allocator_depot_t*   depot = &allocator->depots[index];
+    tb_pointer_t                    list = depot->list;
+    if (list)
+    {
+        depot->list = ((tb_pointer_t*)list)[1];
+        depot->count--;
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return list;
+}
+static tb_bool_t tb_default_allocator_depot_put(tb_default_allocator_ref_t allocator, tb_size_t index, tb_pointer_t list)
+{
+    // check
+    tb_assert(allocator && index < tb_arrayn(allocator->depots) && list);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // put this half magazine if the depot is not full, the smallest item has two pointers at least
+    tb_bool_t                       ok = tb_false;
+    tb_default_allocator_depot_t*   depot = &allocator->depots[index];
+    if (depot->count < TB_DEFAULT_ALLOCATOR_DEPOT_MAXN)
+    {
+        ((tb_pointer_t*)list)[1] = depot->list;
+        depot->list = list;
+        depot->count++;
+        ok = tb_true;
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return ok;
+}
+static tb_void_t tb_default_allocator_depot_clear(tb_default_allocator_ref_t allocator)
+{
+    // check
+    tb_assert(allocator);
+
+    // free all half magazines to the small allocator
+    tb_size_t i = 0;
+    for (i = 0; i < tb_arrayn(allocator->depots); i++)
+    {
+        tb_pointer_t list = tb_null;
+        while ((list = tb_default_allocator_depot_get(allocator, i)))
+            tb_small_allocator_free_list(allocator->small_allocator, list __tb_debug_vals__);
+    }
+}
+static tb_pointer_t tb_default_allocator_cache_split(tb_default_allocator_magazine_t* magazine, tb_size_t keep)
+{
+    // check
+    tb_assert(magazine);
+    tb_check_return_val(magazine->count > keep, tb_null);
+
+    // find the older items after the kept items
+    tb_pointer_t    list = magazine->items;
+    tb_pointer_t*   plist = &magazine->items;
+    tb_size_t       n = keep;
+    while (n--) 
+    {
+        plist = (tb_pointer_t*)list;
+        list = *plist;
+    }
+
+    // detach them
+    *plist = tb_null;
+    magazine->count = keep;
+    return list;
+}
+static tb_void_t tb_default_allocator_cache_clear(tb_default_allocator_ref_t allocator, tb_default_allocator_cache_t* cache)
+{
+    // check
+    tb_assert(allocator && cache);
+
+    // flush all cached items to the small allocator
+    tb_size_t i = 0;
+    for (i = 0; i < tb_arrayn(cache->magazines); i++)
+    {
+        tb_pointer_t list = tb_default_allocator_cache_split(&cache->magazines[i], 0);
+        if (list) tb_small_allocator_free_list(allocator->small_allocator, list __tb_debug_vals__);
+    }
+}
+static tb_void_t tb_default_allocator_cache_detach(tb_cpointer_t priv)
+{
+    // check
+    tb_default_allocator_cache_t* cache = (tb_default_allocator_cache_t*)priv;
+    tb_check_return(cache && cache->owner == tb_thread_self());
+
+    // the allocator
+    tb_default_allocator_ref_t allocator = cache->allocator;
+    tb_assert_and_check_return(allocator && allocator->caches_enabled);
+
+    // flush all cached items, because this thread will be exited
+    tb_default_allocator_cache_clear(allocator, cache);
+
+    // detach it from this thread, and it will be reused by the other threads
+    tb_spinlock_enter(&allocator->base.lock);
+    cache->owner = 0;
+    tb_spinlock_leave(&allocator->base.lock);
+
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    // the freed data after exiting this thread will not be cached 
+    g_cache         = tb_null;
+    g_cache_exited  = tb_true;
+#endif
+}
+static tb_default_allocator_cache_t* tb_default_allocator_cache_attach(tb_default_allocator_ref_t allocator)
+{
+    // check
+    tb_assert(allocator);
+
+    // init the thread local, it will be failed before tb_init()
+    if (!tb_thread_local_init(&g_cache_local, tb_default_allocator_cache_detach)) return tb_null;
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // reuse the detached cache first
+    tb_default_allocator_cache_t* cache = allocator->caches;
+    while (cache && cache->owner) cache = cache->next;
+
+    // make a new cache
+    if (!cache)
+    {
+        cache = (tb_default_allocator_cache_t*)tb_allocator_large_malloc0(allocator->large_allocator, sizeof(tb_default_allocator_cache_t), tb_null);
+        if (cache)
+        {
+            // init the maximum cached items count of each size class
+            tb_size_t i = 0;
+            tb_size_t space = 0;
+            tb_size_t size = 1;
+            for (i = 0; i < tb_arrayn(cache->magazines); i++, size = space + 1)
+            {
+                tb_small_allocator_index(size, &space);
+                cache->magazines[i].maxn = tb_max(tb_min(TB_DEFAULT_ALLOCATOR_CACHE_SIZE / space, TB_DEFAULT_ALLOCATOR_CACHE_MAXN), TB_DEFAULT_ALLOCATOR_CACHE_MINN);
+            }
+
+            // save it
+            cache->allocator = allocator;
+            cache->next = allocator->caches;
+            allocator->caches = cache;
+        }
+    }
+
+    // attach it
+    if (cache) cache->owner = tb_thread_self();
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // save it to the current thread
+    if (cache)
+    {
+        tb_thread_local_set(&g_cache_local, cache);
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        g_cache = cache;
+#endif
+    }
+    return cache;
+}
+static __tb_inline__ tb_default_allocator_cache_t* tb_default_allocator_cache(tb_default_allocator_ref_t allocator)
+{
+    // disabled?
+    tb_check_return_val(allocator->caches_enabled, tb_null);
+
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    // get the cache of the current thread
+    tb_default_allocator_cache_t* cache = g_cache;
+    if (cache) return cache;
+
+    // attach a cache if this thread has not been exited
+    return !g_cache_exited? tb_default_allocator_cache_attach(allocator) : tb_null;
+#else
+    // get the cache of the current thread, it may have been detached after exiting this thread
+    tb_default_allocator_cache_t* cache = (tb_default_allocator_cache_t*)tb_thread_local_get(&g_cache_local);
+    if (cache) return cache->owner == tb_thread_self()? cache : tb_null;
+
+    // attach a cache if this thread has not been exited
+    return !tb_thread_local_has(&g_cache_local)? tb_default_allocator_cache_attach(allocator) : tb_null;
+#endif
+}
+static tb_void_t tb_default_allocator_cache_exit(tb_default_allocator_ref_t allocator)
+{
+    // check
+    tb_assert(allocator);
+
+    // disable the thread caches
+    tb_check_return(allocator->caches_enabled);
+    allocator->caches_enabled = tb_false;
+
+    // exit all caches, all other threads should have been exited now
+    tb_default_allocator_cache_t* cache = allocator->caches;
+    while (cache)
+    {
+        tb_default_allocator_cache_t* next = cache->next;
+        tb_default_allocator_cache_clear(allocator, cache);
+        tb_allocator_large_free(allocator->large_allocator, cache);
+        cache = next;
+    }
+    allocator->caches = tb_null;
+
+    // clear the depots
+    tb_default_allocator_depot_clear(allocator);
+
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    // clear the cache of the current thread
+    g_cache = tb_null;
+#endif
+}
+static tb_pointer_t tb_default_allocator_cache_malloc(tb_default_allocator_ref_t allocator, tb_default_allocator_cache_t* cache, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_assert(allocator && cache && size && size <= TB_SMALL_ALLOCATOR_DATA_MAXN);
+
+    // the magazine of this size class
+    tb_size_t                           space = 0;
+    tb_size_t                           index = tb_small_allocator_index(size, &space);
+    tb_default_allocator_magazine_t*    magazine = &cache->magazines[index];
+
+    // no cached items? refill the half magazine from the depot first, and then from the small allocator
+    if (!magazine->items)
+    {
+        magazine->items = tb_default_allocator_depot_get(allocator, index);
+        if (magazine->items) magazine->count = magazine->maxn >> 1;
+        else magazine->count = tb_small_allocator_malloc_list(allocator->small_allocator, size, magazine->maxn >> 1, &magazine->items __tb_debug_args__);
+        tb_assertf_and_check_return_val(magazine->items, tb_null, "malloc(%lu) failed!", size);
+    }
+
+    // pop an item
+    tb_pointer_t data = magazine->items;
+    magazine->items = *((tb_pointer_t*)data);
+    magazine->count--;
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+
+#ifdef __tb_debug__
+    // check magic
+    tb_assert(data_head->debug.magic == TB_POOL_DATA_MAGIC);
+
+    // update the debug info for the new owner
+    data_head->debug.file = file_;
+    data_head->debug.func = func_;
+    data_head->debug.line = (tb_uint16_t)line_;
+    tb_pool_data_save_backtrace(&data_head->debug, 3);
+
+    // fill the patch bytes
+    if (space > size) tb_memset_((tb_byte_t*)data + size, TB_POOL_DATA_PATCH, space - size);
+#endif
+
+    // update size
+    data_head->size = size;
+
+    // ok
+    return data;
+}
+static tb_bool_t tb_default_allocator_cache_free(tb_default_allocator_ref_t allocator, tb_default_allocator_cache_t* cache, tb_pointer_t data __tb_debug_decl__)
+{
+    // check
+    tb_assert(allocator && cache && data);
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+    tb_assert_and_check_return_val(data_head->size && data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN, tb_false);
+
+    // the magazine of this size class
+    tb_size_t                           space = 0;
+    tb_size_t                           index = tb_small_allocator_index(data_head->size, &space);
+    tb_default_allocator_magazine_t*    magazine = &cache->magazines[index];
+
+#ifdef __tb_debug__
+    // check underflow
+    tb_assertf(space == data_head->size || ((tb_byte_t*)data)[data_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+    // check double free
+    tb_pointer_t item = magazine->items;
+    for (; item; item = *((tb_pointer_t*)item))
+    {
+        tb_assertf_and_check_return_val(item != data, tb_false, "double free data: %p", data);
+    }
+#endif
+
+    // push it
+    *((tb_pointer_t*)data) = magazine->items;
+    magazine->items = data;
+    magazine->count++;
+
+    // full? move the older half magazine to the depot, or flush it to the small allocator if the depot is full
+    if (magazine->count > magazine->maxn) 
+    {
+        tb_pointer_t list = tb_default_allocator_cache_split(magazine, magazine->count - (magazine->maxn >> 1));
+        if (list && !tb_default_allocator_depot_put(allocator, index, list))
+            tb_small_allocator_free_list(allocator->small_allocator, list __tb_debug_args__);
+    }
+
+    // ok
+    return tb_true;
+}
+static tb_pointer_t tb_default_allocator_cache_ralloc(tb_default_allocator_ref_t allocator, tb_default_allocator_cache_t* cache, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+    // check
+    tb_assert(allocator && cache && data && size && size <= TB_SMALL_ALLOCATOR_DATA_MAXN);
+
+    // the data head
+    tb_pool_data_head_t* data_head = &(((tb_pool_data_head_t*)data)[-1]);
+    tb_assert_and_check_return_val(data_head->size && data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN, tb_null);
+
+    // the same size class? 
+    tb_size_t space = 0;
+    if (tb_small_allocator_index(data_head->size, &space) == tb_small_allocator_index(size, tb_null))
+    {
+        // check underflow
+        tb_assertf(space == data_head->size || ((tb_byte_t*)data)[data_head->size] == TB_POOL_DATA_PATCH, "data underflow");
+
+#ifdef __tb_debug__
+        // fill the patch bytes
+        if (data_head->size > size) tb_memset_((tb_byte_t*)data + size, TB_POOL_DATA_PATCH, data_head->size - size);
+#endif
+
+        // only update size
+        data_head->size = size;
+        return data;
+    }
+
+    // make the new data
+    tb_pointer_t data_new = tb_default_allocator_cache_malloc(allocator, cache, size __tb_debug_args__);
+    tb_assert_and_check_return_val(data_new, tb_null);
+
+    // copy the old data
+    tb_memcpy_(data_new, data, tb_min(data_head->size, size));
+
+    // free the old data
+    tb_default_allocator_cache_free(allocator, cache, data __tb_debug_args__);
+
+    // ok
+    return data_new;
+}
+#endif
+static tb_pointer_t tb_default_allocator_small_malloc(tb_default_allocator_ref_t allocator, tb_size_t size __tb_debug_decl__)
+{
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // malloc it from the thread cache
+    tb_default_allocator_cache_t* cache = tb_default_allocator_cache(allocator);
+    if (cache) return tb_default_allocator_cache_malloc(allocator, cache, size __tb_debug_args__);
+#endif
+
+    // malloc it from the small allocator
+    return tb_allocator_malloc_(allocator->small_allocator, size __tb_debug_args__);
+}
+static tb_pointer_t tb_default_allocator_small_ralloc(tb_default_allocator_ref_t allocator, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
+{
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // ralloc it from the thread cache
+    tb_default_allocator_cache_t* cache = tb_default_allocator_cache(allocator);
+    if (cache) return tb_default_allocator_cache_ralloc(allocator, cache, data, size __tb_debug_args__);
+#endif
+
+    // ralloc it from the small allocator
+    return tb_allocator_ralloc_(allocator->small_allocator, data, size __tb_debug_args__);
+}
+static tb_bool_t tb_default_allocator_small_free(tb_default_allocator_ref_t allocator, tb_pointer_t data __tb_debug_decl__)
+{
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // free it to the thread cache
+    tb_default_allocator_cache_t* cache = tb_default_allocator_cache(allocator);
+    if (cache) return tb_default_allocator_cache_free(allocator, cache, data __tb_debug_args__);
+#endif
+
+    // free it to the small allocator
+    return tb_allocator_free_(allocator->small_allocator, data __tb_debug_args__);
+}
 static tb_void_t tb_default_allocator_exit(tb_allocator_ref_t self)
 {
     // check
     tb_default_allocator_ref_t allocator = (tb_default_allocator_ref_t)self;
     tb_assert_and_check_return(allocator);
 
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // exit the thread caches
+    tb_default_allocator_cache_exit(allocator);
+#endif
+
     // enter
     tb_spinlock_enter(&allocator->base.lock);
 
@@ -82,6 +580,18 @@ static tb_void_t tb_default_allocator_exit(tb_allocator_ref_t self)
     // exit allocator
     if (allocator->large_allocator) tb_allocator_large_free(allocator->large_allocator, allocator);
 }
+static tb_bool_t tb_default_allocator_trim(tb_allocator_ref_t self, tb_size_t keep_bytes)
+{
+    // check
+    tb_default_allocator_ref_t allocator = (tb_default_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && allocator->large_allocator, tb_false);
+
+    // return the half magazines in the depots to the small allocator
+    tb_default_allocator_depot_clear(allocator);
+
+    // trim the large allocator, the free slots of the small allocator have been returned to it
+    return tb_allocator_trim(allocator->large_allocator, keep_bytes);
+}
 static tb_pointer_t tb_default_allocator_malloc(tb_allocator_ref_t self, tb_size_t size __tb_debug_decl__)
 {
     // check
@@ -92,7 +602,7 @@ static tb_pointer_t tb_default_allocator_malloc(tb_allocator_ref_t self, tb_size
     tb_assert_and_check_return_val(allocator->large_allocator && allocator->small_allocator && size, tb_null);
 
     // done
-    return size <= TB_SMALL_ALLOCATOR_DATA_MAXN? tb_allocator_malloc_(allocator->small_allocator, size __tb_debug_args__) : tb_allocator_large_malloc_(allocator->large_allocator, size, tb_null __tb_debug_args__);
+    return size <= TB_SMALL_ALLOCATOR_DATA_MAXN? tb_default_allocator_small_malloc(allocator, size __tb_debug_args__) : tb_allocator_large_malloc_(allocator->large_allocator, size, tb_null __tb_debug_args__);
 }
 static tb_pointer_t tb_default_allocator_ralloc(tb_allocator_ref_t self, tb_pointer_t data, tb_size_t size __tb_debug_decl__)
 {
@@ -111,7 +621,7 @@ static tb_pointer_t tb_default_allocator_ralloc(tb_allocator_ref_t self, tb_poin
         if (!data)
         {
             // malloc it directly
-            data_new = size <= TB_SMALL_ALLOCATOR_DATA_MAXN? tb_allocator_malloc_(allocator->small_allocator, size __tb_debug_args__) : tb_allocator_large_malloc_(allocator->large_allocator, size, tb_null __tb_debug_args__);
+            data_new = size <= TB_SMALL_ALLOCATOR_DATA_MAXN? tb_default_allocator_small_malloc(allocator, size __tb_debug_args__) : tb_allocator_large_malloc_(allocator->large_allocator, size, tb_null __tb_debug_args__);
             break;
         }
 
@@ -122,7 +632,7 @@ static tb_pointer_t tb_default_allocator_ralloc(tb_allocator_ref_t self, tb_poin
 
         // small => small
         if (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN && size <= TB_SMALL_ALLOCATOR_DATA_MAXN)
-            data_new = tb_allocator_ralloc_(allocator->small_allocator, data, size __tb_debug_args__);
+            data_new = tb_default_allocator_small_ralloc(allocator, data, size __tb_debug_args__);
         // small => large
         else if (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN)
         {
@@ -134,13 +644,13 @@ static tb_pointer_t tb_default_allocator_ralloc(tb_allocator_ref_t self, tb_poin
             tb_memcpy_(data_new, data, tb_min(data_head->size, size));
 
             // free the old data
-            tb_allocator_free_(allocator->small_allocator, data __tb_debug_args__);
+            tb_default_allocator_small_free(allocator, data __tb_debug_args__);
         }
         // large => small
         else if (size <= TB_SMALL_ALLOCATOR_DATA_MAXN)
         {
             // make the new data
-            data_new = tb_allocator_malloc_(allocator->small_allocator, size __tb_debug_args__);
+            data_new = tb_default_allocator_small_malloc(allocator, size __tb_debug_args__);
             tb_assert_and_check_break(data_new);
 
             // copy the old data
@@ -175,7 +685,7 @@ static tb_bool_t tb_default_allocator_free(tb_allocator_ref_t self, tb_pointer_t
         tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "free invalid data: %p", data);
 
         // free it
-        ok = (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN)? tb_allocator_free_(allocator->small_allocator, data __tb_debug_args__) : tb_allocator_large_free_(allocator->large_allocator, data __tb_debug_args__);
+        ok = (data_head->size <= TB_SMALL_ALLOCATOR_DATA_MAXN)? tb_default_allocator_small_free(allocator, data __tb_debug_args__) : tb_allocator_large_free_(allocator->large_allocator, data __tb_debug_args__);
 
     } while (0);
 
@@ -241,6 +751,11 @@ static tb_handle_t tb_default_allocator_instance_init(tb_cpointer_t* ppriv)
         allocator = tb_default_allocator_init(large_allocator);
         tb_assert_and_check_break(allocator);
 
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+        // enable the thread caches for the global default allocator
+        ((tb_default_allocator_ref_t)allocator)->caches_enabled = tb_true;
+#endif
+
         // ok
         ok = tb_true;
 
@@ -267,6 +782,11 @@ static tb_void_t tb_default_allocator_instance_exit(tb_handle_t self, tb_cpointe
     tb_allocator_ref_t large_allocator = allocator->large_allocator;
     tb_assert_and_check_return(large_allocator);
 
+#ifdef TB_DEFAULT_ALLOCATOR_CACHE_ENABLE
+    // exit the thread caches first, the cached data will not be dumped as the leaks
+    tb_default_allocator_cache_exit(allocator);
+#endif
+
 #ifdef __tb_debug__
     // dump allocator
     if (allocator) tb_allocator_dump((tb_allocator_ref_t)allocator);
@@ -319,18 +839,20 @@ tb_allocator_ref_t tb_default_allocator_init(tb_allocator_ref_t large_allocator)
         allocator = (tb_default_allocator_ref_t)tb_allocator_large_malloc0(large_allocator, sizeof(tb_default_allocator_t), tb_null);
         tb_assert_and_check_break(allocator);
 
-        // init base
+        // init base, the small and large allocators are thread-safe by themselves
         allocator->base.type            = TB_ALLOCATOR_DEFAULT;
+        allocator->base.flag            = TB_ALLOCATOR_FLAG_NOLOCK;
         allocator->base.malloc          = tb_default_allocator_malloc;
         allocator->base.ralloc          = tb_default_allocator_ralloc;
         allocator->base.free            = tb_default_allocator_free;
+        allocator->base.trim            = tb_default_allocator_trim;
         allocator->base.exit            = tb_default_allocator_exit;
 #ifdef __tb_debug__
         allocator->base.dump            = tb_default_allocator_dump;
         allocator->base.have            = tb_default_allocator_have;
 #endif
 
-        // init lock
+        // init lock, it only protects the thread caches now
         if (!tb_spinlock_init(&allocator->base.lock)) break;
 
         // init allocator
@@ -43,6 +43,20 @@
 // the item belong to this slot?
 #define tb_fixed_pool_slot_exists(slot, item)               (((tb_byte_t*)(item) > (tb_byte_t*)(slot)) && ((tb_byte_t*)(item) < (tb_byte_t*)slot + (slot)->size))
 
+/* the page shift of the slot map
+ *
+ * the slot size must be not less than the page size, 
+ * so only one slot can cover the head of a page and only one slot can start in a page
+ */
+#define TB_FIXED_POOL_PAGE_SHIFT                            (12)
+#define TB_FIXED_POOL_PAGE_SIZE                             (1 << TB_FIXED_POOL_PAGE_SHIFT)
+
+// the page index of the given address
+#define tb_fixed_pool_page_index(addr)                      ((tb_size_t)(addr) >> TB_FIXED_POOL_PAGE_SHIFT)
+
+// the hash of the given page index, the golden ratio multiplier is odd, so the contiguous pages will not be collided
+#define tb_fixed_pool_page_hash(pool, index)                (((index) * 0x9e3779b1) & ((pool)->page_maxn - 1))
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -61,6 +75,20 @@ typedef struct __tb_fixed_pool_slot_t
 
 }tb_fixed_pool_slot_t;
 
+// the fixed pool page type of the slot map
+typedef struct __tb_fixed_pool_page_t
+{
+    // the page index, it is zero if this entry is unused
+    tb_size_t                       index;
+
+    // the slot which covers the head of this page
+    tb_fixed_pool_slot_t*           head;
+
+    // the slot which starts in this page
+    tb_fixed_pool_slot_t*           tail;
+
+}tb_fixed_pool_page_t;
+
 // the fixed pool type
 typedef struct __tb_fixed_pool_impl_t
 {
@@ -94,14 +122,18 @@ typedef struct __tb_fixed_pool_impl_t
     // the full slot
     tb_list_entry_head_t            full_slots;
 
-    // the slot list
-    tb_fixed_pool_slot_t**          slot_list;
+    /* the slot map
+     *
+     * it maps the page index of the data to the slots by the open addressing hash table with linear probing,
+     * so we can find the slot of the data in O(1) when freeing it
+     */
+    tb_fixed_pool_page_t*           page_map;
 
-    // the slot count
-    tb_size_t                       slot_count;
+    // the page map size, it is power of 2
+    tb_size_t                       page_maxn;
 
-    // the slot space
-    tb_size_t                       slot_space;
+    // the used pages count
+    tb_size_t                       page_count;
 
     // for small allocator
     tb_bool_t                       for_small;
@@ -128,30 +160,192 @@ static tb_bool_t tb_fixed_pool_item_exit(tb_pointer_t data, tb_cpointer_t priv)
     // continue
     return tb_true;
 }
+static tb_fixed_pool_page_t* tb_fixed_pool_page_find(tb_fixed_pool_t* pool, tb_size_t index)
+{
+    // no pages?
+    tb_check_return_val(pool->page_map, tb_null);
+
+    // find it, the page map is never full, so we will stop at an unused entry at least
+    tb_size_t               mask = pool->page_maxn - 1;
+    tb_size_t               i = tb_fixed_pool_page_hash(pool, index);
+    tb_fixed_pool_page_t*   page = &pool->page_map[i];
+    while (page->index && page->index != index) 
+    {
+        i = (i + 1) & mask;
+        page = &pool->page_map[i];
+    }
+
+    // ok?
+    return page->index? page : tb_null;
+}
+static tb_fixed_pool_page_t* tb_fixed_pool_page_make(tb_fixed_pool_t* pool, tb_size_t index)
+{
+    // check
+    tb_assert(pool->page_map && index && (pool->page_count << 1) < pool->page_maxn);
+
+    // find the existed page or an unused entry
+    tb_size_t               mask = pool->page_maxn - 1;
+    tb_size_t               i = tb_fixed_pool_page_hash(pool, index);
+    tb_fixed_pool_page_t*   page = &pool->page_map[i];
+    while (page->index && page->index != index) 
+    {
+        i = (i + 1) & mask;
+        page = &pool->page_map[i];
+    }
+
+    // use this entry
+    if (!page->index)
+    {
+        page->index = index;
+        page->head  = tb_null;
+        page->tail  = tb_null;
+        pool->page_count++;
+    }
+
+    // ok
+    return page;
+}
+static tb_void_t tb_fixed_pool_page_remove(tb_fixed_pool_t* pool, tb_fixed_pool_page_t* page)
+{
+    // check
+    tb_assert(pool->page_map && page && page->index && pool->page_count);
+
+    // move the following pages back to fill this hole, so we need not any tombstone
+    tb_size_t mask = pool->page_maxn - 1;
+    tb_size_t i = page - pool->page_map;
+    tb_size_t j = i;
+    while (1)
+    {
+        // the next used page
+        j = (j + 1) & mask;
+        tb_check_break(pool->page_map[j].index);
+
+        // move it if its home is not in the range: (i, j]
+        tb_size_t k = tb_fixed_pool_page_hash(pool, pool->page_map[j].index);
+        if (i < j? (k <= i || k > j) : (k <= i && k > j))
+        {
+            pool->page_map[i] = pool->page_map[j];
+            i = j;
+        }
+    }
+
+    // clear the hole
+    pool->page_map[i].index = 0;
+    pool->page_map[i].head  = tb_null;
+    pool->page_map[i].tail  = tb_null;
+    pool->page_count--;
+}
+static tb_bool_t tb_fixed_pool_page_grow(tb_fixed_pool_t* pool, tb_size_t count)
+{
+    // check
+    tb_assert(pool && pool->large_allocator);
+
+    // enough? keep the load factor less than 1/2
+    tb_size_t need = (pool->page_count + count) << 1;
+    tb_check_return_val(need >= pool->page_maxn, tb_true);
+
+    // the new size
+    tb_size_t maxn = pool->page_maxn? pool->page_maxn : 64;
+    while (maxn <= need) maxn <<= 1;
+
+    // make the new map
+    tb_fixed_pool_page_t* map = (tb_fixed_pool_page_t*)tb_allocator_large_nalloc0(pool->large_allocator, maxn, sizeof(tb_fixed_pool_page_t), tb_null);
+    tb_assert_and_check_return_val(map, tb_false);
+
+    // move all pages to the new map
+    tb_fixed_pool_page_t*   map_old = pool->page_map;
+    tb_size_t               maxn_old = pool->page_maxn;
+    tb_size_t               i = 0;
+    pool->page_map      = map;
+    pool->page_maxn     = maxn;
+    pool->page_count    = 0;
+    for (i = 0; i < maxn_old; i++)
+    {
+        if (map_old[i].index) 
+        {
+            tb_fixed_pool_page_t* page = tb_fixed_pool_page_make(pool, map_old[i].index);
+            page->head = map_old[i].head;
+            page->tail = map_old[i].tail;
+        }
+    }
+
+    // exit the old map
+    if (map_old) tb_allocator_large_free(pool->large_allocator, map_old);
+
+    // ok
+    return tb_true;
+}
+static tb_bool_t tb_fixed_pool_slot_map(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // check
+    tb_assert(pool && slot && slot->size >= TB_FIXED_POOL_PAGE_SIZE);
+
+    // the page range of this slot
+    tb_size_t head = tb_fixed_pool_page_index(slot);
+    tb_size_t tail = tb_fixed_pool_page_index((tb_byte_t*)slot + slot->size - 1);
+
+    // grow the page map first, so we need not rollback it
+    if (!tb_fixed_pool_page_grow(pool, tail - head + 1)) return tb_false;
+
+    // map all pages
+    tb_size_t index;
+    for (index = head; index <= tail; index++)
+    {
+        // make page
+        tb_fixed_pool_page_t* page = tb_fixed_pool_page_make(pool, index);
+        tb_assert(page);
+
+        // this slot starts in the middle of the first page? 
+        if (index == head && ((tb_size_t)slot & (TB_FIXED_POOL_PAGE_SIZE - 1)))
+        {
+            tb_assert(!page->tail);
+            page->tail = slot;
+        }
+        else
+        {
+            tb_assert(!page->head);
+            page->head = slot;
+        }
+    }
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_fixed_pool_slot_unmap(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
+{
+    // check
+    tb_assert(pool && slot);
+
+    // the page range of this slot
+    tb_size_t head = tb_fixed_pool_page_index(slot);
+    tb_size_t tail = tb_fixed_pool_page_index((tb_byte_t*)slot + slot->size - 1);
+
+    // unmap all pages
+    tb_size_t index;
+    for (index = head; index <= tail; index++)
+    {
+        // find page, it may be not mapped if the slot init failed
+        tb_fixed_pool_page_t* page = tb_fixed_pool_page_find(pool, index);
+        tb_check_continue(page);
+
+        // remove this slot
+        if (page->head == slot) page->head = tb_null;
+        if (page->tail == slot) page->tail = tb_null;
+
+        // remove this page if it is unused now
+        if (!page->head && !page->tail) tb_fixed_pool_page_remove(pool, page);
+    }
+}
 static tb_void_t tb_fixed_pool_slot_exit(tb_fixed_pool_t* pool, tb_fixed_pool_slot_t* slot)
 {
     // check
     tb_assert_and_check_return(pool && pool->large_allocator && slot);
-    tb_assert_and_check_return(pool->slot_list && pool->slot_count);
 
     // trace
     tb_trace_d("slot[%lu]: exit: size: %lu", pool->item_size, slot->size);
 
-    // make the iterator
-    tb_array_iterator_t array_iterator;
-    tb_iterator_ref_t   iterator = tb_iterator_make_for_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
-    tb_assert(iterator);
-
-    // find the slot from the slot list
-    tb_size_t itor = tb_binary_find_all(iterator, (tb_cpointer_t)slot);
-    tb_assert(itor != tb_iterator_tail(iterator) && itor < pool->slot_count && pool->slot_list[itor]);
-    tb_check_return(itor != tb_iterator_tail(iterator) && itor < pool->slot_count && pool->slot_list[itor]);
-    
-    // remove the slot
-    if (itor + 1 < pool->slot_count) tb_memmov_(pool->slot_list + itor, pool->slot_list + itor + 1, (pool->slot_count - itor - 1) * sizeof(tb_fixed_pool_slot_t*));
-
-    // update the slot count
-    pool->slot_count--;
+    // unmap this slot
+    tb_fixed_pool_slot_unmap(pool, slot);
 
     // exit slot
     tb_allocator_large_free(pool->large_allocator, slot);
@@ -176,8 +370,9 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
         // the item space
         tb_size_t item_space = sizeof(tb_pool_data_head_t) + pool->item_size + patch;
 
-        // the need space
+        // the need space, it must be not less than the page size of the slot map
         tb_size_t need_space = sizeof(tb_fixed_pool_slot_t) + pool->slot_size * item_space;
+        if (need_space < TB_FIXED_POOL_PAGE_SIZE) need_space = TB_FIXED_POOL_PAGE_SIZE;
 
         // make slot
         tb_size_t real_space = 0;
@@ -190,46 +385,8 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
         slot->pool = tb_static_fixed_pool_init((tb_byte_t*)&slot[1], real_space - sizeof(tb_fixed_pool_slot_t), pool->item_size, pool->for_small); 
         tb_assert_and_check_break(slot->pool);
 
-        // no list?
-        if (!pool->slot_list)
-        {
-            // init the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_nalloc(pool->large_allocator, 64, sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // init the slot count
-            pool->slot_count = 0;
-
-            // init the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
-        }
-        // no enough space?
-        else if (pool->slot_count == pool->slot_space)
-        {
-            // grow the slot list
-            tb_size_t size = 0;
-            pool->slot_list = (tb_fixed_pool_slot_t**)tb_allocator_large_ralloc(pool->large_allocator, pool->slot_list, (pool->slot_space << 1) * sizeof(tb_fixed_pool_slot_t*), &size);
-            tb_assert_and_check_break(pool->slot_list && size);
-
-            // update the slot space
-            pool->slot_space = size / sizeof(tb_fixed_pool_slot_t*);
-            tb_assert_and_check_break(pool->slot_space);
-        }
-
-        // check
-        tb_assert_and_check_break(pool->slot_count < pool->slot_space);
-
-        // insert the slot to the slot list in the increasing order (TODO binary search)
-        tb_size_t i = 0;
-        tb_size_t n = pool->slot_count;
-        for (i = 0; i < n; i++) if (slot <= pool->slot_list[i]) break;
-        if (i < n) tb_memmov_(pool->slot_list + i + 1, pool->slot_list + i, (n - i) * sizeof(tb_fixed_pool_slot_t*));
-        pool->slot_list[i] = slot;
-
-        // update the slot count
-        pool->slot_count++;
+        // map this slot to the slot map
+        if (!tb_fixed_pool_slot_map(pool, slot)) break;
 
         // trace
         tb_trace_d("slot[%lu]: init: size: %lu => %lu, item: %lu => %lu", pool->item_size, need_space, real_space, pool->slot_size, tb_static_fixed_pool_maxn(slot->pool));
@@ -250,88 +407,22 @@ static tb_fixed_pool_slot_t* tb_fixed_pool_slot_init(tb_fixed_pool_t* pool)
     // ok?
     return slot;
 }
-#if 0
-static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_pointer_t data)
-{
-    // check
-    tb_assert_and_check_return_val(pool && data, tb_null);
-
-    // done
-    tb_fixed_pool_slot_t* slot = tb_null;
-    do
-    {
-        // belong to the current slot?
-        if (pool->current_slot && tb_fixed_pool_slot_exists(pool->current_slot, data))
-        {
-            slot = pool->current_slot;
-            break;
-        }
-            
-        // find the slot from the partial slots
-        tb_for_all_if(tb_fixed_pool_slot_t*, partial_slot, tb_list_entry_itor(&pool->partial_slots), partial_slot)
-        {
-            // is this?
-            if (tb_fixed_pool_slot_exists(partial_slot, data))
-            {
-                slot = partial_slot;
-                break;
-            }
-        }
-        
-        // no found?
-        tb_check_break(!slot);
-
-        // find the slot from the full slots
-        tb_for_all_if(tb_fixed_pool_slot_t*, full_slot, tb_list_entry_itor(&pool->full_slots), full_slot)
-        {
-            // is this?
-            if (tb_fixed_pool_slot_exists(full_slot, data))
-            {
-                slot = full_slot;
-                break;
-            }
-        }
-
-    } while (0);
-
-    // ok?
-    return slot;
-}
-#else
-static tb_long_t tb_fixed_pool_slot_comp(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t data)
-{
-    // the slot
-    tb_fixed_pool_slot_t* slot = (tb_fixed_pool_slot_t*)item;
-    tb_assert(slot);
-
-    // comp
-    return (tb_byte_t*)data < (tb_byte_t*)slot? 1 : ((tb_byte_t*)data >= (tb_byte_t*)slot + slot->size? -1 : 0);
-}
 static tb_fixed_pool_slot_t* tb_fixed_pool_slot_find(tb_fixed_pool_t* pool, tb_pointer_t data)
 {
     // check
     tb_assert_and_check_return_val(pool && data, tb_null);
 
-    // make the iterator
-    tb_array_iterator_t array_iterator;
-    tb_iterator_ref_t   iterator = tb_iterator_make_for_ptr(&array_iterator, (tb_pointer_t*)pool->slot_list, pool->slot_count);
-    tb_assert(iterator);
-
-    // find it
-    tb_size_t itor = tb_binary_find_all_if(iterator, tb_fixed_pool_slot_comp, data);
-    tb_check_return_val(itor != tb_iterator_tail(iterator), tb_null);
+    // find the page of this data
+    tb_fixed_pool_page_t* page = tb_fixed_pool_page_find(pool, tb_fixed_pool_page_index(data));
+    tb_check_return_val(page, tb_null);
 
-    // the slot
-    tb_fixed_pool_slot_t* slot = pool->slot_list[itor];
-    tb_assert_and_check_return_val(slot, tb_null);
-
-    // check
-    tb_assert(tb_fixed_pool_slot_exists(slot, data));
+    // the data is after the slot which starts in this page? otherwise it belongs to the slot which covers the page head
+    tb_fixed_pool_slot_t* slot = (page->tail && (tb_byte_t*)data > (tb_byte_t*)page->tail)? page->tail : page->head;
+    tb_check_return_val(slot && tb_fixed_pool_slot_exists(slot, data), tb_null);
 
-    // ok?
+    // ok
     return slot;
 }
-#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -403,11 +494,11 @@ tb_void_t tb_fixed_pool_exit(tb_fixed_pool_ref_t self)
     if (pool->current_slot) tb_fixed_pool_slot_exit(pool, pool->current_slot);
     pool->current_slot = tb_null;
 
-    // exit the slot list
-    if (pool->slot_list) tb_allocator_large_free(pool->large_allocator, pool->slot_list);
-    pool->slot_list = tb_null;
-    pool->slot_count = 0;
-    pool->slot_space = 0;
+    // exit the slot map
+    if (pool->page_map) tb_allocator_large_free(pool->large_allocator, pool->page_map);
+    pool->page_map      = tb_null;
+    pool->page_maxn     = 0;
+    pool->page_count    = 0;
 
     // exit it
     tb_allocator_large_free(pool->large_allocator, pool);
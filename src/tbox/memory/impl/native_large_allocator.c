@@ -532,6 +532,19 @@ static tb_void_t tb_native_large_allocator_clear(tb_allocator_ref_t self)
     allocator->free_count    = 0;
 #endif
 }
+static tb_bool_t tb_native_large_allocator_trim(tb_allocator_ref_t self, tb_size_t keep_bytes)
+{
+    // check
+    tb_native_large_allocator_ref_t allocator = (tb_native_large_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+    /* trim the native memory
+     *
+     * @note all data are allocated from the native memory directly, 
+     * so we need not enter the allocator lock and the native memory will be locked by itself
+     */
+    return tb_native_memory_trim(keep_bytes);
+}
 static tb_void_t tb_native_large_allocator_exit(tb_allocator_ref_t self)
 {
     // check
@@ -611,6 +624,7 @@ tb_allocator_ref_t tb_native_large_allocator_init()
         allocator->base.large_ralloc     = tb_native_large_allocator_ralloc;
         allocator->base.large_free       = tb_native_large_allocator_free;
         allocator->base.clear            = tb_native_large_allocator_clear;
+        allocator->base.trim             = tb_native_large_allocator_trim;
         allocator->base.exit             = tb_native_large_allocator_exit;
 #ifdef __tb_debug__
         allocator->base.dump             = tb_native_large_allocator_dump;
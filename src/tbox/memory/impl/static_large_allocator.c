@@ -32,11 +32,21 @@
  * includes
  */
 #include "static_large_allocator.h"
+#ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+#   include <sys/mman.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
  */
 
+// the maximum pages which will be reserved and trimmed at once
+#ifdef __tb_small__
+#   define TB_STATIC_LARGE_ALLOCATOR_TRIM_PAGES     (64)
+#else
+#   define TB_STATIC_LARGE_ALLOCATOR_TRIM_PAGES     (256)
+#endif
+
 // the static large allocator data size
 #define tb_static_large_allocator_data_base(data_head)   (&(((tb_pool_data_head_t*)((tb_static_large_data_head_t*)(data_head) + 1))[-1]))
 
@@ -136,6 +146,21 @@ typedef __tb_pool_data_aligned__ struct __tb_static_large_allocator_t
     // the data tail
     tb_static_large_data_head_t*    data_tail;
 
+    // the reserved data which is being trimmed
+    tb_static_large_data_head_t*    data_reserved;
+
+    // the waiting count of the allocations for the reserved data
+    tb_size_t                       reserved_waiting;
+
+    // the mapped data of the huge pages, it will be freed when exiting allocator
+    tb_pointer_t                    mapped_data;
+
+    // the mapped size
+    tb_size_t                       mapped_size;
+
+    // the size of the pages which back the mapped data, .e.g the hugetlb or transparent huge page size
+    tb_size_t                       mapped_page;
+
     // the data pred
 #ifdef TB_CONFIG_MICRO_ENABLE
     tb_static_large_data_pred_t     data_pred[1];
@@ -439,6 +464,24 @@ static tb_static_large_data_head_t* tb_static_large_allocator_malloc_done(tb_sta
         {
             // find the free data from the first data head 
             data_head = tb_static_large_allocator_malloc_find(allocator, allocator->data_head, -1, need_space);
+
+            /* the free data may be reserved by trimming, we wait for it and find it again
+             *
+             * @note the allocator lock has been entered by tb_allocator_large_malloc_(),
+             * and trimming will be stopped if some allocations are waiting for it
+             */
+            while (!data_head && allocator->data_reserved)
+            {
+                // wait it
+                allocator->reserved_waiting++;
+                tb_spinlock_leave(&allocator->base.lock);
+                tb_sched_yield();
+                tb_spinlock_enter(&allocator->base.lock);
+                allocator->reserved_waiting--;
+
+                // find it again
+                data_head = tb_static_large_allocator_malloc_find(allocator, allocator->data_head, -1, need_space);
+            }
             tb_check_break(data_head);
         }
         tb_assert(data_head->space >= size + patch);
@@ -803,14 +846,224 @@ static tb_void_t tb_static_large_allocator_clear(tb_allocator_ref_t self)
     allocator->free_count    = 0;
 #endif
 }
+#ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+static tb_static_large_data_head_t* tb_static_large_allocator_trim_reserve(tb_static_large_allocator_ref_t allocator, tb_static_large_data_head_t* data_head, tb_static_large_data_head_t* next_head, tb_size_t page_head, tb_size_t page_tail)
+{
+    // check
+    tb_assert(allocator && data_head && data_head->bfree && page_head < page_tail);
+
+    // the page size of the data
+    tb_size_t page_size = allocator->page_size;
+
+    /* split the free data and reserve the middle data for the given pages
+     *
+     * the reserved data head and its first data byte must be before the released pages, 
+     * so they will not be cleared and the reserved data can be checked in debug mode
+     *
+     *  ---------------------------------------------------------------
+     * | data_head: free | reserved_head: busy | tail_head: free | ... |
+     *  ---------------------------------------------------------------
+     *                       |  page_head -> page_tail  |
+     */
+    tb_size_t reserved  = (tb_size_t)data_head + ((page_head - sizeof(tb_static_large_data_head_t) - 1 - (tb_size_t)data_head) & ~(page_size - 1));
+    tb_size_t tail      = (tb_size_t)data_head + tb_align(page_tail - (tb_size_t)data_head, page_size);
+    tb_assert(reserved >= (tb_size_t)data_head && tail <= (tb_size_t)next_head);
+
+    // split the free data before the reserved data
+    tb_static_large_data_head_t* reserved_head = (tb_static_large_data_head_t*)reserved;
+    if (reserved_head != data_head)
+    {
+        data_head->space = reserved - (tb_size_t)(data_head + 1);
+        tb_static_large_allocator_pred_update(allocator, data_head);
+    }
+
+    // split the free data after the reserved data
+    if (tail < (tb_size_t)next_head)
+    {
+        tb_static_large_data_head_t* tail_head = (tb_static_large_data_head_t*)tail;
+        tail_head->bfree = 1;
+        tail_head->space = (tb_size_t)next_head - (tb_size_t)(tail_head + 1);
+        tb_static_large_allocator_pred_update(allocator, tail_head);
+    }
+
+    // reserve it
+    reserved_head->bfree = 0;
+    reserved_head->space = tail - (tb_size_t)(reserved_head + 1);
+
+#ifdef __tb_debug__
+    // make a valid empty data for the checker
+    tb_pool_data_head_t* base_head = tb_static_large_allocator_data_base(reserved_head);
+    base_head->debug.magic  = TB_POOL_DATA_MAGIC;
+    base_head->size         = 0;
+    ((tb_byte_t*)(reserved_head + 1))[0] = TB_POOL_DATA_PATCH;
+#endif
+
+    // ok
+    return reserved_head;
+}
+#endif
+static tb_bool_t tb_static_large_allocator_trim(tb_allocator_ref_t self, tb_size_t keep_bytes)
+{
+    // check
+    tb_static_large_allocator_ref_t allocator = (tb_static_large_allocator_t*)self;
+    tb_assert_and_check_return_val(allocator, tb_false);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MADVISE
+    /* the size of the pages which will be released
+     *
+     * we need release the huge pages at their granularity, otherwise the transparent huge pages will be split
+     * and madvise() will be failed for the hugetlb pages
+     */
+    tb_size_t page_size = allocator->mapped_data? allocator->mapped_page : tb_page_size();
+    tb_assert_and_check_return_val(page_size && !(page_size & (page_size - 1)), tb_false);
+
+    /* the maximum size of the reserved pages at once
+     *
+     * the head of the left free data is written just after the reserved pages and it faults in one more page,
+     * so we need reserve enough pages at once to release the most of them.
+     */
+    tb_size_t page_maxn = TB_STATIC_LARGE_ALLOCATOR_TRIM_PAGES * page_size;
+
+    /* trim the free data step by step
+     *
+     * we only coalesce the free data and reserve some pages of it as a busy data in the lock,
+     * and release these pages after leaving the lock, so the allocating threads will not be stalled by madvise().
+     *
+     * the reserved data cannot be merged by the previous data, so we can continue to walk from it.
+     */
+    tb_bool_t                       ok = tb_false;
+    tb_size_t                       kept = 0;
+    tb_size_t                       trimmed = 0;
+    tb_size_t                       page_head = 0;
+    tb_size_t                       page_tail = 0;
+    tb_static_large_data_head_t*    data_head = tb_null;
+    tb_static_large_data_head_t*    data_tail = tb_null;
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // walk from the first data
+    data_head = allocator->data_head;
+    data_tail = allocator->data_tail;
+    while (1)
+    {
+        // find the next free data which can be trimmed and reserve some pages in it
+        tb_static_large_data_head_t* data_reserved = tb_null;
+        while ((data_head + 1) <= data_tail)
+        {
+            // the next head
+            tb_static_large_data_head_t* next_head = (tb_static_large_data_head_t*)((tb_byte_t*)(data_head + 1) + data_head->space);
+
+            // free?
+            if (data_head->bfree)
+            {
+                // remove this free data from the pred cache first, because the space will be changed
+                tb_static_large_allocator_pred_remove(allocator, data_head);
+
+                // merge all the next free data
+                while (next_head < data_tail && next_head->bfree)
+                {
+                    // remove next free data from the pred cache
+                    tb_static_large_allocator_pred_remove(allocator, next_head);
+
+                    // merge it
+                    data_head->space += sizeof(tb_static_large_data_head_t) + next_head->space;
+
+                    // the next head
+                    next_head = (tb_static_large_data_head_t*)((tb_byte_t*)(data_head + 1) + data_head->space);
+                }
+
+                // the free space which has not been trimmed
+                tb_size_t data_from = tb_max((tb_size_t)(data_head + 1), trimmed);
+                tb_size_t data_to   = (tb_size_t)next_head;
+                if (data_from < data_to)
+                {
+                    // keep some free space first
+                    tb_size_t keep = 0;
+                    if (kept < keep_bytes)
+                    {
+                        keep = tb_min(keep_bytes - kept, data_to - data_from);
+                        kept += keep;
+                    }
+
+                    // the whole free pages in this data
+                    page_head = tb_align(tb_max(data_from + keep, (tb_size_t)(data_head + 1) + 1), page_size);
+                    page_tail = data_to & ~(page_size - 1);
+                    if (page_tail > page_head + page_maxn) page_tail = page_head + page_maxn;
+
+                    // reserve these pages
+                    if (page_head < page_tail)
+                    {
+                        data_reserved = tb_static_large_allocator_trim_reserve(allocator, data_head, next_head, page_head, page_tail);
+                        break;
+                    }
+                }
+
+                // add this free data to the pred cache
+                tb_static_large_allocator_pred_update(allocator, data_head);
+            }
+
+            // the next data
+            data_head = next_head;
+        }
+
+        // end?
+        tb_check_break(data_reserved);
+
+        // leave
+        allocator->data_reserved = data_reserved;
+        tb_spinlock_leave(&allocator->base.lock);
+
+        // release the pages
+        if (!madvise((tb_pointer_t)page_head, page_tail - page_head, MADV_DONTNEED))
+        {
+            // trace
+            tb_trace_d("trim: %p, %lu bytes", (tb_pointer_t)page_head, page_tail - page_head);
+
+            // ok
+            ok = tb_true;
+        }
+        trimmed = page_tail;
+
+        // enter
+        tb_spinlock_enter(&allocator->base.lock);
+
+        // free the reserved data
+        data_reserved->bfree = 1;
+        allocator->data_reserved = tb_null;
+        tb_static_large_allocator_pred_update(allocator, data_reserved);
+
+        // stop it if some allocations are waiting for the reserved data
+        tb_check_break(!allocator->reserved_waiting);
+
+        // continue to walk from the reserved data
+        data_head = data_reserved;
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return ok;
+#else
+    return tb_false;
+#endif
+}
 static tb_void_t tb_static_large_allocator_exit(tb_allocator_ref_t self)
 {
     // check
     tb_static_large_allocator_ref_t allocator = (tb_static_large_allocator_t*)self;
     tb_assert_and_check_return(allocator);
 
+    // the mapped data and size, the allocator is in the mapped data
+    tb_pointer_t    mapped_data = allocator->mapped_data;
+    tb_size_t       mapped_size = allocator->mapped_size;
+
     // exit lock
     tb_spinlock_exit(&allocator->base.lock);
+
+    // free the mapped data
+    if (mapped_data) tb_native_memory_huge_free(mapped_data, mapped_size);
 }
 #ifdef __tb_debug__
 static tb_void_t tb_static_large_allocator_dump(tb_allocator_ref_t self)
@@ -918,6 +1171,7 @@ tb_allocator_ref_t tb_static_large_allocator_init(tb_byte_t* data, tb_size_t siz
     allocator->base.large_ralloc     = tb_static_large_allocator_ralloc;
     allocator->base.large_free       = tb_static_large_allocator_free;
     allocator->base.clear            = tb_static_large_allocator_clear;
+    allocator->base.trim             = tb_static_large_allocator_trim;
     allocator->base.exit             = tb_static_large_allocator_exit;
 #ifdef __tb_debug__
     allocator->base.dump             = tb_static_large_allocator_dump;
@@ -966,4 +1220,29 @@ tb_allocator_ref_t tb_static_large_allocator_init(tb_byte_t* data, tb_size_t siz
     // ok
     return (tb_allocator_ref_t)allocator;
 }
+tb_allocator_ref_t tb_static_large_allocator_init_huge(tb_size_t size, tb_size_t pagesize)
+{
+    // check
+    tb_assert_and_check_return_val(size, tb_null);
 
+    // map the huge pages
+    tb_size_t   real = 0;
+    tb_size_t   page = 0;
+    tb_byte_t*  data = (tb_byte_t*)tb_native_memory_huge_malloc(size, &real, &page);
+    tb_assert_and_check_return_val(data && real >= size, tb_null);
+
+    // init allocator
+    tb_static_large_allocator_ref_t allocator = (tb_static_large_allocator_ref_t)tb_static_large_allocator_init(data, real, pagesize);
+    if (allocator)
+    {
+        // the mapped data will be freed when exiting allocator
+        allocator->mapped_data = data;
+        allocator->mapped_size = real;
+        allocator->mapped_page = page;
+    }
+    // failed? free the mapped data
+    else tb_native_memory_huge_free(data, real);
+
+    // ok?
+    return (tb_allocator_ref_t)allocator;
+}
@@ -48,6 +48,16 @@ __tb_extern_c_enter__
  */
 tb_allocator_ref_t      tb_static_large_allocator_init(tb_byte_t* data, tb_size_t size, tb_size_t pagesize);
 
+/* init the large allocator on the data which is mapped from the huge pages, 
+ * and the mapped data will be freed when exiting allocator
+ * 
+ * @param size          the allocator size
+ * @param pagesize      the pagesize
+ *
+ * @return              the allocator 
+ */
+tb_allocator_ref_t      tb_static_large_allocator_init_huge(tb_size_t size, tb_size_t pagesize);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
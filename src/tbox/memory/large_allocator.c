@@ -40,5 +40,16 @@ tb_allocator_ref_t tb_large_allocator_init(tb_byte_t* data, tb_size_t size)
     // init pool
     return (data && size)? tb_static_large_allocator_init(data, size, tb_page_size()) : tb_native_large_allocator_init();
 }
+tb_allocator_ref_t tb_large_allocator_init_with_huge_pages(tb_size_t size)
+{
+    /* init the page first
+     *
+     * because this allocator may be called before tb_init()
+     */
+    if (!tb_page_init()) return tb_null;
+
+    // init pool
+    return tb_static_large_allocator_init_huge(size, tb_page_size());
+}
 
 
@@ -65,6 +65,32 @@ __tb_extern_c_enter__
  */
 tb_allocator_ref_t      tb_large_allocator_init(tb_byte_t* data, tb_size_t size);
 
+/*! init the large allocator on the huge pages
+ *
+ * the allocator data will be mapped from the huge pages (.e.g 2MB) to reduce the dTLB misses
+ * for the large hash maps and buffers, it uses hugetlb first, and then the transparent huge page,
+ * it will fall back to the normal pages if the huge page is not supported.
+ *
+ * @code
+ * tb_allocator_ref_t allocator = tb_large_allocator_init_with_huge_pages(256 * 1024 * 1024);
+ * if (allocator)
+ * {
+ *     tb_buffer_t buffer;
+ *     if (tb_buffer_init_with_allocator(&buffer, allocator))
+ *     {
+ *         // ...
+ *         tb_buffer_exit(&buffer);
+ *     }
+ *     tb_allocator_exit(allocator);
+ * }
+ * @endcode
+ * 
+ * @param size          the size, it will be aligned by the huge page size
+ *
+ * @return              the allocator 
+ */
+tb_allocator_ref_t      tb_large_allocator_init_with_huge_pages(tb_size_t size);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
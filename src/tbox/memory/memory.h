@@ -36,6 +36,7 @@
 #include "string_pool.h"
 #include "queue_buffer.h"
 #include "static_buffer.h"
+#include "arena_allocator.h"
 #include "large_allocator.h"
 #include "small_allocator.h"
 #include "native_allocator.h"
@@ -52,7 +52,7 @@ typedef struct __tb_small_allocator_t
     tb_allocator_ref_t      large_allocator;
 
     // the fixed pool
-    tb_fixed_pool_ref_t     fixed_pool[12];
+    tb_fixed_pool_ref_t     fixed_pool[TB_SMALL_ALLOCATOR_CLASS_MAXN];
 
 }tb_small_allocator_t, *tb_small_allocator_ref_t;
 
@@ -60,6 +60,7 @@ typedef struct __tb_small_allocator_t
  * declaration
  */
 __tb_extern_c__ tb_fixed_pool_ref_t tb_fixed_pool_init_(tb_allocator_ref_t large_allocator, tb_size_t slot_size, tb_size_t item_size, tb_bool_t for_small_allocator, tb_fixed_pool_item_init_func_t item_init, tb_fixed_pool_item_exit_func_t item_exit, tb_cpointer_t priv);
+__tb_extern_c__ tb_size_t           tb_small_allocator_index(tb_size_t size, tb_size_t* pspace);
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
@@ -74,80 +75,8 @@ static tb_fixed_pool_ref_t tb_small_allocator_find_fixed(tb_small_allocator_ref_
     do
     {
         // the fixed pool index
-        tb_size_t index = 0;
         tb_size_t space = 0;
-        if (size > 64 && size < 193)
-        {
-            if (size < 97)
-            {
-                index = 3;
-                space = 96;
-            }
-            else if (size > 128)
-            {
-                index = 5;
-                space = 192;
-            }
-            else 
-            {
-                index = 4;
-                space = 128;
-            }
-        }
-        else if (size > 192 && size < 513)
-        {
-            if (size < 257)
-            {
-                index = 6;
-                space = 256;
-            }
-            else if (size > 384)
-            {
-                index = 8;
-                space = 512;
-            }
-            else 
-            {
-                index = 7;
-                space = 384;
-            }
-        }
-        else if (size < 65)
-        {
-            if (size < 17)
-            {
-                index = 0;
-                space = 16;
-            }
-            else if (size > 32)
-            {
-                index = 2;
-                space = 64;
-            }
-            else 
-            {
-                index = 1;
-                space = 32;
-            }
-        }
-        else 
-        {
-            if (size < 1025)
-            {
-                index = 9;
-                space = 1024;
-            }
-            else if (size > 2048)
-            {
-                index = 11;
-                space = 3072;
-            }
-            else 
-            {
-                index = 10;
-                space = 2048;
-            }
-        }
+        tb_size_t index = tb_small_allocator_index(size, &space);
 
         // trace
         tb_trace_d("find: size: %lu => index: %lu, space: %lu", size, index, space);
@@ -469,4 +398,152 @@ tb_allocator_ref_t tb_small_allocator_init(tb_allocator_ref_t large_allocator)
     // ok?
     return (tb_allocator_ref_t)allocator;
 }
+tb_size_t tb_small_allocator_index(tb_size_t size, tb_size_t* pspace)
+{
+    // check
+    tb_assert(size && size <= TB_SMALL_ALLOCATOR_DATA_MAXN);
 
+    // the fixed pool index
+    tb_size_t index = 0;
+    tb_size_t space = 0;
+    if (size > 64 && size < 193)
+    {
+        if (size < 97)
+        {
+            index = 3;
+            space = 96;
+        }
+        else if (size > 128)
+        {
+            index = 5;
+            space = 192;
+        }
+        else 
+        {
+            index = 4;
+            space = 128;
+        }
+    }
+    else if (size > 192 && size < 513)
+    {
+        if (size < 257)
+        {
+            index = 6;
+            space = 256;
+        }
+        else if (size > 384)
+        {
+            index = 8;
+            space = 512;
+        }
+        else 
+        {
+            index = 7;
+            space = 384;
+        }
+    }
+    else if (size < 65)
+    {
+        if (size < 17)
+        {
+            index = 0;
+            space = 16;
+        }
+        else if (size > 32)
+        {
+            index = 2;
+            space = 64;
+        }
+        else 
+        {
+            index = 1;
+            space = 32;
+        }
+    }
+    else 
+    {
+        if (size < 1025)
+        {
+            index = 9;
+            space = 1024;
+        }
+        else if (size > 2048)
+        {
+            index = 11;
+            space = 3072;
+        }
+        else 
+        {
+            index = 10;
+            space = 2048;
+        }
+    }
+
+    // save the space
+    if (pspace) *pspace = space;
+
+    // ok
+    return index;
+}
+tb_size_t tb_small_allocator_malloc_list(tb_allocator_ref_t self, tb_size_t size, tb_size_t count, tb_pointer_t* plist __tb_debug_decl__)
+{
+    // check
+    tb_small_allocator_ref_t allocator = (tb_small_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator && plist && size && size <= TB_SMALL_ALLOCATOR_DATA_MAXN, 0);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // make the items of the same size class, and link them by the first pointer of the data
+    tb_size_t n = 0;
+    tb_fixed_pool_ref_t fixed_pool = tb_small_allocator_find_fixed(allocator, size);
+    if (fixed_pool)
+    {
+        for (n = 0; n < count; n++)
+        {
+            tb_pointer_t data = tb_fixed_pool_malloc_(fixed_pool __tb_debug_args__);
+            tb_check_break(data);
+
+            *((tb_pointer_t*)data) = *plist;
+            *plist = data;
+        }
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return n;
+}
+tb_size_t tb_small_allocator_free_list(tb_allocator_ref_t self, tb_pointer_t list __tb_debug_decl__)
+{
+    // check
+    tb_small_allocator_ref_t allocator = (tb_small_allocator_ref_t)self;
+    tb_assert_and_check_return_val(allocator, 0);
+
+    // enter
+    tb_spinlock_enter(&allocator->base.lock);
+
+    // free the linked items
+    tb_size_t n = 0;
+    while (list)
+    {
+        // the data head
+        tb_pointer_t            data = list;
+        tb_pool_data_head_t*    data_head = &(((tb_pool_data_head_t*)data)[-1]);
+        tb_assertf(data_head->debug.magic == TB_POOL_DATA_MAGIC, "free invalid data: %p", data);
+
+        // the next item
+        list = *((tb_pointer_t*)data);
+
+        // free it
+        tb_fixed_pool_ref_t fixed_pool = tb_small_allocator_find_fixed(allocator, data_head->size);
+        if (fixed_pool && tb_fixed_pool_free_(fixed_pool, data __tb_debug_args__)) n++;
+    }
+
+    // leave
+    tb_spinlock_leave(&allocator->base.lock);
+
+    // ok?
+    return n;
+}
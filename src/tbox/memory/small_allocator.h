@@ -43,6 +43,9 @@ __tb_extern_c_enter__
 /// the data size maximum
 #define TB_SMALL_ALLOCATOR_DATA_MAXN        (3072)
 
+/// the size classes count
+#define TB_SMALL_ALLOCATOR_CLASS_MAXN       (12)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
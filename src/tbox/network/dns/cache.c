@@ -53,18 +53,16 @@
  * types
  */
 
-// the dns cache type
+/* the dns cache type
+ *
+ * the readers look up the hash without the lock in the rcu read-side critical section,
+ * and the writers are serialized by the lock and replace the hash with a new copy.
+ */
 typedef struct __tb_dns_cache_t
 {
     // the hash
     tb_hash_map_ref_t       hash;
 
-    // the times
-    tb_hize_t               times;
-
-    // the expired
-    tb_size_t               expired;
-
 }tb_dns_cache_t;
 
 // the dns cache addr type
@@ -82,8 +80,8 @@ typedef struct __tb_dns_cache_addr_t
  * globals
  */
 
-// the lock
-static tb_spinlock_t        g_lock = TB_SPINLOCK_INIT;
+// the lock of the writers
+static tb_spinlock_t        g_lock = TB_SPINLOCK_INIT_TICKET;
 
 // the cache
 static tb_dns_cache_t       g_cache = {0};
@@ -95,32 +93,75 @@ static __tb_inline__ tb_size_t tb_dns_cache_now()
 {
     return (tb_size_t)(tb_cache_time_spak() / 1000);
 }
-static tb_bool_t tb_dns_cache_clear(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_hash_map_ref_t tb_dns_cache_hash_init()
+{
+    /* the items are the pointers to the shared addresses, 
+     *
+     * they will be copied to the new hash without copying the addresses, 
+     * so the readers always update the time of the same address in any versions
+     */
+    return tb_hash_map_init(tb_align8(tb_isqrti(TB_DNS_CACHE_MAXN) + 1), tb_element_str(tb_false), tb_element_ptr(tb_null, tb_null));
+}
+static tb_void_t tb_dns_cache_hash_exit(tb_hash_map_ref_t hash, tb_hash_map_ref_t hash_new)
 {
     // check
-    tb_assert(item);
+    tb_assert_and_check_return(hash);
+
+    // free the addresses which are not used by the new hash
+    tb_for_all_if (tb_hash_map_item_ref_t, item, hash, item)
+    {
+        if (!hash_new || tb_hash_map_get(hash_new, item->name) != item->data) 
+            tb_free(item->data);
+    }
 
-    // the dns cache address
-    tb_dns_cache_addr_t const* caddr = (tb_dns_cache_addr_t const*)((tb_hash_map_item_ref_t)item)->data;
-    tb_assert(caddr);
+    // exit hash
+    tb_hash_map_exit(hash);
+}
+static tb_hash_map_ref_t tb_dns_cache_hash_copy(tb_hash_map_ref_t hash)
+{
+    // check
+    tb_assert(hash);
 
-    // is expired?
-    tb_bool_t ok = tb_false;
-    if (caddr->time < g_cache.expired)
+    // init the new hash
+    tb_hash_map_ref_t hash_new = tb_dns_cache_hash_init();
+    tb_assert_and_check_return_val(hash_new, tb_null);
+
+    // remove the expired items if full, they are older than the average time
+    tb_size_t expired = 0;
+    tb_size_t size = tb_hash_map_size(hash);
+    if (size >= TB_DNS_CACHE_MAXN)
     {
-        // remove it
-        ok = tb_true;
+        // the expired time
+        tb_hize_t times = 0;
+        tb_for_all_if (tb_hash_map_item_ref_t, item, hash, item)
+            times += ((tb_dns_cache_addr_t const*)item->data)->time;
+        expired = (tb_size_t)(times / size) + 1;
 
         // trace
-        tb_trace_d("del: %s => %{ipaddr}, time: %u, size: %u", (tb_char_t const*)item->name, &caddr->addr, caddr->time, tb_hash_map_size(g_cache.hash));
+        tb_trace_d("expired: %lu", expired);
+    }
+
+    // copy the unexpired items
+    tb_for_all_if (tb_hash_map_item_ref_t, item, hash, item)
+    {
+        // the dns cache address
+        tb_dns_cache_addr_t const* caddr = (tb_dns_cache_addr_t const*)item->data;
+        tb_assert(caddr);
+
+        // is expired?
+        if (caddr->time < expired)
+        {
+            // trace
+            tb_trace_d("del: %s => %{ipaddr}, time: %u, size: %u", (tb_char_t const*)item->name, &caddr->addr, caddr->time, size);
+            continue;
+        }
 
-        // update times
-        tb_assert(g_cache.times >= caddr->time);
-        g_cache.times -= caddr->time;
+        // copy it and share the address
+        tb_hash_map_insert(hash_new, item->name, caddr);
     }
 
-    // ok?
-    return ok;
+    // ok
+    return hash_new;
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -136,8 +177,14 @@ tb_bool_t tb_dns_cache_init()
     do
     {
         // init hash
-        if (!g_cache.hash) g_cache.hash = tb_hash_map_init(tb_align8(tb_isqrti(TB_DNS_CACHE_MAXN) + 1), tb_element_str(tb_false), tb_element_mem(sizeof(tb_dns_cache_addr_t), tb_null, tb_null));
-        tb_assert_and_check_break(g_cache.hash);
+        if (!g_cache.hash) 
+        {
+            tb_hash_map_ref_t hash = tb_dns_cache_hash_init();
+            tb_assert_and_check_break(hash);
+
+            // publish it
+            tb_rcu_assign(g_cache.hash, hash);
+        }
 
         // ok
         ok = tb_true;
@@ -158,18 +205,19 @@ tb_void_t tb_dns_cache_exit()
     // enter
     tb_spinlock_enter(&g_lock);
 
-    // exit hash
-    if (g_cache.hash) tb_hash_map_exit(g_cache.hash);
-    g_cache.hash = tb_null;
-
-    // exit times
-    g_cache.times = 0;
-
-    // exit expired 
-    g_cache.expired = 0;
+    // unpublish hash
+    tb_hash_map_ref_t hash = g_cache.hash;
+    tb_rcu_assign(g_cache.hash, tb_null);
 
     // leave
     tb_spinlock_leave(&g_lock);
+
+    // exit hash after all readers have left
+    if (hash)
+    {
+        tb_rcu_synchronize();
+        tb_dns_cache_hash_exit(hash, tb_null);
+    }
 }
 tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
 {
@@ -195,28 +243,27 @@ tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
     // clear address
     tb_ipaddr_clear(addr);
 
-    // enter
-    tb_spinlock_enter(&g_lock);
+    // enter the read-side critical section
+    tb_rcu_read_enter();
 
     // done
     tb_bool_t ok = tb_false;
     do
     {
-        // check
-        tb_assert_and_check_break(g_cache.hash);
+        // get hash
+        tb_hash_map_ref_t hash = (tb_hash_map_ref_t)tb_rcu_dereference(g_cache.hash);
+        tb_assert_and_check_break(hash);
 
         // get the host address
-        tb_dns_cache_addr_t* caddr = (tb_dns_cache_addr_t*)tb_hash_map_get(g_cache.hash, name);
+        tb_dns_cache_addr_t* caddr = (tb_dns_cache_addr_t*)tb_hash_map_get(hash, name);
         tb_check_break(caddr);
 
         // trace
-        tb_trace_d("get: %s => %{ipaddr}, time: %u => %u, size: %u", name, &caddr->addr, caddr->time, tb_dns_cache_now(), tb_hash_map_size(g_cache.hash));
+        tb_trace_d("get: %s => %{ipaddr}, time: %u => %u, size: %u", name, &caddr->addr, caddr->time, tb_dns_cache_now(), tb_hash_map_size(hash));
 
-        // update time
-        tb_assert_and_check_break(g_cache.times >= caddr->time);
-        g_cache.times -= caddr->time;
-        caddr->time = tb_dns_cache_now();
-        g_cache.times += caddr->time;
+        // update time, we write it only once per second to keep the cache line shared between readers
+        tb_size_t now = tb_dns_cache_now();
+        if (caddr->time != now) caddr->time = now;
 
         // save address
         tb_ipaddr_copy(addr, &caddr->addr);
@@ -226,8 +273,8 @@ tb_bool_t tb_dns_cache_get(tb_char_t const* name, tb_ipaddr_ref_t addr)
 
     } while (0);
 
-    // leave
-    tb_spinlock_leave(&g_lock);
+    // leave the read-side critical section
+    tb_rcu_read_leave();
 
     // ok?
     return ok;
@@ -244,49 +291,66 @@ tb_void_t tb_dns_cache_set(tb_char_t const* name, tb_ipaddr_ref_t addr)
     tb_trace_d("set: %s => %{ipaddr}", name, addr);
 
     // init addr
-    tb_dns_cache_addr_t caddr;
-    caddr.time = tb_dns_cache_now();
-    tb_ipaddr_copy(&caddr.addr, addr);
+    tb_dns_cache_addr_t* caddr = tb_malloc0_type(tb_dns_cache_addr_t);
+    tb_assert_and_check_return(caddr);
+    caddr->time = tb_dns_cache_now();
+    tb_ipaddr_copy(&caddr->addr, addr);
 
     // enter
     tb_spinlock_enter(&g_lock);
 
     // done
+    tb_bool_t           ok = tb_false;
+    tb_hash_map_ref_t   hash = tb_null;
+    tb_hash_map_ref_t   hash_new = tb_null;
     do
     {
         // check
-        tb_assert_and_check_break(g_cache.hash);
-
-        // remove the expired items if full
-        if (tb_hash_map_size(g_cache.hash) >= TB_DNS_CACHE_MAXN)
-        {
-            // the expired time
-            g_cache.expired = ((tb_size_t)(g_cache.times / tb_hash_map_size(g_cache.hash)) + 1);
-
-            // check
-            tb_assert_and_check_break(g_cache.expired);
+        hash = g_cache.hash;
+        tb_assert_and_check_break(hash);
 
-            // trace
-            tb_trace_d("expired: %lu", g_cache.expired);
-
-            // remove the expired times
-            tb_remove_if(g_cache.hash, tb_dns_cache_clear, tb_null);
-        }
+        // copy the unexpired items to the new hash, the readers are using the old hash
+        hash_new = tb_dns_cache_hash_copy(hash);
+        tb_assert_and_check_break(hash_new);
 
         // check
-        tb_assert_and_check_break(tb_hash_map_size(g_cache.hash) < TB_DNS_CACHE_MAXN);
+        tb_assert_and_check_break(tb_hash_map_size(hash_new) < TB_DNS_CACHE_MAXN);
 
         // save addr
-        tb_hash_map_insert(g_cache.hash, name, &caddr);
-
-        // update times
-        g_cache.times += caddr.time;
+        tb_hash_map_insert(hash_new, name, caddr);
 
         // trace
-        tb_trace_d("set: %s => %{ipaddr}, time: %u, size: %u", name, &caddr.addr, caddr.time, tb_hash_map_size(g_cache.hash));
+        tb_trace_d("set: %s => %{ipaddr}, time: %u, size: %u", name, &caddr->addr, caddr->time, tb_hash_map_size(hash_new));
+
+        // publish the new hash
+        tb_rcu_assign(g_cache.hash, hash_new);
+
+        // ok
+        ok = tb_true;
 
     } while (0);
 
+    // failed? exit the new hash and keep the old hash, it is still published
+    if (!ok)
+    {
+        if (hash_new) tb_hash_map_exit(hash_new);
+        tb_free(caddr);
+        hash = tb_null;
+    }
+
+    /* exit the old hash after all readers have left
+     *
+     * we wait for the grace period here instead of deferring it,
+     * so only one version will be retained and it is cheap compared with the dns lookup.
+     *
+     * @note the writers are still serialized by the lock, so the old hash will not be changed
+     */
+    if (hash)
+    {
+        tb_rcu_synchronize();
+        tb_dns_cache_hash_exit(hash, hash_new);
+    }
+
     // leave
     tb_spinlock_leave(&g_lock);
 }
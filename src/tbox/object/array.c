@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
 #include "../algorithm/algorithm.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -98,7 +99,7 @@ static tb_void_t tb_oc_array_exit(tb_object_ref_t object)
     array->vector = tb_null;
 
     // exit it
-    tb_free(array);
+    tb_allocator_free(tb_object_allocator(object), array);
 }
 static tb_void_t tb_oc_array_clear(tb_object_ref_t object)
 {
@@ -115,13 +116,19 @@ static tb_oc_array_t* tb_oc_array_init_base()
     tb_oc_array_t*  array = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make array
-        array = tb_malloc0_type(tb_oc_array_t);
+        array = (tb_oc_array_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_array_t));
         tb_assert_and_check_break(array);
 
         // init array
         if (!tb_object_init((tb_object_ref_t)array, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_ARRAY)) break;
 
+        // init allocator
+        array->base.allocator = allocator;
+
         // init base
         array->base.copy    = tb_oc_array_copy;
         array->base.exit    = tb_oc_array_exit;
@@ -162,7 +169,7 @@ tb_object_ref_t tb_oc_array_init(tb_size_t grow, tb_bool_t incr)
         tb_element_t element = tb_element_obj();
 
         // init vector
-        array->vector = tb_vector_init(grow, element);
+        array->vector = tb_vector_init_with_allocator(grow, element, array->base.allocator);
         tb_assert_and_check_break(array->vector);
 
         // init incr
@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
 #include "../utils/utils.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -72,7 +73,7 @@ static tb_void_t tb_oc_data_exit(tb_object_ref_t object)
     if (data) 
     {
         tb_buffer_exit(&data->buffer);
-        tb_free(data);
+        tb_allocator_free(tb_object_allocator(object), data);
     }
 }
 static tb_void_t tb_oc_data_clear(tb_object_ref_t object)
@@ -87,13 +88,19 @@ static tb_oc_data_t* tb_oc_data_init_base()
     tb_oc_data_t*   data = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make data
-        data = tb_malloc0_type(tb_oc_data_t);
+        data = (tb_oc_data_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_data_t));
         tb_assert_and_check_break(data);
 
         // init data
         if (!tb_object_init((tb_object_ref_t)data, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_DATA)) break;
 
+        // init allocator
+        data->base.allocator = allocator;
+
         // init base
         data->base.copy     = tb_oc_data_copy;
         data->base.exit     = tb_oc_data_exit;
@@ -158,7 +165,7 @@ tb_object_ref_t tb_oc_data_init_from_data(tb_pointer_t addr, tb_size_t size)
     tb_assert_and_check_return_val(data, tb_null);
 
     // init buffer
-    if (!tb_buffer_init(&data->buffer))
+    if (!tb_buffer_init_with_allocator(&data->buffer, data->base.allocator))
     {
         tb_oc_data_exit((tb_object_ref_t)data);
         return tb_null;
@@ -177,7 +184,7 @@ tb_object_ref_t tb_oc_data_init_from_buffer(tb_buffer_ref_t pbuf)
     tb_assert_and_check_return_val(data, tb_null);
 
     // init buffer
-    if (!tb_buffer_init(&data->buffer))
+    if (!tb_buffer_init_with_allocator(&data->buffer, data->base.allocator))
     {
         tb_oc_data_exit((tb_object_ref_t)data);
         return tb_null;
@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
 #include "../utils/utils.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -68,7 +69,7 @@ static tb_object_ref_t tb_oc_date_copy(tb_object_ref_t object)
 }
 static tb_void_t tb_oc_date_exit(tb_object_ref_t object)
 {
-    if (object) tb_free(object);
+    if (object) tb_allocator_free(tb_object_allocator(object), object);
 }
 static tb_void_t tb_oc_date_clear(tb_object_ref_t object)
 {
@@ -82,13 +83,19 @@ static tb_oc_date_t* tb_oc_date_init_base()
     tb_oc_date_t*   date = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make date
-        date = tb_malloc0_type(tb_oc_date_t);
+        date = (tb_oc_date_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_date_t));
         tb_assert_and_check_break(date);
 
         // init date
         if (!tb_object_init((tb_object_ref_t)date, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_DATE)) break;
 
+        // init allocator
+        date->base.allocator = allocator;
+
         // init base
         date->base.copy     = tb_oc_date_copy;
         date->base.exit     = tb_oc_date_exit;
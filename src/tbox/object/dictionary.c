@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
 #include "../string/string.h"
 #include "../algorithm/algorithm.h"
 
@@ -115,7 +116,7 @@ static tb_void_t tb_oc_dictionary_exit(tb_object_ref_t object)
     dictionary->hash = tb_null;
 
     // exit it
-    tb_free(dictionary);
+    tb_allocator_free(tb_object_allocator(object), dictionary);
 }
 static tb_void_t tb_oc_dictionary_clear(tb_object_ref_t object)
 {
@@ -132,13 +133,19 @@ static tb_oc_dictionary_t* tb_oc_dictionary_init_base()
     tb_oc_dictionary_t* dictionary = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make dictionary
-        dictionary = tb_malloc0_type(tb_oc_dictionary_t);
+        dictionary = (tb_oc_dictionary_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_dictionary_t));
         tb_assert_and_check_break(dictionary);
 
         // init dictionary
         if (!tb_object_init((tb_object_ref_t)dictionary, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_DICTIONARY)) break;
 
+        // init allocator
+        dictionary->base.allocator = allocator;
+
         // init base
         dictionary->base.copy   = tb_oc_dictionary_copy;
         dictionary->base.exit   = tb_oc_dictionary_exit;
@@ -183,7 +190,7 @@ tb_object_ref_t tb_oc_dictionary_init(tb_size_t size, tb_bool_t incr)
         dictionary->incr = incr;
 
         // init hash
-        dictionary->hash = tb_hash_map_init(size, tb_element_str(tb_true), tb_element_obj());
+        dictionary->hash = tb_hash_map_init_with_allocator(size, tb_element_str(tb_true), tb_element_obj(), dictionary->base.allocator);
         tb_assert_and_check_break(dictionary->hash);
 
         // ok
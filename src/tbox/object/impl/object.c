@@ -36,6 +36,14 @@
 #include "object.h"
 #include "reader/reader.h"
 #include "writer/writer.h"
+#include "../../platform/thread_local.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the allocator of the objects made by the current thread
+static tb_thread_local_t    g_object_allocator = TB_THREAD_LOCAL_INIT;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -83,4 +91,23 @@ tb_void_t tb_object_exit_env()
     tb_oc_writer_remove(TB_OBJECT_FORMAT_XPLIST);
 #endif
 }
+tb_allocator_ref_t tb_object_allocator_get()
+{
+    // init the thread local, only once
+    if (!tb_thread_local_init(&g_object_allocator, tb_null)) return tb_null;
+
+    // get it
+    return (tb_allocator_ref_t)tb_thread_local_get(&g_object_allocator);
+}
+tb_allocator_ref_t tb_object_allocator_set(tb_allocator_ref_t allocator)
+{
+    // get the previous allocator
+    tb_allocator_ref_t previous = tb_object_allocator_get();
+
+    // set it
+    if (previous != allocator) tb_thread_local_set(&g_object_allocator, allocator);
+
+    // ok
+    return previous;
+}
 
@@ -31,6 +31,13 @@
  */
 #include "prefix.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the object allocator
+#define tb_object_allocator(object)     ((object)->allocator? (object)->allocator : tb_allocator())
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -49,6 +56,20 @@ tb_bool_t           tb_object_init_env(tb_noarg_t);
 // exit object envirnoment
 tb_void_t           tb_object_exit_env(tb_noarg_t);
 
+/* get the allocator of the objects made by the current thread
+ *
+ * @return          the allocator, the global allocator if be null
+ */
+tb_allocator_ref_t  tb_object_allocator_get(tb_noarg_t);
+
+/* set the allocator of the objects made by the current thread
+ *
+ * @param allocator the allocator, the global allocator if be null
+ *
+ * @return          the previous allocator
+ */
+tb_allocator_ref_t  tb_object_allocator_set(tb_allocator_ref_t allocator);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
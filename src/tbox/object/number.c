@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
  
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -137,7 +138,7 @@ static tb_object_ref_t tb_oc_number_copy(tb_object_ref_t object)
 }
 static tb_void_t tb_oc_number_exit(tb_object_ref_t object)
 {
-    if (object) tb_free(object);
+    if (object) tb_allocator_free(tb_object_allocator(object), object);
 }
 static tb_void_t tb_oc_number_clear(tb_object_ref_t object)
 {
@@ -191,13 +192,19 @@ static tb_oc_number_t* tb_oc_number_init_base()
     tb_oc_number_t* number = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make number
-        number = tb_malloc0_type(tb_oc_number_t);
+        number = (tb_oc_number_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_number_t));
         tb_assert_and_check_break(number);
 
         // init number
         if (!tb_object_init((tb_object_ref_t)number, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_NUMBER)) break;
 
+        // init allocator
+        number->base.allocator = allocator;
+
         // init base
         number->base.copy   = tb_oc_number_copy;
         number->base.exit   = tb_oc_number_exit;
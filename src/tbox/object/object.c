@@ -345,6 +345,57 @@ tb_object_ref_t tb_object_read_from_data(tb_byte_t const* data, tb_size_t size)
     // ok?
     return object;
 }
+tb_object_ref_t tb_object_read_with_allocator(tb_stream_ref_t stream, tb_allocator_ref_t allocator)
+{
+    // check
+    tb_assert_and_check_return_val(stream, tb_null);
+
+    // make objects from the given allocator
+    tb_allocator_ref_t previous = tb_object_allocator_set(allocator);
+
+    // read object
+    tb_object_ref_t object = tb_object_read(stream);
+
+    // restore the previous allocator
+    tb_object_allocator_set(previous);
+
+    // ok?
+    return object;
+}
+tb_object_ref_t tb_object_read_from_url_with_allocator(tb_char_t const* url, tb_allocator_ref_t allocator)
+{
+    // check
+    tb_assert_and_check_return_val(url, tb_null);
+
+    // make objects from the given allocator
+    tb_allocator_ref_t previous = tb_object_allocator_set(allocator);
+
+    // read object
+    tb_object_ref_t object = tb_object_read_from_url(url);
+
+    // restore the previous allocator
+    tb_object_allocator_set(previous);
+
+    // ok?
+    return object;
+}
+tb_object_ref_t tb_object_read_from_data_with_allocator(tb_byte_t const* data, tb_size_t size, tb_allocator_ref_t allocator)
+{
+    // check
+    tb_assert_and_check_return_val(data && size, tb_null);
+
+    // make objects from the given allocator
+    tb_allocator_ref_t previous = tb_object_allocator_set(allocator);
+
+    // read object
+    tb_object_ref_t object = tb_object_read_from_data(data, size);
+
+    // restore the previous allocator
+    tb_object_allocator_set(previous);
+
+    // ok?
+    return object;
+}
 tb_long_t tb_object_writ(tb_object_ref_t object, tb_stream_ref_t stream, tb_size_t format)
 {
     // check
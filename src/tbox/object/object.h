@@ -116,6 +116,37 @@ tb_object_ref_t     tb_object_read_from_url(tb_char_t const* url);
  */
 tb_object_ref_t     tb_object_read_from_data(tb_byte_t const* data, tb_size_t size);
 
+/*! read object with the given allocator
+ *
+ * all objects made by the reader are allocated from this allocator and freed to it when they are exited,
+ * so an arena allocator can drop the whole object tree at once by tb_allocator_clear().
+ *
+ * @param stream    the stream
+ * @param allocator the allocator, uses the global allocator if be null
+ *
+ * @return          the object
+ */
+tb_object_ref_t     tb_object_read_with_allocator(tb_stream_ref_t stream, tb_allocator_ref_t allocator);
+
+/*! read object from url with the given allocator
+ *
+ * @param url       the url
+ * @param allocator the allocator, uses the global allocator if be null
+ *
+ * @return          the object
+ */
+tb_object_ref_t     tb_object_read_from_url_with_allocator(tb_char_t const* url, tb_allocator_ref_t allocator);
+
+/*! read object from data with the given allocator
+ *
+ * @param data      the data
+ * @param size      the size
+ * @param allocator the allocator, uses the global allocator if be null
+ *
+ * @return          the object
+ */
+tb_object_ref_t     tb_object_read_from_data_with_allocator(tb_byte_t const* data, tb_size_t size, tb_allocator_ref_t allocator);
+
 /*! writ object
  *
  * @param object    the object
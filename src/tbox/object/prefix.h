@@ -31,6 +31,7 @@
  */
 #include "../prefix.h"
 #include "../xml/xml.h"
+#include "../memory/allocator.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -99,6 +100,9 @@ typedef struct __tb_object_t
     /// the exit func
     tb_void_t                   (*exit)(struct __tb_object_t* object);
 
+    /// the allocator, uses the global allocator if be null
+    tb_allocator_ref_t          allocator;
+
 }tb_object_t, *tb_object_ref_t;
 
 #endif
@@ -34,6 +34,7 @@
  * includes
  */
 #include "object.h"
+#include "impl/object.h"
 #include "../string/string.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -82,7 +83,7 @@ static tb_void_t tb_oc_string_exit(tb_object_ref_t object)
         tb_string_exit(&string->str);
 
         // exit the object
-        tb_free(object);
+        tb_allocator_free(tb_object_allocator(object), object);
     }
 }
 static tb_void_t tb_oc_string_clear(tb_object_ref_t object)
@@ -101,13 +102,19 @@ static tb_oc_string_t* tb_oc_string_init_base()
     tb_oc_string_t* string = tb_null;
     do
     {
+        // the allocator of the objects made by the current thread
+        tb_allocator_ref_t allocator = tb_object_allocator_get();
+
         // make string
-        string = tb_malloc0_type(tb_oc_string_t);
+        string = (tb_oc_string_t*)tb_allocator_malloc0(allocator? allocator : tb_allocator(), sizeof(tb_oc_string_t));
         tb_assert_and_check_break(string);
 
         // init string
         if (!tb_object_init((tb_object_ref_t)string, TB_OBJECT_FLAG_NONE, TB_OBJECT_TYPE_STRING)) break;
 
+        // init allocator
+        string->base.allocator = allocator;
+
         // init base
         string->base.copy   = tb_oc_string_copy;
         string->base.exit   = tb_oc_string_exit;
@@ -145,7 +152,7 @@ tb_object_ref_t tb_oc_string_init_from_cstr(tb_char_t const* cstr)
         tb_assert_and_check_break(string);
 
         // init str
-        if (!tb_string_init(&string->str)) break;
+        if (!tb_string_init_with_allocator(&string->str, string->base.allocator)) break;
 
         // copy string
         if (cstr) tb_string_cstrcpy(&string->str, cstr);
@@ -178,7 +185,7 @@ tb_object_ref_t tb_oc_string_init_from_str(tb_string_ref_t str)
         tb_assert_and_check_break(string);
 
         // init str
-        if (!tb_string_init(&string->str)) break;
+        if (!tb_string_init_with_allocator(&string->str, string->base.allocator)) break;
 
         // copy string
         if (str) tb_string_strcpy(&string->str, str);
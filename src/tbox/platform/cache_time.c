@@ -31,6 +31,9 @@
 #include "time.h"
 #include "atomic64.h"
 #include "../libc/libc.h"
+#ifdef TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME
+#   include <time.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
@@ -39,17 +42,46 @@
 // the cached time
 static tb_atomic64_t    g_time = 0;
 
+#if defined(TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME) && defined(CLOCK_REALTIME_COARSE)
+// the coarse clock is enabled? 0: unknown, 1: enabled, 2: disabled
+static tb_size_t        g_coarse = 0;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
- * implementation
+ * private implementation
  */
-tb_hong_t tb_cache_time_spak()
+static tb_hong_t tb_cache_time_now()
 {
+#if defined(TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME) && defined(CLOCK_REALTIME_COARSE)
+    /* the coarse clock only reads the time of the last kernel tick without the hardware clock,
+     * so we use it only if the tick is not longer than 1ms
+     */
+    if (!g_coarse)
+    {
+        struct timespec res = {0};
+        g_coarse = (!clock_getres(CLOCK_REALTIME_COARSE, &res) && !res.tv_sec && res.tv_nsec <= 1000000)? 1 : 2;
+    }
+    if (g_coarse == 1)
+    {
+        struct timespec ts = {0};
+        if (!clock_gettime(CLOCK_REALTIME_COARSE, &ts)) return ((tb_hong_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+    }
+#endif
+
     // get the time
     tb_timeval_t tv = {0};
     if (!tb_gettimeofday(&tv, tb_null)) return -1;
+    return ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
 
-    // the time value
-    tb_hong_t val = ((tb_hong_t)tv.tv_sec * 1000 + tv.tv_usec / 1000);
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_hong_t tb_cache_time_spak()
+{
+    // get the time
+    tb_hong_t val = tb_cache_time_now();
+    tb_check_return_val(val >= 0, -1);
 
     // save it
     tb_atomic64_set(&g_time, val);
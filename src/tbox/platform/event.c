@@ -32,12 +32,15 @@
 #include "cache_time.h"
 #include "atomic.h"
 #include "semaphore.h"
+#include "impl/futex.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 #if defined(TB_CONFIG_OS_WINDOWS)
 #   include "windows/event.c"
+#elif defined(TB_FUTEX_ENABLE)
+#   include "linux/event.c"
 #else 
 tb_event_ref_t tb_event_init()
 {
@@ -0,0 +1,146 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "futex.h"
+#include "../time.h"
+#include "../barrier.h"
+#include "../processor.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+#ifdef TB_FUTEX_ENABLE
+tb_void_t tb_futex_counter_init(tb_futex_counter_t* counter, tb_size_t value)
+{
+    // check
+    tb_assert(counter);
+
+    // init it
+    counter->value      = (tb_long_t)value;
+    counter->waiters    = 0;
+    counter->spin       = 0;
+
+    // need not spin on the uniprocessor, the owner cannot run before we are parked
+    counter->spin_maxn  = tb_processor_count() > 1? TB_FUTEX_SPIN_MAXN : 0;
+}
+tb_void_t tb_futex_counter_post(tb_futex_counter_t* counter, tb_size_t post, tb_size_t maxn)
+{
+    // check
+    tb_assert(counter && post);
+
+    // post it
+    if (!maxn) tb_atomic_fetch_and_add(&counter->value, post);
+    else
+    {
+        // increase it to the maximum value at most
+        tb_long_t value = (tb_long_t)counter->value;
+        while (value < (tb_long_t)maxn)
+        {
+            tb_long_t prev = tb_atomic_fetch_and_pset(&counter->value, value, tb_min(value + (tb_long_t)post, (tb_long_t)maxn));
+            if (prev == value) break;
+            value = prev;
+        }
+
+        // only wake up the needed waiters
+        if (post > maxn) post = maxn;
+
+        // make sure that the read of the waiters is not reordered before the new value
+        tb_barrier();
+    }
+
+    /* wake up the parked waiters, only as many as the posted value
+     *
+     * the waiters are increased before checking the value again,
+     * so the waiter which is parking now will see the new value or be waked up here.
+     */
+    tb_long_t waiters = (tb_long_t)counter->waiters;
+    if (waiters > 0) tb_futex_wake(&counter->value, tb_min(post, (tb_size_t)waiters));
+}
+tb_long_t tb_futex_counter_wait_slow(tb_futex_counter_t* counter, tb_long_t timeout)
+{
+    // check
+    tb_assert(counter);
+
+    // spin it first, the value may be posted soon if the other processors are running
+    tb_long_t spin = (tb_long_t)counter->spin;
+    tb_long_t maxn = tb_futex_spin_maxn(spin, counter->spin_maxn);
+    if (maxn)
+    {
+        tb_long_t i = 0;
+        for (i = 0; i < maxn; i++)
+        {
+            if (counter->value > 0 && tb_futex_counter_take(counter))
+            {
+                counter->spin = tb_futex_spin_next(spin, i);
+                return 1;
+            }
+
+            // pause it
+            tb_futex_spin_pause();
+        }
+        counter->spin = tb_futex_spin_next(spin, maxn);
+    }
+
+    // no wait?
+    if (!timeout) return tb_futex_counter_take(counter)? 1 : 0;
+
+    // park it
+    tb_long_t ok = 0;
+    tb_hong_t base = timeout > 0? tb_mclock() : 0;
+    tb_atomic_fetch_and_inc(&counter->waiters);
+    while (1)
+    {
+        // take it again after increasing the waiters
+        if (tb_futex_counter_take(counter))
+        {
+            ok = 1;
+            break;
+        }
+
+        // the left time
+        tb_long_t left = timeout;
+        if (timeout > 0)
+        {
+            left = timeout - (tb_long_t)(tb_mclock() - base);
+            tb_check_break(left > 0);
+        }
+
+        // wait it if the value is still zero
+        if (tb_futex_wait(&counter->value, 0, left) < 0)
+        {
+            ok = -1;
+            break;
+        }
+    }
+    tb_atomic_fetch_and_dec(&counter->waiters);
+
+    // ok?
+    return ok;
+}
+#endif
@@ -0,0 +1,216 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        futex.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_IMPL_FUTEX_H
+#define TB_PLATFORM_IMPL_FUTEX_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../atomic.h"
+#include "../spinlock.h"
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include <time.h>
+#   include <errno.h>
+#   include <unistd.h>
+#   include <sys/syscall.h>
+#   include <linux/futex.h>
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// enable the futex?
+#if (defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)) && defined(SYS_futex)
+#   define TB_FUTEX_ENABLE
+#endif
+
+// the maximum adaptive spin count before parking
+#define TB_FUTEX_SPIN_MAXN              (100)
+
+// the futex word of the atomic value, it is the low 32-bits of the atomic value
+#ifdef TB_WORDS_BIGENDIAN
+#   define tb_futex_word(a)             ((tb_int_t*)(a) + (sizeof(tb_atomic_t) / sizeof(tb_int_t)) - 1)
+#else
+#   define tb_futex_word(a)             ((tb_int_t*)(a))
+#endif
+
+/* the adaptive spin count of this time, it is always zero on the uniprocessor
+ *
+ * the spin count will be moved towards the count which was really spun at the last time
+ */
+#define tb_futex_spin_maxn(spin, maxn)  ((maxn)? tb_min((maxn), ((spin) << 1) + 10) : 0)
+
+// the next adaptive spin count after we have spun n times
+#define tb_futex_spin_next(spin, n)     ((spin) + ((tb_long_t)(n) - (spin)) / 8)
+
+// pause the processor in the spin loop
+#define tb_futex_spin_pause()           tb_spinlock_pause()
+
+#ifdef TB_FUTEX_ENABLE
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the futex counter type
+ *
+ * it is used to implement the semaphore and event, 
+ * the value is never negative and the waiters will be parked on its low 32-bits if it is zero.
+ */
+typedef struct __tb_futex_counter_t
+{
+    // the value
+    tb_atomic_t             value;
+
+    // the parked waiters count
+    tb_atomic_t             waiters;
+
+    /* the adaptive spin count
+     *
+     * it is only a hint shared by all waiters, so it is loaded and stored once per wait without the atomic read-modify-write,
+     * the lost updates are harmless.
+     */
+    tb_atomic_t             spin;
+
+    // the spin maxn, it is zero on the uniprocessor
+    tb_long_t               spin_maxn;
+
+}tb_futex_counter_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/* init the futex counter
+ *
+ * @param counter       the counter
+ * @param value         the initial value
+ */
+tb_void_t               tb_futex_counter_init(tb_futex_counter_t* counter, tb_size_t value);
+
+/* post the futex counter and only wake up the needed waiters
+ *
+ * @param counter       the counter
+ * @param post          the post value
+ * @param maxn          the maximum value, no limit if be zero (.e.g the auto-reset event is one)
+ */
+tb_void_t               tb_futex_counter_post(tb_futex_counter_t* counter, tb_size_t post, tb_size_t maxn);
+
+/* wait the futex counter after the fast path was failed, spin it first and park it
+ *
+ * @param counter       the counter
+ * @param timeout       the timeout
+ *
+ * @return              ok: 1, timeout: 0, fail: -1
+ */
+tb_long_t               tb_futex_counter_wait_slow(tb_futex_counter_t* counter, tb_long_t timeout);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * inline implementation
+ */
+
+/* wait the futex if the low 32-bits of the atomic value is equal to the expected value
+ *
+ * @param value         the atomic value
+ * @param expect        the expected value
+ * @param timeout       the timeout, infinity if be negative
+ *
+ * @return              ok: 1 (waked up, interrupted or the value has been changed), timeout: 0, fail: -1
+ */
+static __tb_inline__ tb_long_t tb_futex_wait(tb_atomic_t* value, tb_long_t expect, tb_long_t timeout)
+{
+    // init the relative timeout
+    struct timespec t;
+    if (timeout >= 0)
+    {
+        t.tv_sec    = timeout / 1000;
+        t.tv_nsec   = (timeout % 1000) * 1000000;
+    }
+
+    // wait it
+    if (!syscall(SYS_futex, tb_futex_word(value), FUTEX_WAIT_PRIVATE, (tb_int_t)expect, timeout >= 0? &t : tb_null, tb_null, 0)) return 1;
+
+    // timeout or failed?
+    return errno == ETIMEDOUT? 0 : ((errno == EAGAIN || errno == EINTR)? 1 : -1);
+}
+
+/* wake up the waiters of the futex
+ *
+ * @param value         the atomic value
+ * @param count         the waked waiters count
+ */
+static __tb_inline__ tb_void_t tb_futex_wake(tb_atomic_t* value, tb_size_t count)
+{
+    syscall(SYS_futex, tb_futex_word(value), FUTEX_WAKE_PRIVATE, (tb_int_t)tb_min(count, (tb_size_t)TB_MAXS32), tb_null, tb_null, 0);
+}
+
+/* try to take one from the futex counter without blocking
+ *
+ * @param counter       the counter
+ *
+ * @return              tb_true or tb_false
+ */
+static __tb_inline__ tb_bool_t tb_futex_counter_take(tb_futex_counter_t* counter)
+{
+    // decrease it if be positive
+    tb_long_t value = (tb_long_t)counter->value;
+    while (value > 0)
+    {
+        tb_long_t prev = tb_atomic_fetch_and_pset(&counter->value, value, value - 1);
+        if (prev == value) return tb_true;
+        value = prev;
+    }
+    return tb_false;
+}
+
+/* wait the futex counter
+ *
+ * @param counter       the counter
+ * @param timeout       the timeout
+ *
+ * @return              ok: 1, timeout: 0, fail: -1
+ */
+static __tb_inline__ tb_long_t tb_futex_counter_wait(tb_futex_counter_t* counter, tb_long_t timeout)
+{
+    // the fast path without any syscalls
+    return tb_futex_counter_take(counter)? 1 : tb_futex_counter_wait_slow(counter, timeout);
+}
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -29,6 +29,7 @@
  * includes
  */
 #include "dns.h"
+#include "rcu.h"
 #include "socket.h"
 #include "exception.h"
 #include "thread_local.h"
@@ -61,6 +61,11 @@ tb_bool_t tb_platform_init_env(tb_handle_t priv)
     if (!tb_thread_local_init_env()) return tb_false;
 #endif
 
+    // init rcu envirnoment
+#ifndef TB_CONFIG_MICRO_ENABLE
+    if (!tb_rcu_init_env()) return tb_false;
+#endif
+
     // init exception envirnoment
 #ifdef TB_CONFIG_EXCEPTION_ENABLE
     if (!tb_exception_init_env()) return tb_false;
@@ -86,6 +91,11 @@ tb_void_t tb_platform_exit_env()
     tb_dns_exit_env();
 #endif
 
+    // exit rcu envirnoment, all deferred functions will be called
+#ifndef TB_CONFIG_MICRO_ENABLE
+    tb_rcu_exit_env();
+#endif
+
     // exit socket envirnoment
     tb_socket_exit_env();
 
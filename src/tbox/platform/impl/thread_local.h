@@ -31,6 +31,23 @@
 #include "prefix.h"
 #include "../../algorithm/algorithm.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* free the thread local data by the key destructor when the thread exits?
+ *
+ * the posix thread local frees it by the destructor of the pthread key,
+ * so it is also freed for the threads which are not created by tb_thread_init().
+ * otherwise, it is only freed after the thread function of tb_thread_init() returns.
+ */
+#if defined(TB_CONFIG_POSIX_HAVE_PTHREAD_SETSPECIFIC) && \
+    defined(TB_CONFIG_POSIX_HAVE_PTHREAD_GETSPECIFIC) && \
+    defined(TB_CONFIG_POSIX_HAVE_PTHREAD_KEY_CREATE) && \
+    defined(TB_CONFIG_POSIX_HAVE_PTHREAD_KEY_DELETE)
+#   define TB_THREAD_LOCAL_DESTRUCTOR_ENABLE
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
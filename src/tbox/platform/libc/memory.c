@@ -28,7 +28,14 @@
  */
 #include "prefix.h"
 #include "../memory.h"
+#include "../page.h"
 #include <stdlib.h>
+#ifdef TB_CONFIG_POSIX_HAVE_MALLOC_TRIM
+#   include <malloc.h>
+#endif
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+#   include <sys/mman.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -93,4 +100,104 @@ tb_bool_t tb_native_memory_free(tb_pointer_t data)
     // ok
     return tb_true;
 }
+tb_bool_t tb_native_memory_trim(tb_size_t keep_bytes)
+{
+#ifdef TB_CONFIG_POSIX_HAVE_MALLOC_TRIM
+    // trim it
+    return malloc_trim(keep_bytes)? tb_true : tb_false;
+#else
+    // not supported
+    return tb_false;
+#endif
+}
+tb_pointer_t tb_native_memory_huge_malloc(tb_size_t size, tb_size_t* real, tb_size_t* page)
+{
+    // check
+    tb_check_return_val(size, tb_null);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // the page size
+    tb_size_t page_size = tb_page_size();
+    tb_assert_and_check_return_val(page_size, tb_null);
+
+    // the mapped data and the size of the pages which back it
+    tb_byte_t* data = tb_null;
+    tb_size_t  data_page = 0;
+
+    /* attempt to map the hugetlb pages first, it will be failed if no huge pages are reserved
+     *
+     * the size must be aligned by the hugetlb page size, otherwise munmap() will be failed
+     */
+#   ifdef MAP_HUGETLB
+    tb_size_t hugetlb_size = tb_page_hugetlb_size();
+    if (hugetlb_size)
+    {
+        data = (tb_byte_t*)mmap(tb_null, tb_align(size, hugetlb_size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED)
+        {
+            size = tb_align(size, hugetlb_size);
+            data_page = hugetlb_size;
+        }
+        else data = tb_null;
+    }
+#   endif
+
+    // map the normal pages and align them by the huge page size for the transparent huge page
+    tb_size_t huge_size = tb_page_huge_size();
+    if (!data && huge_size)
+    {
+        size = tb_align(size, huge_size);
+        tb_byte_t* base = (tb_byte_t*)mmap(tb_null, size + huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED)
+        {
+            // unmap the unaligned head and tail
+            data = (tb_byte_t*)tb_align((tb_size_t)base, huge_size);
+            if (data > base) munmap(base, data - base);
+            if (data + size < base + size + huge_size) munmap(data + size, (base + size + huge_size) - (data + size));
+            data_page = huge_size;
+
+            // advise to use the transparent huge page
+#   if defined(TB_CONFIG_POSIX_HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+            madvise(data, size, MADV_HUGEPAGE);
+#   endif
+        }
+    }
 
+    // map the normal pages if the huge page is not supported
+    if (!data)
+    {
+        size = tb_align(size, page_size);
+        data = (tb_byte_t*)mmap(tb_null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data != MAP_FAILED) data_page = page_size;
+        else data = tb_null;
+    }
+
+    // save the real size and the page size
+    if (data && real) *real = size;
+    if (data && page) *page = data_page;
+
+    // ok?
+    return data;
+#else
+    // save the real size and the page size
+    if (real) *real = size;
+    if (page) *page = tb_page_size();
+
+    // malloc it
+    return malloc(size);
+#endif
+}
+tb_bool_t tb_native_memory_huge_free(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_check_return_val(data, tb_true);
+
+#ifdef TB_CONFIG_POSIX_HAVE_MMAP
+    // unmap it
+    return !munmap(data, size)? tb_true : tb_false;
+#else
+    // free it
+    free(data);
+    return tb_true;
+#endif
+}
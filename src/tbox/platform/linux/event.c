@@ -0,0 +1,77 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        event.c
+ *
+ */
+
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../impl/futex.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_event_ref_t tb_event_init()
+{
+    // make event
+    tb_futex_counter_t* event = tb_malloc0_type(tb_futex_counter_t);
+    tb_assert_and_check_return_val(event, tb_null);
+
+    // init it
+    tb_futex_counter_init(event, 0);
+
+    // ok
+    return (tb_event_ref_t)event;
+}
+tb_void_t tb_event_exit(tb_event_ref_t self)
+{
+    // check
+    tb_futex_counter_t* event = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return(event);
+
+    // free it
+    tb_free(event);
+}
+tb_bool_t tb_event_post(tb_event_ref_t self)
+{
+    // check
+    tb_futex_counter_t* event = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return_val(event, tb_false);
+
+    // signal it, it is auto-reset and the multiple posts before waiting will be merged
+    tb_futex_counter_post(event, 1, 1);
+
+    // ok
+    return tb_true;
+}
+tb_long_t tb_event_wait(tb_event_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_futex_counter_t* event = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return_val(event, -1);
+
+    // wait it
+    return tb_futex_counter_wait(event, timeout);
+}
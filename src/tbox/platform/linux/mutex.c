@@ -0,0 +1,176 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mutex.c
+ *
+ */
+
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../impl/futex.h"
+#include "../processor.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/* the futex mutex type
+ *
+ * state: 0: unlocked, 1: locked, 2: locked and maybe have the parked waiters
+ */
+typedef struct __tb_mutex_futex_t
+{
+    // the state
+    tb_atomic_t             state;
+
+    // the adaptive spin count, it is only a hint and is loaded and stored once per wait (see tb_futex_counter_t)
+    tb_atomic_t             spin;
+
+    // the spin maxn, it is zero on the uniprocessor
+    tb_long_t               spin_maxn;
+
+}tb_mutex_futex_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_mutex_enter_slow(tb_mutex_futex_t* mutex)
+{
+    // spin it first, the owner may leave it soon if it is running on the other processor
+    tb_long_t spin = (tb_long_t)mutex->spin;
+    tb_long_t maxn = tb_futex_spin_maxn(spin, mutex->spin_maxn);
+    if (maxn)
+    {
+        tb_long_t i = 0;
+        for (i = 0; i < maxn; i++)
+        {
+            if (!mutex->state && !tb_atomic_fetch_and_pset(&mutex->state, 0, 1))
+            {
+                mutex->spin = tb_futex_spin_next(spin, i);
+                return ;
+            }
+
+            // pause it
+            tb_futex_spin_pause();
+        }
+        mutex->spin = tb_futex_spin_next(spin, maxn);
+    }
+
+    /* park it
+     *
+     * we mark it as contended (2) before parking, so the owner will wake us up after leaving,
+     * and we need also keep it as contended after entering because the other waiters may be still parked.
+     */
+    while (tb_atomic_fetch_and_set(&mutex->state, 2))
+        tb_futex_wait(&mutex->state, 2, -1);
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_mutex_ref_t tb_mutex_init()
+{
+    // make mutex
+    tb_mutex_futex_t* mutex = tb_malloc0_type(tb_mutex_futex_t);
+    tb_assert_and_check_return_val(mutex, tb_null);
+
+    // init the spin maxn, need not spin on the uniprocessor
+    mutex->spin_maxn = tb_processor_count() > 1? TB_FUTEX_SPIN_MAXN : 0;
+
+    // ok
+    return (tb_mutex_ref_t)mutex;
+}
+tb_void_t tb_mutex_exit(tb_mutex_ref_t self)
+{
+    // check
+    tb_mutex_futex_t* mutex = (tb_mutex_futex_t*)self;
+    tb_assert_and_check_return(mutex);
+
+    // free it
+    tb_free(mutex);
+}
+tb_bool_t tb_mutex_enter(tb_mutex_ref_t self)
+{
+    // check
+    tb_mutex_futex_t* mutex = (tb_mutex_futex_t*)self;
+    tb_assert_and_check_return_val(mutex, tb_false);
+
+    // try to enter for profiler
+#ifdef TB_LOCK_PROFILER_ENABLE
+    if (tb_mutex_enter_try(self)) return tb_true;
+#else
+    // the fast path without any syscalls
+    if (!tb_atomic_fetch_and_pset(&mutex->state, 0, 1)) return tb_true;
+#endif
+
+    // spin and park it
+    tb_mutex_enter_slow(mutex);
+
+    // ok
+    return tb_true;
+}
+tb_bool_t tb_mutex_enter_try(tb_mutex_ref_t self)
+{
+    // check
+    tb_mutex_futex_t* mutex = (tb_mutex_futex_t*)self;
+    tb_assert_and_check_return_val(mutex, tb_false);
+
+    // try to enter
+    if (tb_atomic_fetch_and_pset(&mutex->state, 0, 1))
+    {
+        // occupied
+#ifdef TB_LOCK_PROFILER_ENABLE
+        tb_lock_profiler_occupied(tb_lock_profiler(), (tb_handle_t)self);
+#endif
+
+        // failed
+        return tb_false;
+    }
+
+    // ok
+    return tb_true;
+}
+tb_bool_t tb_mutex_leave(tb_mutex_ref_t self)
+{
+    // check
+    tb_mutex_futex_t* mutex = (tb_mutex_futex_t*)self;
+    tb_assert_and_check_return_val(mutex, tb_false);
+
+    // leave it and wake up one waiter if it was contended
+    tb_long_t state = tb_atomic_fetch_and_sub(&mutex->state, 1);
+    if (state != 1)
+    {
+        // check
+        tb_assert_and_check_return_val(state == 2, tb_false);
+
+        // unlock it
+        tb_atomic_set0(&mutex->state);
+
+        // wake up one waiter
+        tb_futex_wake(&mutex->state, 1);
+    }
+
+    // ok
+    return tb_true;
+}
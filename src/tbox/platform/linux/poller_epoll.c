@@ -26,6 +26,7 @@
  * includes
  */
 #include "prefix.h"
+#include "../atomic.h"
 #include <sys/epoll.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -35,6 +36,9 @@
 #ifdef TB_CONFIG_POSIX_HAVE_GETRLIMIT
 #   include <sys/resource.h>
 #endif
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+#   include <sys/eventfd.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
@@ -49,8 +53,16 @@ typedef struct __tb_poller_epoll_t
     // the user private data
     tb_cpointer_t           priv;
 
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    // the event fd for spak, kill ..
+    tb_long_t               evfd;
+
+    // is killed?
+    tb_atomic_t             killed;
+#else
     // the pair sockets for spak, kill ..
     tb_socket_ref_t         pair[2];
+#endif
 
     // the epoll fd
     tb_long_t               epfd;
@@ -132,11 +144,11 @@ static tb_void_t tb_poller_hash_set(tb_poller_epoll_ref_t poller, tb_long_t fd,
 static __tb_inline__ tb_cpointer_t tb_poller_hash_get(tb_poller_epoll_ref_t poller, tb_long_t fd)
 {
     // check
-    tb_assert(poller && poller->hash);
+    tb_assert(poller);
     tb_assert(fd > 0 && fd < TB_MAXS32);
 
-    // get the user private data
-    return fd < poller->hash_size? poller->hash[fd] : tb_null;
+    // get the user private data, the hash may be null if all sockets have no private data
+    return (poller->hash && fd < poller->hash_size)? poller->hash[fd] : tb_null;
 }
 static __tb_inline__ tb_void_t tb_poller_hash_del(tb_poller_epoll_ref_t poller, tb_long_t fd)
 {
@@ -173,11 +185,20 @@ tb_poller_ref_t tb_poller_init(tb_cpointer_t priv)
         // init user private data
         poller->priv = priv;
 
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+        // init event fd, only one syscall for spak and it will never be full
+        poller->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        tb_assert_and_check_break(poller->evfd > 0);
+
+        // insert event fd first
+        if (!tb_poller_insert((tb_poller_ref_t)poller, tb_fd2sock(poller->evfd), TB_POLLER_EVENT_RECV, tb_null)) break;
+#else
         // init pair sockets
         if (!tb_socket_pair(TB_SOCKET_TYPE_TCP, poller->pair)) break;
 
         // insert pair socket first
         if (!tb_poller_insert((tb_poller_ref_t)poller, poller->pair[1], TB_POLLER_EVENT_RECV, tb_null)) break;  
+#endif
 
         // ok
         ok = tb_true;
@@ -201,11 +222,17 @@ tb_void_t tb_poller_exit(tb_poller_ref_t self)
     tb_poller_epoll_ref_t poller = (tb_poller_epoll_ref_t)self;
     tb_assert_and_check_return(poller);
 
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    // exit event fd
+    if (poller->evfd > 0) close(poller->evfd);
+    poller->evfd = 0;
+#else
     // exit pair sockets
     if (poller->pair[0]) tb_socket_exit(poller->pair[0]);
     if (poller->pair[1]) tb_socket_exit(poller->pair[1]);
     poller->pair[0] = tb_null;
     poller->pair[1] = tb_null;
+#endif
 
     // exit hash
     if (poller->hash) tb_free(poller->hash);
@@ -253,7 +280,12 @@ tb_void_t tb_poller_kill(tb_poller_ref_t self)
     tb_assert_and_check_return(poller);
 
     // kill it
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    tb_atomic_set(&poller->killed, 1);
+    tb_poller_spak(self);
+#else
     if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"k", 1);
+#endif
 }
 tb_void_t tb_poller_spak(tb_poller_ref_t self)
 {
@@ -262,16 +294,32 @@ tb_void_t tb_poller_spak(tb_poller_ref_t self)
     tb_assert_and_check_return(poller);
 
     // post it
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    if (poller->evfd > 0)
+    {
+        // the counter will be merged for multiple spaks, so it will not be full
+        eventfd_t value = 1;
+        if (write(poller->evfd, &value, sizeof(value)) != sizeof(value))
+        {
+            // trace
+            tb_trace_e("spak: failed, errno: %d", errno);
+        }
+    }
+#else
     if (poller->pair[0]) tb_socket_send(poller->pair[0], (tb_byte_t const*)"p", 1);
+#endif
 }
 tb_bool_t tb_poller_support(tb_poller_ref_t self, tb_size_t events)
 {
     // all supported events 
+    static tb_size_t events_supported = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR
 #ifdef EPOLLONESHOT 
-    static tb_size_t events_supported = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR | TB_POLLER_EVENT_ONESHOT;
-#else
-    static tb_size_t events_supported = TB_POLLER_EVENT_EALL | TB_POLLER_EVENT_CLEAR;
+                                        | TB_POLLER_EVENT_ONESHOT
 #endif
+#ifdef EPOLLEXCLUSIVE
+                                        | TB_POLLER_EVENT_EXCLUSIVE
+#endif
+                                        ;
 
     // is supported?
     return (events_supported & events) == events;
@@ -294,6 +342,10 @@ tb_bool_t tb_poller_insert(tb_poller_ref_t self, tb_socket_ref_t sock, tb_size_t
     tb_assertf(!(events & TB_POLLER_EVENT_ONESHOT), "cannot insert events with oneshot, not supported!");
 #endif
 
+#ifdef EPOLLEXCLUSIVE
+    if (events & TB_POLLER_EVENT_EXCLUSIVE) e.events |= EPOLLEXCLUSIVE;
+#endif
+
     // save fd
     e.data.fd = (tb_int_t)tb_sock2fd(sock);
     
@@ -301,7 +353,16 @@ tb_bool_t tb_poller_insert(tb_poller_ref_t self, tb_socket_ref_t sock, tb_size_t
     tb_poller_hash_set(poller, e.data.fd, priv);
 
     // add socket and events
-    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, e.data.fd, &e) < 0)
+    tb_int_t ok = epoll_ctl(poller->epfd, EPOLL_CTL_ADD, e.data.fd, &e);
+#ifdef EPOLLEXCLUSIVE
+    // the exclusive flag is not supported for the old kernel (< 4.5)? add it again without this flag
+    if (ok < 0 && errno == EINVAL && (e.events & EPOLLEXCLUSIVE))
+    {
+        e.events &= ~EPOLLEXCLUSIVE;
+        ok = epoll_ctl(poller->epfd, EPOLL_CTL_ADD, e.data.fd, &e);
+    }
+#endif
+    if (ok < 0)
     {
         // trace
         tb_trace_e("insert socket(%p) events: %lu failed, errno: %d", sock, events, errno);
@@ -421,7 +482,11 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
     tb_size_t           i = 0;
     tb_size_t           wait = 0; 
     struct epoll_event* e = tb_null;
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+    tb_socket_ref_t     pair = tb_fd2sock(poller->evfd);
+#else
     tb_socket_ref_t     pair = poller->pair[1];
+#endif
     for (i = 0; i < events_count; i++)
     {
         // the epoll event
@@ -437,12 +502,21 @@ tb_long_t tb_poller_wait(tb_poller_ref_t self, tb_poller_event_func_t func, tb_l
         // spak?
         if (sock == pair && (epoll_events & EPOLLIN)) 
         {
+#ifdef TB_CONFIG_POSIX_HAVE_EVENTFD
+            // read and reset all spaks
+            eventfd_t value = 0;
+            if (read(poller->evfd, &value, sizeof(value)) != sizeof(value) && errno != EAGAIN) return -1;
+
+            // killed?
+            if (tb_atomic_fetch_and_set(&poller->killed, 0)) return -1;
+#else
             // read spak
             tb_char_t spak = '\0';
             if (1 != tb_socket_recv(pair, (tb_byte_t*)&spak, 1)) return -1;
 
             // killed?
             if (spak == 'k') return -1;
+#endif
 
             // continue it
             continue ;
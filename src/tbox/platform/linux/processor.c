@@ -0,0 +1,247 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        processor.c
+ * @ingroup     platform
+ */
+
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_processor_sysfs_read(tb_char_t* data, tb_size_t maxn, tb_char_t const* format, ...)
+{
+    // check
+    tb_assert_and_check_return_val(data && maxn > 1 && format, tb_false);
+
+    // format the path
+    tb_long_t size = 0;
+    tb_char_t path[256];
+    tb_vsnprintf_format(path, sizeof(path) - 1, format, &size);
+    tb_check_return_val(size > 0, tb_false);
+
+    // open it
+    tb_int_t fd = open(path, O_RDONLY);
+    tb_check_return_val(fd >= 0, tb_false);
+
+    // read it
+    size = read(fd, data, maxn - 1);
+    close(fd);
+    tb_check_return_val(size > 0, tb_false);
+
+    // strip the trailing newline
+    while (size && (data[size - 1] == '\n' || data[size - 1] == ' ')) size--;
+    data[size] = '\0';
+
+    // ok
+    return size > 0;
+}
+static tb_long_t tb_processor_sysfs_long(tb_long_t defval, tb_char_t const* format, tb_long_t index)
+{
+    // read it
+    tb_char_t data[64];
+    if (!tb_processor_sysfs_read(data, sizeof(data), format, index)) return defval;
+
+    // the value
+    return tb_s10toi32(data);
+}
+static tb_bool_t tb_processor_sysfs_cpuset(tb_cpuset_ref_t cpuset, tb_char_t const* format, tb_long_t index)
+{
+    // check
+    tb_assert_and_check_return_val(cpuset, tb_false);
+
+    // read the cpu list, .e.g 0-3,8-11
+    tb_char_t data[1024];
+    if (!tb_processor_sysfs_read(data, sizeof(data), format, index)) return tb_false;
+
+    // parse it
+    tb_char_t const* p = data;
+    while (*p)
+    {
+        // the first cpu
+        tb_check_return_val(tb_isdigit(*p), tb_false);
+        tb_size_t first = 0;
+        while (tb_isdigit(*p)) first = first * 10 + (*p++ - '0');
+
+        // the last cpu
+        tb_size_t last = first;
+        if (*p == '-')
+        {
+            p++;
+            tb_check_return_val(tb_isdigit(*p), tb_false);
+            last = 0;
+            while (tb_isdigit(*p)) last = last * 10 + (*p++ - '0');
+        }
+
+        // add them
+        for (; first <= last && first < TB_CPUSET_MAXN; first++) tb_cpuset_set(cpuset, first);
+
+        // the next range
+        if (*p == ',') p++;
+    }
+
+    // ok
+    return tb_true;
+}
+static tb_size_t tb_processor_sysfs_cache(tb_char_t const* format, tb_long_t index)
+{
+    // read the cache size, .e.g 32K
+    tb_char_t data[64];
+    if (!tb_processor_sysfs_read(data, sizeof(data), format, index)) return 0;
+
+    // the size
+    tb_char_t const*    p = data;
+    tb_size_t           size = 0;
+    while (tb_isdigit(*p)) size = size * 10 + (*p++ - '0');
+
+    // the unit
+    if (*p == 'K') size <<= 10;
+    else if (*p == 'M') size <<= 20;
+    else if (*p == 'G') size <<= 30;
+
+    // ok
+    return size;
+}
+static tb_bool_t tb_processor_topology_load(tb_processor_topology_t* topology)
+{
+    // check
+    tb_assert_and_check_return_val(topology, tb_false);
+
+    // load the online cpus
+    if (!tb_processor_sysfs_cpuset(&topology->online, "/sys/devices/system/cpu/online", 0)) return tb_false;
+
+    // load the raw package and core ids of all online cpus
+    tb_size_t   cpu = 0;
+    tb_long_t   core_ids[TB_CPUSET_MAXN];
+    tb_long_t   package_ids[TB_CPUSET_MAXN];
+    for (cpu = 0; cpu < TB_CPUSET_MAXN; cpu++)
+    {
+        tb_check_continue(tb_cpuset_isset(&topology->online, cpu));
+        core_ids[cpu]       = tb_processor_sysfs_long(cpu, "/sys/devices/system/cpu/cpu%ld/topology/core_id", (tb_long_t)cpu);
+        package_ids[cpu]    = tb_processor_sysfs_long(0, "/sys/devices/system/cpu/cpu%ld/topology/physical_package_id", (tb_long_t)cpu);
+        topology->cpus_count++;
+    }
+    tb_check_return_val(topology->cpus_count, tb_false);
+
+    // load the numa nodes, all cpus are on the node zero if the kernel has no numa support
+    tb_cpuset_t nodes;
+    tb_cpuset_clear(&nodes);
+    if (tb_processor_sysfs_cpuset(&nodes, "/sys/devices/system/node/online", 0))
+    {
+        tb_size_t node = 0;
+        for (node = 0; node < TB_CPUSET_MAXN; node++)
+        {
+            // load the cpus of this node
+            tb_cpuset_t cpus;
+            tb_cpuset_clear(&cpus);
+            tb_check_continue(tb_cpuset_isset(&nodes, node));
+            tb_check_continue(tb_processor_sysfs_cpuset(&cpus, "/sys/devices/system/node/node%ld/cpulist", (tb_long_t)node));
+
+            // the node index
+            tb_size_t index = topology->nodes_count++;
+            for (cpu = 0; cpu < TB_CPUSET_MAXN; cpu++)
+            {
+                if (tb_cpuset_isset(&cpus, cpu)) topology->cpus[cpu].node = (tb_uint16_t)index;
+            }
+        }
+    }
+    if (!topology->nodes_count) topology->nodes_count = 1;
+
+    /* make the physical cores
+     *
+     * the cores are sorted by the node and we merge the smt siblings 
+     * which have the same package and core ids
+     */
+    tb_size_t   node = 0;
+    tb_long_t   packages[TB_CPUSET_MAXN];
+    tb_cpuset_t done;
+    tb_cpuset_clear(&done);
+    for (node = 0; node < topology->nodes_count; node++)
+    {
+        for (cpu = 0; cpu < TB_CPUSET_MAXN; cpu++)
+        {
+            // the first unused cpu of this node
+            tb_check_continue(tb_cpuset_isset(&topology->online, cpu) && !tb_cpuset_isset(&done, cpu));
+            tb_check_continue(topology->cpus[cpu].node == node);
+
+            // get the package index
+            tb_size_t package = 0;
+            for (package = 0; package < topology->packages_count && packages[package] != package_ids[cpu]; package++) ;
+            if (package == topology->packages_count) packages[topology->packages_count++] = package_ids[cpu];
+
+            // make a new core
+            tb_size_t               index = topology->cores_count++;
+            tb_processor_core_t*    core = &topology->cores[index];
+            core->package   = (tb_uint16_t)package;
+            core->node      = (tb_uint16_t)node;
+
+            // add all smt siblings to this core
+            tb_size_t sibling = 0;
+            for (sibling = cpu; sibling < TB_CPUSET_MAXN; sibling++)
+            {
+                tb_check_continue(tb_cpuset_isset(&topology->online, sibling) && !tb_cpuset_isset(&done, sibling));
+                tb_check_continue(topology->cpus[sibling].node == node);
+                tb_check_continue(core_ids[sibling] == core_ids[cpu] && package_ids[sibling] == package_ids[cpu]);
+
+                // add it
+                tb_cpuset_set(&done, sibling);
+                tb_cpuset_set(&core->cpus, sibling);
+                topology->cpus[sibling].core    = (tb_uint16_t)index;
+                topology->cpus[sibling].thread  = core->threads++;
+                topology->cpus[sibling].package = (tb_uint16_t)package;
+            }
+        }
+    }
+
+    // load the caches of the first cpu
+    tb_long_t index = 0;
+    for (index = 0; index < 8; index++)
+    {
+        // the cache level
+        tb_long_t level = tb_processor_sysfs_long(-1, "/sys/devices/system/cpu/cpu0/cache/index%ld/level", index);
+        tb_check_break(level >= 0);
+
+        // the cache type, skip the instruction cache
+        tb_char_t type[32];
+        if (!tb_processor_sysfs_read(type, sizeof(type), "/sys/devices/system/cpu/cpu0/cache/index%ld/type", index)) continue;
+        tb_check_continue(tb_strcmp(type, "Instruction"));
+
+        // the cache size
+        tb_size_t size = tb_processor_sysfs_cache("/sys/devices/system/cpu/cpu0/cache/index%ld/size", index);
+        if (level == 1) topology->cache_l1d = size;
+        else if (level == 2) topology->cache_l2 = size;
+        else if (level == 3) topology->cache_l3 = size;
+
+        // the cache line size
+        if (level == 1) topology->cache_line = tb_processor_sysfs_long(0, "/sys/devices/system/cpu/cpu0/cache/index%ld/coherency_line_size", index);
+    }
+    if (!topology->cache_line) topology->cache_line = TB_L1_CACHE_BYTES;
+
+    // ok
+    return topology->cores_count > 0;
+}
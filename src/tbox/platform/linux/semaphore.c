@@ -0,0 +1,86 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        semaphore.c
+ *
+ */
+
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../impl/futex.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_semaphore_ref_t tb_semaphore_init(tb_size_t init)
+{
+    // make semaphore
+    tb_futex_counter_t* semaphore = tb_malloc0_type(tb_futex_counter_t);
+    tb_assert_and_check_return_val(semaphore, tb_null);
+
+    // init it
+    tb_futex_counter_init(semaphore, init);
+
+    // ok
+    return (tb_semaphore_ref_t)semaphore;
+}
+tb_void_t tb_semaphore_exit(tb_semaphore_ref_t self)
+{
+    // check
+    tb_futex_counter_t* semaphore = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return(semaphore);
+
+    // free it
+    tb_free(semaphore);
+}
+tb_bool_t tb_semaphore_post(tb_semaphore_ref_t self, tb_size_t post)
+{
+    // check
+    tb_futex_counter_t* semaphore = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return_val(semaphore && post, tb_false);
+
+    // post it and only wake up the needed waiters
+    tb_futex_counter_post(semaphore, post, 0);
+
+    // ok
+    return tb_true;
+}
+tb_long_t tb_semaphore_value(tb_semaphore_ref_t self)
+{
+    // check
+    tb_futex_counter_t* semaphore = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return_val(semaphore, -1);
+
+    // get value
+    return (tb_long_t)semaphore->value;
+}
+tb_long_t tb_semaphore_wait(tb_semaphore_ref_t self, tb_long_t timeout)
+{
+    // check
+    tb_futex_counter_t* semaphore = (tb_futex_counter_t*)self;
+    tb_assert_and_check_return_val(semaphore, -1);
+
+    // wait it
+    return tb_futex_counter_wait(semaphore, timeout);
+}
@@ -0,0 +1,216 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lockfree_stack.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "lockfree_stack.h"
+#include "atomic64.h"
+#include "barrier.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+#if defined(TB_LOCKFREE_STACK_DCAS_ENABLE) && !TB_CPU_BIT64
+// the 64bits value of the top entry and tag
+typedef union __tb_lockfree_stack_value_t
+{
+    // the stack
+    tb_lockfree_stack_t         stack;
+
+    // the value
+    tb_hong_t                   value;
+
+}tb_lockfree_stack_value_t;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+#ifdef TB_LOCKFREE_STACK_DCAS_ENABLE
+static __tb_inline__ tb_void_t tb_lockfree_stack_load(tb_lockfree_stack_ref_t stack, tb_lockfree_stack_ref_t head)
+{
+    /* load the tag and top entry
+     *
+     * it may be torn if other threads are changing it, but the cas will fail and we will load it again
+     */
+    head->tag = *((tb_size_t volatile*)&stack->tag);
+    head->top = *((tb_single_list_entry_ref_t volatile*)&stack->top);
+}
+static __tb_inline__ tb_bool_t tb_lockfree_stack_cas(tb_lockfree_stack_ref_t stack, tb_lockfree_stack_ref_t head, tb_single_list_entry_ref_t top)
+{
+#if TB_CPU_BIT64
+    // the expected top entry and tag
+    tb_size_t   low = (tb_size_t)head->top;
+    tb_size_t   high = head->tag;
+    tb_byte_t   ok = 0;
+
+    // change the top entry and increase the tag
+    __tb_asm__ __tb_volatile__
+    (
+        "lock; cmpxchg16b %1\n"
+        "setz %0\n"
+        : "=q" (ok), "+m" (*stack), "+a" (low), "+d" (high)
+        : "b" ((tb_size_t)top), "c" (head->tag + 1)
+        : "memory", "cc"
+    );
+    return (tb_bool_t)ok;
+#else
+    // the expected value
+    tb_lockfree_stack_value_t expected;
+    expected.stack.top = head->top;
+    expected.stack.tag = head->tag;
+
+    // the new value
+    tb_lockfree_stack_value_t value;
+    value.stack.top = top;
+    value.stack.tag = head->tag + 1;
+
+    // change the top entry and increase the tag
+    return tb_atomic64_fetch_and_pset((tb_atomic64_t*)stack, expected.value, value.value) == expected.value;
+#endif
+}
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_lockfree_stack_init(tb_lockfree_stack_ref_t stack)
+{
+    // check
+    tb_assert_and_check_return(stack);
+
+    // init it
+    stack->top = tb_null;
+    stack->tag = 0;
+#ifndef TB_LOCKFREE_STACK_DCAS_ENABLE
+    tb_spinlock_init(&stack->lock);
+#endif
+}
+tb_void_t tb_lockfree_stack_exit(tb_lockfree_stack_ref_t stack)
+{
+    // check
+    tb_assert_and_check_return(stack);
+
+    // clear it
+    stack->top = tb_null;
+#ifndef TB_LOCKFREE_STACK_DCAS_ENABLE
+    tb_spinlock_exit(&stack->lock);
+#endif
+}
+tb_void_t tb_lockfree_stack_push(tb_lockfree_stack_ref_t stack, tb_single_list_entry_ref_t entry)
+{
+    // check
+    tb_assert(stack && entry);
+
+#ifdef TB_LOCKFREE_STACK_DCAS_ENABLE
+    // push it
+    tb_lockfree_stack_t head;
+    do
+    {
+        // link the top entry
+        tb_lockfree_stack_load(stack, &head);
+        entry->next = head.top;
+
+    } while (!tb_lockfree_stack_cas(stack, &head, entry));
+#else
+    // push it
+    tb_spinlock_enter(&stack->lock);
+    entry->next = stack->top;
+    stack->top = entry;
+    tb_spinlock_leave(&stack->lock);
+#endif
+}
+tb_single_list_entry_ref_t tb_lockfree_stack_pop(tb_lockfree_stack_ref_t stack)
+{
+    // check
+    tb_assert(stack);
+
+#ifdef TB_LOCKFREE_STACK_DCAS_ENABLE
+    // pop it
+    tb_lockfree_stack_t head;
+    do
+    {
+        // empty?
+        tb_lockfree_stack_load(stack, &head);
+        tb_check_return_val(head.top, tb_null);
+
+        /* the top entry may have been popped by the other threads, 
+         * but the tag has been changed and the cas will fail
+         */
+    } while (!tb_lockfree_stack_cas(stack, &head, *((tb_single_list_entry_ref_t volatile*)&head.top->next)));
+
+    // ok
+    return head.top;
+#else
+    // pop it
+    tb_spinlock_enter(&stack->lock);
+    tb_single_list_entry_ref_t entry = stack->top;
+    if (entry) stack->top = entry->next;
+    tb_spinlock_leave(&stack->lock);
+
+    // ok
+    return entry;
+#endif
+}
+tb_single_list_entry_ref_t tb_lockfree_stack_pop_all(tb_lockfree_stack_ref_t stack)
+{
+    // check
+    tb_assert(stack);
+
+#ifdef TB_LOCKFREE_STACK_DCAS_ENABLE
+    // pop all
+    tb_lockfree_stack_t head;
+    do
+    {
+        // empty?
+        tb_lockfree_stack_load(stack, &head);
+        tb_check_return_val(head.top, tb_null);
+
+    } while (!tb_lockfree_stack_cas(stack, &head, tb_null));
+
+    // ok
+    return head.top;
+#else
+    // pop all
+    tb_spinlock_enter(&stack->lock);
+    tb_single_list_entry_ref_t entry = stack->top;
+    stack->top = tb_null;
+    tb_spinlock_leave(&stack->lock);
+
+    // ok
+    return entry;
+#endif
+}
+tb_bool_t tb_lockfree_stack_null(tb_lockfree_stack_ref_t stack)
+{
+    // check
+    tb_assert_and_check_return_val(stack, tb_true);
+
+    // null?
+    return !*((tb_single_list_entry_ref_t volatile*)&stack->top);
+}
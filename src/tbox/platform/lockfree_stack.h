@@ -0,0 +1,148 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        lockfree_stack.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_LOCKFREE_STACK_H
+#define TB_PLATFORM_LOCKFREE_STACK_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "spinlock.h"
+#include "../container/single_list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/* the top entry and the aba tag can be changed by the double-width cas?
+ *
+ * - x64: cmpxchg16b
+ * - 32bits: the 64bits atomic
+ *
+ * otherwise, we use the spinlock
+ */
+#if TB_CPU_BIT64
+#   if defined(TB_ARCH_x64) && defined(TB_ASSEMBLER_IS_GAS)
+#       define TB_LOCKFREE_STACK_DCAS_ENABLE
+#   endif
+#   define TB_LOCKFREE_STACK_ALIGN          (16)
+#else
+#   define TB_LOCKFREE_STACK_DCAS_ENABLE
+#   define TB_LOCKFREE_STACK_ALIGN          (8)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the intrusive lock-free stack type (treiber stack)
+ *
+ * <pre>
+ * top(tag) -> entry -> entry -> entry -> null
+ *
+ * push: entry->next = top, cas(top, tag: entry, tag + 1)
+ * pop:  cas(top, tag: top->next, tag + 1)
+ * </pre>
+ *
+ * the tag is changed with the top entry together, so pop will fail 
+ * if the top entry has been popped and pushed again (aba problem) after we load it.
+ *
+ * @note the popped entry may be still read by the other poppers, so its memory cannot be 
+ * unmapped before exiting the stack, e.g. the entries are allocated from a pool or a free list.
+ */
+typedef __tb_aligned__(TB_LOCKFREE_STACK_ALIGN) struct __tb_lockfree_stack_t
+{
+    // the top entry
+    tb_single_list_entry_ref_t  top;
+
+    // the aba tag
+    tb_size_t                   tag;
+
+#ifndef TB_LOCKFREE_STACK_DCAS_ENABLE
+    // the lock
+    tb_spinlock_t               lock;
+#endif
+
+}__tb_aligned__(TB_LOCKFREE_STACK_ALIGN) tb_lockfree_stack_t, *tb_lockfree_stack_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init stack
+ *
+ * @param stack         the stack
+ */
+tb_void_t                   tb_lockfree_stack_init(tb_lockfree_stack_ref_t stack);
+
+/*! exit stack, the remaining entries are not freed
+ *
+ * @param stack         the stack
+ */
+tb_void_t                   tb_lockfree_stack_exit(tb_lockfree_stack_ref_t stack);
+
+/*! push the entry to the stack top
+ *
+ * @param stack         the stack
+ * @param entry         the entry
+ */
+tb_void_t                   tb_lockfree_stack_push(tb_lockfree_stack_ref_t stack, tb_single_list_entry_ref_t entry);
+
+/*! pop the entry from the stack top
+ *
+ * @param stack         the stack
+ *
+ * @return              the entry or tb_null if the stack is empty
+ */
+tb_single_list_entry_ref_t  tb_lockfree_stack_pop(tb_lockfree_stack_ref_t stack);
+
+/*! pop all entries from the stack
+ *
+ * @param stack         the stack
+ *
+ * @return              the top entry of the popped entries list
+ */
+tb_single_list_entry_ref_t  tb_lockfree_stack_pop_all(tb_lockfree_stack_ref_t stack);
+
+/*! the stack is null? it is only a snapshot if other threads are accessing it
+ *
+ * @param stack         the stack
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_lockfree_stack_null(tb_lockfree_stack_ref_t stack);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
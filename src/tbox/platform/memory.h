@@ -103,6 +103,37 @@ tb_pointer_t            tb_native_memory_ralloc(tb_pointer_t data, tb_size_t siz
  */
 tb_bool_t               tb_native_memory_free(tb_pointer_t data);
 
+/*! trim the native memory and return the free pages at the heap top to the system
+ *
+ * @param keep_bytes    the free bytes which will be kept for the next allocation
+ *
+ * @return              tb_true if some memory was released, otherwise tb_false
+ */
+tb_bool_t               tb_native_memory_trim(tb_size_t keep_bytes);
+
+/*! malloc the native memory which is backed by the huge pages
+ *
+ * it will attempt to use hugetlb first, and then the transparent huge page, 
+ * it will fall back to the normal pages if the huge page is not supported.
+ *
+ * @param size          the size
+ * @param real          the real allocated size which is aligned by the page size, optional
+ * @param page          the size of the pages which back it, optional,
+ *                      .e.g the hugetlb or transparent huge page size, it should be released at this granularity
+ *
+ * @return              the data address, it is aligned by the page size
+ */
+tb_pointer_t            tb_native_memory_huge_malloc(tb_size_t size, tb_size_t* real, tb_size_t* page);
+
+/*! free the native memory which is allocated by tb_native_memory_huge_malloc()
+ *
+ * @param data          the data address
+ * @param size          the real allocated size
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_native_memory_huge_free(tb_pointer_t data, tb_size_t size);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
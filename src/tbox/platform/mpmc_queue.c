@@ -0,0 +1,256 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpmc_queue.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "mpmc_queue"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "mpmc_queue.h"
+#include "atomic.h"
+#include "barrier.h"
+#include "../utils/utils.h"
+#include "../memory/memory.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the padding size, we pad two default cache lines because most processors use 64 bytes 
+#define TB_MPMC_QUEUE_PADDING           (TB_L1_CACHE_BYTES << 1)
+
+// the item maxn
+#ifdef __tb_small__
+#   define TB_MPMC_QUEUE_MAXN           (1 << 16)
+#else
+#   define TB_MPMC_QUEUE_MAXN           (1 << 20)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the mpmc queue cell type
+typedef struct __tb_mpmc_queue_cell_t
+{
+    // the sequence, it is equal to the put position if be writable and to the position + 1 if be readable
+    tb_atomic_t                 sequence;
+
+    // the data
+    tb_cpointer_t               data;
+
+}tb_mpmc_queue_cell_t;
+
+// the mpmc queue type
+typedef struct __tb_mpmc_queue_t
+{
+    // the cells
+    tb_mpmc_queue_cell_t*       cells;
+
+    // the cells mask
+    tb_size_t                   mask;
+
+    // the padding
+    tb_byte_t                   padding0[TB_MPMC_QUEUE_PADDING];
+
+    // the put position, only contended by the producers
+    tb_atomic_t                 put;
+
+    // the padding
+    tb_byte_t                   padding1[TB_MPMC_QUEUE_PADDING];
+
+    // the pop position, only contended by the consumers
+    tb_atomic_t                 pop;
+
+    // the padding
+    tb_byte_t                   padding2[TB_MPMC_QUEUE_PADDING];
+
+}tb_mpmc_queue_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_mpmc_queue_ref_t tb_mpmc_queue_init(tb_size_t maxn)
+{
+    // check
+    tb_assert_and_check_return_val(maxn && maxn <= TB_MPMC_QUEUE_MAXN, tb_null);
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_mpmc_queue_t*    queue = tb_null;
+    do
+    {
+        // make queue
+        queue = tb_malloc0_type(tb_mpmc_queue_t);
+        tb_assert_and_check_break(queue);
+
+        // we need two cells at least to distinguish the writable and readable sequence
+        maxn = tb_align_pow2(tb_max(maxn, 2));
+
+        // make cells
+        queue->cells = tb_nalloc_type(maxn, tb_mpmc_queue_cell_t);
+        tb_assert_and_check_break(queue->cells);
+
+        // init cells, the cell i is writable at the position i
+        tb_size_t i = 0;
+        for (i = 0; i < maxn; i++) 
+        {
+            queue->cells[i].sequence    = (tb_atomic_t)i;
+            queue->cells[i].data        = tb_null;
+        }
+        queue->mask = maxn - 1;
+
+        // publish it
+        tb_barrier();
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (queue) tb_mpmc_queue_exit((tb_mpmc_queue_ref_t)queue);
+        queue = tb_null;
+    }
+
+    // ok?
+    return (tb_mpmc_queue_ref_t)queue;
+}
+tb_void_t tb_mpmc_queue_exit(tb_mpmc_queue_ref_t self)
+{
+    // check
+    tb_mpmc_queue_t* queue = (tb_mpmc_queue_t*)self;
+    tb_assert_and_check_return(queue);
+
+    // exit cells
+    if (queue->cells) tb_free(queue->cells);
+    queue->cells = tb_null;
+
+    // exit it
+    tb_free(queue);
+}
+tb_bool_t tb_mpmc_queue_put(tb_mpmc_queue_ref_t self, tb_cpointer_t data)
+{
+    // check
+    tb_mpmc_queue_t* queue = (tb_mpmc_queue_t*)self;
+    tb_assert_and_check_return_val(queue && queue->cells, tb_false);
+
+    // claim a writable cell
+    tb_mpmc_queue_cell_t*   cell = tb_null;
+    tb_size_t               pos = (tb_size_t)*((tb_atomic_t volatile*)&queue->put);
+    while (1)
+    {
+        // get the cell sequence
+        cell = &queue->cells[pos & queue->mask];
+        tb_long_t diff = (tb_long_t)(tb_atomic_t)((tb_size_t)*((tb_atomic_t volatile*)&cell->sequence) - pos);
+
+        // it is writable? claim this position
+        if (!diff)
+        {
+            tb_size_t prev = (tb_size_t)tb_atomic_fetch_and_pset(&queue->put, (tb_atomic_t)pos, (tb_atomic_t)(pos + 1));
+            tb_check_break(prev != pos);
+            pos = prev;
+        }
+        // it has not been popped after the last round, the queue is full
+        else if (diff < 0) return tb_false;
+        // the position has been claimed by the other producers, reload it
+        else pos = (tb_size_t)*((tb_atomic_t volatile*)&queue->put);
+    }
+
+    // save data
+    cell->data = data;
+
+    // make it readable after saving data
+    tb_barrier();
+    *((tb_atomic_t volatile*)&cell->sequence) = (tb_atomic_t)(pos + 1);
+
+    // ok
+    return tb_true;
+}
+tb_bool_t tb_mpmc_queue_pop(tb_mpmc_queue_ref_t self, tb_pointer_t* pdata)
+{
+    // check
+    tb_mpmc_queue_t* queue = (tb_mpmc_queue_t*)self;
+    tb_assert_and_check_return_val(queue && queue->cells && pdata, tb_false);
+
+    // claim a readable cell
+    tb_mpmc_queue_cell_t*   cell = tb_null;
+    tb_size_t               pos = (tb_size_t)*((tb_atomic_t volatile*)&queue->pop);
+    while (1)
+    {
+        // get the cell sequence
+        cell = &queue->cells[pos & queue->mask];
+        tb_long_t diff = (tb_long_t)(tb_atomic_t)((tb_size_t)*((tb_atomic_t volatile*)&cell->sequence) - (pos + 1));
+
+        // it is readable? claim this position
+        if (!diff)
+        {
+            tb_size_t prev = (tb_size_t)tb_atomic_fetch_and_pset(&queue->pop, (tb_atomic_t)pos, (tb_atomic_t)(pos + 1));
+            tb_check_break(prev != pos);
+            pos = prev;
+        }
+        // it has not been put yet, the queue is empty
+        else if (diff < 0) return tb_false;
+        // the position has been claimed by the other consumers, reload it
+        else pos = (tb_size_t)*((tb_atomic_t volatile*)&queue->pop);
+    }
+
+    // load data
+    *pdata = (tb_pointer_t)cell->data;
+
+    // make it writable for the next round after loading data
+    tb_barrier();
+    *((tb_atomic_t volatile*)&cell->sequence) = (tb_atomic_t)(pos + queue->mask + 1);
+
+    // ok
+    return tb_true;
+}
+tb_size_t tb_mpmc_queue_size(tb_mpmc_queue_ref_t self)
+{
+    // check
+    tb_mpmc_queue_t* queue = (tb_mpmc_queue_t*)self;
+    tb_assert_and_check_return_val(queue, 0);
+
+    // the size, the pop position may be newer than the put position
+    tb_long_t size = (tb_long_t)(tb_atomic_t)((tb_size_t)*((tb_atomic_t volatile*)&queue->put) - (tb_size_t)*((tb_atomic_t volatile*)&queue->pop));
+    return size > 0? tb_min((tb_size_t)size, queue->mask + 1) : 0;
+}
+tb_size_t tb_mpmc_queue_maxn(tb_mpmc_queue_ref_t self)
+{
+    // check
+    tb_mpmc_queue_t* queue = (tb_mpmc_queue_t*)self;
+    tb_assert_and_check_return_val(queue, 0);
+
+    // the maxn
+    return queue->mask + 1;
+}
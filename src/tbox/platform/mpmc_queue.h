@@ -0,0 +1,124 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpmc_queue.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_MPMC_QUEUE_H
+#define TB_PLATFORM_MPMC_QUEUE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the bounded lock-free multi-producer multi-consumer queue ref type
+ *
+ * <pre>
+ * cells: |seq|data|seq|data|seq|data|seq|data| ... 
+ *                  |                    |
+ *                 pop                  put
+ *
+ * put: claim the put position if the cell sequence == position, 
+ *      then save data and set the sequence to position + 1
+ *
+ * pop: claim the pop position if the cell sequence == position + 1,
+ *      then load data and set the sequence to position + maxn
+ *
+ * performance: 
+ *
+ * put: O(1), one cas
+ * pop: O(1), one cas
+ * </pre>
+ *
+ * @note the producers and consumers only contend on their own position,
+ * and pop may fail if the producer of the head item has been preempted before saving it.
+ */
+typedef __tb_typeref__(mpmc_queue);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init queue
+ *
+ * @param maxn          the item maxn, it will be aligned to the power of 2
+ *
+ * @return              the queue
+ */
+tb_mpmc_queue_ref_t     tb_mpmc_queue_init(tb_size_t maxn);
+
+/*! exit queue
+ *
+ * @param queue         the queue
+ */
+tb_void_t               tb_mpmc_queue_exit(tb_mpmc_queue_ref_t queue);
+
+/*! put the item to the queue tail
+ *
+ * @param queue         the queue
+ * @param data          the item data
+ *
+ * @return              tb_true or tb_false if the queue is full
+ */
+tb_bool_t               tb_mpmc_queue_put(tb_mpmc_queue_ref_t queue, tb_cpointer_t data);
+
+/*! pop the item from the queue head
+ *
+ * @param queue         the queue
+ * @param pdata         the item data pointer
+ *
+ * @return              tb_true or tb_false if the queue is empty
+ */
+tb_bool_t               tb_mpmc_queue_pop(tb_mpmc_queue_ref_t queue, tb_pointer_t* pdata);
+
+/*! the queue size, it is only a snapshot if other threads are accessing it
+ *
+ * @param queue         the queue
+ *
+ * @return              the queue size
+ */
+tb_size_t               tb_mpmc_queue_size(tb_mpmc_queue_ref_t queue);
+
+/*! the queue maxn
+ *
+ * @param queue         the queue
+ *
+ * @return              the queue maxn
+ */
+tb_size_t               tb_mpmc_queue_maxn(tb_mpmc_queue_ref_t queue);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -0,0 +1,126 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpsc_queue.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "mpsc_queue.h"
+#include "atomic.h"
+#include "barrier.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// load the next entry
+#define tb_mpsc_queue_next(entry)       (*((tb_single_list_entry_ref_t volatile*)&(entry)->next))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_void_t tb_mpsc_queue_init(tb_mpsc_queue_ref_t queue)
+{
+    // check
+    tb_assert_and_check_return(queue);
+
+    // init it, the stub entry is always in the queue if it is empty
+    queue->stub.next    = tb_null;
+    queue->head         = &queue->stub;
+    queue->tail         = &queue->stub;
+}
+tb_void_t tb_mpsc_queue_exit(tb_mpsc_queue_ref_t queue)
+{
+    // check
+    tb_assert_and_check_return(queue);
+
+    // clear it
+    tb_mpsc_queue_init(queue);
+}
+tb_void_t tb_mpsc_queue_put(tb_mpsc_queue_ref_t queue, tb_single_list_entry_ref_t entry)
+{
+    // check
+    tb_assert(queue && entry);
+
+    // it will be the last entry
+    entry->next = tb_null;
+
+    // publish the entry before exchanging the head
+    tb_barrier();
+
+    // exchange the head
+    tb_single_list_entry_ref_t prev = (tb_single_list_entry_ref_t)tb_atomic_fetch_and_set((tb_atomic_t*)&queue->head, (tb_long_t)entry);
+    tb_assert(prev);
+
+    // link it, the consumer cannot pop it before this
+    tb_mpsc_queue_next(prev) = entry;
+}
+tb_single_list_entry_ref_t tb_mpsc_queue_pop(tb_mpsc_queue_ref_t queue)
+{
+    // check
+    tb_assert(queue);
+
+    // skip the stub entry
+    tb_single_list_entry_ref_t tail = queue->tail;
+    tb_single_list_entry_ref_t next = tb_mpsc_queue_next(tail);
+    if (tail == &queue->stub)
+    {
+        // empty?
+        tb_check_return_val(next, tb_null);
+
+        // skip it
+        queue->tail = next;
+        tail        = next;
+        next        = tb_mpsc_queue_next(next);
+    }
+
+    // pop the tail if it is not the last entry
+    if (next)
+    {
+        queue->tail = next;
+        return tail;
+    }
+
+    // a producer is putting an entry after the tail? we need wait it
+    tb_single_list_entry_ref_t head = *((tb_single_list_entry_ref_t volatile*)&queue->head);
+    tb_check_return_val(tail == head, tb_null);
+
+    // put the stub entry back to pop the last entry
+    tb_mpsc_queue_put(queue, &queue->stub);
+
+    // pop the tail if it has been linked
+    next = tb_mpsc_queue_next(tail);
+    tb_check_return_val(next, tb_null);
+    queue->tail = next;
+    return tail;
+}
+tb_bool_t tb_mpsc_queue_null(tb_mpsc_queue_ref_t queue)
+{
+    // check
+    tb_assert_and_check_return_val(queue, tb_true);
+
+    // it is null if only the stub entry is left
+    return queue->tail == &queue->stub && !tb_mpsc_queue_next(&queue->stub) && *((tb_single_list_entry_ref_t volatile*)&queue->head) == &queue->stub;
+}
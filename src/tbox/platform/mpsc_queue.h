@@ -0,0 +1,148 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        mpsc_queue.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_MPSC_QUEUE_H
+#define TB_PLATFORM_MPSC_QUEUE_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "../container/single_list_entry.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the unbounded intrusive multi-producer single-consumer queue type
+ *
+ * <pre>
+ * tail -> entry -> entry -> entry -> entry <- head
+ *  |                                          |
+ * pop (the consumer only)                    put (exchange the head)
+ * </pre>
+ *
+ * the producers only exchange the head and link the previous head to the new entry,
+ * so put is wait-free, and pop is lock-free without any atomic operations.
+ *
+ * @code
+ *
+    // the xxxx entry type
+    typedef struct __tb_xxxx_entry_t 
+    {
+        // the queue entry
+        tb_single_list_entry_t      entry;
+
+        // the data
+        tb_size_t                   data;
+
+    }tb_xxxx_entry_t;
+
+    // init queue
+    tb_mpsc_queue_t queue;
+    tb_mpsc_queue_init(&queue);
+
+    // put entry on the producer threads
+    tb_mpsc_queue_put(&queue, &xxxx->entry);
+
+    // pop entry on the consumer thread
+    tb_single_list_entry_ref_t entry = tb_mpsc_queue_pop(&queue);
+    if (entry)
+    {
+        tb_xxxx_entry_t* xxxx = tb_container_of(tb_xxxx_entry_t, entry, entry);
+        // ...
+    }
+
+ * @endcode
+ *
+ * @note pop may return null if a producer has been preempted between exchanging the head and linking it,
+ * the entry will be popped after the producer is resumed.
+ */
+typedef struct __tb_mpsc_queue_t
+{
+    // the head, it is exchanged by the producers
+    tb_single_list_entry_ref_t  head;
+
+    // the padding
+    tb_byte_t                   padding[TB_L1_CACHE_BYTES << 1];
+
+    // the tail, it is only accessed by the consumer
+    tb_single_list_entry_ref_t  tail;
+
+    // the stub entry
+    tb_single_list_entry_t      stub;
+
+}tb_mpsc_queue_t, *tb_mpsc_queue_ref_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! init queue
+ *
+ * @param queue         the queue
+ */
+tb_void_t                   tb_mpsc_queue_init(tb_mpsc_queue_ref_t queue);
+
+/*! exit queue, the remaining entries are not freed
+ *
+ * @param queue         the queue
+ */
+tb_void_t                   tb_mpsc_queue_exit(tb_mpsc_queue_ref_t queue);
+
+/*! put the entry to the queue head, it can be called on any threads
+ *
+ * @param queue         the queue
+ * @param entry         the entry
+ */
+tb_void_t                   tb_mpsc_queue_put(tb_mpsc_queue_ref_t queue, tb_single_list_entry_ref_t entry);
+
+/*! pop the entry from the queue tail, it can be only called on the consumer thread
+ *
+ * @param queue         the queue
+ *
+ * @return              the entry or tb_null if the queue is empty
+ */
+tb_single_list_entry_ref_t  tb_mpsc_queue_pop(tb_mpsc_queue_ref_t queue);
+
+/*! the queue is null? it can be only called on the consumer thread
+ *
+ * @param queue         the queue
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t                   tb_mpsc_queue_null(tb_mpsc_queue_ref_t queue);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -28,12 +28,15 @@
  */
 #include "mutex.h"
 #include "spinlock.h"
+#include "impl/futex.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
 #ifdef TB_CONFIG_OS_WINDOWS
 #   include "windows/mutex.c"
+#elif defined(TB_FUTEX_ENABLE)
+#   include "linux/mutex.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_PTHREAD_MUTEX_INIT)
 #   include "posix/mutex.c"
 #else
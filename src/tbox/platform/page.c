@@ -52,4 +52,14 @@ tb_size_t tb_page_size()
     // default: 4KB
     return 4096;
 }
+tb_size_t tb_page_huge_size()
+{
+    // not supported
+    return 0;
+}
+tb_size_t tb_page_hugetlb_size()
+{
+    // not supported
+    return 0;
+}
 #endif
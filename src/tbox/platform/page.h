@@ -61,6 +61,20 @@ tb_void_t               tb_page_exit(tb_noarg_t);
  */
 tb_size_t               tb_page_size(tb_noarg_t);
 
+/*! get huge page size
+ *
+ * @return              the huge page size, .e.g 2MB, returns zero if the huge page is not supported
+ */
+tb_size_t               tb_page_huge_size(tb_noarg_t);
+
+/*! get the hugetlb page size
+ *
+ * it is the default size of the pages mapped by MAP_HUGETLB, it may be different from the transparent huge page size
+ *
+ * @return              the hugetlb page size, .e.g 2MB, returns zero if hugetlb is not supported
+ */
+tb_size_t               tb_page_hugetlb_size(tb_noarg_t);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
@@ -0,0 +1,335 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME                "parallel"
+#define TB_TRACE_MODULE_DEBUG               (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "parallel.h"
+#include "atomic.h"
+#include "processor.h"
+#include "semaphore.h"
+#include "../libc/libc.h"
+#include "../memory/memory.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the helpers maxn
+#ifdef __tb_small__
+#   define TB_PARALLEL_HELPERS_MAXN     (32)
+#else
+#   define TB_PARALLEL_HELPERS_MAXN     (64)
+#endif
+
+// the closed flag of the active helpers count, no more helpers can be started if it is set
+#define TB_PARALLEL_CLOSED          ((tb_long_t)1 << ((sizeof(tb_long_t) << 3) - 2))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the parallel type
+typedef struct __tb_parallel_t
+{
+    // the reference count, the calling thread and all posted helper tasks
+    tb_atomic_t                         refn;
+
+    // the active helpers count and the closed flag
+    tb_atomic_t                         active;
+
+    // the started helpers count
+    tb_atomic_t                         started;
+
+    // the next index
+    tb_atomic_t                         next;
+
+    // the end index
+    tb_size_t                           end;
+
+    // the minimal chunk size
+    tb_size_t                           grain;
+
+    // the parts count, the calling thread and all helpers
+    tb_size_t                           parts;
+
+    // the semaphore for waiting the active helpers
+    tb_semaphore_ref_t                  semaphore;
+
+    // the for func
+    tb_parallel_for_func_t              func_for;
+
+    // the reduce func
+    tb_parallel_reduce_func_t           func_reduce;
+
+    // the user private data
+    tb_cpointer_t                       priv;
+
+    // the value size
+    tb_size_t                           value_size;
+
+    // the identity value
+    tb_byte_t*                          identity;
+
+    // the partial values of all helpers
+    tb_byte_t*                          values;
+
+}tb_parallel_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_parallel_next(tb_parallel_t* parallel, tb_size_t* pbegin, tb_size_t* pend)
+{
+    // check
+    tb_assert(parallel && pbegin && pend);
+
+    // split the left range lazily
+    while (1)
+    {
+        // no more chunks?
+        tb_size_t begin = (tb_size_t)tb_atomic_get(&parallel->next);
+        tb_check_return_val(begin < parallel->end, tb_false);
+
+        // the chunk size, it becomes smaller when the left range becomes smaller
+        tb_size_t left = parallel->end - begin;
+        tb_size_t size = left / (parallel->parts << 1);
+        if (size < parallel->grain) size = parallel->grain;
+        if (size > left) size = left;
+
+        // take this chunk
+        if ((tb_size_t)tb_atomic_fetch_and_pset(&parallel->next, (tb_long_t)begin, (tb_long_t)(begin + size)) == begin)
+        {
+            *pbegin = begin;
+            *pend   = begin + size;
+            return tb_true;
+        }
+    }
+
+    // unreachable
+    return tb_false;
+}
+static tb_void_t tb_parallel_run(tb_parallel_t* parallel, tb_pointer_t value)
+{
+    // check
+    tb_assert(parallel);
+
+    // run all left chunks
+    tb_size_t begin = 0;
+    tb_size_t end = 0;
+    while (tb_parallel_next(parallel, &begin, &end))
+    {
+        if (parallel->func_for) parallel->func_for(begin, end, parallel->priv);
+        else parallel->func_reduce(begin, end, value, parallel->priv);
+    }
+}
+static tb_void_t tb_parallel_exit(tb_parallel_t* parallel)
+{
+    // check
+    tb_assert(parallel);
+
+    // the last reference? exit it
+    if (tb_atomic_fetch_and_dec(&parallel->refn) == 1)
+    {
+        // exit semaphore
+        if (parallel->semaphore) tb_semaphore_exit(parallel->semaphore);
+        parallel->semaphore = tb_null;
+
+        // exit it
+        tb_free(parallel);
+    }
+}
+static tb_void_t tb_parallel_helper_done(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_parallel_t* parallel = (tb_parallel_t*)priv;
+    tb_assert_and_check_return(parallel);
+
+    // enter the active helpers if be not closed
+    tb_long_t active = 0;
+    do
+    {
+        // closed? all chunks have been done by the others
+        active = tb_atomic_get(&parallel->active);
+        tb_check_return(!(active & TB_PARALLEL_CLOSED));
+
+    } while (tb_atomic_fetch_and_pset(&parallel->active, active, active + 1) != active);
+
+    // init the partial value of this helper
+    tb_pointer_t value = tb_null;
+    if (parallel->values)
+    {
+        tb_size_t index = (tb_size_t)tb_atomic_fetch_and_inc(&parallel->started);
+        value = parallel->values + index * parallel->value_size;
+        tb_memcpy(value, parallel->identity, parallel->value_size);
+    }
+    else tb_atomic_fetch_and_inc(&parallel->started);
+
+    // run chunks
+    tb_parallel_run(parallel, value);
+
+    // leave the active helpers, notify the calling thread if it is the last helper 
+    if (tb_atomic_fetch_and_dec(&parallel->active) == (TB_PARALLEL_CLOSED | 1))
+        tb_semaphore_post(parallel->semaphore, 1);
+}
+static tb_void_t tb_parallel_helper_exit(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv)
+{
+    // check
+    tb_parallel_t* parallel = (tb_parallel_t*)priv;
+    tb_assert_and_check_return(parallel);
+
+    // release it
+    tb_parallel_exit(parallel);
+}
+static tb_bool_t tb_parallel_done(tb_thread_pool_ref_t pool, tb_size_t begin, tb_size_t end, tb_size_t grain, tb_pointer_t value, tb_size_t value_size, tb_parallel_for_func_t func_for, tb_parallel_reduce_func_t func_reduce, tb_parallel_join_func_t join, tb_cpointer_t priv)
+{
+    // empty?
+    tb_check_return_val(begin < end, tb_true);
+
+    // using the default pool if be null
+    if (!pool) pool = tb_thread_pool();
+    tb_assert_and_check_return_val(pool, tb_false);
+
+    // the chunks count
+    if (!grain) grain = 1;
+    tb_size_t chunks = (end - begin + grain - 1) / grain;
+
+    // the helpers count, the calling thread runs chunks too
+    tb_size_t helpers = tb_min(tb_processor_count(), chunks);
+    if (helpers) helpers--;
+    if (helpers > TB_PARALLEL_HELPERS_MAXN) helpers = TB_PARALLEL_HELPERS_MAXN;
+
+    // only one part? run it directly
+    if (!helpers)
+    {
+        if (func_for) func_for(begin, end, priv);
+        else func_reduce(begin, end, value, priv);
+        return tb_true;
+    }
+
+    // done
+    tb_bool_t           ok = tb_false;
+    tb_parallel_t*      parallel = tb_null;
+    do
+    {
+        // make parallel with the identity value and the partial values of all helpers
+        parallel = (tb_parallel_t*)tb_malloc0(sizeof(tb_parallel_t) + (helpers + 1) * value_size);
+        tb_assert_and_check_break(parallel);
+
+        // init parallel, the calling thread holds one reference
+        parallel->refn          = 1;
+        parallel->next          = (tb_long_t)begin;
+        parallel->end           = end;
+        parallel->grain         = grain;
+        parallel->parts         = helpers + 1;
+        parallel->func_for      = func_for;
+        parallel->func_reduce   = func_reduce;
+        parallel->priv          = priv;
+        parallel->value_size    = value_size;
+        if (value_size)
+        {
+            parallel->identity  = (tb_byte_t*)&parallel[1];
+            parallel->values    = parallel->identity + value_size;
+            tb_memcpy(parallel->identity, value, value_size);
+        }
+
+        // init semaphore
+        parallel->semaphore = tb_semaphore_init(0);
+        tb_assert_and_check_break(parallel->semaphore);
+
+        // init helper tasks
+        tb_thread_pool_task_t   tasks[TB_PARALLEL_HELPERS_MAXN];
+        tb_size_t               i = 0;
+        tb_size_t               n = helpers;
+        for (i = 0; i < n; i++)
+        {
+            tasks[i].name   = "parallel";
+            tasks[i].done   = tb_parallel_helper_done;
+            tasks[i].exit   = tb_parallel_helper_exit;
+            tasks[i].priv   = parallel;
+            tasks[i].urgent = tb_false;
+        }
+
+        // post helper tasks, each posted task holds one reference
+        tb_atomic_fetch_and_add(&parallel->refn, (tb_long_t)n);
+        tb_size_t posted = tb_thread_pool_task_post_list(pool, tasks, n);
+        if (posted < n) tb_atomic_fetch_and_sub(&parallel->refn, (tb_long_t)(n - posted));
+
+        // trace
+        tb_trace_d("done: [%lu, %lu), grain: %lu, helpers: %lu", begin, end, grain, posted);
+
+        // run chunks in the calling thread
+        tb_parallel_run(parallel, value);
+
+        // close it and wait the active helpers, the helpers which have been not started will do nothing
+        tb_long_t active = tb_atomic_fetch_and_or(&parallel->active, TB_PARALLEL_CLOSED);
+        if (active && tb_semaphore_wait(parallel->semaphore, -1) <= 0) break;
+
+        // join the partial values of the started helpers
+        if (parallel->values && join)
+        {
+            tb_size_t started = (tb_size_t)tb_atomic_get(&parallel->started);
+            for (i = 0; i < started; i++)
+                join(value, parallel->values + i * value_size, priv);
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // exit parallel
+    if (parallel) tb_parallel_exit(parallel);
+
+    // ok?
+    return ok;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_parallel_for(tb_thread_pool_ref_t pool, tb_size_t begin, tb_size_t end, tb_size_t grain, tb_parallel_for_func_t func, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_false);
+
+    // done
+    return tb_parallel_done(pool, begin, end, grain, tb_null, 0, func, tb_null, tb_null, priv);
+}
+tb_bool_t tb_parallel_reduce(tb_thread_pool_ref_t pool, tb_size_t begin, tb_size_t end, tb_size_t grain, tb_pointer_t value, tb_size_t value_size, tb_parallel_reduce_func_t func, tb_parallel_join_func_t join, tb_cpointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(value && value_size && func && join, tb_false);
+
+    // done
+    return tb_parallel_done(pool, begin, end, grain, value, value_size, tb_null, func, join, priv);
+}
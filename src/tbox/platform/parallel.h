@@ -0,0 +1,143 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        parallel.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_PARALLEL_H
+#define TB_PLATFORM_PARALLEL_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "thread_pool.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the parallel for func type
+ *
+ * @param begin             the begin index of this chunk
+ * @param end               the end index of this chunk
+ * @param priv              the user private data
+ */
+typedef tb_void_t           (*tb_parallel_for_func_t)(tb_size_t begin, tb_size_t end, tb_cpointer_t priv);
+
+/*! the parallel reduce func type
+ *
+ * @param begin             the begin index of this chunk
+ * @param end               the end index of this chunk
+ * @param value             the partial value of the current thread, accumulate this chunk into it
+ * @param priv              the user private data
+ */
+typedef tb_void_t           (*tb_parallel_reduce_func_t)(tb_size_t begin, tb_size_t end, tb_pointer_t value, tb_cpointer_t priv);
+
+/*! the parallel join func type
+ *
+ * @param value             the reduced value
+ * @param other             the partial value of the other thread, join it into the reduced value
+ * @param priv              the user private data
+ */
+typedef tb_void_t           (*tb_parallel_join_func_t)(tb_pointer_t value, tb_cpointer_t other, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! run the func for all chunks of the range [begin, end) in parallel 
+ *
+ * the range will be split lazily, the chunks are large at first and become smaller (>= grain) at last.
+ * the calling thread runs chunks too, and it only waits the chunks of this call.
+ *
+ * it can be called in the worker of this pool, the helper tasks which have been not started 
+ * will not be waited, so it will not be blocked by the busy workers.
+ *
+ * @code
+    static tb_void_t tb_demo_for(tb_size_t begin, tb_size_t end, tb_cpointer_t priv)
+    {
+        tb_size_t* data = (tb_size_t*)priv;
+        for (; begin < end; begin++) data[begin] *= 2;
+    }
+
+    tb_parallel_for(tb_null, 0, tb_arrayn(data), 1024, tb_demo_for, data);
+ * @endcode
+ *
+ * @param pool              the thread pool, using the default pool if be null
+ * @param begin             the begin index
+ * @param end               the end index
+ * @param grain             the minimal chunk size, using 1 if be zero
+ * @param func              the for func
+ * @param priv              the user private data
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_parallel_for(tb_thread_pool_ref_t pool, tb_size_t begin, tb_size_t end, tb_size_t grain, tb_parallel_for_func_t func, tb_cpointer_t priv);
+
+/*! reduce all chunks of the range [begin, end) in parallel 
+ *
+ * the calling thread reduces chunks into the given value directly, and each helper task 
+ * reduces chunks into its own partial value which is inited with a copy of the given value,
+ * so the given value must be inited with the identity value (e.g. 0 for sum).
+ *
+ * the partial values will be joined into the given value in the calling thread at last.
+ *
+ * @code
+    static tb_void_t tb_demo_sum(tb_size_t begin, tb_size_t end, tb_pointer_t value, tb_cpointer_t priv)
+    {
+        for (; begin < end; begin++) *((tb_hize_t*)value) += ((tb_size_t const*)priv)[begin];
+    }
+    static tb_void_t tb_demo_join(tb_pointer_t value, tb_cpointer_t other, tb_cpointer_t priv)
+    {
+        *((tb_hize_t*)value) += *((tb_hize_t const*)other);
+    }
+
+    tb_hize_t sum = 0;
+    tb_parallel_reduce(tb_null, 0, tb_arrayn(data), 1024, &sum, sizeof(sum), tb_demo_sum, tb_demo_join, data);
+ * @endcode
+ *
+ * @param pool              the thread pool, using the default pool if be null
+ * @param begin             the begin index
+ * @param end               the end index
+ * @param grain             the minimal chunk size, using 1 if be zero
+ * @param value             the reduced value, it must be inited with the identity value
+ * @param value_size        the value size
+ * @param func              the reduce func
+ * @param join              the join func
+ * @param priv              the user private data
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_parallel_reduce(tb_thread_pool_ref_t pool, tb_size_t begin, tb_size_t end, tb_size_t grain, tb_pointer_t value, tb_size_t value_size, tb_parallel_reduce_func_t func, tb_parallel_join_func_t join, tb_cpointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -33,6 +33,7 @@
 #include "page.h"
 #include "path.h"
 #include "file.h"
+#include "rcu.h"
 #include "time.h"
 #include "mutex.h"
 #include "event.h"
@@ -54,15 +55,19 @@
 #include "spinlock.h"
 #include "atomic64.h"
 #include "hostname.h"
+#include "parallel.h"
 #include "processor.h"
 #include "semaphore.h"
 #include "backtrace.h"
 #include "directory.h"
 #include "exception.h"
+#include "mpmc_queue.h"
+#include "mpsc_queue.h"
 #include "cache_time.h"
 #include "environment.h"
 #include "thread_pool.h"
 #include "thread_local.h"
+#include "lockfree_stack.h"
 #ifdef TB_CONFIG_API_HAVE_DEPRECATED
 #   include "deprecated/deprecated.h"
 #endif
@@ -55,6 +55,12 @@ typedef enum __tb_poller_event_e
 ,   TB_POLLER_EVENT_CLEAR       = 0x0010 //!< edge trigger. after the event is retrieved by the user, its state is reset
 ,   TB_POLLER_EVENT_ONESHOT     = 0x0020 //!< causes the event to return only the first occurrence of the filter being triggered
 
+    /*! wake only one of the pollers which are waiting the same listening socket, only for tb_poller_insert()
+     *
+     * be similar to epoll.EPOLLEXCLUSIVE, it avoids the thundering herd if the listener is shared by multiple threads
+     */
+,   TB_POLLER_EVENT_EXCLUSIVE   = 0x0040
+
     /*! the event flag will be marked if the connection be closed in the edge trigger (TB_POLLER_EVENT_CLEAR)
      *
      * be similar to epoll.EPOLLRDHUP and kqueue.EV_EOF
@@ -149,6 +155,8 @@ tb_bool_t           tb_poller_insert(tb_poller_ref_t poller, tb_socket_ref_t soc
 tb_bool_t           tb_poller_remove(tb_poller_ref_t poller, tb_socket_ref_t sock);
 
 /*! modify events for the given socket
+ *
+ * @note the exclusive flag (TB_POLLER_EVENT_EXCLUSIVE) cannot be modified and will be ignored
  *
  * @param poller    the poller
  * @param sock      the socket
@@ -29,6 +29,9 @@
 #include "prefix.h"
 #include "../platform.h"
 #include <unistd.h>
+#ifdef TB_CONFIG_OS_LINUX
+#   include <fcntl.h>
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
@@ -37,6 +40,12 @@
 // the page size
 static tb_size_t g_page_size = 0;
 
+// the huge page size
+static tb_size_t g_page_huge_size = 0;
+
+// the hugetlb page size
+static tb_size_t g_page_hugetlb_size = 0;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -52,6 +61,52 @@ tb_bool_t tb_page_init()
 #endif
     }
 
+    // init huge page size
+#ifdef TB_CONFIG_OS_LINUX
+    if (!g_page_huge_size)
+    {
+        // read the pmd size of the transparent huge page, .e.g 2097152
+        tb_int_t fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", O_RDONLY);
+        if (fd >= 0)
+        {
+            tb_char_t   data[32];
+            tb_long_t   real = read(fd, data, sizeof(data) - 1);
+            if (real > 0)
+            {
+                data[real] = '\0';
+                g_page_huge_size = tb_s10tou32(data);
+            }
+            close(fd);
+        }
+
+        // the huge page size must be aligned by the page size
+        if (g_page_huge_size <= g_page_size || (g_page_huge_size & (g_page_huge_size - 1)))
+            g_page_huge_size = 0;
+    }
+
+    // init hugetlb page size
+    if (!g_page_hugetlb_size)
+    {
+        // read the default hugetlb page size from "Hugepagesize:    2048 kB"
+        tb_int_t fd = open("/proc/meminfo", O_RDONLY);
+        if (fd >= 0)
+        {
+            tb_char_t   data[4096];
+            tb_size_t   size = 0;
+            tb_long_t   real = 0;
+            while (size < sizeof(data) - 1 && (real = read(fd, data + size, sizeof(data) - 1 - size)) > 0) size += (tb_size_t)real;
+            data[size] = '\0';
+            tb_char_t const* p = tb_strstr(data, "Hugepagesize:");
+            if (p) g_page_hugetlb_size = (tb_size_t)tb_s10tou32(p + 13) << 10;
+            close(fd);
+        }
+
+        // the hugetlb page size must be aligned by the page size
+        if (g_page_hugetlb_size <= g_page_size || (g_page_hugetlb_size & (g_page_hugetlb_size - 1)))
+            g_page_hugetlb_size = 0;
+    }
+#endif
+
     // ok?
     return g_page_size? tb_true : tb_false;
 }
@@ -62,5 +117,11 @@ tb_size_t tb_page_size()
 {
     return g_page_size;
 }
-
-
+tb_size_t tb_page_huge_size()
+{
+    return g_page_huge_size;
+}
+tb_size_t tb_page_hugetlb_size()
+{
+    return g_page_hugetlb_size;
+}
@@ -45,6 +45,9 @@
 #ifdef TB_CONFIG_POSIX_HAVE_SENDFILE
 #   include <sys/sendfile.h>
 #endif
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include <linux/filter.h>
+#endif
 #ifdef TB_CONFIG_MODULE_HAVE_COROUTINE
 #   include "../../coroutine/coroutine.h"
 #   include "../../coroutine/impl/impl.h"
@@ -86,6 +89,24 @@ static tb_int_t tb_socket_proto(tb_size_t type, tb_size_t family)
     return -1;
 }
 
+static tb_bool_t tb_socket_steer_cpu(tb_socket_ref_t sock, tb_size_t count)
+{
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(SKF_AD_CPU) && defined(BPF_MOD)
+    // select the socket (cpu % count) of the reuseport group by the current cpu
+    struct sock_filter code[] = 
+    {
+        { BPF_LD  | BPF_W   | BPF_ABS,  0, 0, SKF_AD_OFF + SKF_AD_CPU   }
+    ,   { BPF_ALU | BPF_MOD | BPF_K,    0, 0, (tb_uint32_t)count        }
+    ,   { BPF_RET | BPF_A,              0, 0, 0                         }
+    };
+    struct sock_fprog prog = {(tb_uint16_t)tb_arrayn(code), code};
+
+    // attach it to the whole group
+    return !setsockopt(tb_sock2fd(sock), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+#else
+    return tb_false;
+#endif
+}
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
@@ -143,14 +164,13 @@ tb_bool_t tb_socket_pair(tb_size_t type, tb_socket_ref_t pair[2])
     // check
     tb_assert_and_check_return_val(type && pair, tb_false);
 
-    // init socket type and protocol
+    // init socket type
     tb_int_t t = tb_socket_type(type);
-    tb_int_t p = tb_socket_proto(type, TB_IPADDR_FAMILY_NONE);
-    tb_assert_and_check_return_val(t >= 0 && p >= 0, tb_false);
+    tb_assert_and_check_return_val(t >= 0, tb_false);
 
-    // make pair
+    // make pair, the local socket only supports the default protocol
     tb_int_t fd[2] = {0};
-    if (socketpair(AF_LOCAL, t, p, fd) == -1) return tb_false;
+    if (socketpair(AF_LOCAL, t, 0, fd) == -1) return tb_false;
 
     // non-block
     fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
@@ -399,6 +419,69 @@ tb_bool_t tb_socket_listen(tb_socket_ref_t sock, tb_size_t backlog)
     // listen
     return (listen(tb_sock2fd(sock), backlog) < 0)? tb_false : tb_true;
 }
+tb_bool_t tb_socket_listen_group(tb_socket_ref_t* socks, tb_size_t count, tb_size_t type, tb_ipaddr_ref_t addr, tb_size_t backlog, tb_bool_t affinity)
+{
+    // check
+    tb_assert_and_check_return_val(socks && count && addr && tb_ipaddr_port(addr), tb_false);
+
+#ifdef SO_REUSEPORT
+    // done
+    tb_bool_t ok = tb_false;
+    tb_size_t i = 0;
+    tb_memset(socks, 0, count * sizeof(tb_socket_ref_t));
+    do
+    {
+        /* init, bind (with SO_REUSEPORT) and listen all sockets, 
+         * the order of the group is the listening order for the steering program
+         */
+        for (i = 0; i < count; i++)
+        {
+            // init socket
+            socks[i] = tb_socket_init(type, tb_ipaddr_family(addr));
+            tb_assert_and_check_break(socks[i]);
+
+            // bind socket
+            if (!tb_socket_bind(socks[i], addr)) break;
+
+            // listen socket
+            if (!tb_socket_listen(socks[i], backlog)) break;
+        }
+        tb_check_break(i == count);
+
+        // steer the connections by the current cpu, we need not it if be only one socket
+        if (affinity && count > 1 && !tb_socket_steer_cpu(socks[0], count))
+        {
+            // trace, the connections will be still balanced by the hash of the address 
+            tb_trace_w("listen group: the cpu affinity is not supported, errno: %d", errno);
+        }
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed? exit all sockets
+    if (!ok)
+    {
+        // trace
+        tb_trace_e("listen group: %{ipaddr} failed, errno: %d", addr, errno);
+
+        // exit them
+        for (i = 0; i < count; i++)
+        {
+            if (socks[i]) tb_socket_exit(socks[i]);
+            socks[i] = tb_null;
+        }
+    }
+
+    // ok?
+    return ok;
+#else
+    // not supported
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
 tb_socket_ref_t tb_socket_accept(tb_socket_ref_t sock, tb_ipaddr_ref_t addr)
 {
     // check
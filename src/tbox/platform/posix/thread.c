@@ -29,6 +29,9 @@
 #include "prefix.h"
 #include "../thread.h"
 #include <pthread.h>
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include <sched.h>
+#endif
 #include <stdlib.h>
 #include <errno.h>
 
@@ -130,4 +133,62 @@ tb_size_t tb_thread_self()
 {
     return (tb_size_t)pthread_self();
 }
+tb_bool_t tb_thread_affinity_set(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    // check
+    tb_assert_and_check_return_val(cpuset, tb_false);
+
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+    // make the cpu set
+    cpu_set_t   set;
+    tb_size_t   cpu = 0;
+    CPU_ZERO(&set);
+    for (cpu = 0; cpu < TB_CPUSET_MAXN && cpu < CPU_SETSIZE; cpu++)
+    {
+        if (tb_cpuset_isset(cpuset, cpu)) CPU_SET(cpu, &set);
+    }
 
+#   ifdef __GLIBC__
+    // set the affinity of the given thread
+    return !pthread_setaffinity_np(thread? (pthread_t)thread : pthread_self(), sizeof(cpu_set_t), &set);
+#   else
+    // only the current thread can be pinned
+    tb_check_return_val(!thread || pthread_equal((pthread_t)thread, pthread_self()), tb_false);
+    return !sched_setaffinity(0, sizeof(cpu_set_t), &set);
+#   endif
+#else
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
+tb_bool_t tb_thread_affinity_get(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    // check
+    tb_assert_and_check_return_val(cpuset, tb_false);
+
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+    // get the cpu set
+    cpu_set_t set;
+    CPU_ZERO(&set);
+#   ifdef __GLIBC__
+    if (pthread_getaffinity_np(thread? (pthread_t)thread : pthread_self(), sizeof(cpu_set_t), &set)) return tb_false;
+#   else
+    tb_check_return_val(!thread || pthread_equal((pthread_t)thread, pthread_self()), tb_false);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set)) return tb_false;
+#   endif
+
+    // save it
+    tb_size_t cpu = 0;
+    tb_cpuset_clear(cpuset);
+    for (cpu = 0; cpu < TB_CPUSET_MAXN && cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &set)) tb_cpuset_set(cpuset, cpu);
+    }
+
+    // ok
+    return tb_true;
+#else
+    tb_trace_noimpl();
+    return tb_false;
+#endif
+}
@@ -51,8 +51,11 @@ static tb_bool_t tb_thread_local_once(tb_cpointer_t priv)
     // check the pthread key space size
     tb_assert_static(sizeof(pthread_key_t) * 2 <= sizeof(local->priv));
 
-    // create the pthread key for data
-    tb_bool_t ok = pthread_key_create(&((pthread_key_t*)local->priv)[0], tb_null) == 0;
+    /* create the pthread key for data
+     *
+     * the free function is the key destructor, so the data will be freed when any thread exits
+     */
+    tb_bool_t ok = pthread_key_create(&((pthread_key_t*)local->priv)[0], (tb_void_t (*)(tb_pointer_t))local->free) == 0;
     if (ok)
     {
         // create the pthread key for mark
@@ -85,6 +88,9 @@ tb_bool_t tb_thread_local_init(tb_thread_local_ref_t local, tb_thread_local_free
     // check
     tb_assert_and_check_return_val(local, tb_false);
 
+    // the thread local list has not been initialized? it may be called before tb_init() by the allocator
+    tb_check_return_val(g_thread_local_inited, tb_false);
+
     // run the once function
     tb_value_t tuple[2];
     tuple[0].ptr = (tb_pointer_t)local;
@@ -36,6 +36,159 @@
         && !defined(TB_CONFIG_MICRO_ENABLE)
 #   include "../../coroutine/coroutine.h"
 #endif
+#include "../atomic.h"
+#include "../../libc/libc.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// enable the tsc clock?
+#if defined(TB_ASSEMBLER_IS_GAS) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+#   define TB_CLOCK_TSC_ENABLE
+#endif
+
+// the tsc calibration period, ns
+#define TB_CLOCK_TSC_PERIOD             (10000000)
+
+// the fixed-point shift of the tsc scale
+#define TB_CLOCK_TSC_SHIFT              (24)
+
+// the tsc clock states
+#define TB_CLOCK_TSC_STATE_NONE         (0)
+#define TB_CLOCK_TSC_STATE_BUSY         (1)
+#define TB_CLOCK_TSC_STATE_SAMPLED      (2)
+#define TB_CLOCK_TSC_STATE_READY        (3)
+#define TB_CLOCK_TSC_STATE_UNSUPPORTED  (4)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+#ifdef TB_CLOCK_TSC_ENABLE
+
+// the tsc clock state
+static tb_atomic_t      g_tsc_state = TB_CLOCK_TSC_STATE_NONE;
+
+// the tsc base
+static tb_hize_t        g_tsc_base = 0;
+
+// the ns base of the monotonic clock at the tsc base
+static tb_hong_t        g_tsc_base_ns = 0;
+
+// the ns per tsc tick, it is fixed-point with TB_CLOCK_TSC_SHIFT bits
+static tb_hize_t        g_tsc_scale = 0;
+
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_hong_t tb_clock_ns_system()
+{
+#if defined(TB_CONFIG_POSIX_HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    // get the monotonic clock, it is in the vdso on linux
+    struct timespec ts = {0};
+    if (!clock_gettime(CLOCK_MONOTONIC, &ts)) return ((tb_hong_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#endif
+
+    // get the real clock
+    return tb_uclock() * 1000;
+}
+#ifdef TB_CLOCK_TSC_ENABLE
+static __tb_inline_force__ tb_hize_t tb_clock_tsc()
+{
+    tb_uint32_t lo;
+    tb_uint32_t hi;
+    __tb_asm__ __tb_volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (((tb_hize_t)hi << 32) | lo);
+}
+static tb_void_t tb_clock_cpuid(tb_uint32_t leaf, tb_uint32_t regs[4])
+{
+#ifdef TB_ARCH_x86
+    // ebx may be the pic register
+    __tb_asm__ __tb_volatile__
+    (
+        "xchgl %%ebx, %1\n"
+        "cpuid\n"
+        "xchgl %%ebx, %1\n"
+        : "=a" (regs[0]), "=&r" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+        : "a" (leaf), "c" (0)
+    );
+#else
+    __tb_asm__ __tb_volatile__
+    (
+        "cpuid\n"
+        : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+        : "a" (leaf), "c" (0)
+    );
+#endif
+}
+static tb_bool_t tb_clock_tsc_check()
+{
+    // the invariant tsc is supported? it runs at a constant rate in all power states
+    tb_uint32_t regs[4] = {0};
+    tb_clock_cpuid(0x80000000, regs);
+    tb_check_return_val(regs[0] >= 0x80000007, tb_false);
+    tb_clock_cpuid(0x80000007, regs);
+    tb_check_return_val(regs[3] & (1 << 8), tb_false);
+
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+    // the kernel trusts the tsc? it may be unstable or unsynchronized between the processors in some virtual machines
+    FILE* fp = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (fp)
+    {
+        tb_char_t source[64] = {0};
+        tb_bool_t ok = fgets(source, sizeof(source), fp) && !tb_strncmp(source, "tsc", 3);
+        fclose(fp);
+        tb_check_return_val(ok, tb_false);
+    }
+#endif
+
+    // ok
+    return tb_true;
+}
+static tb_void_t tb_clock_tsc_calibrate(tb_hong_t now)
+{
+    // take the first sample
+    tb_long_t state = (tb_long_t)g_tsc_state;
+    if (state == TB_CLOCK_TSC_STATE_NONE)
+    {
+        // only one thread can calibrate it
+        tb_check_return(tb_atomic_fetch_and_pset(&g_tsc_state, TB_CLOCK_TSC_STATE_NONE, TB_CLOCK_TSC_STATE_BUSY) == TB_CLOCK_TSC_STATE_NONE);
+
+        // not supported?
+        if (!tb_clock_tsc_check())
+        {
+            tb_atomic_set(&g_tsc_state, TB_CLOCK_TSC_STATE_UNSUPPORTED);
+            return ;
+        }
+
+        // save the base
+        g_tsc_base      = tb_clock_tsc();
+        g_tsc_base_ns   = tb_clock_ns_system();
+
+        // sampled
+        tb_barrier();
+        tb_atomic_set(&g_tsc_state, TB_CLOCK_TSC_STATE_SAMPLED);
+    }
+    // take the second sample after the calibration period, and we need not sleep for it
+    else if (state == TB_CLOCK_TSC_STATE_SAMPLED && now - g_tsc_base_ns >= TB_CLOCK_TSC_PERIOD)
+    {
+        // only one thread can calibrate it
+        tb_check_return(tb_atomic_fetch_and_pset(&g_tsc_state, TB_CLOCK_TSC_STATE_SAMPLED, TB_CLOCK_TSC_STATE_BUSY) == TB_CLOCK_TSC_STATE_SAMPLED);
+
+        // compute the scale
+        tb_hize_t tsc   = tb_clock_tsc();
+        tb_hong_t ns    = tb_clock_ns_system();
+        if (tsc > g_tsc_base && ns > g_tsc_base_ns)
+            g_tsc_scale = ((tb_hize_t)(ns - g_tsc_base_ns) << TB_CLOCK_TSC_SHIFT) / (tsc - g_tsc_base);
+
+        // ready
+        tb_barrier();
+        tb_atomic_set(&g_tsc_state, g_tsc_scale? TB_CLOCK_TSC_STATE_READY : TB_CLOCK_TSC_STATE_UNSUPPORTED);
+    }
+}
+#endif
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -79,6 +232,28 @@ tb_hong_t tb_uclock()
     if (!tb_gettimeofday(&tv, tb_null)) return -1;
     return ((tb_hong_t)tv.tv_sec * 1000000 + tv.tv_usec);
 }
+tb_hong_t tb_clock_ns()
+{
+#ifdef TB_CLOCK_TSC_ENABLE
+    // using the calibrated tsc clock
+    if (g_tsc_state == TB_CLOCK_TSC_STATE_READY)
+    {
+        // the elapsed ticks, it may be a little less than the base if the tsc is not synchronized
+        tb_hize_t tsc = tb_clock_tsc();
+        tb_hize_t ticks = tsc > g_tsc_base? tsc - g_tsc_base : 0;
+
+        // scale it without overflow
+        return g_tsc_base_ns + (tb_hong_t)((((ticks >> 32) * g_tsc_scale) << (32 - TB_CLOCK_TSC_SHIFT)) + (((ticks & 0xffffffff) * g_tsc_scale) >> TB_CLOCK_TSC_SHIFT));
+    }
+
+    // using the system clock before the tsc clock is ready
+    tb_hong_t now = tb_clock_ns_system();
+    if (g_tsc_state != TB_CLOCK_TSC_STATE_UNSUPPORTED) tb_clock_tsc_calibrate(now);
+    return now;
+#else
+    return tb_clock_ns_system();
+#endif
+}
 tb_bool_t tb_gettimeofday(tb_timeval_t* tv, tb_timezone_t* tz)
 {
     // gettimeofday
@@ -23,14 +23,95 @@
  * @ingroup     platform
  */
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "processor"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * includes
  */
 #include "processor.h"
+#include "thread.h"
+#include "../libc/libc.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the processor topology
+static tb_processor_topology_t  s_topology;
+
+// the processor topology once
+static tb_atomic_t              s_topology_once = 0;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_bool_t tb_processor_topology_load_default(tb_processor_topology_t* topology)
+{
+    // check
+    tb_assert_and_check_return_val(topology, tb_false);
+
+    // every cpu is a physical core on the node zero
+    tb_size_t count = tb_min(tb_processor_count(), TB_CPUSET_MAXN);
+    tb_size_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        tb_cpuset_set(&topology->online, i);
+        tb_cpuset_set(&topology->cores[i].cpus, i);
+        topology->cores[i].threads  = 1;
+        topology->cpus[i].core      = (tb_uint16_t)i;
+    }
+    topology->cpus_count        = count;
+    topology->cores_count       = count;
+    topology->packages_count    = 1;
+    topology->nodes_count       = 1;
+    topology->cache_line        = TB_L1_CACHE_BYTES;
+
+    // ok
+    return tb_true;
+}
+#if defined(TB_CONFIG_OS_LINUX) || defined(TB_CONFIG_OS_ANDROID)
+#   include "linux/processor.c"
+#else
+static tb_bool_t tb_processor_topology_load(tb_processor_topology_t* topology)
+{
+    return tb_false;
+}
+#endif
+static tb_bool_t tb_processor_topology_init(tb_cpointer_t priv)
+{
+    // the topology
+    tb_processor_topology_t* topology = (tb_processor_topology_t*)priv;
+    tb_assert_and_check_return_val(topology, tb_false);
+
+    // load it from the system, uses the default topology if failed
+    tb_memset(topology, 0, sizeof(tb_processor_topology_t));
+    if (!tb_processor_topology_load(topology))
+    {
+        tb_memset(topology, 0, sizeof(tb_processor_topology_t));
+        if (!tb_processor_topology_load_default(topology)) return tb_false;
+    }
+
+    // trace
+    tb_trace_d("topology: cpus: %lu, cores: %lu, packages: %lu, nodes: %lu, cache: line: %lu, l1d: %lu, l2: %lu, l3: %lu"
+            , topology->cpus_count, topology->cores_count, topology->packages_count, topology->nodes_count
+            , topology->cache_line, topology->cache_l1d, topology->cache_l2, topology->cache_l3);
+
+    // ok
+    return tb_true;
+}
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
  */
+tb_processor_topology_t const* tb_processor_topology()
+{
+    // init the topology only once
+    return tb_thread_once(&s_topology_once, tb_processor_topology_init, &s_topology)? &s_topology : tb_null;
+}
 #ifdef TB_CONFIG_OS_WINDOWS
 #   include "windows/processor.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_SYSCONF)
@@ -36,6 +36,114 @@
  */
 __tb_extern_c_enter__
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the cpuset maximum count, the cpus with the larger id will be ignored
+#ifdef __tb_small__
+#   define TB_CPUSET_MAXN           (64)
+#else
+#   define TB_CPUSET_MAXN           (256)
+#endif
+
+/// clear the cpuset
+#define tb_cpuset_clear(set)        tb_memset((set), 0, sizeof(tb_cpuset_t))
+
+/// add the cpu to the cpuset
+#define tb_cpuset_set(set, cpu)     do { if ((tb_size_t)(cpu) < TB_CPUSET_MAXN) (set)->bits[(tb_size_t)(cpu) >> TB_CPU_SHIFT] |= ((tb_size_t)1 << ((tb_size_t)(cpu) & (TB_CPU_BITSIZE - 1))); } while (0)
+
+/// the cpu is in the cpuset?
+#define tb_cpuset_isset(set, cpu)   ((tb_size_t)(cpu) < TB_CPUSET_MAXN && ((set)->bits[(tb_size_t)(cpu) >> TB_CPU_SHIFT] & ((tb_size_t)1 << ((tb_size_t)(cpu) & (TB_CPU_BITSIZE - 1)))))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/// the cpuset type
+typedef struct __tb_cpuset_t
+{
+    /// the cpu bits
+    tb_size_t               bits[TB_CPUSET_MAXN / TB_CPU_BITSIZE];
+
+}tb_cpuset_t, *tb_cpuset_ref_t;
+
+/// the logical cpu type of the processor topology
+typedef struct __tb_processor_cpu_t
+{
+    /// the physical core index in the topology
+    tb_uint16_t             core;
+
+    /// the smt thread index in the physical core, the first thread is zero
+    tb_uint16_t             thread;
+
+    /// the package (socket) index
+    tb_uint16_t             package;
+
+    /// the numa node index
+    tb_uint16_t             node;
+
+}tb_processor_cpu_t;
+
+/// the physical core type of the processor topology
+typedef struct __tb_processor_core_t
+{
+    /// the smt sibling cpus of this core
+    tb_cpuset_t             cpus;
+
+    /// the smt threads count
+    tb_uint16_t             threads;
+
+    /// the package (socket) index
+    tb_uint16_t             package;
+
+    /// the numa node index
+    tb_uint16_t             node;
+
+}tb_processor_core_t;
+
+/*! the processor topology type
+ *
+ * the physical cores are sorted by the numa node and package,
+ * so the cores of the same node are always adjacent.
+ */
+typedef struct __tb_processor_topology_t
+{
+    /// the online cpus
+    tb_cpuset_t             online;
+
+    /// the online cpus count
+    tb_size_t               cpus_count;
+
+    /// the physical cores count
+    tb_size_t               cores_count;
+
+    /// the packages count
+    tb_size_t               packages_count;
+
+    /// the numa nodes count
+    tb_size_t               nodes_count;
+
+    /// the cache line size
+    tb_size_t               cache_line;
+
+    /// the l1 data cache size of one core
+    tb_size_t               cache_l1d;
+
+    /// the l2 cache size
+    tb_size_t               cache_l2;
+
+    /// the l3 cache size
+    tb_size_t               cache_l3;
+
+    /// the logical cpus, indexed by the cpu id
+    tb_processor_cpu_t      cpus[TB_CPUSET_MAXN];
+
+    /// the physical cores
+    tb_processor_core_t     cores[TB_CPUSET_MAXN];
+
+}tb_processor_topology_t;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -46,6 +154,23 @@ __tb_extern_c_enter__
  */
 tb_size_t               tb_processor_count(tb_noarg_t);
 
+/*! the processor topology
+ *
+ * it will be discovered from sysfs only once on linux, 
+ * and every cpu will be regarded as a physical core on the node zero for the other platforms.
+ *
+ * @code
+    tb_processor_topology_t const* topology = tb_processor_topology();
+    if (topology)
+    {
+        tb_trace_i("cpus: %lu, cores: %lu, nodes: %lu", topology->cpus_count, topology->cores_count, topology->nodes_count);
+    }
+ * @endcode
+ *
+ * @return              the processor topology
+ */
+tb_processor_topology_t const* tb_processor_topology(tb_noarg_t);
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
  */
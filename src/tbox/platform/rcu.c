@@ -0,0 +1,384 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rcu.c
+ * @ingroup     platform
+ *
+ */
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * trace
+ */
+#define TB_TRACE_MODULE_NAME            "rcu"
+#define TB_TRACE_MODULE_DEBUG           (0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "rcu.h"
+#include "time.h"
+#include "sched.h"
+#include "atomic.h"
+#include "spinlock.h"
+#include "thread_local.h"
+#include "impl/rcu.h"
+#include "../memory/memory.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the deferred callbacks maxn, we will try to reclaim them if be full
+#ifdef __tb_small__
+#   define TB_RCU_CALLBACKS_MAXN        (32)
+#else
+#   define TB_RCU_CALLBACKS_MAXN        (128)
+#endif
+
+// the epoch is older than the given epoch? it may be wrapped
+#define tb_rcu_epoch_before(a, b)       ((tb_long_t)((tb_size_t)(a) - (tb_size_t)(b)) < 0)
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+// the rcu reader type
+typedef struct __tb_rcu_reader_t
+{
+    // the next reader
+    struct __tb_rcu_reader_t*   next;
+
+    // the epoch when entering the outermost read-side critical section, it is zero if not be reading
+    tb_atomic_t                 epoch;
+
+    // the nesting count
+    tb_size_t                   nesting;
+
+    // is used by a thread?
+    tb_bool_t                   used;
+
+    // the padding, the reader is only written by its thread
+    tb_byte_t                   padding[TB_L1_CACHE_BYTES << 1];
+
+}tb_rcu_reader_t;
+
+// the rcu callback type
+typedef struct __tb_rcu_callback_t
+{
+    // the next callback
+    struct __tb_rcu_callback_t* next;
+
+    // the function
+    tb_rcu_func_t               func;
+
+    // the private data
+    tb_pointer_t                priv;
+
+    // the epoch when it was deferred
+    tb_size_t                   epoch;
+
+}tb_rcu_callback_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+// the lock for the readers and callbacks
+static tb_spinlock_t                        g_lock = TB_SPINLOCK_INIT;
+
+/* the global epoch
+ *
+ * it is always odd and increased by 2, so the epoch of the reader is zero only if it is not reading
+ */
+static tb_atomic_t                          g_epoch = 1;
+
+// the readers
+static tb_rcu_reader_t*                     g_readers = tb_null;
+
+// the deferred callbacks, the older callbacks are in the front
+static tb_rcu_callback_t*                   g_callbacks = tb_null;
+static tb_rcu_callback_t*                   g_callbacks_tail = tb_null;
+
+// the deferred callbacks count
+static tb_size_t                            g_callbacks_count = 0;
+
+// the reader of the current thread
+static tb_thread_local_t                    g_reader_local = TB_THREAD_LOCAL_INIT;
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+static __tb_thread_local__ tb_rcu_reader_t* g_reader = tb_null;
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+static tb_void_t tb_rcu_reader_free(tb_cpointer_t priv)
+{
+    // check
+    tb_rcu_reader_t* reader = (tb_rcu_reader_t*)priv;
+    tb_check_return(reader);
+
+    // detach it from the exited thread, and it will be reused by the other threads
+    tb_spinlock_enter(&g_lock);
+    reader->epoch   = 0;
+    reader->nesting = 0;
+    reader->used    = tb_false;
+    tb_spinlock_leave(&g_lock);
+
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    // clear the reader of the current thread
+    g_reader = tb_null;
+#endif
+}
+static tb_rcu_reader_t* tb_rcu_reader_attach(tb_noarg_t)
+{
+    // init the reader local
+    if (!tb_thread_local_init(&g_reader_local, tb_rcu_reader_free)) return tb_null;
+
+    // enter
+    tb_spinlock_enter(&g_lock);
+
+    // reuse the detached reader first
+    tb_rcu_reader_t* reader = g_readers;
+    while (reader && reader->used) reader = reader->next;
+
+    // make a new reader
+    if (!reader)
+    {
+        reader = tb_malloc0_type(tb_rcu_reader_t);
+        if (reader)
+        {
+            reader->next = g_readers;
+            g_readers = reader;
+        }
+    }
+
+    // attach it
+    if (reader) reader->used = tb_true;
+
+    // leave
+    tb_spinlock_leave(&g_lock);
+
+    // save it to the current thread
+    if (reader)
+    {
+        tb_thread_local_set(&g_reader_local, reader);
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        g_reader = reader;
+#endif
+    }
+    return reader;
+}
+static __tb_inline__ tb_rcu_reader_t* tb_rcu_reader(tb_noarg_t)
+{
+    // get the reader of the current thread
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    tb_rcu_reader_t* reader = g_reader;
+#else
+    tb_rcu_reader_t* reader = (tb_rcu_reader_t*)tb_thread_local_get(&g_reader_local);
+#endif
+
+    // attach a reader if not exists
+    return reader? reader : tb_rcu_reader_attach();
+}
+static tb_size_t tb_rcu_epoch_min(tb_noarg_t)
+{
+    // the oldest epoch of the reading readers, it is the global epoch if no readers
+    tb_size_t           epoch = (tb_size_t)g_epoch;
+    tb_rcu_reader_t*    reader = g_readers;
+    for (; reader; reader = reader->next)
+    {
+        tb_size_t reading = (tb_size_t)reader->epoch;
+        if (reading && tb_rcu_epoch_before(reading, epoch)) epoch = reading;
+    }
+    return epoch;
+}
+static tb_void_t tb_rcu_reclaim(tb_noarg_t)
+{
+    // enter
+    tb_spinlock_enter(&g_lock);
+
+    // advance the global epoch, the new readers will not block the deferred callbacks
+    tb_atomic_fetch_and_add(&g_epoch, 2);
+
+    // detach the callbacks which cannot be seen by the reading readers
+    tb_size_t           epoch = tb_rcu_epoch_min();
+    tb_rcu_callback_t*  callbacks = g_callbacks;
+    tb_rcu_callback_t*  last = tb_null;
+    while (g_callbacks && tb_rcu_epoch_before(g_callbacks->epoch, epoch))
+    {
+        last = g_callbacks;
+        g_callbacks = g_callbacks->next;
+        g_callbacks_count--;
+    }
+    if (last) last->next = tb_null;
+    else callbacks = tb_null;
+    if (!g_callbacks) g_callbacks_tail = tb_null;
+
+    // leave
+    tb_spinlock_leave(&g_lock);
+
+    // call them
+    while (callbacks)
+    {
+        tb_rcu_callback_t* next = callbacks->next;
+        callbacks->func(callbacks->priv);
+        tb_free(callbacks);
+        callbacks = next;
+    }
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * implementation
+ */
+tb_bool_t tb_rcu_init_env()
+{
+    // init lock
+    if (!tb_spinlock_init(&g_lock)) return tb_false;
+
+    // init epoch
+    g_epoch = 1;
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_rcu_exit_env()
+{
+    // detach all callbacks and readers
+    tb_spinlock_enter(&g_lock);
+    tb_rcu_callback_t*  callbacks = g_callbacks;
+    tb_rcu_reader_t*    readers = g_readers;
+    g_callbacks         = tb_null;
+    g_callbacks_tail    = tb_null;
+    g_callbacks_count   = 0;
+    g_readers           = tb_null;
+    tb_spinlock_leave(&g_lock);
+
+    // call all callbacks, all readers should have left now
+    while (callbacks)
+    {
+        tb_rcu_callback_t* next = callbacks->next;
+        callbacks->func(callbacks->priv);
+        tb_free(callbacks);
+        callbacks = next;
+    }
+
+    // exit all readers
+    while (readers)
+    {
+        tb_rcu_reader_t* next = readers->next;
+        tb_free(readers);
+        readers = next;
+    }
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    g_reader = tb_null;
+#endif
+
+    // exit lock
+    tb_spinlock_exit(&g_lock);
+}
+tb_void_t tb_rcu_read_enter()
+{
+    // get the reader
+    tb_rcu_reader_t* reader = tb_rcu_reader();
+    tb_assert_and_check_return(reader);
+
+    // enter the outermost critical section
+    if (!reader->nesting++)
+    {
+        // save the global epoch
+        reader->epoch = g_epoch;
+
+        // the epoch must be seen by the reclaimer before we load the protected pointers
+        tb_barrier();
+    }
+}
+tb_void_t tb_rcu_read_leave()
+{
+    // get the reader
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    tb_rcu_reader_t* reader = g_reader;
+#else
+    tb_rcu_reader_t* reader = (tb_rcu_reader_t*)tb_thread_local_get(&g_reader_local);
+#endif
+    tb_assert_and_check_return(reader && reader->nesting);
+
+    // leave the outermost critical section
+    if (!--reader->nesting)
+    {
+        // finish all loads before clearing the epoch
+        tb_barrier();
+        reader->epoch = 0;
+    }
+}
+tb_bool_t tb_rcu_call(tb_rcu_func_t func, tb_pointer_t priv)
+{
+    // check
+    tb_assert_and_check_return_val(func, tb_false);
+
+    // make callback
+    tb_rcu_callback_t* callback = tb_malloc0_type(tb_rcu_callback_t);
+    tb_assert_and_check_return_val(callback, tb_false);
+    callback->func = func;
+    callback->priv = priv;
+
+    // defer it, the old version has been unpublished before this epoch
+    tb_spinlock_enter(&g_lock);
+    callback->epoch = (tb_size_t)g_epoch;
+    if (g_callbacks_tail) g_callbacks_tail->next = callback;
+    else g_callbacks = callback;
+    g_callbacks_tail = callback;
+    tb_size_t count = ++g_callbacks_count;
+    tb_spinlock_leave(&g_lock);
+
+    // too many callbacks? try to reclaim them
+    if (count >= TB_RCU_CALLBACKS_MAXN) tb_rcu_reclaim();
+
+    // ok
+    return tb_true;
+}
+tb_void_t tb_rcu_synchronize()
+{
+    // advance the global epoch, all old versions have been unpublished before it
+    tb_size_t epoch = (tb_size_t)tb_atomic_add_and_fetch(&g_epoch, 2);
+
+    // wait the readers which may see the old versions
+    while (1)
+    {
+        // get the oldest reading epoch
+        tb_spinlock_enter(&g_lock);
+        tb_size_t reading = tb_rcu_epoch_min();
+        tb_spinlock_leave(&g_lock);
+
+        // all readers have left?
+        tb_check_break(tb_rcu_epoch_before(reading, epoch));
+
+        // wait them
+        tb_sched_yield();
+    }
+
+    // call the deferred functions
+    tb_rcu_reclaim();
+}
+tb_void_t tb_rcu_free_func(tb_pointer_t priv)
+{
+    // free it
+    if (priv) tb_free(priv);
+}
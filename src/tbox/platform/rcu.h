@@ -0,0 +1,141 @@
+/*!The Treasure Box Library
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * 
+ * Copyright (C) 2009 - 2017, TBOOX Open Source Group.
+ *
+ * @author      ruki
+ * @file        rcu.h
+ * @ingroup     platform
+ *
+ */
+#ifndef TB_PLATFORM_RCU_H
+#define TB_PLATFORM_RCU_H
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * includes
+ */
+#include "prefix.h"
+#include "barrier.h"
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_enter__
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+/*! load the rcu protected pointer in the read-side critical section
+ *
+ * @param p         the protected pointer
+ *
+ * @return          the current version
+ */
+#define tb_rcu_dereference(p)           ((tb_pointer_t)*((tb_pointer_t volatile*)&(p)))
+
+/*! publish the new version of the rcu protected pointer
+ *
+ * the new version must be initialized before it is published
+ *
+ * @param p         the protected pointer
+ * @param v         the new version
+ */
+#define tb_rcu_assign(p, v)             do { tb_barrier(); *((tb_pointer_t volatile*)&(p)) = (tb_pointer_t)(v); } while (0)
+
+/*! free the old version after all readers have left
+ *
+ * @param data      the old version
+ */
+#define tb_rcu_free(data)               tb_rcu_call(tb_rcu_free_func, (tb_pointer_t)(data))
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * types
+ */
+
+/*! the rcu callback type
+ *
+ * @param priv      the user private data
+ */
+typedef tb_void_t   (*tb_rcu_func_t)(tb_pointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * interfaces
+ */
+
+/*! enter the read-side critical section
+ *
+ * it only writes the epoch of the current thread to its own cache line, 
+ * and the old versions will not be freed until we leave it.
+ *
+ * @note it can be nested, but cannot be blocked in it for a long time
+ *
+ * @code
+    tb_rcu_read_enter();
+    tb_xxxx_t* xxxx = (tb_xxxx_t*)tb_rcu_dereference(g_xxxx);
+    if (xxxx)
+    {
+        // read it
+        // ...
+    }
+    tb_rcu_read_leave();
+ * @endcode
+ */
+tb_void_t           tb_rcu_read_enter(tb_noarg_t);
+
+/// leave the read-side critical section
+tb_void_t           tb_rcu_read_leave(tb_noarg_t);
+
+/*! call the function after all readers which may see the old version have left
+ *
+ * @code
+    // the writers are serialized by the lock
+    tb_spinlock_enter(&g_lock);
+    tb_xxxx_t* xxxx_old = g_xxxx;
+    tb_rcu_assign(g_xxxx, xxxx_new);
+    tb_spinlock_leave(&g_lock);
+
+    // free the old version
+    if (xxxx_old) tb_rcu_call(tb_xxxx_exit, xxxx_old);
+ * @endcode
+ *
+ * @param func      the callback function
+ * @param priv      the user private data
+ *
+ * @return          tb_true or tb_false
+ */
+tb_bool_t           tb_rcu_call(tb_rcu_func_t func, tb_pointer_t priv);
+
+/*! wait all readers which may see the old versions and call the deferred functions
+ *
+ * @note it cannot be called in the read-side critical section
+ */
+tb_void_t           tb_rcu_synchronize(tb_noarg_t);
+
+/*! the deferred free function for tb_rcu_free()
+ *
+ * @param priv      the data
+ */
+tb_void_t           tb_rcu_free_func(tb_pointer_t priv);
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * extern
+ */
+__tb_extern_c_leave__
+
+#endif
@@ -30,6 +30,7 @@
 #include "time.h"
 #include "cache_time.h"
 #include "atomic.h"
+#include "impl/futex.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -38,6 +39,8 @@
 #   include "windows/semaphore.c"
 #elif defined(TB_CONFIG_OS_MACOSX) || defined(TB_CONFIG_OS_IOS)
 #   include "mach/semaphore.c"
+#elif defined(TB_FUTEX_ENABLE)
+#   include "linux/semaphore.c"
 #elif defined(TB_CONFIG_POSIX_HAVE_SEM_INIT)
 #   include "posix/semaphore.c"
 #elif defined(TB_CONFIG_SYSTEMV_HAVE_SEMGET) \
@@ -81,6 +81,11 @@ tb_bool_t tb_socket_listen(tb_socket_ref_t sock, tb_size_t backlog)
     tb_trace_noimpl();
     return tb_false;
 }
+tb_bool_t tb_socket_listen_group(tb_socket_ref_t* socks, tb_size_t count, tb_size_t type, tb_ipaddr_ref_t addr, tb_size_t backlog, tb_bool_t affinity)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 tb_socket_ref_t tb_socket_accept(tb_socket_ref_t sock, tb_ipaddr_ref_t addr)
 {
     tb_trace_noimpl();
@@ -175,6 +175,25 @@ tb_bool_t           tb_socket_bind(tb_socket_ref_t sock, tb_ipaddr_ref_t addr);
  */
 tb_bool_t           tb_socket_listen(tb_socket_ref_t sock, tb_size_t backlog);
 
+/*! init the listener group, one listening socket with SO_REUSEPORT for each worker
+ *
+ * the kernel will balance the new connections to all sockets of this group,
+ * so each worker (thread or scheduler) can accept on its own socket without the thundering herd.
+ *
+ * the connections will be steered to socks[cpu % count] by the current cpu if affinity is enabled and be supported (linux),
+ * so we need bind the worker of socks[i] to the cpu i for keeping the accepts and the connection's lifetime on one core.
+ *
+ * @param socks     the listening sockets, all sockets will be closed if failed
+ * @param count     the sockets count
+ * @param type      the socket type
+ * @param addr      the bound address, the port cannot be zero
+ * @param backlog   the maximum length for the queue of pending connections of each socket
+ * @param affinity  steer the connections by the current cpu?
+ *
+ * @return          tb_true or tb_false, it will be failed if SO_REUSEPORT is not supported
+ */
+tb_bool_t           tb_socket_listen_group(tb_socket_ref_t* socks, tb_size_t count, tb_size_t type, tb_ipaddr_ref_t addr, tb_size_t backlog, tb_bool_t affinity);
+
 /*! accept socket
  *
  * @param sock      the socket 
@@ -32,6 +32,7 @@
 #include "prefix.h"
 #include "sched.h"
 #include "atomic.h"
+#include "barrier.h"
 #include "../utils/lock_profiler.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -41,6 +42,172 @@
 // the initial value
 #define TB_SPINLOCK_INIT            (0)
 
+/* the initial value of the ticket spinlock
+ *
+ * the ticket spinlock grants the lock in the FIFO order, so it is fair and the waiters
+ * only read the lock word instead of bouncing it with the test-and-set under contention.
+ *
+ * the lock word: [next ticket: the high half][owner ticket: bit 2 ~ half - 1][ticket flag: bit 1]
+ */
+#define TB_SPINLOCK_INIT_TICKET     (2)
+
+// the ticket flag, the test-and-set spinlock is always 0 or 1
+#define TB_SPINLOCK_TICKET          (2)
+
+// the shift of the next ticket
+#define TB_SPINLOCK_TICKET_SHIFT    (sizeof(tb_atomic_t) << 2)
+
+// the mask of the ticket
+#define TB_SPINLOCK_TICKET_MASK     (((tb_size_t)1 << (TB_SPINLOCK_TICKET_SHIFT - 2)) - 1)
+
+// get the owner ticket of the lock word
+#define tb_spinlock_ticket_owner(v) (((tb_size_t)(v) >> 2) & TB_SPINLOCK_TICKET_MASK)
+
+// get the next ticket of the lock word
+#define tb_spinlock_ticket_next(v)  (((tb_size_t)(v) >> TB_SPINLOCK_TICKET_SHIFT) & TB_SPINLOCK_TICKET_MASK)
+
+// the maximum pause count before yielding the processor
+#ifdef __tb_small__
+#   define TB_SPINLOCK_SPIN_MAXN    (64)
+#else
+#   define TB_SPINLOCK_SPIN_MAXN    (256)
+#endif
+
+// the maximum pause count of one backoff
+#define TB_SPINLOCK_BACKOFF_MAXN    (16)
+
+// pause the processor in the spin loop, it saves the power and the pipeline flush when leaving the loop
+#if defined(TB_ASSEMBLER_IS_GAS) && (defined(TB_ARCH_x86) || defined(TB_ARCH_x64))
+#   define tb_spinlock_pause()      __tb_asm__ __tb_volatile__ ("pause" ::: "memory")
+#elif defined(TB_ASSEMBLER_IS_GAS) && defined(TB_ARCH_ARM) && (TB_ARCH_ARM_VERSION >= 7)
+#   define tb_spinlock_pause()      __tb_asm__ __tb_volatile__ ("yield" ::: "memory")
+#else
+#   define tb_spinlock_pause()      
+#endif
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * private implementation
+ */
+
+/* pause the processor for the given count and yield it if we have spun too long
+ *
+ * @param spin      the spun count
+ * @param pause     the pause count
+ */
+static __tb_inline_force__ tb_void_t tb_spinlock_backoff(tb_size_t* spin, tb_size_t pause)
+{
+    // yield the processor, the owner may be preempted
+    if (*spin >= TB_SPINLOCK_SPIN_MAXN)
+    {
+        // yield
+        tb_sched_yield();
+
+        // reset spin
+        *spin = 0;
+        return ;
+    }
+
+    // pause the processor
+    *spin += pause;
+    while (pause--) tb_spinlock_pause();
+}
+
+/* enter spinlock
+ *
+ * @param lock      the lock
+ * @param profiler  report the occupied lock to the lock profiler?
+ */
+static __tb_inline_force__ tb_void_t tb_spinlock_enter_impl(tb_spinlock_ref_t lock, tb_bool_t profiler)
+{
+    // init spin
+    tb_size_t spin = 0;
+
+    // init occupied
+#ifdef TB_LOCK_PROFILER_ENABLE
+    tb_bool_t occupied = !profiler;
+#endif
+
+    // the ticket spinlock?
+    if (*((tb_atomic_t volatile*)lock) & TB_SPINLOCK_TICKET)
+    {
+        // take a ticket, the owner ticket is the old value before this full barrier
+        tb_atomic_t value   = tb_atomic_fetch_and_add((tb_atomic_t*)lock, (tb_atomic_t)1 << TB_SPINLOCK_TICKET_SHIFT);
+        tb_size_t   ticket  = tb_spinlock_ticket_next(value);
+        tb_size_t   owner   = tb_spinlock_ticket_owner(value);
+        tb_check_return(owner != ticket);
+
+        // wait for our turn
+        do
+        {
+#ifdef TB_LOCK_PROFILER_ENABLE
+            // occupied
+            if (!occupied)
+            {
+                occupied = tb_true;
+                tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+            }
+#endif
+
+            // backoff in proportion to the count of the waiters before us
+            tb_size_t ahead = (ticket - owner) & TB_SPINLOCK_TICKET_MASK;
+            tb_spinlock_backoff(&spin, tb_min(ahead, TB_SPINLOCK_BACKOFF_MAXN));
+
+            // get the owner ticket
+            owner = tb_spinlock_ticket_owner(*((tb_atomic_t volatile*)lock));
+
+        } while (owner != ticket);
+
+        // the critical section cannot be read before the owner ticket
+        tb_barrier();
+    }
+    else
+    {
+        // lock it
+        tb_size_t backoff = 1;
+        while (tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1))
+        {
+#ifdef TB_LOCK_PROFILER_ENABLE
+            // occupied
+            if (!occupied)
+            {
+                occupied = tb_true;
+                tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
+            }
+#endif
+
+            // wait it with the exponential backoff, only read it to keep the cache line shared
+            do
+            {
+                tb_spinlock_backoff(&spin, backoff);
+                if (backoff < TB_SPINLOCK_BACKOFF_MAXN) backoff <<= 1;
+
+            } while (*((tb_atomic_t volatile*)lock));
+        }
+    }
+}
+
+/* try to enter spinlock
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_spinlock_enter_try_impl(tb_spinlock_ref_t lock)
+{
+    // get the lock word
+    tb_atomic_t value = *((tb_atomic_t volatile*)lock);
+
+    // the ticket spinlock? only take a ticket if it is unlocked now
+    if (value & TB_SPINLOCK_TICKET)
+    {
+        return tb_spinlock_ticket_owner(value) == tb_spinlock_ticket_next(value)
+            && tb_atomic_fetch_and_pset((tb_atomic_t*)lock, value, value + ((tb_atomic_t)1 << TB_SPINLOCK_TICKET_SHIFT)) == value;
+    }
+
+    // try locking it
+    return !tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1);
+}
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * interfaces
  */
@@ -57,7 +224,27 @@ static __tb_inline_force__ tb_bool_t tb_spinlock_init(tb_spinlock_ref_t lock)
     tb_assert(lock);
 
     // init 
-    *lock = 0;
+    *lock = TB_SPINLOCK_INIT;
+
+    // ok
+    return tb_true;
+}
+
+/*! init the ticket spinlock
+ *
+ * it is fair and scales better than the default test-and-set spinlock for the hot locks
+ *
+ * @param lock      the lock
+ *
+ * @return          tb_true or tb_false
+ */
+static __tb_inline_force__ tb_bool_t tb_spinlock_init_ticket(tb_spinlock_ref_t lock)
+{
+    // check
+    tb_assert(lock);
+
+    // init 
+    *lock = TB_SPINLOCK_INIT_TICKET;
 
     // ok
     return tb_true;
@@ -85,43 +272,8 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter(tb_spinlock_ref_t lock)
     // check
     tb_assert(lock);
 
-    // init tryn
-    tb_size_t tryn = 5;
-    
-    // init occupied
-#ifdef TB_LOCK_PROFILER_ENABLE
-    tb_bool_t occupied = tb_false;
-#endif
-
-    // lock it
-    while (tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1))
-    {
-#ifdef TB_LOCK_PROFILER_ENABLE
-        // occupied
-        if (!occupied)
-        {
-            // occupied++
-            occupied = tb_true;
-            tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
-
-            // dump backtrace
-#if 0//def __tb_debug__
-            tb_backtrace_dump("spinlock", tb_null, 10);
-#endif
-        }
-#endif
-
-        // yield the processor
-        if (!tryn--)
-        {
-            // yield
-            tb_sched_yield();
-//          tb_usleep(1);
-
-            // reset tryn
-            tryn = 5;
-        }
-    }
+    // enter
+    tb_spinlock_enter_impl(lock, tb_true);
 }
 
 /*! enter spinlock without the lock profiler
@@ -133,23 +285,8 @@ static __tb_inline_force__ tb_void_t tb_spinlock_enter_without_profiler(tb_spinl
     // check
     tb_assert(lock);
 
-    // init tryn
-    tb_size_t tryn = 5;
-    
-    // lock it
-    while (tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1))
-    {
-        // yield the processor
-        if (!tryn--)
-        {
-            // yield
-            tb_sched_yield();
-//          tb_usleep(1);
-
-            // reset tryn
-            tryn = 5;
-        }
-    }
+    // enter
+    tb_spinlock_enter_impl(lock, tb_false);
 }
 
 /*! try to enter spinlock
@@ -165,10 +302,10 @@ static __tb_inline_force__ tb_bool_t tb_spinlock_enter_try(tb_spinlock_ref_t loc
 
 #ifndef TB_LOCK_PROFILER_ENABLE
     // try locking it
-    return !tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1);
+    return tb_spinlock_enter_try_impl(lock);
 #else
     // try locking it
-    tb_bool_t ok = !tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1);
+    tb_bool_t ok = tb_spinlock_enter_try_impl(lock);
 
     // occupied?
     if (!ok) tb_lock_profiler_occupied(tb_lock_profiler(), (tb_pointer_t)lock);
@@ -190,7 +327,7 @@ static __tb_inline_force__ tb_bool_t tb_spinlock_enter_try_without_profiler(tb_s
     tb_assert(lock);
 
     // try locking it
-    return !tb_atomic_fetch_and_pset((tb_atomic_t*)lock, 0, 1);
+    return tb_spinlock_enter_try_impl(lock);
 }
 
 /*! leave spinlock
@@ -202,8 +339,20 @@ static __tb_inline_force__ tb_void_t tb_spinlock_leave(tb_spinlock_ref_t lock)
     // check
     tb_assert(lock);
 
+    // the ticket spinlock?
+    tb_atomic_t value = *((tb_atomic_t volatile*)lock);
+    if (value & TB_SPINLOCK_TICKET)
+    {
+        /* pass it to the next ticket, only the owner updates the owner ticket
+         *
+         * we wrap the owner ticket by hand to avoid carrying into the next ticket
+         */
+        if (tb_spinlock_ticket_owner(value) == TB_SPINLOCK_TICKET_MASK)
+            tb_atomic_fetch_and_sub((tb_atomic_t*)lock, (tb_atomic_t)TB_SPINLOCK_TICKET_MASK << 2);
+        else tb_atomic_fetch_and_add((tb_atomic_t*)lock, 4);
+    }
     // leave
-    *((tb_atomic_t*)lock) = 0;
+    else *((tb_atomic_t*)lock) = 0;
 }
 
 #endif
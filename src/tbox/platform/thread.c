@@ -51,7 +51,7 @@ typedef tb_pointer_t    tb_thread_retval_t;
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
-#ifndef TB_CONFIG_MICRO_ENABLE
+#if !defined(TB_CONFIG_MICRO_ENABLE) && !defined(TB_THREAD_LOCAL_DESTRUCTOR_ENABLE)
 static tb_bool_t tb_thread_local_free(tb_iterator_ref_t iterator, tb_pointer_t item, tb_cpointer_t priv)
 {
     // the local
@@ -92,7 +92,7 @@ static tb_thread_retval_t tb_thread_func(tb_pointer_t priv)
         // call the thread function
         retval = (tb_thread_retval_t)(tb_size_t)func(args[1].ptr);
 
-#ifndef TB_CONFIG_MICRO_ENABLE
+#if !defined(TB_CONFIG_MICRO_ENABLE) && !defined(TB_THREAD_LOCAL_DESTRUCTOR_ENABLE)
         // free all thread local data on the current thread
         tb_thread_local_walk(tb_thread_local_free, tb_null);
 #endif
@@ -149,6 +149,16 @@ tb_size_t tb_thread_self()
     tb_trace_noimpl();
     return 0;
 }
+tb_bool_t tb_thread_affinity_set(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
+tb_bool_t tb_thread_affinity_get(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
 #endif
 tb_bool_t tb_thread_once(tb_atomic_t* lock, tb_bool_t (*func)(tb_cpointer_t), tb_cpointer_t priv)
 {
@@ -30,6 +30,7 @@
  * includes
  */
 #include "prefix.h"
+#include "processor.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * extern
@@ -143,6 +144,34 @@ tb_size_t               tb_thread_self(tb_noarg_t);
  */
 tb_void_t               tb_thread_return(tb_int_t value);
 
+/*! set the cpu affinity of the thread
+ *
+ * @code
+    
+    // pin the current thread to the smt siblings of the first physical core
+    tb_processor_topology_t const* topology = tb_processor_topology();
+    if (topology && topology->cores_count) tb_thread_affinity_set(tb_null, &topology->cores[0].cpus);
+
+ * @endcode
+ *
+ * @note only the current thread can be pinned on android
+ *
+ * @param thread        the thread, the current thread if be null
+ * @param cpuset        the cpuset
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_thread_affinity_set(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset);
+
+/*! get the cpu affinity of the thread
+ *
+ * @param thread        the thread, the current thread if be null
+ * @param cpuset        the cpuset
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_thread_affinity_get(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset);
+
 /*! run the given function only once
  *
  * @code
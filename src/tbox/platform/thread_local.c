@@ -48,6 +48,9 @@ static tb_single_list_entry_head_t  g_thread_local_list;
 // the thread local list lock
 static tb_spinlock_t                g_thread_local_lock = TB_SPINLOCK_INIT;
 
+// the thread local environment has been initialized?
+static tb_bool_t                    g_thread_local_inited = tb_false;
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * private implementation
  */
@@ -59,6 +62,9 @@ tb_bool_t tb_thread_local_init_env()
     // init the thread local list
     tb_single_list_entry_init(&g_thread_local_list, tb_thread_local_t, entry, tb_null);
 
+    // inited
+    g_thread_local_inited = tb_true;
+
     // ok
     return tb_true;
 }
@@ -67,6 +73,9 @@ tb_void_t tb_thread_local_exit_env()
     // enter lock
     tb_spinlock_enter(&g_thread_local_lock);
 
+    // exited
+    g_thread_local_inited = tb_false;
+
     // exit all thread locals
     tb_for_all_if (tb_thread_local_ref_t, local, tb_single_list_entry_itor(&g_thread_local_list), local)
     {
@@ -44,6 +44,21 @@ __tb_extern_c_enter__
 /// the thread local initial value
 #define TB_THREAD_LOCAL_INIT    {{0}, 0}
 
+/* the static thread local variable is enabled?
+ *
+ * the library can define its hot thread locals with __tb_thread_local__ directly instead of looking up the key.
+ *
+ * getting it is only one load relative to the thread pointer if tbox is linked into the executable (initial-exec/local-exec tls),
+ * but it still calls __tls_get_addr() in the shared libtbox (general-dynamic tls), which is cheaper than the key lookup too.
+ *
+ * the emulated tls of android and mingw is not faster than the key, so we do not use it.
+ */
+#if defined(__tb_thread_local__) \
+    && !defined(TB_CONFIG_OS_ANDROID) \
+    && !(defined(TB_CONFIG_OS_WINDOWS) && defined(TB_COMPILER_IS_GCC))
+#   define TB_THREAD_LOCAL_STATIC_ENABLE
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
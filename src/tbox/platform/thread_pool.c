@@ -38,6 +38,7 @@
 #include "../memory/memory.h"
 #include "../container/container.h"
 #include "../algorithm/algorithm.h"
+#include "impl/futex.h"
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * macros
@@ -50,6 +51,13 @@
 #   define TB_THREAD_POOL_WORKER_MAXN           (64)
 #endif
 
+// the worker deque maxn, must be power of 2
+#ifdef __tb_small__
+#   define TB_THREAD_POOL_WORKER_DEQUE_MAXN     (256)
+#else
+#   define TB_THREAD_POOL_WORKER_DEQUE_MAXN     (1024)
+#endif
+
 // the jobs grow
 #ifdef __tb_small__
 #   define TB_THREAD_POOL_JOBS_POOL_GROW        (256)
@@ -57,7 +65,7 @@
 #   define TB_THREAD_POOL_JOBS_POOL_GROW        (512)
 #endif
 
-// the working jobs grow
+// the finished jobs grow, they will be freed together if be full
 #ifdef __tb_small__
 #   define TB_THREAD_POOL_JOBS_WORKING_GROW     (32)
 #else
@@ -78,10 +86,27 @@
 #   define TB_THREAD_POOL_JOBS_PULL_TIME_MAXN   (20000)
 #endif
 
+// the pull jobs count maxn, only pull the half of the worker deque at once
+#define TB_THREAD_POOL_JOBS_PULL_MAXN           (TB_THREAD_POOL_WORKER_DEQUE_MAXN >> 1)
+
+// the sealed dependent links of the completed job
+#define TB_THREAD_POOL_JOB_LINKS_SEALED         ((tb_long_t)1)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
 
+// the thread pool job link type
+typedef struct __tb_thread_pool_job_link_t
+{
+    // the next link
+    struct __tb_thread_pool_job_link_t* next;
+
+    // the dependent job
+    struct __tb_thread_pool_job_t*      job;
+
+}tb_thread_pool_job_link_t;
+
 // the thread pool job type
 typedef struct __tb_thread_pool_job_t
 {
@@ -101,9 +126,21 @@ typedef struct __tb_thread_pool_job_t
      */
     tb_atomic_t                         state;
 
-    // the entry
+    // the entry for the urgent or waiting jobs
     tb_list_entry_t                     entry;
 
+    // the group
+    struct __tb_thread_pool_group_t*    group;
+
+    // the unfinished dependencies count, it will be posted to the workers if be zero
+    tb_atomic_t                         deps;
+
+    // the links of the dependent jobs, it will be sealed after this job is completed
+    tb_atomic_t                         links;
+
+    // the links to the dependencies of this job
+    tb_thread_pool_job_link_t*          links_data;
+
 }tb_thread_pool_job_t;
 
 // the thread pool job stats type
@@ -128,30 +165,67 @@ typedef struct __tb_thread_pool_worker_priv_t
 
 }tb_thread_pool_worker_priv_t;
 
+/* the thread pool worker deque type (chase-lev)
+ *
+ * only the owner worker pushes and pops jobs at the bottom, 
+ * and the other workers steal jobs from the top.
+ *
+ * the top and bottom are placed at the both sides of the jobs 
+ * to avoid the false sharing between the owner and the thieves.
+ */
+typedef struct __tb_thread_pool_deque_t
+{
+    // the top index, only be increased by the thieves and the owner
+    tb_atomic_t                         top;
+
+    // the jobs ring
+    tb_thread_pool_job_t* __tb_volatile__ jobs[TB_THREAD_POOL_WORKER_DEQUE_MAXN];
+
+    // the bottom index, only be modified by the owner
+    tb_atomic_t                         bottom;
+
+}tb_thread_pool_deque_t;
+
 // the thread pool worker type
 typedef struct __tb_thread_pool_worker_t
 {
     // the worker id
     tb_size_t                           id;
 
-    // the thread pool 
-    tb_thread_pool_ref_t                pool;
+    /* the thread pool 
+     *
+     * @note it is typed, so the compiler knows the size of the atomic members accessed by it
+     */
+    struct __tb_thread_pool_impl_t*     pool;
 
     // the loop
     tb_thread_ref_t                     loop;
 
-    // the jobs
+    // the finished jobs which will be freed together
     tb_vector_ref_t                     jobs;
 
     // the pull time
     tb_size_t                           pull;
 
+    // the last stolen worker
+    tb_size_t                           steal;
+
+    // the numa node of the pinned worker
+    tb_size_t                           node;
+
     // the stats
     tb_hash_map_ref_t                   stats;
 
     // is stoped?
     tb_atomic_t                         bstoped;
 
+    /* the jobs deque
+     *
+     * it is allocated by the worker thread after pinning, so it will be placed on the local node,
+     * and it will be null until the worker has been started.
+     */
+    tb_thread_pool_deque_t*             deque;
+
     // the private data 
     tb_thread_pool_worker_priv_t        priv[TB_THREAD_POOL_WORKER_PRIV_MAXN];
 
@@ -166,35 +240,78 @@ typedef struct __tb_thread_pool_impl_t
     // the worker maxn
     tb_size_t                           worker_maxn;
 
+    // pin one worker per physical core?
+    tb_bool_t                           pinned;
+
     // the lock
     tb_spinlock_t                       lock;
 
     // the jobs pool
     tb_fixed_pool_ref_t                 jobs_pool;
 
-    // the urgent jobs
+    // the urgent jobs, the priority lane and all workers will pull them first
     tb_list_entry_head_t                jobs_urgent;
+
+    // the urgent jobs size, it can be peeked without the lock
+    tb_atomic_t                         jobs_urgent_size;
     
-    // the waiting jobs
+    // the waiting jobs posted from the non-worker threads
     tb_list_entry_head_t                jobs_waiting;
-    
-    // the pending jobs
-    tb_list_entry_head_t                jobs_pending;
+
+    // the waiting jobs size, it can be peeked without the lock
+    tb_atomic_t                         jobs_waiting_size;
 
     // is stoped
     tb_bool_t                           bstoped;
 
+    // the idle workers count
+    tb_atomic_t                         idle_size;
+
+    // the wait sequence, the idle workers will be waked up if it is changed
+    tb_atomic_t                         wait_seq;
+
+#ifndef TB_FUTEX_ENABLE
     // the semaphore
     tb_semaphore_ref_t                  semaphore;
-    
+#endif
+
     // the worker size
-    tb_size_t                           worker_size;
+    tb_atomic_t                         worker_size;
 
     // the worker list
     tb_thread_pool_worker_t             worker_list[TB_THREAD_POOL_WORKER_MAXN];
 
 }tb_thread_pool_impl_t;
 
+// the thread pool group type
+typedef struct __tb_thread_pool_group_t
+{
+    // the thread pool
+    tb_thread_pool_impl_t*              pool;
+
+    // the reference count, the group handle and all unfinished tasks
+    tb_atomic_t                         refn;
+
+    // the unfinished tasks count
+    tb_atomic_t                         size;
+
+    // the event for waiting all tasks
+    tb_event_ref_t                      event;
+
+}tb_thread_pool_group_t;
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * globals
+ */
+
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+// the current worker
+static __tb_thread_local__ tb_thread_pool_worker_t* s_worker_self = tb_null;
+#else
+// the current worker
+static tb_thread_local_t                s_worker_self = TB_THREAD_LOCAL_INIT;
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * instance implementation
  */
@@ -220,170 +337,554 @@ static tb_void_t tb_thread_pool_instance_kill(tb_handle_t pool, tb_cpointer_t pr
 }
 
 /* //////////////////////////////////////////////////////////////////////////////////////
- * worker implementation
+ * deque implementation
  */
-static tb_bool_t tb_thread_pool_worker_walk_pull(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value, tb_bool_t* is_break)
+static __tb_inline__ tb_size_t tb_thread_pool_deque_size(tb_thread_pool_deque_t* deque)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs && worker->stats && is_break);
+    // the approximate size, it is only a hint for the other workers
+    tb_long_t size = deque->bottom - deque->top;
+    return size > 0? (tb_size_t)size : 0;
+}
+static tb_bool_t tb_thread_pool_deque_push(tb_thread_pool_deque_t* deque, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(deque && job);
 
     // full?
-    if (worker->pull >= TB_THREAD_POOL_JOBS_PULL_TIME_MAXN)
+    tb_long_t bottom = deque->bottom;
+    tb_long_t top = tb_atomic_get(&deque->top);
+    tb_check_return_val(bottom - top < TB_THREAD_POOL_WORKER_DEQUE_MAXN, tb_false);
+
+    // save the job
+    deque->jobs[bottom & (TB_THREAD_POOL_WORKER_DEQUE_MAXN - 1)] = job;
+
+    // publish it after the job has been saved
+    tb_barrier();
+    deque->bottom = bottom + 1;
+
+    // ok
+    return tb_true;
+}
+static tb_thread_pool_job_t* tb_thread_pool_deque_pop(tb_thread_pool_deque_t* deque)
+{
+    // check
+    tb_assert(deque);
+
+    // reserve the bottom job first
+    tb_long_t bottom = deque->bottom - 1;
+    deque->bottom = bottom;
+
+    // the thieves must see the reserved bottom before we read the top
+    tb_barrier();
+    tb_long_t top = deque->top;
+
+    // empty? restore it
+    if (top > bottom)
     {
-        // break it
-        *is_break = tb_true;
-        return tb_false;
+        deque->bottom = bottom + 1;
+        return tb_null;
     }
 
-    // the job
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
+    // get the job
+    tb_thread_pool_job_t* job = deque->jobs[bottom & (TB_THREAD_POOL_WORKER_DEQUE_MAXN - 1)];
 
-    // the pool
-    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
+    // the last job? race with the thieves
+    if (top == bottom)
+    {
+        // it has been stolen?
+        if (tb_atomic_fetch_and_pset(&deque->top, top, top + 1) != top) job = tb_null;
+
+        // restore the bottom
+        deque->bottom = bottom + 1;
+    }
+
+    // ok?
+    return job;
+}
+static tb_thread_pool_job_t* tb_thread_pool_deque_steal(tb_thread_pool_deque_t* deque)
+{
+    // check
+    tb_assert(deque);
+
+    // read the top before the bottom
+    tb_long_t top = tb_atomic_get(&deque->top);
+    tb_barrier();
+    tb_long_t bottom = deque->bottom;
+
+    // empty?
+    tb_check_return_val(top < bottom, tb_null);
+
+    // get the job
+    tb_thread_pool_job_t* job = deque->jobs[top & (TB_THREAD_POOL_WORKER_DEQUE_MAXN - 1)];
+
+    // steal it, it has been taken by the owner or the other thieves if failed
+    return tb_atomic_fetch_and_pset(&deque->top, top, top + 1) == top? job : tb_null;
+}
+
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * worker implementation
+ */
+static tb_size_t tb_thread_pool_worker_node(tb_thread_pool_impl_t* impl, tb_size_t id)
+{
+    // check
     tb_assert(impl);
 
-    // append the job to the pending jobs
-    tb_list_entry_insert_tail(&impl->jobs_pending, &job->entry);  
+    // the pinned worker is placed on the numa node of its physical core
+    tb_processor_topology_t const* topology = impl->pinned? tb_processor_topology() : tb_null;
+    return (topology && id < topology->cores_count)? topology->cores[id].node : 0;
+}
+static tb_bool_t tb_thread_pool_worker_ready(tb_thread_pool_impl_t* impl)
+{
+    // check
+    tb_assert(impl);
 
-    // append the job to the working jobs
-    tb_vector_insert_tail(worker->jobs, job);   
+    // have urgent or waiting jobs?
+    if (impl->jobs_urgent_size || impl->jobs_waiting_size) return tb_true;
 
-    // computate the job average time 
-    tb_size_t average_time = 200;
-    if (tb_hash_map_size(worker->stats))
+    // have jobs in the worker deques?
+    tb_size_t i = 0;
+    tb_size_t n = (tb_size_t)impl->worker_size;
+    for (i = 0; i < n; i++)
     {
-        tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-        if (stats && stats->done_count) average_time = (tb_size_t)(stats->total_time / stats->done_count);
+        tb_thread_pool_deque_t* deque = impl->worker_list[i].deque;
+        if (deque && tb_thread_pool_deque_size(deque)) return tb_true;
+    }
+
+    // no jobs
+    return tb_false;
+}
+static tb_void_t tb_thread_pool_worker_wake(tb_thread_pool_impl_t* impl, tb_size_t wake, tb_bool_t force)
+{
+    // check
+    tb_assert_and_check_return(impl && wake);
+
+    // no idle workers? the busy workers will see the new jobs before parking
+    tb_long_t idle = tb_atomic_get(&impl->idle_size);
+    tb_check_return(force || idle > 0);
+
+    // change the wait sequence for the workers which are parking now
+    tb_atomic_fetch_and_inc(&impl->wait_seq);
+
+#ifdef TB_FUTEX_ENABLE
+    // wake up the parked workers
+    tb_futex_wake(&impl->wait_seq, force? TB_MAXS32 : tb_min(wake, (tb_size_t)idle));
+#else
+    // post the semaphore
+    tb_semaphore_post(impl->semaphore, force? wake : tb_min(wake, (tb_size_t)idle));
+#endif
+}
+static tb_void_t tb_thread_pool_worker_park(tb_thread_pool_worker_t* worker)
+{
+    // check
+    tb_thread_pool_impl_t* impl = worker->pool;
+    tb_assert(impl);
+
+    /* mark it as idle before checking the jobs again, 
+     * so the posters will see it and wake it up after the new jobs are posted
+     */
+    tb_atomic_fetch_and_inc(&impl->idle_size);
+
+#ifdef TB_FUTEX_ENABLE
+    // the wait sequence before checking the jobs again
+    tb_long_t seq = tb_atomic_get(&impl->wait_seq);
+#endif
+
+    // no jobs and not stoped? wait it
+    if (!tb_thread_pool_worker_ready(impl) && !tb_atomic_get(&worker->bstoped))
+    {
+        // trace
+        tb_trace_d("worker[%lu]: wait: ..", worker->id);
+
+#ifdef TB_FUTEX_ENABLE
+        // wait it if the wait sequence is not changed
+        tb_futex_wait(&impl->wait_seq, seq, -1);
+#else
+        // wait the semaphore
+        tb_semaphore_wait(impl->semaphore, -1);
+#endif
+
+        // trace
+        tb_trace_d("worker[%lu]: wait: ok", worker->id);
     }
 
-    // update the pull time
-    worker->pull += average_time;
+    // leave the idle state
+    tb_atomic_fetch_and_dec(&impl->idle_size);
+}
+static tb_thread_pool_worker_t* tb_thread_pool_worker_self(tb_thread_pool_impl_t* impl)
+{
+    // the current worker of this pool
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+    tb_thread_pool_worker_t* worker = s_worker_self;
+#else
+    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)tb_thread_local_get(&s_worker_self);
+#endif
+    return (worker && worker->pool == impl)? worker : tb_null;
+}
+static tb_void_t tb_thread_pool_group_release(tb_thread_pool_group_t* group)
+{
+    // check
+    tb_assert(group);
+
+    // the last reference? exit it
+    if (tb_atomic_fetch_and_dec(&group->refn) == 1)
+    {
+        // exit event
+        if (group->event) tb_event_exit(group->event);
+        group->event = tb_null;
+
+        // exit it
+        tb_free(group);
+    }
+}
+static tb_void_t tb_thread_pool_jobs_free(tb_thread_pool_impl_t* impl, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(impl && job);
+
+    // exit the links to the dependencies
+    if (job->links_data) tb_free(job->links_data);
+    job->links_data = tb_null;
+
+    // remove it from the jobs pool
+    tb_fixed_pool_free(impl->jobs_pool, job);
+}
+static tb_void_t tb_thread_pool_jobs_release(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
+{
+    // check
+    tb_assert(impl && job);
 
     // trace
-    tb_trace_d("worker[%lu]: pull: task[%p:%s] from %s", worker->id, job->task.done, job->task.name, iterator == tb_list_entry_itor(&impl->jobs_waiting)? "waiting" : "urgent");
+    tb_trace_d("task[%p:%s]: release: ..", job->task.done, job->task.name);
 
-    // remove the job from the waiting or urgent jobs
-    return tb_true;
+    // push it to the deque of the current worker, it will be done next by this worker
+    if (job->task.urgent || !worker || !tb_thread_pool_deque_push(worker->deque, job))
+    {
+        // enter
+        tb_spinlock_enter(&impl->lock);
+
+        // post it to the urgent or waiting jobs
+        if (job->task.urgent)
+        {
+            tb_list_entry_insert_tail(&impl->jobs_urgent, &job->entry);
+            tb_atomic_fetch_and_inc(&impl->jobs_urgent_size);
+        }
+        else
+        {
+            tb_list_entry_insert_tail(&impl->jobs_waiting, &job->entry);
+            tb_atomic_fetch_and_inc(&impl->jobs_waiting_size);
+        }
+
+        // leave
+        tb_spinlock_leave(&impl->lock);
+    }
+
+    // wake up one idle worker
+    tb_thread_pool_worker_wake(impl, 1, tb_false);
 }
-static tb_bool_t tb_thread_pool_worker_walk_pull_and_clean(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_void_t tb_thread_pool_jobs_complete(tb_thread_pool_impl_t* impl, tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job, tb_bool_t killed)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs && worker->stats);
+    // check
+    tb_assert(impl && job);
 
-    // the job
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
+    // seal the dependent links, no more jobs can depend on it
+    tb_thread_pool_job_link_t* link = (tb_thread_pool_job_link_t*)tb_atomic_fetch_and_set(&job->links, TB_THREAD_POOL_JOB_LINKS_SEALED);
 
-    // the job state
-    tb_size_t state = tb_atomic_get(&job->state);
+    // release the dependent jobs
+    while (link)
+    {
+        // the dependent job, we need get the next link first because it may be freed after releasing
+        tb_thread_pool_job_link_t*  next = link->next;
+        tb_thread_pool_job_t*       dependent = link->job;
+        tb_assert(dependent);
 
-    // waiting and non-full? pull it
-    tb_bool_t ok = tb_false;
-    if (state == TB_STATE_WAITING && worker->pull < TB_THREAD_POOL_JOBS_PULL_TIME_MAXN)
+        // kill it too if this job has been killed
+        if (killed) tb_atomic_pset(&dependent->state, TB_STATE_WAITING, TB_STATE_KILLING);
+
+        // all dependencies are completed? release it
+        if (tb_atomic_fetch_and_dec(&dependent->deps) == 1) 
+            tb_thread_pool_jobs_release(impl, worker, dependent);
+
+        // the next link
+        link = next;
+    }
+
+    // leave the group
+    tb_thread_pool_group_t* group = job->group;
+    if (group)
     {
-        // append the job to the working jobs
-        tb_vector_insert_tail(worker->jobs, job);   
+        // the last task of this group? notify the waiters
+        if (tb_atomic_fetch_and_dec(&group->size) == 1) tb_event_post(group->event);
 
-        // computate the job average time 
-        tb_size_t average_time = 200;
-        if (tb_hash_map_size(worker->stats))
+        // release the group
+        job->group = tb_null;
+        tb_thread_pool_group_release(group);
+    }
+}
+static tb_void_t tb_thread_pool_worker_free(tb_thread_pool_worker_t* worker)
+{
+    // check
+    tb_assert(worker && worker->jobs);
+
+    // no finished jobs?
+    tb_check_return(tb_vector_size(worker->jobs));
+
+    // the pool
+    tb_thread_pool_impl_t* impl = worker->pool;
+    tb_assert(impl);
+
+    // enter
+    tb_spinlock_enter(&impl->lock);
+
+    // free all finished jobs
+    tb_for_all_if (tb_thread_pool_job_t*, job, worker->jobs, job)
+    {
+        tb_thread_pool_jobs_free(impl, job);
+    }
+
+    // leave
+    tb_spinlock_leave(&impl->lock);
+
+    // clear jobs
+    tb_vector_clear(worker->jobs);
+}
+static tb_thread_pool_job_t* tb_thread_pool_worker_pull(tb_thread_pool_worker_t* worker)
+{
+    // check
+    tb_thread_pool_impl_t* impl = worker->pool;
+    tb_assert(impl && worker->stats);
+
+    // pull one job from the urgent jobs first, we peek it without the lock
+    tb_thread_pool_job_t* job = tb_null;
+    if (impl->jobs_urgent_size)
+    {
+        // enter
+        tb_spinlock_enter(&impl->lock);
+
+        // pull it
+        if (tb_list_entry_size(&impl->jobs_urgent))
         {
-            tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-            if (stats && stats->done_count) average_time = (tb_size_t)(stats->total_time / stats->done_count);
+            job = (tb_thread_pool_job_t*)tb_list_entry(&impl->jobs_urgent, tb_list_entry_head(&impl->jobs_urgent));
+            tb_list_entry_remove_head(&impl->jobs_urgent);
+            tb_atomic_fetch_and_dec(&impl->jobs_urgent_size);
         }
 
-        // update the pull time
-        worker->pull += average_time;
+        // leave
+        tb_spinlock_leave(&impl->lock);
 
-        // trace
-        tb_trace_d("worker[%lu]: pull: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+        // ok?
+        if (job) 
+        {
+            // trace
+            tb_trace_d("worker[%lu]: pull: task[%p:%s] from urgent", worker->id, job->task.done, job->task.name);
+            return job;
+        }
     }
-    // finished or killed? remove it
-    else if (state == TB_STATE_FINISHED || state == TB_STATE_KILLED)
+
+    // pop one job from the own deque
+    job = tb_thread_pool_deque_pop(worker->deque);
+    tb_check_return_val(!job, job);
+
+    // pull some jobs from the waiting jobs to the own deque
+    if (impl->jobs_waiting_size)
     {
-        // trace
-        tb_trace_d("worker[%lu]: remove: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+        // enter
+        tb_spinlock_enter(&impl->lock);
 
-        // exit the job
-        if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+        // init the pull time
+        worker->pull = 0;
 
-        // remove it from the waiting or urgent jobs
-        ok = tb_true;
+        // pull them until the pull time is full
+        tb_size_t count = 0;
+        while (     tb_list_entry_size(&impl->jobs_waiting) 
+                &&  worker->pull < TB_THREAD_POOL_JOBS_PULL_TIME_MAXN
+                &&  count < TB_THREAD_POOL_JOBS_PULL_MAXN)
+        {
+            // the job
+            tb_thread_pool_job_t* item = (tb_thread_pool_job_t*)tb_list_entry(&impl->jobs_waiting, tb_list_entry_head(&impl->jobs_waiting));
 
-        // refn--
-        if (job->refn > 1) job->refn--;
-        // remove it from pool directly
-        else 
+            // the first job will be done directly and the others will be pushed to the own deque
+            if (!job) job = item;
+            else if (!tb_thread_pool_deque_push(worker->deque, item)) break;
+
+            // remove it from the waiting jobs
+            tb_list_entry_remove_head(&impl->jobs_waiting);
+            tb_atomic_fetch_and_dec(&impl->jobs_waiting_size);
+            count++;
+
+            // computate the job average time 
+            tb_size_t average_time = 200;
+            if (tb_hash_map_size(worker->stats))
+            {
+                tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, item->task.done);
+                if (stats && stats->done_count) average_time = (tb_size_t)(stats->total_time / stats->done_count);
+            }
+
+            // update the pull time
+            worker->pull += average_time;
+        }
+
+        // leave
+        tb_spinlock_leave(&impl->lock);
+
+        // ok?
+        if (job) 
+        {
+            // trace
+            tb_trace_d("worker[%lu]: pull: %lu jobs, time: %lu ms from waiting", worker->id, count, worker->pull);
+            return job;
+        }
+    }
+
+    /* steal one job from the other workers, start from the last stolen worker
+     *
+     * the pinned worker steals from the workers on the same numa node at the first pass,
+     * and the other nodes will be stolen only if the local node has no jobs.
+     */
+    tb_size_t i = 0;
+    tb_size_t n = (tb_size_t)impl->worker_size;
+    tb_size_t pass = impl->pinned? 0 : 1;
+    for (; pass < 2 && !job; pass++)
+    {
+        for (i = 0; i < n && !job; i++)
         {
-            // the pool
-            tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-            tb_assert(impl);
+            // the victim
+            tb_size_t victim = (worker->steal + i) % n;
+            tb_check_continue(victim != worker->id);
+
+            // the victim is on the required node?
+            tb_thread_pool_worker_t* other = &impl->worker_list[victim];
+            tb_check_continue(!impl->pinned || (other->node == worker->node) == !pass);
 
-            // remove it from the jobs pool
-            tb_fixed_pool_free(impl->jobs_pool, job);
+            // the victim has been not started?
+            tb_thread_pool_deque_t* deque = other->deque;
+            tb_check_continue(deque);
+
+            // steal it
+            job = tb_thread_pool_deque_steal(deque);
+            if (job)
+            {
+                // trace
+                tb_trace_d("worker[%lu]: steal: task[%p:%s] from worker[%lu]", worker->id, job->task.done, job->task.name, victim);
+
+                // steal from this worker at the next time
+                worker->steal = victim;
+            }
         }
     }
 
-    // remove it?
-    return ok;
+    // ok?
+    return job;
 }
-static tb_bool_t tb_thread_pool_worker_walk_clean(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_void_t tb_thread_pool_worker_done(tb_thread_pool_worker_t* worker, tb_thread_pool_job_t* job)
 {
-    // the worker pull
-    tb_thread_pool_worker_t* worker = (tb_thread_pool_worker_t*)value;
-    tb_assert(worker && worker->jobs);
-
-    // the job
-    tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
-    tb_assert(job);
+    // check
+    tb_assert(worker && worker->jobs && worker->stats && job && job->task.done);
 
     // the job state
-    tb_size_t state = tb_atomic_get(&job->state);
-
-    // finished or killed? remove it
-    tb_bool_t ok = tb_false;
-    if (state == TB_STATE_FINISHED || state == TB_STATE_KILLED)
+    tb_size_t state = tb_atomic_fetch_and_pset(&job->state, TB_STATE_WAITING, TB_STATE_WORKING);
+    
+    // the job is waiting? work it
+    if (state == TB_STATE_WAITING)
     {
         // trace
-        tb_trace_d("worker[%lu]: remove: task[%p:%s] from pending", worker->id, job->task.done, job->task.name);
+        tb_trace_d("worker[%lu]: done: task[%p:%s]: ..", worker->id, job->task.done, job->task.name);
 
-        // exit the job
-        if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+        // init the time
+        tb_hong_t time = tb_cache_time_spak();
 
-        // remove it from the pending jobs
-        ok = tb_true;
+        // done the job
+        job->task.done((tb_thread_pool_worker_ref_t)worker, job->task.priv);
 
-        // refn--
-        if (job->refn > 1) job->refn--;
-        // remove it from pool directly
-        else 
+        // computate the time
+        time = tb_cache_time_spak() - time;
+
+        // exists? update time and count
+        tb_size_t               itor;
+        tb_hash_map_item_ref_t  item = tb_null;
+        if (    ((itor = tb_hash_map_find(worker->stats, job->task.done)) != tb_iterator_tail(worker->stats))
+            &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(worker->stats, itor)))
         {
-            // the pool
-            tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-            tb_assert(impl);
+            // the stats
+            tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)item->data;
+            tb_assert(stats);
+
+            // update the done count
+            stats->done_count++;
 
-            // remove it from the jobs pool
-            tb_fixed_pool_free(impl->jobs_pool, job);
+            // update the total time 
+            stats->total_time += time;
+        }
+        
+        // no item? add it
+        if (!item) 
+        {
+            // init stats
+            tb_thread_pool_job_stats_t stats = {0};
+            stats.done_count = 1;
+            stats.total_time = time;
+
+            // add stats
+            tb_hash_map_insert(worker->stats, job->task.done, &stats);
+        }
+
+#ifdef TB_TRACE_DEBUG
+        tb_size_t done_count = 0;
+        tb_hize_t total_time = 0;
+        tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
+        if (stats)
+        {
+            done_count = stats->done_count;
+            total_time = stats->total_time;
         }
+
+        // trace
+        tb_trace_d("worker[%lu]: done: task[%p:%s]: time: %lld ms, average: %lld ms, count: %lu", worker->id, job->task.done, job->task.name, time, (total_time / (tb_hize_t)done_count), done_count);
+#endif
+
+        // update the job state
+        tb_atomic_set(&job->state, TB_STATE_FINISHED);
     }
+    // the job is killing? work it
+    else if (state == TB_STATE_KILLING)
+    {
+        // trace
+        tb_trace_d("worker[%lu]: kill: task[%p:%s]", worker->id, job->task.done, job->task.name);
 
-    // remove it?
-    return ok;
+        // update the job state
+        tb_atomic_set(&job->state, TB_STATE_KILLED);
+    }
+
+    // exit the job
+    if (job->task.exit) job->task.exit((tb_thread_pool_worker_ref_t)worker, job->task.priv);
+
+    // complete it, release the dependent jobs and leave the group
+    tb_thread_pool_jobs_complete(worker->pool, worker, job, state == TB_STATE_KILLING);
+
+    // refn--, free it later if it is not referenced by the task handle
+    if (tb_atomic_fetch_and_dec(&job->refn) == 1)
+    {
+        // append it to the finished jobs
+        tb_vector_insert_tail(worker->jobs, job);
+
+        // free them if be full
+        if (tb_vector_size(worker->jobs) >= TB_THREAD_POOL_JOBS_WORKING_GROW) 
+            tb_thread_pool_worker_free(worker);
+    }
 }
-static tb_void_t tb_thread_pool_worker_post(tb_thread_pool_impl_t* impl, tb_size_t post)
+static tb_bool_t tb_thread_pool_worker_help(tb_thread_pool_worker_t* worker)
 {
     // check
-    tb_assert_and_check_return(impl && impl->semaphore);
+    tb_assert(worker);
 
-    // the semaphore value
-    tb_long_t value = tb_semaphore_value(impl->semaphore);
+    // pull one job
+    tb_thread_pool_job_t* job = tb_thread_pool_worker_pull(worker);
+    tb_check_return_val(job, tb_false);
 
-    // post wait
-    if (value >= 0 && (tb_size_t)value < post) 
-        tb_semaphore_post(impl->semaphore, post - value);
+    // done it in the waiting worker
+    tb_thread_pool_worker_done(worker, job);
+
+    // ok
+    return tb_true;
 }
 static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
 {
@@ -400,11 +901,33 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
         tb_assert_and_check_break(worker && !worker->jobs && !worker->stats);
 
         // the pool
-        tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)worker->pool;
-        tb_assert_and_check_break(impl && impl->semaphore);
+        tb_thread_pool_impl_t* impl = worker->pool;
+        tb_assert_and_check_break(impl);
+
+        // pin this worker to its physical core before allocating anything, the memory will be touched on the local node first
+        if (impl->pinned)
+        {
+            tb_processor_topology_t const* topology = tb_processor_topology();
+            if (topology && worker->id < topology->cores_count && !tb_thread_affinity_set(tb_null, (tb_cpuset_ref_t)&topology->cores[worker->id].cpus))
+            {
+                // trace
+                tb_trace_e("worker[%lu]: pin to core[%lu] failed!", worker->id, worker->id);
+            }
+        }
 
-        // wait some time for leaving the lock
-        tb_msleep((worker->id + 1) * 20);
+        // init the jobs deque and publish it to the thieves
+        tb_thread_pool_deque_t* deque = tb_malloc0_type(tb_thread_pool_deque_t);
+        tb_assert_and_check_break(deque);
+        tb_barrier();
+        worker->deque = deque;
+
+        // init the current worker
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        s_worker_self = worker;
+#else
+        if (!tb_thread_local_init(&s_worker_self, tb_null)) break;
+        tb_thread_local_set(&s_worker_self, worker);
+#endif
 
         // init jobs
         worker->jobs = tb_vector_init(TB_THREAD_POOL_JOBS_WORKING_GROW, tb_element_ptr(tb_null, tb_null));
@@ -417,168 +940,32 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
         // loop
         while (1)
         {
-            // pull jobs if be idle
-            if (!tb_vector_size(worker->jobs))
-            {
-                // enter 
-                tb_spinlock_enter(&impl->lock);
-
-                // init the pull time
-                worker->pull = 0;
-
-                // pull from the urgent jobs
-                if (tb_list_entry_size(&impl->jobs_urgent))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from urgent: %lu", worker->id, tb_list_entry_size(&impl->jobs_urgent));
-
-                    // pull it
-                    tb_remove_if_until(tb_list_entry_itor(&impl->jobs_urgent), tb_thread_pool_worker_walk_pull, worker);
-                }
-
-                // pull from the waiting jobs
-                if (tb_list_entry_size(&impl->jobs_waiting))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from waiting: %lu", worker->id, tb_list_entry_size(&impl->jobs_waiting));
-
-                    // pull it
-                    tb_remove_if_until(tb_list_entry_itor(&impl->jobs_waiting), tb_thread_pool_worker_walk_pull, worker);
-                }
-
-                // pull from the pending jobs and clean some finished and killed jobs
-                if (tb_list_entry_size(&impl->jobs_pending))
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: try pulling from pending: %lu", worker->id, tb_list_entry_size(&impl->jobs_pending));
-
-                    // no jobs? try to pull from the pending jobs
-                    if (!tb_vector_size(worker->jobs))
-                        tb_remove_if(tb_list_entry_itor(&impl->jobs_pending), tb_thread_pool_worker_walk_pull_and_clean, worker);
-                    // clean some finished and killed jobs
-                    else tb_remove_if(tb_list_entry_itor(&impl->jobs_pending), tb_thread_pool_worker_walk_clean, worker);
-                }
-
-                // leave 
-                tb_spinlock_leave(&impl->lock);
-
-                // idle? wait it
-                if (!tb_vector_size(worker->jobs))
-                {
-                    // killed?
-                    tb_check_break(!tb_atomic_get(&worker->bstoped));
-
-                    // trace
-                    tb_trace_d("worker[%lu]: wait: ..", worker->id);
-
-                    // wait some time
-                    tb_long_t wait = tb_semaphore_wait(impl->semaphore, -1);
-                    tb_assert_and_check_break(wait > 0);
-
-                    // trace
-                    tb_trace_d("worker[%lu]: wait: ok", worker->id);
-
-                    // continue it
-                    continue;
-                }
-                else
-                {
-#ifdef TB_TRACE_DEBUG
-                    // update the jobs urgent size
-                    tb_size_t jobs_urgent_size = tb_list_entry_size(&impl->jobs_urgent);
-
-                    // update the jobs waiting size
-                    tb_size_t jobs_waiting_size = tb_list_entry_size(&impl->jobs_waiting);
-
-                    // update the jobs pending size
-                    tb_size_t jobs_pending_size = tb_list_entry_size(&impl->jobs_pending);
-
-                    // trace
-                    tb_trace_d("worker[%lu]: pull: jobs: %lu, time: %lu ms, waiting: %lu, pending: %lu, urgent: %lu", worker->id, tb_vector_size(worker->jobs), worker->pull, jobs_waiting_size, jobs_pending_size, jobs_urgent_size);
-#endif
-                }
-            }
-
-            // done jobs
-            tb_for_all (tb_thread_pool_job_t*, job, worker->jobs)
+            /* is stoped? 
+             *
+             * we need read it before pulling jobs, 
+             * all jobs posted before killing will be pulled and killed
+             */
+            tb_bool_t stoped = (tb_bool_t)tb_atomic_get(&worker->bstoped);
+
+            // pull one job
+            tb_thread_pool_job_t* job = tb_thread_pool_worker_pull(worker);
+
+            // idle?
+            if (!job)
             {
-                // check
-                tb_assert_and_check_continue(job && job->task.done);
-
-                // the job state
-                tb_size_t state = tb_atomic_fetch_and_pset(&job->state, TB_STATE_WAITING, TB_STATE_WORKING);
-                
-                // the job is waiting? work it
-                if (state == TB_STATE_WAITING)
-                {
-                    // trace
-                    tb_trace_d("worker[%lu]: done: task[%p:%s]: ..", worker->id, job->task.done, job->task.name);
-
-                    // init the time
-                    tb_hong_t time = tb_cache_time_spak();
-
-                    // done the job
-                    job->task.done((tb_thread_pool_worker_ref_t)worker, job->task.priv);
-
-                    // computate the time
-                    time = tb_cache_time_spak() - time;
-
-                    // exists? update time and count
-                    tb_size_t               itor;
-                    tb_hash_map_item_ref_t  item = tb_null;
-                    if (    ((itor = tb_hash_map_find(worker->stats, job->task.done)) != tb_iterator_tail(worker->stats))
-                        &&  (item = (tb_hash_map_item_ref_t)tb_iterator_item(worker->stats, itor)))
-                    {
-                        // the stats
-                        tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)item->data;
-                        tb_assert_and_check_break(stats);
-
-                        // update the done count
-                        stats->done_count++;
-
-                        // update the total time 
-                        stats->total_time += time;
-                    }
-                    
-                    // no item? add it
-                    if (!item) 
-                    {
-                        // init stats
-                        tb_thread_pool_job_stats_t stats = {0};
-                        stats.done_count = 1;
-                        stats.total_time = time;
-
-                        // add stats
-                        tb_hash_map_insert(worker->stats, job->task.done, &stats);
-                    }
+                // free the finished jobs
+                tb_thread_pool_worker_free(worker);
 
-#ifdef TB_TRACE_DEBUG
-                    tb_size_t done_count = 0;
-                    tb_hize_t total_time = 0;
-                    tb_thread_pool_job_stats_t* stats = (tb_thread_pool_job_stats_t*)tb_hash_map_get(worker->stats, job->task.done);
-                    if (stats)
-                    {
-                        done_count = stats->done_count;
-                        total_time = stats->total_time;
-                    }
-
-                    // trace
-                    tb_trace_d("worker[%lu]: done: task[%p:%s]: time: %lld ms, average: %lld ms, count: %lu", worker->id, job->task.done, job->task.name, time, (total_time / (tb_hize_t)done_count), done_count);
-#endif
+                // killed?
+                tb_check_break(!stoped);
 
-                    // update the job state
-                    tb_atomic_set(&job->state, TB_STATE_FINISHED);
-                }
-                // the job is killing? work it
-                else if (state == TB_STATE_KILLING)
-                {
-                    // update the job state
-                    tb_atomic_set(&job->state, TB_STATE_KILLED);
-                }
+                // park it
+                tb_thread_pool_worker_park(worker);
+                continue;
             }
 
-            // clear jobs
-            tb_vector_clear(worker->jobs);
+            // done the job
+            tb_thread_pool_worker_done(worker, job);
         }
 
     } while (0);
@@ -613,8 +1000,19 @@ static tb_int_t tb_thread_pool_worker_loop(tb_cpointer_t priv)
         worker->stats = tb_null;
 
         // exit jobs
-        if (worker->jobs) tb_vector_exit(worker->jobs);
+        if (worker->jobs) 
+        {
+            tb_thread_pool_worker_free(worker);
+            tb_vector_exit(worker->jobs);
+        }
         worker->jobs = tb_null;
+
+        // clear the current worker
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+        s_worker_self = tb_null;
+#else
+        tb_thread_local_set(&s_worker_self, tb_null);
+#endif
     }
 
     // exit
@@ -630,6 +1028,9 @@ static tb_bool_t tb_thread_pool_jobs_walk_kill_all(tb_pointer_t item, tb_cpointe
     tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
     tb_assert_and_check_return_val(job, tb_false);
 
+    // only kill the jobs of the given group
+    tb_check_return_val(!priv || job->group == (tb_thread_pool_group_t*)priv, tb_true);
+
     // trace
     tb_trace_d("task[%p:%s]: kill: ..", job->task.done, job->task.name);
 
@@ -646,27 +1047,17 @@ static tb_bool_t tb_thread_pool_jobs_walk_dump_all(tb_pointer_t item, tb_cpointe
     tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)item;
     tb_assert_and_check_return_val(job, tb_false);
 
-    // the state string
-    static tb_char_t const* s_state_cstr[] = 
-    {
-        "waiting"
-    ,   "working"
-    ,   "killed"
-    ,   "finished"
-    };
-    tb_assert_and_check_return_val(job->state < tb_arrayn(s_state_cstr), tb_false);
-
     // trace
-    tb_trace_d("    task[%p:%s]: refn: %lu, state: %s", job->task.done, job->task.name, job->refn, s_state_cstr[job->state]);
+    tb_trace_d("    task[%p:%s]: refn: %lu, state: %s", job->task.done, job->task.name, job->refn, tb_state_cstr(tb_atomic_get(&job->state)));
 
     // ok
     return tb_true;
 }
 #endif
-static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t* impl, tb_thread_pool_task_t const* task, tb_size_t* post_size)
+static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t* impl, tb_thread_pool_task_t const* task, tb_size_t refn, tb_thread_pool_group_t* group, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size, tb_size_t* post_size)
 {
     // check
-    tb_assert_and_check_return_val(impl && task && task->done && post_size, tb_null);
+    tb_assert_and_check_return_val(impl && task && task->done && refn && post_size && (deps || !deps_size), tb_null);
 
     // done
     tb_bool_t               ok = tb_false;
@@ -674,44 +1065,116 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
     do
     {
         // check
-        tb_assert_and_check_break(tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent) + 1 < TB_THREAD_POOL_JOBS_WAITING_MAXN);
+        tb_assert_and_check_break(tb_fixed_pool_size(impl->jobs_pool) + 1 < TB_THREAD_POOL_JOBS_WAITING_MAXN);
 
         // make job
         job = (tb_thread_pool_job_t*)tb_fixed_pool_malloc0(impl->jobs_pool);
         tb_assert_and_check_break(job);
 
-        // init job
-        job->refn   = 1;
+        // init job, the reference count must be inited before it can be pulled by the workers
+        job->refn   = refn;
         job->state  = TB_STATE_WAITING;
         job->task   = *task;
 
-        // non-urgent job? 
-        if (!task->urgent)
+        // enter the group
+        if (group)
         {
-            // post to the waiting jobs
-            tb_list_entry_insert_tail(&impl->jobs_waiting, &job->entry);
+            tb_atomic_fetch_and_inc(&group->refn);
+            tb_atomic_fetch_and_inc(&group->size);
+            job->group = group;
         }
-        else
+
+        // depend on the given jobs
+        if (deps_size)
+        {
+            // init the links to the dependencies
+            job->links_data = tb_nalloc0_type(deps_size, tb_thread_pool_job_link_t);
+            tb_assert_and_check_break(job->links_data);
+
+            // hold one dependency until all links are added
+            job->deps = deps_size + 1;
+
+            // add links
+            tb_size_t i = 0;
+            for (i = 0; i < deps_size; i++)
+            {
+                // the dependency
+                tb_thread_pool_job_t* dep = (tb_thread_pool_job_t*)deps[i];
+                tb_assert(dep);
+
+                // no dependency? ignore it
+                if (!dep)
+                {
+                    tb_atomic_fetch_and_dec(&job->deps);
+                    continue;
+                }
+
+                // the link
+                tb_thread_pool_job_link_t* link = &job->links_data[i];
+                link->job = job;
+
+                // add it to the links of the dependency if it has been not completed
+                tb_long_t links = 0;
+                do
+                {
+                    links = tb_atomic_get(&dep->links);
+                    link->next = (tb_thread_pool_job_link_t*)links;
+
+                } while (links != TB_THREAD_POOL_JOB_LINKS_SEALED && tb_atomic_fetch_and_pset(&dep->links, links, (tb_long_t)link) != links);
+
+                // it has been completed?
+                if (links == TB_THREAD_POOL_JOB_LINKS_SEALED)
+                {
+                    // kill it too if the dependency has been killed
+                    if (tb_atomic_get(&dep->state) == TB_STATE_KILLED) 
+                        tb_atomic_pset(&job->state, TB_STATE_WAITING, TB_STATE_KILLING);
+
+                    // this dependency is completed
+                    tb_atomic_fetch_and_dec(&job->deps);
+                }
+            }
+        }
+
+        // the current worker of this pool
+        tb_thread_pool_worker_t* self = tb_thread_pool_worker_self(impl);
+
+        // wait the dependencies? it will be posted after all dependencies are completed
+        if (deps_size && tb_atomic_fetch_and_dec(&job->deps) != 1)
+        {
+            // trace
+            tb_trace_d("task[%p:%s]: wait %ld dependencies", task->done, task->name, (tb_long_t)job->deps);
+        }
+        // urgent job? post to the urgent jobs
+        else if (task->urgent)
         {
-            // post to the urgent jobs
             tb_list_entry_insert_tail(&impl->jobs_urgent, &job->entry);
+            tb_atomic_fetch_and_inc(&impl->jobs_urgent_size);
+        }
+        /* post to the deque of the current worker, 
+         * or post to the waiting jobs if be posted from the non-worker thread or the deque is full
+         */
+        else if (!self || !tb_thread_pool_deque_push(self->deque, job))
+        {
+            tb_list_entry_insert_tail(&impl->jobs_waiting, &job->entry);
+            tb_atomic_fetch_and_inc(&impl->jobs_waiting_size);
         }
 
-        // the waiting jobs count
-        tb_size_t jobs_waiting_count = tb_list_entry_size(&impl->jobs_waiting) + tb_list_entry_size(&impl->jobs_urgent);
-        tb_assert_and_check_break(jobs_waiting_count);
+        // the jobs count
+        tb_size_t jobs_count = tb_fixed_pool_size(impl->jobs_pool);
+        tb_assert_and_check_break(jobs_count);
 
         // update the post size
-        if (*post_size < impl->worker_size) (*post_size)++;
+        if (*post_size < impl->worker_maxn) (*post_size)++;
 
         // trace
         tb_trace_d("task[%p:%s]: post: %lu: ..", task->done, task->name, *post_size);
 
         // init them if the workers have been not inited
-        if (impl->worker_size < jobs_waiting_count)
+        tb_size_t worker_size = (tb_size_t)impl->worker_size;
+        if (worker_size < jobs_count)
         {
-            tb_size_t i = impl->worker_size;
-            tb_size_t n = tb_min(jobs_waiting_count, impl->worker_maxn);
+            tb_size_t i = worker_size;
+            tb_size_t n = tb_min(jobs_count, impl->worker_maxn);
             for (; i < n; i++)
             {
                 // the worker 
@@ -722,13 +1185,15 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
 
                 // init worker
                 worker->id          = i;
-                worker->pool        = (tb_thread_pool_ref_t)impl;
+                worker->pool        = impl;
+                worker->steal       = i + 1;
+                worker->node        = tb_thread_pool_worker_node(impl, i);
                 worker->loop        = tb_thread_init(__tb_lstring__("thread_pool"), tb_thread_pool_worker_loop, worker, impl->stack);
                 tb_assert_and_check_continue(worker->loop);
             }
 
-            // update the worker size
-            impl->worker_size = i;
+            // update the worker size, the other workers will steal jobs from the new workers after it
+            tb_atomic_set(&impl->worker_size, i);
         }
 
         // ok
@@ -740,7 +1205,16 @@ static tb_thread_pool_job_t* tb_thread_pool_jobs_post_task(tb_thread_pool_impl_t
     if (!ok)
     {
         // exit it
-        tb_fixed_pool_free(impl->jobs_pool, job);
+        if (job) 
+        {
+            // leave the group
+            if (job->group)
+            {
+                tb_atomic_fetch_and_dec(&job->group->size);
+                tb_atomic_fetch_and_dec(&job->group->refn);
+            }
+            tb_thread_pool_jobs_free(impl, job);
+        }
         job = tb_null;
     }
 
@@ -778,7 +1252,7 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
 
         // init workers
         impl->worker_size   = 0;
-        impl->worker_maxn   = worker_maxn;
+        impl->worker_maxn   = tb_min(worker_maxn, TB_THREAD_POOL_WORKER_MAXN);
 
         // init jobs pool
         impl->jobs_pool     = tb_fixed_pool_init(tb_null, TB_THREAD_POOL_JOBS_POOL_GROW, sizeof(tb_thread_pool_job_t), tb_null, tb_null, tb_null);
@@ -790,12 +1264,11 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
         // init jobs waiting
         tb_list_entry_init(&impl->jobs_waiting, tb_thread_pool_job_t, entry, tb_null);
 
-        // init jobs pending
-        tb_list_entry_init(&impl->jobs_pending, tb_thread_pool_job_t, entry, tb_null);
-
+#ifndef TB_FUTEX_ENABLE
         // init semaphore
         impl->semaphore = tb_semaphore_init(0);
         tb_assert_and_check_break(impl->semaphore);
+#endif
 
         // register lock profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
@@ -818,6 +1291,25 @@ tb_thread_pool_ref_t tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack)
     // ok?
     return (tb_thread_pool_ref_t)impl;
 }
+tb_thread_pool_ref_t tb_thread_pool_init_pinned(tb_size_t stack)
+{
+    // get the physical cores count
+    tb_processor_topology_t const* topology = tb_processor_topology();
+    tb_assert_and_check_return_val(topology && topology->cores_count, tb_null);
+
+    // init pool with one worker per physical core
+    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)tb_thread_pool_init(topology->cores_count, stack);
+    tb_assert_and_check_return_val(impl, tb_null);
+
+    // pin all workers, they have been not started now
+    impl->pinned = tb_true;
+
+    // trace
+    tb_trace_d("init: pinned: %lu workers on %lu nodes", impl->worker_maxn, topology->nodes_count);
+
+    // ok
+    return (tb_thread_pool_ref_t)impl;
+}
 tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
 {
     // check
@@ -842,7 +1334,7 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
      * need not lock it because the worker size will not be increase d
      */
     tb_size_t i = 0;
-    tb_size_t n = impl->worker_size;
+    tb_size_t n = (tb_size_t)impl->worker_size;
     for (i = 0; i < n; i++) 
     {
         // the worker
@@ -863,15 +1355,16 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
             tb_thread_exit(worker->loop);
             worker->loop = tb_null;
         }
+
+        // exit the jobs deque after the worker thread has been exited, the thieves may access it before it
+        if (worker->deque) tb_free(worker->deque);
+        worker->deque = tb_null;
     }
     impl->worker_size = 0;
 
     // enter
     tb_spinlock_enter(&impl->lock);
 
-    // exit pending jobs
-    tb_list_entry_exit(&impl->jobs_pending);
-
     // exit waiting jobs
     tb_list_entry_exit(&impl->jobs_waiting);
 
@@ -888,9 +1381,11 @@ tb_bool_t tb_thread_pool_exit(tb_thread_pool_ref_t pool)
     // exit lock
     tb_spinlock_exit(&impl->lock);
 
+#ifndef TB_FUTEX_ENABLE
     // exit semaphore
     if (impl->semaphore) tb_semaphore_exit(impl->semaphore);
     impl->semaphore = tb_null;
+#endif
 
     // exit it
     tb_free(impl);
@@ -922,21 +1417,21 @@ tb_void_t tb_thread_pool_kill(tb_thread_pool_ref_t pool)
         
         // kill all workers
         tb_size_t i = 0;
-        tb_size_t n = impl->worker_size;
+        tb_size_t n = (tb_size_t)impl->worker_size;
         for (i = 0; i < n; i++) tb_atomic_set(&impl->worker_list[i].bstoped, 1);
 
         // kill all jobs
         if (impl->jobs_pool) tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_kill_all, tb_null);
 
         // post it
-        post = impl->worker_size;
+        post = n;
     }
 
     // leave
     tb_spinlock_leave(&impl->lock);
 
-    // post the workers
-    if (post) tb_thread_pool_worker_post(impl, post);
+    // wake up all workers
+    if (post) tb_thread_pool_worker_wake(impl, post, tb_true);
 }
 tb_size_t tb_thread_pool_worker_size(tb_thread_pool_ref_t pool)
 {
@@ -948,7 +1443,7 @@ tb_size_t tb_thread_pool_worker_size(tb_thread_pool_ref_t pool)
     tb_spinlock_enter(&impl->lock);
 
     // the worker size
-    tb_size_t worker_size = impl->worker_size;
+    tb_size_t worker_size = (tb_size_t)impl->worker_size;
 
     // leave
     tb_spinlock_leave(&impl->lock);
@@ -1021,7 +1516,7 @@ tb_bool_t tb_thread_pool_task_post(tb_thread_pool_ref_t pool, tb_char_t const* n
         task.urgent     = urgent;
 
         // post task
-        tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &task, &post_size);
+        tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &task, 1, tb_null, tb_null, 0, &post_size);
         tb_assert_and_check_break(job);
 
         // ok
@@ -1032,8 +1527,8 @@ tb_bool_t tb_thread_pool_task_post(tb_thread_pool_ref_t pool, tb_char_t const* n
     // leave
     tb_spinlock_leave(&impl->lock);
 
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
+    // wake up the idle workers
+    if (ok && post_size) tb_thread_pool_worker_wake(impl, post_size, tb_false);
 
     // ok?
     return ok;
@@ -1057,7 +1552,7 @@ tb_size_t tb_thread_pool_task_post_list(tb_thread_pool_ref_t pool, tb_thread_poo
         for (ok = 0; ok < size; ok++)
         {
             // post task
-            tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &list[ok], &post_size);
+            tb_thread_pool_job_t* job = tb_thread_pool_jobs_post_task(impl, &list[ok], 1, tb_null, tb_null, 0, &post_size);
             tb_assert_and_check_break(job);
         }
     }
@@ -1065,8 +1560,8 @@ tb_size_t tb_thread_pool_task_post_list(tb_thread_pool_ref_t pool, tb_thread_poo
     // leave
     tb_spinlock_leave(&impl->lock);
 
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
+    // wake up the idle workers
+    if (ok && post_size) tb_thread_pool_worker_wake(impl, post_size, tb_false);
 
     // ok?
     return ok;
@@ -1099,13 +1594,10 @@ tb_thread_pool_task_ref_t tb_thread_pool_task_init(tb_thread_pool_ref_t pool, tb
         task.priv       = priv;
         task.urgent     = urgent;
 
-        // post task
-        job = tb_thread_pool_jobs_post_task(impl, &task, &post_size);
+        // post task, it is referenced by the task handle too
+        job = tb_thread_pool_jobs_post_task(impl, &task, 2, tb_null, tb_null, 0, &post_size);
         tb_assert_and_check_break(job);
 
-        // refn++
-        job->refn++;
-
         // ok
         ok = tb_true;
 
@@ -1114,8 +1606,8 @@ tb_thread_pool_task_ref_t tb_thread_pool_task_init(tb_thread_pool_ref_t pool, tb
     // leave
     tb_spinlock_leave(&impl->lock);
 
-    // post the workers
-    if (ok && post_size) tb_thread_pool_worker_post(impl, post_size);
+    // wake up the idle workers
+    if (ok && post_size) tb_thread_pool_worker_wake(impl, post_size, tb_false);
     // failed?
     else if (!ok) job = tb_null;
 
@@ -1156,6 +1648,9 @@ tb_long_t tb_thread_pool_task_wait(tb_thread_pool_ref_t pool, tb_thread_pool_tas
     tb_thread_pool_job_t* job = (tb_thread_pool_job_t*)task;
     tb_assert_and_check_return_val(pool && job, -1);
 
+    // the current worker of this pool
+    tb_thread_pool_worker_t* self = tb_thread_pool_worker_self((tb_thread_pool_impl_t*)pool);
+
     // wait it
     tb_hong_t time = tb_cache_time_spak();
     tb_size_t state = TB_STATE_WAITING;
@@ -1166,8 +1661,8 @@ tb_long_t tb_thread_pool_task_wait(tb_thread_pool_ref_t pool, tb_thread_pool_tas
         // trace
         tb_trace_d("task[%p:%s]: wait: state: %s: ..", job->task.done, job->task.name, tb_state_cstr(state));
 
-        // wait some time
-        tb_msleep(200);
+        // help the other jobs if it is waited in the worker, or wait some time
+        if (!self || !tb_thread_pool_worker_help(self)) tb_msleep(self? 1 : 200);
     }
 
     // ok?
@@ -1191,18 +1686,11 @@ tb_long_t tb_thread_pool_task_wait_all(tb_thread_pool_ref_t pool, tb_long_t time
         size = impl->jobs_pool? tb_fixed_pool_size(impl->jobs_pool) : 0;
 
         // trace
-        tb_trace_d("wait: jobs: %lu, waiting: %lu, pending: %lu, urgent: %lu: .."
+        tb_trace_d("wait: jobs: %lu, waiting: %lu, urgent: %lu, idle: %ld: .."
                     , size
                     , tb_list_entry_size(&impl->jobs_waiting)
-                    , tb_list_entry_size(&impl->jobs_pending) 
-                    , tb_list_entry_size(&impl->jobs_urgent));
-
-#if 0
-        tb_for_all_if (tb_thread_pool_job_t*, job, tb_list_entry_itor(&impl->jobs_pending), job)
-        {
-            tb_trace_d("wait: job: %s from pending", tb_state_cstr(tb_atomic_get(&job->state)));
-        }
-#endif
+                    , tb_list_entry_size(&impl->jobs_urgent)
+                    , (tb_long_t)impl->idle_size);
 
         // leave
         tb_spinlock_leave(&impl->lock);
@@ -1227,17 +1715,242 @@ tb_void_t tb_thread_pool_task_exit(tb_thread_pool_ref_t pool, tb_thread_pool_tas
     // kill it first
     tb_thread_pool_task_kill(pool, task);
 
+    // detach it
+    tb_thread_pool_task_detach(pool, task);
+}
+tb_void_t tb_thread_pool_task_detach(tb_thread_pool_ref_t pool, tb_thread_pool_task_ref_t task)
+{
+    // check
+    tb_thread_pool_impl_t*  impl = (tb_thread_pool_impl_t*)pool;
+    tb_thread_pool_job_t*   job = (tb_thread_pool_job_t*)task;
+    tb_assert_and_check_return(impl && job);
+
+    // refn--, remove it from pool directly if it has been done by the worker
+    if (tb_atomic_fetch_and_dec(&job->refn) == 1)
+    {
+        // enter
+        tb_spinlock_enter(&impl->lock);
+
+        // remove it from pool directly
+        tb_thread_pool_jobs_free(impl, job);
+
+        // leave
+        tb_spinlock_leave(&impl->lock);
+    }
+}
+tb_thread_pool_task_ref_t tb_thread_pool_task_init_after(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size)
+{
+    // check
+    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
+    tb_assert_and_check_return_val(impl && done && (deps || !deps_size), tb_null);
+
+    // init the post size
+    tb_size_t post_size = 0;
+
+    // enter
+    tb_spinlock_enter(&impl->lock);
+
+    // done
+    tb_thread_pool_job_t* job = tb_null;
+    if (!impl->bstoped)
+    {
+        // init task
+        tb_thread_pool_task_t task = {0};
+        task.name       = name;
+        task.done       = done;
+        task.exit       = exit;
+        task.priv       = priv;
+        task.urgent     = urgent;
+
+        // post task after the dependencies, it is referenced by the task handle too
+        job = tb_thread_pool_jobs_post_task(impl, &task, 2, tb_null, deps, deps_size, &post_size);
+    }
+
+    // leave
+    tb_spinlock_leave(&impl->lock);
+
+    // wake up the idle workers
+    if (job && post_size) tb_thread_pool_worker_wake(impl, post_size, tb_false);
+
+    // ok?
+    return (tb_thread_pool_task_ref_t)job;
+}
+tb_bool_t tb_thread_pool_task_post_after(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size)
+{
+    // init task after the dependencies
+    tb_thread_pool_task_ref_t task = tb_thread_pool_task_init_after(pool, name, done, exit, priv, urgent, deps, deps_size);
+    tb_check_return_val(task, tb_false);
+
+    // detach it
+    tb_thread_pool_task_detach(pool, task);
+
+    // ok
+    return tb_true;
+}
+tb_thread_pool_group_ref_t tb_thread_pool_group_init(tb_thread_pool_ref_t pool)
+{
+    // check
+    tb_thread_pool_impl_t* impl = (tb_thread_pool_impl_t*)pool;
+    tb_assert_and_check_return_val(impl, tb_null);
+
+    // done
+    tb_bool_t               ok = tb_false;
+    tb_thread_pool_group_t* group = tb_null;
+    do
+    {
+        // make group
+        group = tb_malloc0_type(tb_thread_pool_group_t);
+        tb_assert_and_check_break(group);
+
+        // init group, it is referenced by the group handle
+        group->pool = impl;
+        group->refn = 1;
+
+        // init event
+        group->event = tb_event_init();
+        tb_assert_and_check_break(group->event);
+
+        // ok
+        ok = tb_true;
+
+    } while (0);
+
+    // failed?
+    if (!ok)
+    {
+        // exit it
+        if (group) tb_thread_pool_group_release(group);
+        group = tb_null;
+    }
+
+    // ok?
+    return (tb_thread_pool_group_ref_t)group;
+}
+tb_void_t tb_thread_pool_group_exit(tb_thread_pool_group_ref_t group)
+{
+    // check
+    tb_thread_pool_group_t* group_impl = (tb_thread_pool_group_t*)group;
+    tb_assert_and_check_return(group_impl);
+
+    // kill all waiting tasks of this group
+    tb_thread_pool_group_kill(group);
+
+    // release it, it will be freed after all tasks of this group are completed
+    tb_thread_pool_group_release(group_impl);
+}
+tb_size_t tb_thread_pool_group_size(tb_thread_pool_group_ref_t group)
+{
+    // check
+    tb_thread_pool_group_t* group_impl = (tb_thread_pool_group_t*)group;
+    tb_assert_and_check_return_val(group_impl, 0);
+
+    // the unfinished tasks count
+    return (tb_size_t)tb_atomic_get(&group_impl->size);
+}
+tb_bool_t tb_thread_pool_group_post(tb_thread_pool_group_ref_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size)
+{
+    // init task of this group
+    tb_thread_pool_task_ref_t task = tb_thread_pool_group_task_init(group, name, done, exit, priv, urgent, deps, deps_size);
+    tb_check_return_val(task, tb_false);
+
+    // detach it
+    tb_thread_pool_task_detach((tb_thread_pool_ref_t)((tb_thread_pool_group_t*)group)->pool, task);
+
+    // ok
+    return tb_true;
+}
+tb_thread_pool_task_ref_t tb_thread_pool_group_task_init(tb_thread_pool_group_ref_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size)
+{
+    // check
+    tb_thread_pool_group_t* group_impl = (tb_thread_pool_group_t*)group;
+    tb_assert_and_check_return_val(group_impl && group_impl->pool && done && (deps || !deps_size), tb_null);
+
+    // the pool
+    tb_thread_pool_impl_t* impl = group_impl->pool;
+
+    // init the post size
+    tb_size_t post_size = 0;
+
+    // enter
+    tb_spinlock_enter(&impl->lock);
+
+    // done
+    tb_thread_pool_job_t* job = tb_null;
+    if (!impl->bstoped)
+    {
+        // init task
+        tb_thread_pool_task_t task = {0};
+        task.name       = name;
+        task.done       = done;
+        task.exit       = exit;
+        task.priv       = priv;
+        task.urgent     = urgent;
+
+        // post task to this group, it is referenced by the task handle too
+        job = tb_thread_pool_jobs_post_task(impl, &task, 2, group_impl, deps, deps_size, &post_size);
+    }
+
+    // leave
+    tb_spinlock_leave(&impl->lock);
+
+    // wake up the idle workers
+    if (job && post_size) tb_thread_pool_worker_wake(impl, post_size, tb_false);
+
+    // ok?
+    return (tb_thread_pool_task_ref_t)job;
+}
+tb_void_t tb_thread_pool_group_kill(tb_thread_pool_group_ref_t group)
+{
+    // check
+    tb_thread_pool_group_t* group_impl = (tb_thread_pool_group_t*)group;
+    tb_assert_and_check_return(group_impl && group_impl->pool);
+
+    // the pool
+    tb_thread_pool_impl_t* impl = group_impl->pool;
+
     // enter
     tb_spinlock_enter(&impl->lock);
 
-    // refn--
-    if (job->refn > 1) job->refn--;
-    // remove it from pool directly
-    else tb_fixed_pool_free(impl->jobs_pool, job);
+    // kill all jobs of this group
+    if (impl->jobs_pool) tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_kill_all, group_impl);
 
     // leave
     tb_spinlock_leave(&impl->lock);
 }
+tb_long_t tb_thread_pool_group_wait(tb_thread_pool_group_ref_t group, tb_long_t timeout)
+{
+    // check
+    tb_thread_pool_group_t* group_impl = (tb_thread_pool_group_t*)group;
+    tb_assert_and_check_return_val(group_impl && group_impl->pool && group_impl->event, -1);
+
+    // the current worker of this pool
+    tb_thread_pool_worker_t* self = tb_thread_pool_worker_self(group_impl->pool);
+
+    // wait it
+    tb_long_t wait = 0;
+    tb_hong_t time = tb_cache_time_spak();
+    while (tb_atomic_get(&group_impl->size))
+    {
+        // the left time
+        tb_long_t left = -1;
+        if (timeout >= 0)
+        {
+            tb_hong_t now = tb_cache_time_spak();
+            tb_check_break(now < time + timeout);
+            left = (tb_long_t)(time + timeout - now);
+        }
+
+        // help the other jobs if it is waited in the worker
+        if (self && tb_thread_pool_worker_help(self)) continue;
+
+        // wait the last task of this group, only wait a moment in the worker for helping the new jobs
+        wait = tb_event_wait(group_impl->event, self && (left < 0 || left > 1)? 1 : left);
+        tb_assert_and_check_break(wait >= 0);
+    }
+
+    // ok?
+    return wait >= 0? (!tb_atomic_get(&group_impl->size)? 1 : 0) : -1;
+}
 #ifdef __tb_debug__
 tb_void_t tb_thread_pool_dump(tb_thread_pool_ref_t pool)
 {
@@ -1253,18 +1966,18 @@ tb_void_t tb_thread_pool_dump(tb_thread_pool_ref_t pool)
     {
         // trace
         tb_trace_i("");
-        tb_trace_i("workers: size: %lu, maxn: %lu", impl->worker_size, impl->worker_maxn);
+        tb_trace_i("workers: size: %lu, maxn: %lu, idle: %ld", (tb_size_t)impl->worker_size, impl->worker_maxn, (tb_long_t)impl->idle_size);
 
         // walk
         tb_size_t i = 0;
-        for (i = 0; i < impl->worker_size; i++)
+        for (i = 0; i < (tb_size_t)impl->worker_size; i++)
         {
             // the worker
             tb_thread_pool_worker_t* worker = &impl->worker_list[i];
             tb_assert_and_check_break(worker);
 
             // dump worker
-            tb_trace_i("    worker: id: %lu, stoped: %ld", worker->id, (tb_long_t)tb_atomic_get(&worker->bstoped));
+            tb_trace_i("    worker: id: %lu, stoped: %ld, deque: %lu", worker->id, (tb_long_t)tb_atomic_get(&worker->bstoped), worker->deque? tb_thread_pool_deque_size(worker->deque) : 0);
         }
 
         // trace
@@ -1274,7 +1987,7 @@ tb_void_t tb_thread_pool_dump(tb_thread_pool_ref_t pool)
         if (impl->jobs_pool) 
         {
             // trace
-            tb_trace_i("jobs: size: %lu", tb_fixed_pool_size(impl->jobs_pool));
+            tb_trace_i("jobs: size: %lu, waiting: %lu, urgent: %lu", tb_fixed_pool_size(impl->jobs_pool), tb_list_entry_size(&impl->jobs_waiting), tb_list_entry_size(&impl->jobs_urgent));
 
             // dump jobs
             tb_fixed_pool_walk(impl->jobs_pool, tb_thread_pool_jobs_walk_dump_all, tb_null);
@@ -60,6 +60,9 @@ typedef __tb_typeref__(thread_pool_task);
 /// the thread pool worker ref type
 typedef __tb_typeref__(thread_pool_worker);
 
+/// the thread pool group ref type
+typedef __tb_typeref__(thread_pool_group);
+
 /// the thread pool priv exit func type
 typedef tb_void_t                       (*tb_thread_pool_priv_exit_func_t)(tb_thread_pool_worker_ref_t worker, tb_cpointer_t priv);
 
@@ -108,6 +111,18 @@ tb_thread_pool_ref_t        tb_thread_pool(tb_noarg_t);
  */
 tb_thread_pool_ref_t        tb_thread_pool_init(tb_size_t worker_maxn, tb_size_t stack);
 
+/*! init thread pool with one pinned worker per physical core
+ *
+ * each worker is pinned to the smt siblings of its physical core and allocates 
+ * its jobs deque on the local numa node, the idle worker steals jobs from 
+ * the workers on the same node before the other nodes.
+ *
+ * @param stack             the thread stack, using the default stack size if be zero 
+ *
+ * @return                  the thread pool 
+ */
+tb_thread_pool_ref_t        tb_thread_pool_init_pinned(tb_size_t stack);
+
 /*! exit thread pool
  *
  * @param pool              the thread pool 
@@ -157,13 +172,16 @@ tb_cpointer_t               tb_thread_pool_worker_getp(tb_thread_pool_worker_ref
 tb_size_t                   tb_thread_pool_task_size(tb_thread_pool_ref_t pool);
 
 /*! post one task
+ *
+ * the task posted from the worker of this pool will be pushed to the deque of this worker first,
+ * and the other idle workers will steal it if this worker is busy.
  *
  * @param pool              the thread pool 
  * @param name              the task name, optional
  * @param done              the task done func
  * @param exit              the task exit func, optional
  * @param priv              the task private data
- * @param urgent            is urgent task?
+ * @param urgent            is urgent task? all workers will pull the urgent tasks first
  *
  * @return                  tb_true or tb_false
  */
@@ -206,6 +224,8 @@ tb_void_t                   tb_thread_pool_task_kill(tb_thread_pool_ref_t pool,
 tb_void_t                   tb_thread_pool_task_kill_all(tb_thread_pool_ref_t pool);
 
 /*! wait one task 
+ *
+ * it will help to do the other tasks if it is called in the worker of this pool.
  *
  * @param pool              the thread pool 
  * @param task              the thread pool task 
@@ -224,13 +244,142 @@ tb_long_t                   tb_thread_pool_task_wait(tb_thread_pool_ref_t pool,
  */
 tb_long_t                   tb_thread_pool_task_wait_all(tb_thread_pool_ref_t pool, tb_long_t timeout);
 
-/*! exit the task
+/*! exit the task, it will be killed if be waiting
  *
  * @param pool              the thread pool 
  * @param task              the thread pool task 
  */
 tb_void_t                   tb_thread_pool_task_exit(tb_thread_pool_ref_t pool, tb_thread_pool_task_ref_t task);
 
+/*! detach the task handle, the task will be not killed and it will be freed after it is done
+ *
+ * @param pool              the thread pool 
+ * @param task              the thread pool task 
+ */
+tb_void_t                   tb_thread_pool_task_detach(tb_thread_pool_ref_t pool, tb_thread_pool_task_ref_t task);
+
+/*! init one task which will be posted after all dependencies are done
+ *
+ * the task will be released to the worker which has done the last dependency, 
+ * and it will be killed if one of the dependencies has been killed.
+ *
+ * @code
+    // run c after a and b
+    tb_thread_pool_task_ref_t deps[2];
+    deps[0] = tb_thread_pool_task_init(pool, "a", tb_demo_a, tb_null, tb_null, tb_false);
+    deps[1] = tb_thread_pool_task_init(pool, "b", tb_demo_b, tb_null, tb_null, tb_false);
+    tb_thread_pool_task_ref_t c = tb_thread_pool_task_init_after(pool, "c", tb_demo_c, tb_null, tb_null, tb_false, deps, 2);
+
+    // we need not the handles of the dependencies now
+    tb_thread_pool_task_detach(pool, deps[0]);
+    tb_thread_pool_task_detach(pool, deps[1]);
+
+    // wait c
+    tb_thread_pool_task_wait(pool, c, -1);
+    tb_thread_pool_task_exit(pool, c);
+ * @endcode
+ *
+ * @param pool              the thread pool 
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param urgent            is urgent task?
+ * @param deps              the dependencies, they must be the valid task handles of this pool
+ * @param deps_size         the dependencies count
+ *
+ * @return                  the thread pool task
+ */
+tb_thread_pool_task_ref_t   tb_thread_pool_task_init_after(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size);
+
+/*! post one task which will be posted after all dependencies are done
+ *
+ * @param pool              the thread pool 
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param urgent            is urgent task?
+ * @param deps              the dependencies, they must be the valid task handles of this pool
+ * @param deps_size         the dependencies count
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_thread_pool_task_post_after(tb_thread_pool_ref_t pool, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size);
+
+/*! init the task group
+ *
+ * @param pool              the thread pool 
+ *
+ * @return                  the task group
+ */
+tb_thread_pool_group_ref_t  tb_thread_pool_group_init(tb_thread_pool_ref_t pool);
+
+/*! exit the task group, it must be exited before exiting the thread pool
+ *
+ * the waiting tasks of this group will be killed, 
+ * and the group will be freed after all tasks of this group are completed.
+ *
+ * @param group             the task group
+ */
+tb_void_t                   tb_thread_pool_group_exit(tb_thread_pool_group_ref_t group);
+
+/*! the unfinished tasks count of the group
+ *
+ * @param group             the task group
+ *
+ * @return                  the unfinished tasks count
+ */
+tb_size_t                   tb_thread_pool_group_size(tb_thread_pool_group_ref_t group);
+
+/*! post one task to the group
+ *
+ * @param group             the task group
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param urgent            is urgent task?
+ * @param deps              the dependencies, optional
+ * @param deps_size         the dependencies count
+ *
+ * @return                  tb_true or tb_false
+ */
+tb_bool_t                   tb_thread_pool_group_post(tb_thread_pool_group_ref_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size);
+
+/*! init one task of the group
+ *
+ * @param group             the task group
+ * @param name              the task name, optional
+ * @param done              the task done func
+ * @param exit              the task exit func, optional
+ * @param priv              the task private data
+ * @param urgent            is urgent task?
+ * @param deps              the dependencies, optional
+ * @param deps_size         the dependencies count
+ *
+ * @return                  the thread pool task
+ */
+tb_thread_pool_task_ref_t   tb_thread_pool_group_task_init(tb_thread_pool_group_ref_t group, tb_char_t const* name, tb_thread_pool_task_done_func_t done, tb_thread_pool_task_exit_func_t exit, tb_cpointer_t priv, tb_bool_t urgent, tb_thread_pool_task_ref_t const* deps, tb_size_t deps_size);
+
+/*! kill all waiting tasks of the group
+ *
+ * @param group             the task group
+ */
+tb_void_t                   tb_thread_pool_group_kill(tb_thread_pool_group_ref_t group);
+
+/*! wait all tasks of the group
+ *
+ * it only waits the tasks of this group, 
+ * and it will help to do the other tasks if it is called in the worker of this pool.
+ *
+ * @param group             the task group
+ * @param timeout           the timeout
+ *
+ * @return                  ok: 1, timeout: 0, error: -1
+ */
+tb_long_t                   tb_thread_pool_group_wait(tb_thread_pool_group_ref_t group, tb_long_t timeout);
+
 #ifdef __tb_debug__
 /*! dump the thread pool
  *
@@ -70,6 +70,18 @@ tb_hong_t       tb_mclock(tb_noarg_t);
  */
 tb_hong_t       tb_uclock(tb_noarg_t);
 
+/*! the monotonic clock, ns
+ *
+ * it reads the calibrated invariant tsc if be supported and trusted by the system,
+ * otherwise it uses the monotonic clock of the system.
+ *
+ * it is fast enough for timestamping each request or wait, 
+ * but it should only be used to measure the intervals.
+ *
+ * @return      the nclock
+ */
+tb_hong_t       tb_clock_ns(tb_noarg_t);
+
 /*! get the time from 1970-01-01 00:00:00:000
  *
  * @param tv    the timeval
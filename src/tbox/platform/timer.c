@@ -39,6 +39,40 @@
 #include "../algorithm/algorithm.h"
 #include "../utils/utils.h"
 
+/* //////////////////////////////////////////////////////////////////////////////////////
+ * macros
+ */
+
+// the bits of the first wheel (1ms per slot)
+#define TB_TIMER_WHEEL_BITS0                (8)
+
+// the bits of the higher wheels
+#define TB_TIMER_WHEEL_BITSN                (6)
+
+// the levels of the wheels, (8 + 6 * 4) bits => 2^32 ms => ~49 days
+#define TB_TIMER_WHEEL_LEVELS               (5)
+
+// the slots of the first wheel
+#define TB_TIMER_WHEEL_SLOTS0               (1 << TB_TIMER_WHEEL_BITS0)
+
+// the slots of the higher wheels
+#define TB_TIMER_WHEEL_SLOTSN               (1 << TB_TIMER_WHEEL_BITSN)
+
+// the slots of all wheels
+#define TB_TIMER_WHEEL_MAXN                 (TB_TIMER_WHEEL_SLOTS0 + (TB_TIMER_WHEEL_LEVELS - 1) * TB_TIMER_WHEEL_SLOTSN)
+
+// the maximum range of all wheels
+#define TB_TIMER_WHEEL_RANGE                (((tb_hong_t)1 << (TB_TIMER_WHEEL_BITS0 + (TB_TIMER_WHEEL_LEVELS - 1) * TB_TIMER_WHEEL_BITSN)) - 1)
+
+// the maximum lag of the wheel time, we will rebuild the wheels instead of turning them if the clock jumps
+#define TB_TIMER_WHEEL_LAGN                 (TB_TIMER_WHEEL_SLOTS0 * TB_TIMER_WHEEL_SLOTSN)
+
+// the wheel index of the expired tasks
+#define TB_TIMER_WINDX_EXPIRED              (TB_TIMER_WHEEL_MAXN)
+
+// the wheel index of the detached task
+#define TB_TIMER_WINDX_NONE                 ((tb_uint32_t)-1)
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * types
  */
@@ -46,6 +80,9 @@
 // the timer task type
 typedef struct __tb_timer_task_t
 {
+    // the list entry
+    tb_list_entry_t             entry;
+
     // the func
     tb_timer_task_func_t        func;
 
@@ -67,9 +104,31 @@ typedef struct __tb_timer_task_t
     // the refn, <= 2
     tb_uint32_t                 refn    : 2;
 
+    // the wheel index
+    tb_uint32_t                 windx;
+
 }tb_timer_task_t;
 
-/// the timer type
+/*! the timer type
+ *
+ * <pre>
+ *
+ * the hierarchical timing wheels, insert and remove tasks in O(1)
+ *
+ * wheel0: |-|-|-|-|-|-|- ... -|-|     256 slots, 1ms per slot
+ *                  |
+ *                wtime
+ *
+ * wheel1: |---|---|--- ... ---|        64 slots, 256ms per slot
+ * wheel2: |---|---|--- ... ---|        64 slots, 16s per slot
+ * wheel3: |---|---|--- ... ---|        64 slots, ~17min per slot
+ * wheel4: |---|---|--- ... ---|        64 slots, ~18h per slot
+ *
+ * the tasks of the higher wheel slot will be cascaded to the lower wheels
+ * when the lower wheel turns around
+ *
+ * </pre>
+ */
 typedef struct __tb_timer_t
 {
     // the grow
@@ -90,12 +149,24 @@ typedef struct __tb_timer_t
     // the pool
     tb_fixed_pool_ref_t         pool;
 
-    // the heap
-    tb_heap_ref_t               heap;
-
     // the event
     tb_event_ref_t              event;
 
+    // the wheel time, all tasks before this time have been moved to the expired tasks
+    tb_hong_t                   wtime;
+
+    // the tasks count in the wheels and the expired tasks
+    tb_size_t                   size;
+
+    // the expired tasks
+    tb_list_entry_head_t        expired;
+
+    // the wheel slots
+    tb_list_entry_head_t        wheel[TB_TIMER_WHEEL_MAXN];
+
+    // the non-empty bits of the first wheel
+    tb_uint32_t                 wbits[TB_TIMER_WHEEL_SLOTS0 >> 5];
+
 }tb_timer_t;
 
 /* //////////////////////////////////////////////////////////////////////////////////////
@@ -114,20 +185,221 @@ static __tb_inline__ tb_hong_t tb_timer_now(tb_timer_t* timer)
     // using cached time
     return tb_cache_time_mclock();
 }
-static tb_long_t tb_timer_comp_by_when(tb_element_ref_t element, tb_cpointer_t ldata, tb_cpointer_t rdata)
+static __tb_inline__ tb_list_entry_head_ref_t tb_timer_list(tb_timer_t* timer, tb_size_t windx)
 {
     // check
-    tb_timer_task_t const* ltask = (tb_timer_task_t const*)ldata;
-    tb_timer_task_t const* rtask = (tb_timer_task_t const*)rdata;
-    tb_assert_and_check_return_val(ltask && rtask, -1);
+    tb_assert(windx <= TB_TIMER_WINDX_EXPIRED);
 
-    // comp
-    return (ltask->when > rtask->when? 1 : (ltask->when < rtask->when? -1 : 0));
+    // get the slot list or the expired list
+    return windx < TB_TIMER_WHEEL_MAXN? &timer->wheel[windx] : &timer->expired;
 }
-static tb_bool_t tb_timer_pred_by_task(tb_iterator_ref_t iterator, tb_cpointer_t item, tb_cpointer_t value)
+static tb_size_t tb_timer_wheel_next(tb_timer_t* timer, tb_size_t index)
 {
-    // is equal?
-    return item == value;
+    // find the next non-empty slot of the first wheel from the given index
+    tb_size_t i = index >> 5;
+    tb_uint32_t bits = timer->wbits[i] & ~(((tb_uint32_t)1 << (index & 31)) - 1);
+    while (1)
+    {
+        // found?
+        if (bits) return (i << 5) + tb_bits_fb1_u32_le(bits);
+
+        // the next bits
+        if (++i >= tb_arrayn(timer->wbits)) break;
+        bits = timer->wbits[i];
+    }
+
+    // not found
+    return TB_TIMER_WHEEL_SLOTS0;
+}
+static tb_hong_t tb_timer_wheel_when(tb_timer_t* timer)
+{
+    // expired tasks? 
+    if (tb_list_entry_size(&timer->expired)) return timer->wtime - 1;
+
+    // no tasks?
+    tb_check_return_val(timer->size, -1);
+
+    /* the higher wheels will be cascaded at the begin of this round, 
+     * so we need spak it now before the first wheel becomes valid
+     */
+    tb_size_t index = (tb_size_t)(timer->wtime & (TB_TIMER_WHEEL_SLOTS0 - 1));
+    if (!index) return timer->wtime;
+
+    /* the next non-empty slot of the first wheel in this round, 
+     * or the end of this round for cascading the higher wheels
+     */
+    return timer->wtime + (tb_timer_wheel_next(timer, index) - index);
+}
+static tb_void_t tb_timer_add_task(tb_timer_t* timer, tb_timer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer_task && timer_task->windx == TB_TIMER_WINDX_NONE);
+
+    // trace
+    tb_trace_d("add: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // compute the wheel index
+    tb_size_t windx;
+    tb_hong_t when = timer_task->when;
+    tb_hong_t diff = when - timer->wtime;
+    if (diff < 0) windx = TB_TIMER_WINDX_EXPIRED;
+    else if (diff < TB_TIMER_WHEEL_SLOTS0)
+    {
+        // the slot of the first wheel
+        windx = (tb_size_t)(when & (TB_TIMER_WHEEL_SLOTS0 - 1));
+
+        // mark this slot as non-empty
+        timer->wbits[windx >> 5] |= ((tb_uint32_t)1 << (windx & 31));
+    }
+    else
+    {
+        // out of range? put it to the last slot and it will be cascaded again
+        if (diff > TB_TIMER_WHEEL_RANGE) 
+        {
+            diff = TB_TIMER_WHEEL_RANGE;
+            when = timer->wtime + diff;
+        }
+
+        // find the higher wheel
+        tb_size_t level = 1;
+        tb_size_t shift = TB_TIMER_WHEEL_BITS0;
+        while (level < TB_TIMER_WHEEL_LEVELS - 1 && (diff >> (shift + TB_TIMER_WHEEL_BITSN))) 
+        {
+            shift += TB_TIMER_WHEEL_BITSN;
+            level++;
+        }
+
+        // the slot of the higher wheel
+        windx = TB_TIMER_WHEEL_SLOTS0 + (level - 1) * TB_TIMER_WHEEL_SLOTSN + (tb_size_t)((when >> shift) & (TB_TIMER_WHEEL_SLOTSN - 1));
+    }
+
+    // add it to the slot
+    timer_task->windx = (tb_uint32_t)windx;
+    tb_list_entry_insert_tail(tb_timer_list(timer, windx), &timer_task->entry);
+    timer->size++;
+}
+static tb_void_t tb_timer_del_task(tb_timer_t* timer, tb_timer_task_t* timer_task)
+{
+    // check
+    tb_assert(timer && timer_task && timer_task->windx != TB_TIMER_WINDX_NONE);
+
+    // trace
+    tb_trace_d("del: when: %lld, period: %u, refn: %u", timer_task->when, timer_task->period, timer_task->refn);
+
+    // remove it from the slot
+    tb_size_t                   windx = timer_task->windx;
+    tb_list_entry_head_ref_t    list = tb_timer_list(timer, windx);
+    tb_list_entry_remove(list, &timer_task->entry);
+    timer_task->windx = TB_TIMER_WINDX_NONE;
+    timer->size--;
+
+    // the slot of the first wheel is empty now?
+    if (windx < TB_TIMER_WHEEL_SLOTS0 && !tb_list_entry_size(list))
+        timer->wbits[windx >> 5] &= ~((tb_uint32_t)1 << (windx & 31));
+}
+static tb_void_t tb_timer_cascade(tb_timer_t* timer, tb_size_t windx)
+{
+    // re-add all tasks of this slot to the lower wheels
+    tb_list_entry_head_ref_t list = &timer->wheel[windx];
+    while (tb_list_entry_size(list))
+    {
+        // get the task
+        tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_list_entry(list, tb_list_entry_head(list));
+
+        // move it
+        tb_timer_del_task(timer, timer_task);
+        tb_timer_add_task(timer, timer_task);
+    }
+}
+static tb_void_t tb_timer_wheel_jump(tb_timer_t* timer, tb_hong_t now)
+{
+    // detach all tasks from the wheels
+    tb_size_t               windx;
+    tb_list_entry_head_t    tasks;
+    tb_list_entry_init(&tasks, tb_timer_task_t, entry, tb_null);
+    for (windx = 0; windx < TB_TIMER_WHEEL_MAXN; windx++)
+    {
+        tb_list_entry_head_ref_t list = &timer->wheel[windx];
+        while (tb_list_entry_size(list))
+        {
+            tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_list_entry(list, tb_list_entry_head(list));
+            tb_timer_del_task(timer, timer_task);
+            tb_list_entry_insert_tail(&tasks, &timer_task->entry);
+        }
+    }
+
+    // move the wheel time to now and add them again, the timeout tasks will be expired
+    timer->wtime = now + 1;
+    while (tb_list_entry_size(&tasks))
+    {
+        tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_list_entry(&tasks, tb_list_entry_head(&tasks));
+        tb_list_entry_remove_head(&tasks);
+        tb_timer_add_task(timer, timer_task);
+    }
+    tb_list_entry_exit(&tasks);
+}
+static tb_void_t tb_timer_wheel_spak(tb_timer_t* timer, tb_hong_t now)
+{
+    // no tasks? move the wheel time to now directly
+    if (!timer->size)
+    {
+        timer->wtime = now + 1;
+        return ;
+    }
+
+    /* the clock jumps? (e.g. the cached time is updated at first or the system time is changed)
+     * rebuild the wheels directly instead of turning them slot by slot
+     */
+    if (now - timer->wtime > TB_TIMER_WHEEL_LAGN || timer->wtime - now > TB_TIMER_WHEEL_LAGN)
+    {
+        tb_timer_wheel_jump(timer, now);
+        return ;
+    }
+
+    // move all tasks before now to the expired tasks
+    while (timer->wtime <= now)
+    {
+        // the slot index of the first wheel
+        tb_size_t index = (tb_size_t)(timer->wtime & (TB_TIMER_WHEEL_SLOTS0 - 1));
+
+        // the first wheel turns around? cascade the higher wheels
+        if (!index)
+        {
+            tb_size_t level = 1;
+            tb_size_t shift = TB_TIMER_WHEEL_BITS0;
+            for (level = 1; level < TB_TIMER_WHEEL_LEVELS; level++, shift += TB_TIMER_WHEEL_BITSN)
+            {
+                // cascade this slot
+                tb_size_t slot = (tb_size_t)((timer->wtime >> shift) & (TB_TIMER_WHEEL_SLOTSN - 1));
+                tb_timer_cascade(timer, TB_TIMER_WHEEL_SLOTS0 + (level - 1) * TB_TIMER_WHEEL_SLOTSN + slot);
+
+                // this wheel does not turn around? stop cascading
+                if (slot) break;
+            }
+        }
+
+        // skip the empty slots
+        tb_size_t next = tb_timer_wheel_next(timer, index);
+        if (next != index)
+        {
+            // the wheel time of the next non-empty slot or the next round
+            tb_hong_t wtime = timer->wtime + (next - index);
+            timer->wtime = wtime <= now? wtime : now + 1;
+            continue;
+        }
+
+        // move this slot to the expired tasks
+        tb_list_entry_head_ref_t list = &timer->wheel[index];
+        tb_for_all_if (tb_timer_task_t*, timer_task, tb_list_entry_itor(list), timer_task)
+        {
+            timer_task->windx = TB_TIMER_WINDX_EXPIRED;
+        }
+        tb_list_entry_splice_tail(&timer->expired, list);
+        timer->wbits[index >> 5] &= ~((tb_uint32_t)1 << (index & 31));
+
+        // next slot
+        timer->wtime++;
+    }
 }
 static tb_int_t tb_timer_instance_loop(tb_cpointer_t priv)
 {
@@ -223,24 +495,31 @@ tb_timer_ref_t tb_timer_init(tb_size_t grow, tb_bool_t ctime)
         timer = tb_malloc0_type(tb_timer_t);
         tb_assert_and_check_break(timer);
 
-        // init element
-        tb_element_t element = tb_element_ptr(tb_null, tb_null); element.comp = tb_timer_comp_by_when;
-
         // init timer
         timer->grow         = tb_max(grow, 16);
         timer->ctime        = ctime;
 
+        // update the cached time first if it has been never updated, otherwise the new tasks will be expired immediately
+        if (ctime && !tb_cache_time_mclock()) tb_cache_time_spak();
+
+        // init the wheel time
+        timer->wtime        = tb_timer_now(timer);
+
         // init lock
         if (!tb_spinlock_init(&timer->lock)) break;
 
         // init pool
         timer->pool         = tb_fixed_pool_init(tb_null, timer->grow, sizeof(tb_timer_task_t), tb_null, tb_null, tb_null);
         tb_assert_and_check_break(timer->pool);
-        
-        // init heap
-        timer->heap         = tb_heap_init(timer->grow, element);
-        tb_assert_and_check_break(timer->heap);
 
+        // init wheel
+        tb_size_t i = 0;
+        for (i = 0; i < TB_TIMER_WHEEL_MAXN; i++)
+            tb_list_entry_init(&timer->wheel[i], tb_timer_task_t, entry, tb_null);
+
+        // init the expired tasks
+        tb_list_entry_init(&timer->expired, tb_timer_task_t, entry, tb_null);
+        
         // register lock profiler
 #ifdef TB_LOCK_PROFILER_ENABLE
         tb_lock_profiler_register(tb_lock_profiler(), (tb_pointer_t)&timer->lock, TB_TRACE_MODULE_NAME);
@@ -283,9 +562,13 @@ tb_void_t tb_timer_exit(tb_timer_ref_t self)
     // enter
     tb_spinlock_enter(&timer->lock);
 
-    // exit heap
-    if (timer->heap) tb_heap_exit(timer->heap);
-    timer->heap = tb_null;
+    // exit wheel
+    tb_size_t i = 0;
+    for (i = 0; i < TB_TIMER_WHEEL_MAXN; i++)
+        tb_list_entry_exit(&timer->wheel[i]);
+
+    // exit the expired tasks
+    tb_list_entry_exit(&timer->expired);
 
     // exit pool
     if (timer->pool) tb_fixed_pool_exit(timer->pool);
@@ -330,8 +613,18 @@ tb_void_t tb_timer_clear(tb_timer_ref_t self)
         // enter
         tb_spinlock_enter(&timer->lock);
 
-        // clear heap
-        if (timer->heap) tb_heap_clear(timer->heap);
+        // clear wheel
+        tb_size_t i = 0;
+        for (i = 0; i < TB_TIMER_WHEEL_MAXN; i++)
+            tb_list_entry_clear(&timer->wheel[i]);
+        tb_memset(timer->wbits, 0, sizeof(timer->wbits));
+
+        // clear the expired tasks
+        tb_list_entry_clear(&timer->expired);
+        timer->size = 0;
+
+        // move the wheel time to now
+        timer->wtime = tb_timer_now(timer);
 
         // clear pool
         if (timer->pool) tb_fixed_pool_clear(timer->pool);
@@ -344,7 +637,7 @@ tb_hize_t tb_timer_top(tb_timer_ref_t self)
 {
     // check
     tb_timer_t* timer = (tb_timer_t*)self;
-    tb_assert_and_check_return_val(timer && timer->heap, -1);
+    tb_assert_and_check_return_val(timer, -1);
 
     // stoped?
     tb_assert_and_check_return_val(!tb_atomic_get(&timer->stop), -1);
@@ -352,26 +645,20 @@ tb_hize_t tb_timer_top(tb_timer_ref_t self)
     // enter
     tb_spinlock_enter(&timer->lock);
 
-    // done
-    tb_hize_t when = -1; 
-    if (tb_heap_size(timer->heap))
-    {
-        // the task
-        tb_timer_task_t const* timer_task = (tb_timer_task_t const*)tb_heap_top(timer->heap);
-        if (timer_task) when = timer_task->when;
-    }
+    // the next when of the wheel, it may be earlier than the first task if the higher wheels need be cascaded
+    tb_hong_t when = tb_timer_wheel_when(timer);
 
     // leave
     tb_spinlock_leave(&timer->lock);
 
     // ok?
-    return when;
+    return when >= 0? (tb_hize_t)when : (tb_hize_t)-1;
 }
 tb_size_t tb_timer_delay(tb_timer_ref_t self)
 {
     // check
     tb_timer_t* timer = (tb_timer_t*)self;
-    tb_assert_and_check_return_val(timer && timer->heap, -1);
+    tb_assert_and_check_return_val(timer, -1);
 
     // stoped?
     tb_assert_and_check_return_val(!tb_atomic_get(&timer->stop), -1);
@@ -381,18 +668,14 @@ tb_size_t tb_timer_delay(tb_timer_ref_t self)
 
     // done
     tb_size_t delay = -1; 
-    if (tb_heap_size(timer->heap))
+    tb_hong_t when = tb_timer_wheel_when(timer);
+    if (when >= 0)
     {
-        // the task
-        tb_timer_task_t const* timer_task = (tb_timer_task_t const*)tb_heap_top(timer->heap);
-        if (timer_task)
-        {
-            // the now
-            tb_hong_t now = tb_timer_now(timer);
+        // the now
+        tb_hong_t now = tb_timer_now(timer);
 
-            // the delay
-            delay = timer_task->when > now? (tb_size_t)(timer_task->when - now) : 0;
-        }
+        // the delay
+        delay = when > now? (tb_size_t)(when - now) : 0;
     }
 
     // leave
@@ -405,43 +688,44 @@ tb_bool_t tb_timer_spak(tb_timer_ref_t self)
 {
     // check
     tb_timer_t* timer = (tb_timer_t*)self;
-    tb_assert_and_check_return_val(timer && timer->pool && timer->heap, tb_false);
+    tb_assert_and_check_return_val(timer && timer->pool, tb_false);
 
     // stoped?
     tb_check_return_val(!tb_atomic_get(&timer->stop), tb_false);
 
+    // the now
+    tb_hong_t now = tb_timer_now(timer);
+
     // enter
     tb_spinlock_enter(&timer->lock);
 
-    // done
-    tb_bool_t               ok = tb_false;
-    tb_timer_task_func_t    func = tb_null;
-    tb_cpointer_t           priv = tb_null;
-    tb_bool_t               killed = tb_false;
-    do
-    {
-        // empty? 
-        if (!tb_heap_size(timer->heap))
-        {
-            ok = tb_true;
-            break;
-        }
+    // move all timeout tasks to the expired tasks
+    tb_timer_wheel_spak(timer, now);
 
-        // the top task
-        tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_heap_top(timer->heap);
-        tb_assert_and_check_break(timer_task);
+    // only done the current expired tasks, the repeated tasks with zero period will be done in the next spak
+    tb_size_t count = tb_list_entry_size(&timer->expired);
 
-        // check refn
-        tb_assert(timer_task->refn);
+    // leave
+    tb_spinlock_leave(&timer->lock);
 
-        // the now
-        tb_hong_t now = tb_timer_now(timer);
+    // done the expired tasks
+    while (count--)
+    {
+        // enter
+        tb_spinlock_enter(&timer->lock);
 
-        // timeout?
-        if (timer_task->when <= now)
+        // the expired task may be removed by tb_timer_task_exit() in the previous task func
+        tb_timer_task_func_t    func = tb_null;
+        tb_cpointer_t           priv = tb_null;
+        tb_bool_t               killed = tb_false;
+        if (tb_list_entry_size(&timer->expired))
         {
-            // pop it
-            tb_heap_pop(timer->heap);
+            // the expired task
+            tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_list_entry(&timer->expired, tb_list_entry_head(&timer->expired));
+            tb_assert(timer_task && timer_task->refn);
+
+            // remove it
+            tb_timer_del_task(timer, timer_task);
 
             // save func and data for calling it later
             func = timer_task->func;
@@ -457,7 +741,7 @@ tb_bool_t tb_timer_spak(tb_timer_ref_t self)
                 timer_task->when = now + timer_task->period;
 
                 // continue timer_task
-                tb_heap_put(timer->heap, timer_task);
+                tb_timer_add_task(timer, timer_task);
             }
             else 
             {
@@ -467,20 +751,17 @@ tb_bool_t tb_timer_spak(tb_timer_ref_t self)
                 else tb_fixed_pool_free(timer->pool, timer_task);
             }
         }
+        else count = 0;
 
-        // ok
-        ok = tb_true;
-
-    } while (0);
-
-    // leave
-    tb_spinlock_leave(&timer->lock);
+        // leave
+        tb_spinlock_leave(&timer->lock);
 
-    // done func
-    if (func) func(killed, priv);
+        // done func
+        if (func) func(killed, priv);
+    }
 
-    // ok?
-    return ok;
+    // ok
+    return tb_true;
 }
 tb_void_t tb_timer_loop(tb_timer_ref_t self)
 {
@@ -536,7 +817,7 @@ tb_timer_task_ref_t tb_timer_task_init_at(tb_timer_ref_t self, tb_hize_t when, t
 {
     // check
     tb_timer_t* timer = (tb_timer_t*)self;
-    tb_assert_and_check_return_val(timer && timer->pool && timer->heap && func, tb_null);
+    tb_assert_and_check_return_val(timer && timer->pool && func, tb_null);
 
     // stoped?
     tb_assert_and_check_return_val(!tb_atomic_get(&timer->stop), tb_null);
@@ -546,16 +827,12 @@ tb_timer_task_ref_t tb_timer_task_init_at(tb_timer_ref_t self, tb_hize_t when, t
 
     // make task
     tb_event_ref_t      event = tb_null;
-    tb_hize_t           when_top = -1;
+    tb_hong_t           when_top = -1;
     tb_timer_task_t*    timer_task = (tb_timer_task_t*)tb_fixed_pool_malloc0(timer->pool);
     if (timer_task)
     {
         // the top when 
-        if (tb_heap_size(timer->heap))
-        {
-            tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_heap_top(timer->heap);
-            if (timer_task) when_top = timer_task->when;
-        }
+        when_top = tb_timer_wheel_when(timer);
 
         // init task
         timer_task->refn      = 2;
@@ -564,9 +841,10 @@ tb_timer_task_ref_t tb_timer_task_init_at(tb_timer_ref_t self, tb_hize_t when, t
         timer_task->when      = when;
         timer_task->period    = period;
         timer_task->repeat    = repeat? 1 : 0;
+        timer_task->windx     = TB_TIMER_WINDX_NONE;
 
         // add task
-        tb_heap_put(timer->heap, timer_task);
+        tb_timer_add_task(timer, timer_task);
 
         // the event
         event = timer->event;
@@ -576,7 +854,7 @@ tb_timer_task_ref_t tb_timer_task_init_at(tb_timer_ref_t self, tb_hize_t when, t
     tb_spinlock_leave(&timer->lock);
 
     // post event if the top task is changed
-    if (event && timer_task && when < when_top)
+    if (event && timer_task && (when_top < 0 || (tb_hong_t)when < when_top))
         tb_event_post(event);
 
     // ok?
@@ -604,7 +882,7 @@ tb_void_t tb_timer_task_post_at(tb_timer_ref_t self, tb_hize_t when, tb_size_t p
 {
     // check
     tb_timer_t* timer = (tb_timer_t*)self;
-    tb_assert_and_check_return(timer && timer->pool && timer->heap && func);
+    tb_assert_and_check_return(timer && timer->pool && func);
 
     // stoped?
     tb_assert_and_check_return(!tb_atomic_get(&timer->stop));
@@ -614,16 +892,12 @@ tb_void_t tb_timer_task_post_at(tb_timer_ref_t self, tb_hize_t when, tb_size_t p
 
     // make task
     tb_event_ref_t      event = tb_null;
-    tb_hize_t           when_top = -1;
+    tb_hong_t           when_top = -1;
     tb_timer_task_t*    timer_task = (tb_timer_task_t*)tb_fixed_pool_malloc0(timer->pool);
     if (timer_task)
     {
         // the top when 
-        if (tb_heap_size(timer->heap))
-        {
-            tb_timer_task_t* timer_task = (tb_timer_task_t*)tb_heap_top(timer->heap);
-            if (timer_task) when_top = timer_task->when;
-        }
+        when_top = tb_timer_wheel_when(timer);
 
         // init task
         timer_task->refn      = 1;
@@ -632,9 +906,10 @@ tb_void_t tb_timer_task_post_at(tb_timer_ref_t self, tb_hize_t when, tb_size_t p
         timer_task->when      = when;
         timer_task->period    = period;
         timer_task->repeat    = repeat? 1 : 0;
+        timer_task->windx     = TB_TIMER_WINDX_NONE;
 
         // add task
-        tb_heap_put(timer->heap, timer_task);
+        tb_timer_add_task(timer, timer_task);
 
         // the event
         event = timer->event;
@@ -644,7 +919,7 @@ tb_void_t tb_timer_task_post_at(tb_timer_ref_t self, tb_hize_t when, tb_size_t p
     tb_spinlock_leave(&timer->lock);
 
     // post event if the top task is changed
-    if (event && timer_task && when < when_top)
+    if (event && timer_task && (when_top < 0 || (tb_hong_t)when < when_top))
         tb_event_post(event);
 }
 tb_void_t tb_timer_task_post_after(tb_timer_ref_t self, tb_hize_t after, tb_size_t period, tb_bool_t repeat, tb_timer_task_func_t func, tb_cpointer_t priv)
@@ -659,8 +934,8 @@ tb_void_t tb_timer_task_post_after(tb_timer_ref_t self, tb_hize_t after, tb_size
 tb_void_t tb_timer_task_exit(tb_timer_ref_t self, tb_timer_task_ref_t task)
 {
     // check
-    tb_timer_t*             timer = (tb_timer_t*)self;
-    tb_timer_task_t*   timer_task = (tb_timer_task_t*)task;
+    tb_timer_t*         timer = (tb_timer_t*)self;
+    tb_timer_task_t*    timer_task = (tb_timer_task_t*)task;
     tb_assert_and_check_return(timer && timer->pool && timer_task);
 
     // trace
@@ -669,19 +944,11 @@ tb_void_t tb_timer_task_exit(tb_timer_ref_t self, tb_timer_task_ref_t task)
     // enter
     tb_spinlock_enter(&timer->lock);
 
-    // remove it?
-    if (timer_task->refn > 1)
-    {
-        // refn--
-        timer_task->refn--;
+    // remove it from the wheel directly if it is not expired, it is only O(1)
+    if (timer_task->windx != TB_TIMER_WINDX_NONE) tb_timer_del_task(timer, timer_task);
 
-        // cancel task 
-        timer_task->func      = tb_null;
-        timer_task->priv      = tb_null;
-        timer_task->repeat    = 0;
-    }
-    // remove it from pool directly if the timer_task have been expired 
-    else tb_fixed_pool_free(timer->pool, timer_task);
+    // free it
+    tb_fixed_pool_free(timer->pool, timer_task);
 
     // leave
     tb_spinlock_leave(&timer->lock);
@@ -703,14 +970,10 @@ tb_void_t tb_timer_task_kill(tb_timer_ref_t self, tb_timer_task_ref_t task)
     do
     {
         // expired or removed?
-        tb_check_break(timer_task->refn == 2);
-
-        // find it
-        tb_size_t itor = tb_find_all_if(timer->heap, tb_timer_pred_by_task, timer_task);
-        tb_assert_and_check_break(itor != tb_iterator_tail(timer->heap));
+        tb_check_break(timer_task->refn == 2 && timer_task->windx != TB_TIMER_WINDX_NONE);
 
         // remove this task
-        tb_heap_remove(timer->heap, itor);
+        tb_timer_del_task(timer, timer_task);
 
         // killed
         timer_task->killed = 1;
@@ -718,11 +981,9 @@ tb_void_t tb_timer_task_kill(tb_timer_ref_t self, tb_timer_task_ref_t task)
         // no repeat
         timer_task->repeat = 0;
                 
-        // modify when => now
-        timer_task->when = tb_timer_now(timer);
-
-        // re-add timer_task
-        tb_heap_put(timer->heap, timer_task);
+        // done it in the next spak
+        timer_task->when = timer->wtime - 1;
+        tb_timer_add_task(timer, timer_task);
 
     } while (0);
 
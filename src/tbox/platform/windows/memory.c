@@ -29,6 +29,7 @@
 #include "prefix.h"
 #include "../sched.h"
 #include "../memory.h"
+#include "../page.h"
 #include "../atomic.h"
 #include "../spinlock.h"
 
@@ -187,4 +188,51 @@ tb_bool_t tb_native_memory_free(tb_pointer_t data)
     // ok?
     return ok;
 }
+tb_bool_t tb_native_memory_trim(tb_size_t keep_bytes)
+{
+    /* enter 
+     *
+     * @note the heap will decommit the free pages by itself, so keep_bytes is not used and we only coalesce the free blocks here
+     */
+    tb_spinlock_enter_without_profiler(&g_lock);
+
+    // compact heap
+    tb_bool_t ok = tb_false;
+    if (g_heap) ok = HeapCompact((HANDLE)g_heap, 0)? tb_true : tb_false;
+
+    // leave
+    tb_spinlock_leave(&g_lock);
 
+    // ok?
+    return ok;
+}
+tb_pointer_t tb_native_memory_huge_malloc(tb_size_t size, tb_size_t* real, tb_size_t* page)
+{
+    // check
+    tb_check_return_val(size, tb_null);
+
+    /* align size
+     *
+     * @note the large pages need SeLockMemoryPrivilege, so we only use the normal pages now
+     */
+    tb_size_t page_size = tb_page_size();
+    if (page_size) size = tb_align(size, page_size);
+
+    // alloc it
+    tb_pointer_t data = VirtualAlloc(tb_null, (SIZE_T)size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+    // save the real size and the page size
+    if (data && real) *real = size;
+    if (data && page) *page = page_size;
+
+    // ok?
+    return data;
+}
+tb_bool_t tb_native_memory_huge_free(tb_pointer_t data, tb_size_t size)
+{
+    // check
+    tb_check_return_val(data, tb_true);
+
+    // free it
+    return VirtualFree(data, 0, MEM_RELEASE)? tb_true : tb_false;
+}
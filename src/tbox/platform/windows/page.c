@@ -59,5 +59,16 @@ tb_size_t tb_page_size()
 {
     return g_page_size;
 }
-
-
+tb_size_t tb_page_huge_size()
+{
+    /* not supported now
+     *
+     * @note the large pages need SeLockMemoryPrivilege on windows
+     */
+    return 0;
+}
+tb_size_t tb_page_hugetlb_size()
+{
+    // not supported now
+    return 0;
+}
@@ -490,6 +490,12 @@ tb_bool_t tb_socket_listen(tb_socket_ref_t sock, tb_size_t backlog)
     // listen
     return (tb_ws2_32()->listen(tb_sock2fd(sock), (tb_int_t)backlog) < 0)? tb_false : tb_true;
 }
+tb_bool_t tb_socket_listen_group(tb_socket_ref_t* socks, tb_size_t count, tb_size_t type, tb_ipaddr_ref_t addr, tb_size_t backlog, tb_bool_t affinity)
+{
+    // SO_REUSEPORT is not supported, and SO_REUSEADDR cannot balance the connections on windows
+    tb_trace_noimpl();
+    return tb_false;
+}
 tb_socket_ref_t tb_socket_accept(tb_socket_ref_t sock, tb_ipaddr_ref_t addr)
 {
     // check
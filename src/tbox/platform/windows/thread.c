@@ -112,3 +112,16 @@ tb_size_t tb_thread_self()
 {
     return (tb_size_t)GetCurrentThreadId();
 }
+tb_bool_t tb_thread_affinity_set(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    // check
+    tb_assert_and_check_return_val(cpuset, tb_false);
+
+    // set the affinity mask, only the cpus of the current processor group are supported
+    return SetThreadAffinityMask(thread? (HANDLE)thread : GetCurrentThread(), (DWORD_PTR)cpuset->bits[0])? tb_true : tb_false;
+}
+tb_bool_t tb_thread_affinity_get(tb_thread_ref_t thread, tb_cpuset_ref_t cpuset)
+{
+    tb_trace_noimpl();
+    return tb_false;
+}
@@ -88,6 +88,9 @@ tb_bool_t tb_thread_local_init(tb_thread_local_ref_t local, tb_thread_local_free
     // check
     tb_assert_and_check_return_val(local, tb_false);
 
+    // the thread local list has not been initialized? it may be called before tb_init() by the allocator
+    tb_check_return_val(g_thread_local_inited, tb_false);
+
     // run the once function
     tb_value_t tuple[2];
     tuple[0].ptr = (tb_pointer_t)local;
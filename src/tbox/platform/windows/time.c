@@ -77,6 +77,24 @@ tb_hong_t tb_uclock()
     
     return (t.QuadPart * 1000000) / f.QuadPart;
 }
+tb_hong_t tb_clock_ns()
+{
+    // the frequency is fixed at system boot
+    static tb_hong_t s_freq = 0;
+    if (!s_freq)
+    {
+        LARGE_INTEGER f = {{0}};
+        if (!QueryPerformanceFrequency(&f) || !f.QuadPart) return 0;
+        s_freq = f.QuadPart;
+    }
+
+    // get the counter, it is the invariant tsc on the modern systems
+    LARGE_INTEGER t = {{0}};
+    if (!QueryPerformanceCounter(&t)) return 0;
+
+    // scale it without overflow
+    return (t.QuadPart / s_freq) * 1000000000 + ((t.QuadPart % s_freq) * 1000000000) / s_freq;
+}
 tb_bool_t tb_gettimeofday(tb_timeval_t* tv, tb_timezone_t* tz)
 {
     union 
@@ -59,6 +59,15 @@ typedef tb_buffer_ref_t     tb_string_ref_t;
  */
 tb_bool_t               tb_string_init(tb_string_ref_t string);
 
+/*! init string with the given allocator
+ *
+ * @param string        the string
+ * @param allocator     the allocator, uses the global allocator if be null
+ *
+ * @return              tb_true or tb_false
+ */
+tb_bool_t               tb_string_init_with_allocator(tb_string_ref_t string, tb_allocator_ref_t allocator);
+
 /*! exit string
  *
  * @param string        the string
@@ -46,6 +46,22 @@
 #   endif
 #endif
 
+/* lock the line and the output
+ *
+ * the line is formatted without the lock if it is thread-local, so we only lock the output
+ */
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+#   define tb_trace_line_enter()
+#   define tb_trace_line_leave()
+#   define tb_trace_output_enter()      tb_spinlock_enter_without_profiler(&g_lock)
+#   define tb_trace_output_leave()      tb_spinlock_leave(&g_lock)
+#else
+#   define tb_trace_line_enter()        tb_spinlock_enter_without_profiler(&g_lock)
+#   define tb_trace_line_leave()        tb_spinlock_leave(&g_lock)
+#   define tb_trace_output_enter()
+#   define tb_trace_output_leave()
+#endif
+
 /* //////////////////////////////////////////////////////////////////////////////////////
  * globals
  */
@@ -61,11 +77,19 @@ static tb_file_ref_t    g_file = tb_null;
 static tb_bool_t        g_bref = tb_false;
 #endif
 
+#ifdef TB_THREAD_LOCAL_STATIC_ENABLE
+/* the line of the current thread
+ *
+ * we format it without the lock and only lock the output
+ */
+static __tb_thread_local__ tb_char_t    g_line[TB_TRACE_LINE_MAXN];
+#else
 // the line
 static tb_char_t        g_line[TB_TRACE_LINE_MAXN];
+#endif
 
 // the lock
-static tb_spinlock_t    g_lock = TB_SPINLOCK_INIT; 
+static tb_spinlock_t    g_lock = TB_SPINLOCK_INIT_TICKET; 
 
 /* //////////////////////////////////////////////////////////////////////////////////////
  * implementation
@@ -73,7 +97,7 @@ static tb_spinlock_t    g_lock = TB_SPINLOCK_INIT;
 tb_bool_t tb_trace_init()
 {
     // init lock
-    return tb_spinlock_init(&g_lock);
+    return tb_spinlock_init_ticket(&g_lock);
 }
 tb_void_t tb_trace_exit()
 {
@@ -193,8 +217,8 @@ tb_void_t tb_trace_done_with_args(tb_char_t const* prefix, tb_char_t const* modu
     // check
     tb_check_return(format);
 
-    // enter
-    tb_spinlock_enter_without_profiler(&g_lock);
+    // enter the line
+    tb_trace_line_enter();
 
     // done
     do
@@ -234,6 +258,9 @@ tb_void_t tb_trace_done_with_args(tb_char_t const* prefix, tb_char_t const* modu
         if (p < e) *p = '\0';
         e[-1] = '\0';
 
+        // enter the output
+        tb_trace_output_enter();
+
         // print it
         if (g_mode & TB_TRACE_MODE_PRINT) tb_print(b);
 
@@ -256,10 +283,13 @@ tb_void_t tb_trace_done_with_args(tb_char_t const* prefix, tb_char_t const* modu
         }
 #endif
 
+        // leave the output
+        tb_trace_output_leave();
+
     } while (0);
 
-    // leave
-    tb_spinlock_leave(&g_lock);
+    // leave the line
+    tb_trace_line_leave();
 }
 tb_void_t tb_trace_done(tb_char_t const* prefix, tb_char_t const* module, tb_char_t const* format, ...)
 {
@@ -281,8 +311,8 @@ tb_void_t tb_trace_tail(tb_char_t const* format, ...)
     // check
     tb_check_return(format);
 
-    // enter
-    tb_spinlock_enter_without_profiler(&g_lock);
+    // enter the line
+    tb_trace_line_enter();
 
     // done
     do
@@ -303,6 +333,9 @@ tb_void_t tb_trace_tail(tb_char_t const* format, ...)
         if (p < e) *p = '\0';
         e[-1] = '\0';
 
+        // enter the output
+        tb_trace_output_enter();
+
         // print it
         if (g_mode & TB_TRACE_MODE_PRINT) tb_print(g_line);
 
@@ -325,13 +358,16 @@ tb_void_t tb_trace_tail(tb_char_t const* format, ...)
         }
 #endif
 
+        // leave the output
+        tb_trace_output_leave();
+
         // exit
         tb_va_end(l);
 
     } while (0);
 
-    // leave
-    tb_spinlock_leave(&g_lock);
+    // leave the line
+    tb_trace_line_leave();
 }
 tb_void_t tb_trace_sync()
 {
@@ -164,6 +164,7 @@ function check_interfaces()
     add_cfuncs("posix", nil,        "ifaddrs.h",                        "getifaddrs")
     add_cfuncs("posix", nil,        "semaphore.h",                      "sem_init")
     add_cfuncs("posix", nil,        "unistd.h",                         "getpagesize", "sysconf")
+    add_cfuncs("posix", nil,        "sys/mman.h",                       "mmap", "mprotect", "madvise")
     add_cfuncs("posix", nil,        "sched.h",                          "sched_yield")
     add_cfuncs("posix", nil,        "regex.h",                          "regcomp", "regexec")
     add_cfuncs("posix", nil,        "sys/uio.h",                        "readv", "writev", "preadv", "pwritev")
@@ -172,6 +173,10 @@ function check_interfaces()
     add_cfuncs("posix", nil,        "copyfile.h",                       "copyfile")
     add_cfuncs("posix", nil,        "sys/sendfile.h",                   "sendfile")
     add_cfuncs("posix", nil,        "sys/epoll.h",                      "epoll_create", "epoll_wait")
+    add_cfuncs("posix", nil,        "time.h",                           "clock_gettime")
+    add_cfuncs("posix", nil,        "malloc.h",                         "malloc_trim")
+    add_cfuncs("posix", nil,        "sys/eventfd.h",                    "eventfd")
+    add_cfuncs("posix", nil,        {"unistd.h", "sys/syscall.h", "linux/io_uring.h"}, "io_uring_setup{struct io_uring_params p; p.features = IORING_FEAT_FAST_POLL; syscall(__NR_io_uring_setup, 1, &p);}")
     add_cfuncs("posix", nil,        "spawn.h",                          "posix_spawnp")
     add_cfuncs("posix", nil,        "unistd.h",                         "execvp", "execvpe", "fork", "vfork")
     add_cfuncs("posix", nil,        "sys/wait.h",                       "waitpid")